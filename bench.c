@@ -0,0 +1,3221 @@
+/*******************************************************************************
+* bench.c: Prestandamtning av vektorbibliotekets publika funktioner fr
+*          samtliga datatyper och vektorstorlekar frn 10 till 10^8 element.
+*          Varje mtning upprepas ett antal gnger, dr den snabbaste
+*          upprepningen redovisas som tid per operation (ns/op) samt som
+*          genomstrmning (operationer respektive byte per sekund).
+*          Resultatet skrivs ut i JSON-format, ett resultat per rad.
+*          Mtningar av komprimerade vektorer redovisar ven
+*          kompressionsgraden. Mtningar som inte stdjer en viss datatyp
+*          hoppas ver fr den datatypen.
+*
+*          Tv resultatfiler (exempelvis fre och efter en ndring) kan
+*          jmfras, dr mtningar som blivit lngsammare n angiven
+*          trskel markeras som regressioner. Programmet avslutas d med
+*          returkod 1, vilket gr att jmfrelsen kan anvndas som kontroll
+*          innan driftsttning.
+*
+*          Kompilera programmet via GCC-kompilatorn och skapa en krbar fil
+*          dpt bench med fljande kommando:
+*          $ gcc -O2 bench.c vector*.c -o bench -pthread -lm
+*
+*          Kr samtliga mtningar och spara resultatet i filen base.json:
+*          $ ./bench --output base.json
+*
+*          Tillgngliga flaggor vid mtning:
+*          --max-size N : Strsta vektorstorlek (standard 10^8).
+*          --samples N  : Antalet upprepningar per mtning (standard 5).
+*          --filter text: Kr enbart mtningar vars namn innehller text.
+*          --output fil : Skriver resultatet till angiven fil i stllet fr
+*                         till terminalen.
+*
+*          Jmfr tv resultatfiler med en trskel p 10 procent:
+*          $ ./bench --compare base.json new.json --threshold 10
+*
+*          Kontrollera att SIMD-versionerna av berkningarna i vector_kernels
+*          ger samma resultat som den skalra versionen:
+*          $ ./bench --verify
+*
+*          Stresstesta vector_concurrent med fyra producenter som matar in
+*          10^6 element var, medan en lsare kontrollerar publicerade
+*          element (kr grna med -fsanitize=thread):
+*          $ ./bench --stress 1000000
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector.h"
+#include "vector_allocator.h"
+#include "vector_compressed.h"
+#include "vector_concurrent.h"
+#include "vector_convert.h"
+#include "vector_expr.h"
+#include "vector_file.h"
+#include "vector_format.h"
+#include "vector_hash.h"
+#include "vector_kernels.h"
+#include "vector_parallel.h"
+#include "vector_parse.h"
+#include "vector_sort.h"
+#include "vector_sparse.h"
+#include "vector_table.h"
+#include "vector_view.h"
+#include "vector_writer.h"
+#include <pthread.h>
+#include <string.h>
+#include <time.h>
+
+/* Makrodefinitioner: */
+#define BENCH_MIN_SIZE 10                 /* Minsta vektorstorlek. */
+#define BENCH_MAX_SIZE 100000000          /* Strsta vektorstorlek. */
+#define BENCH_IO_MAX_SIZE 10000000        /* Strsta vektorstorlek vid textutskrift. */
+#define BENCH_CHURN_MAX_SIZE 100000       /* Strsta antalet vektorer vid allokeringsmtning. */
+#define BENCH_CHURN_LIVE 64               /* Antalet samtidigt levande vektorer vid allokeringsmtning. */
+#define BENCH_CHURN_ROUND 1024            /* Antalet skapade vektorer per varv vid allokeringsmtning. */
+#define BENCH_CHURN_MAX_GROWTH 16         /* Strsta vektorstorlek i antalet interna buffertar. */
+#define BENCH_TABLE_MAX_SIZE 10000000     /* Strsta antalet rader vid mtning av tabeller. */
+#define BENCH_MIN_OPS 1000000             /* Minsta antalet operationer per upprepning. */
+#define BENCH_MAX_SAMPLE_TIME 2e8          /* Lngsta tid per upprepning i ns (efter frsta varvet). */
+#define BENCH_SAMPLES 5                   /* Antalet upprepningar per mtning. */
+#define BENCH_MOVES 1000                  /* Antalet frflyttningar per mtning. */
+#define BENCH_WRITER_VECTORS 4            /* Antalet kade vektorer per mtning av asynkron utskrift. */
+#define BENCH_MAX_THREADS 8               /* Strsta antalet trdar vid samtidig inmatning. */
+#define BENCH_STRESS_PRODUCERS 4          /* Antalet producenter vid stresstest. */
+#define BENCH_THRESHOLD 10.0              /* Trskel fr regression i procent. */
+#define BENCH_VERIFY_MAX_SIZE 300         /* Strsta vektorstorlek vid kontroll av berkningar. */
+#define BENCH_VERIFY_REDUCTIONS 5         /* Antalet reduktioner som kontrolleras. */
+#define BENCH_VERIFY_UPDATES 4            /* Antalet elementvisa operationer som kontrolleras. */
+#define BENCH_FILE "vector_bench.pvec"    /* Temporr fil vid mtning av filfunktioner. */
+
+/*******************************************************************************
+* bench_value: Union fr lagring av ett element av godtycklig datatyp.
+*******************************************************************************/
+union bench_value
+{
+   int integer;    /* Signerat heltal. */
+   double decimal; /* Flyttal. */
+   size_t natural; /* Osignerat heltal. */
+};
+
+/*******************************************************************************
+* bench_row: Rad vid mtning av tabeller lagrade som en array av strukter,
+*            motsvarande kolumnerna i bench_table_fill.
+*******************************************************************************/
+struct bench_row
+{
+   size_t id;        /* Radens id. */
+   size_t timestamp; /* Tidsstmpel. */
+   double value;     /* Mtvrde. */
+   double weight;    /* Vikt. */
+   int flags;        /* Flaggor (0 - 7). */
+};
+
+/*******************************************************************************
+* bench_case: Mtning av en funktion. Mtfunktionen returnerar uppmtt tid i
+*             nanosekunder och lagrar antalet utfrda operationer, eller
+*             returnerar ett negativt vrde om datatypen inte stds.
+*******************************************************************************/
+struct bench_case
+{
+   const char* name; /* Mtningens namn. */
+   size_t max_size;  /* Strsta vektorstorlek fr mtningen. */
+   double (*run)(const enum vector_type type,
+                 const size_t size,
+                 size_t* num_ops);
+};
+
+/*******************************************************************************
+* bench_producer: Trd som matar in element vid mtning av samtidig inmatning,
+*                 antingen i en segmenterad vektor eller i en vanlig vektor
+*                 skyddad av ett mutex.
+*******************************************************************************/
+struct bench_producer
+{
+   struct vector_concurrent* concurrent; /* Segmenterad vektor (eller nullpekare). */
+   struct vector* locked;                /* Vanlig vektor (eller nullpekare). */
+   pthread_mutex_t* mutex;               /* Mutex som skyddar den vanliga vektorn. */
+   union bench_value value;              /* Vrdet som matas in. */
+   size_t count;                         /* Antalet element som matas in. */
+};
+
+/*******************************************************************************
+* bench_stress: Trd vid stresstest av vector_concurrent, antingen en
+*               producent som matar in element mrkta med sitt nummer och
+*               lpnummer, eller en lsare som kontrollerar publicerade
+*               element medan inmatningen pgr.
+*******************************************************************************/
+struct bench_stress
+{
+   struct vector_concurrent* vector; /* Vektorn som testas. */
+   atomic_size_t* done;              /* Antalet frdiga producenter. */
+   size_t producer;                  /* Producentens nummer (1 - BENCH_STRESS_PRODUCERS). */
+   size_t count;                     /* Antalet element per producent. */
+   size_t errors;                    /* Antalet upptckta fel. */
+};
+
+/*******************************************************************************
+* bench_result: Resultat av en mtning, inlst frn en resultatfil.
+*******************************************************************************/
+struct bench_result
+{
+   char name[32];    /* Mtningens namn. */
+   char type[16];    /* Vektorns datatyp. */
+   size_t size;      /* Vektorns storlek. */
+   double ns_per_op; /* Tid per operation i nanosekunder. */
+};
+
+/*******************************************************************************
+* bench_kernel_result: Resultat av samtliga berkningar i vector_kernels fr
+*                      en vald instruktionsuppsttning, se bench_verify.
+*******************************************************************************/
+struct bench_kernel_result
+{
+   int status[BENCH_VERIFY_REDUCTIONS + BENCH_VERIFY_UPDATES]; /* Returkoder. */
+   union bench_value value[BENCH_VERIFY_REDUCTIONS];           /* Reduktionernas resultat. */
+   struct vector vector[BENCH_VERIFY_UPDATES];                 /* Elementvisa resultat. */
+};
+
+/* Statiska funktioner: */
+static double bench_now(void);
+static void bench_fill_compressible(struct vector* self,
+                                    const enum vector_type type,
+                                    const size_t size);
+static void bench_scan_sum(const void* data,
+                           const size_t size,
+                           void* context);
+static void bench_value_new(union bench_value* self,
+                            const enum vector_type type,
+                            const size_t index);
+static void bench_fill(struct vector* self,
+                       const enum vector_type type,
+                       const size_t size);
+static const char* bench_type_name(const enum vector_type type);
+static char* bench_text(const struct vector* vector,
+                        size_t* length);
+static int bench_compare_int(const void* first,
+                             const void* second);
+static int bench_compare_double(const void* first,
+                                const void* second);
+static int bench_compare_unsigned(const void* first,
+                                  const void* second);
+static double bench_push(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_pop(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_resize(const enum vector_type type,
+                           const size_t size,
+                           size_t* num_ops);
+static double bench_copy(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_copy_shared(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops);
+static double bench_copy_shared_write(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops);
+static double bench_join(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_move(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_get(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_set(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_get_typed(const enum vector_type type,
+                              const size_t size,
+                              size_t* num_ops);
+static double bench_print(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops);
+static double bench_write(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops);
+static struct vector_writer* bench_writer_get(void);
+static double bench_writer_move(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops);
+static double bench_writer_snapshot(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static double bench_parse(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops);
+static double bench_parse_parallel(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static double bench_sort(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_qsort(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops);
+static double bench_sum(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_dot(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_parallel_reduce(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static double bench_save(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_load(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_map(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops);
+static double bench_push_allocator(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops,
+                                   const struct vector_allocator* allocator);
+static void* bench_malloc_allocate(void* context,
+                                   const size_t size);
+static void* bench_malloc_reallocate(void* context,
+                                     void* block,
+                                     const size_t old_size,
+                                     const size_t new_size);
+static void bench_malloc_deallocate(void* context,
+                                    void* block,
+                                    const size_t size);
+static double bench_churn(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops,
+                          const struct vector_allocator* allocator,
+                          struct vector_arena* arena);
+static double bench_churn_malloc(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops);
+static double bench_churn_heap(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops);
+static double bench_churn_arena(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops);
+static double bench_churn_pool(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops);
+static double bench_push_pages(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const int huge_pages);
+static double bench_push_huge_pages(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static double bench_push_small_pages(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops);
+static double bench_scan_pages(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const int huge_pages);
+static double bench_scan_huge_pages(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static double bench_scan_small_pages(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops);
+static double bench_compress(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops);
+static double bench_decompress(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops);
+static double bench_compressed_scan(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static double bench_compressed_get(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static double bench_plain_scan(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops);
+static double bench_expr(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_expr_unfused(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops);
+static double bench_view_sum(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops);
+static double bench_view_sum_strided(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops);
+static double bench_view_sort_split(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops);
+static enum vector_type bench_compact_type(const enum vector_type type);
+static double bench_convert_narrow(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static double bench_convert_widen(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static void bench_table_fill(struct vector_table* self,
+                             struct bench_row** rows,
+                             const size_t size);
+static double bench_table_scan(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops);
+static double bench_aos_scan(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops);
+static void bench_fill_keys(struct vector* self,
+                            const enum vector_type type,
+                            const size_t size);
+static double bench_distinct(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops);
+static double bench_sort_distinct(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_histogram(const enum vector_type type,
+                              const size_t size,
+                              size_t* num_ops);
+static double bench_group_reduce(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops);
+static void bench_fill_density(struct vector* self,
+                               const enum vector_type type,
+                               const size_t size,
+                               const size_t percent);
+static double bench_axpy(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops);
+static double bench_sparse_dot(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const size_t percent);
+static double bench_sparse_axpy(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops,
+                                const size_t percent);
+static double bench_sparse_dot_1(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops);
+static double bench_sparse_dot_5(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops);
+static double bench_sparse_dot_10(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_sparse_dot_25(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_sparse_dot_50(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_sparse_axpy_1(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_sparse_axpy_5(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static double bench_sparse_axpy_10(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static double bench_sparse_axpy_25(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static double bench_sparse_axpy_50(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops);
+static void* bench_producer_run(void* arg);
+static double bench_push_threads(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops,
+                                 const size_t num_threads,
+                                 const int locked);
+static double bench_concurrent_push_1(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops);
+static double bench_concurrent_push_2(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops);
+static double bench_concurrent_push_4(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops);
+static double bench_concurrent_push_8(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops);
+static double bench_locked_push_4(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops);
+static int bench_run(FILE* ostream,
+                     const size_t max_size,
+                     const size_t num_samples,
+                     const char* filter);
+static size_t bench_read(const char* path,
+                         struct bench_result** results);
+static int bench_compare(const char* base_path,
+                         const char* new_path,
+                         const double threshold);
+static void bench_kernel_compute(struct bench_kernel_result* self,
+                                 const struct vector* x,
+                                 const struct vector* y,
+                                 const void* alpha);
+static void bench_kernel_delete(struct bench_kernel_result* self);
+static const char* bench_kernel_compare(const struct bench_kernel_result* self,
+                                        const struct bench_kernel_result* other,
+                                        const size_t element_size);
+static void bench_verify_fill(struct vector* self,
+                              const enum vector_type type,
+                              const size_t size,
+                              const size_t seed);
+static int bench_verify_type(FILE* ostream,
+                             const enum vector_isa isa,
+                             const enum vector_type type);
+static int bench_verify(FILE* ostream);
+static int bench_stress_check(const size_t value,
+                              const size_t count,
+                              size_t* last);
+static void* bench_stress_produce(void* arg);
+static void* bench_stress_read(void* arg);
+static int bench_stress(FILE* ostream,
+                        const size_t count);
+
+/* Statiska variabler: */
+static volatile size_t bench_sink = 0; /* Frhindrar att mtta berkningar optimeras bort. */
+static double bench_ratio = 0.0;       /* Kompressionsgrad fr senaste mtningen (0 = ingen). */
+static FILE* bench_null = 0;           /* Utstrm till /dev/null fr asynkron utskrift. */
+static struct vector_writer* bench_writer = 0; /* Asynkron skrivare, skapas vid frsta mtningen. */
+
+/* Allokerare via malloc, realloc och free, referens vid allokeringsmtning: */
+static const struct vector_allocator bench_malloc_allocator =
+{
+   &bench_malloc_allocate, &bench_malloc_reallocate, &bench_malloc_deallocate, 0
+};
+
+static const struct bench_case bench_cases[] =
+{
+   { "push",              BENCH_MAX_SIZE,       &bench_push },
+   { "pop",               BENCH_MAX_SIZE,       &bench_pop },
+   { "resize",            BENCH_MAX_SIZE,       &bench_resize },
+   { "copy",              BENCH_MAX_SIZE,       &bench_copy },
+   { "copy_shared",       BENCH_MAX_SIZE,       &bench_copy_shared },
+   { "copy_shared_write", BENCH_MAX_SIZE,       &bench_copy_shared_write },
+   { "join",              BENCH_MAX_SIZE,       &bench_join },
+   { "move",              BENCH_MAX_SIZE,       &bench_move },
+   { "get",               BENCH_MAX_SIZE,       &bench_get },
+   { "set",               BENCH_MAX_SIZE,       &bench_set },
+   { "get_typed",         BENCH_MAX_SIZE,       &bench_get_typed },
+   { "print",             BENCH_IO_MAX_SIZE,    &bench_print },
+   { "write",             BENCH_IO_MAX_SIZE,    &bench_write },
+   { "writer_move",       BENCH_IO_MAX_SIZE,    &bench_writer_move },
+   { "writer_snapshot",   BENCH_IO_MAX_SIZE,    &bench_writer_snapshot },
+   { "parse",             BENCH_IO_MAX_SIZE,    &bench_parse },
+   { "parse_parallel",    BENCH_IO_MAX_SIZE,    &bench_parse_parallel },
+   { "sort",              BENCH_MAX_SIZE,       &bench_sort },
+   { "qsort",             BENCH_MAX_SIZE,       &bench_qsort },
+   { "sum",               BENCH_MAX_SIZE,       &bench_sum },
+   { "dot",               BENCH_MAX_SIZE,       &bench_dot },
+   { "parallel_reduce",   BENCH_MAX_SIZE,       &bench_parallel_reduce },
+   { "save",              BENCH_MAX_SIZE,       &bench_save },
+   { "load",              BENCH_MAX_SIZE,       &bench_load },
+   { "map",               BENCH_MAX_SIZE,       &bench_map },
+   { "churn_malloc",      BENCH_CHURN_MAX_SIZE, &bench_churn_malloc },
+   { "churn_heap",        BENCH_CHURN_MAX_SIZE, &bench_churn_heap },
+   { "churn_arena",       BENCH_CHURN_MAX_SIZE, &bench_churn_arena },
+   { "churn_pool",        BENCH_CHURN_MAX_SIZE, &bench_churn_pool },
+   { "push_huge_pages",   BENCH_MAX_SIZE,       &bench_push_huge_pages },
+   { "push_small_pages",  BENCH_MAX_SIZE,       &bench_push_small_pages },
+   { "scan_huge_pages",   BENCH_MAX_SIZE,       &bench_scan_huge_pages },
+   { "scan_small_pages",  BENCH_MAX_SIZE,       &bench_scan_small_pages },
+   { "compress",          BENCH_MAX_SIZE,       &bench_compress },
+   { "decompress",        BENCH_MAX_SIZE,       &bench_decompress },
+   { "compressed_scan",   BENCH_MAX_SIZE,       &bench_compressed_scan },
+   { "compressed_get",    BENCH_MAX_SIZE,       &bench_compressed_get },
+   { "plain_scan",        BENCH_MAX_SIZE,       &bench_plain_scan },
+   { "expr",              BENCH_MAX_SIZE,       &bench_expr },
+   { "expr_unfused",      BENCH_MAX_SIZE,       &bench_expr_unfused },
+   { "view_sum",          BENCH_MAX_SIZE,       &bench_view_sum },
+   { "view_sum_strided",  BENCH_MAX_SIZE,       &bench_view_sum_strided },
+   { "view_sort_split",   BENCH_MAX_SIZE,       &bench_view_sort_split },
+   { "convert_narrow",    BENCH_MAX_SIZE,       &bench_convert_narrow },
+   { "convert_widen",     BENCH_MAX_SIZE,       &bench_convert_widen },
+   { "table_scan",        BENCH_TABLE_MAX_SIZE, &bench_table_scan },
+   { "aos_scan",          BENCH_TABLE_MAX_SIZE, &bench_aos_scan },
+   { "distinct",          BENCH_MAX_SIZE,       &bench_distinct },
+   { "sort_distinct",     BENCH_MAX_SIZE,       &bench_sort_distinct },
+   { "histogram",         BENCH_MAX_SIZE,       &bench_histogram },
+   { "group_reduce",      BENCH_MAX_SIZE,       &bench_group_reduce },
+   { "axpy",              BENCH_MAX_SIZE,       &bench_axpy },
+   { "sparse_dot_1",      BENCH_MAX_SIZE,       &bench_sparse_dot_1 },
+   { "sparse_dot_5",      BENCH_MAX_SIZE,       &bench_sparse_dot_5 },
+   { "sparse_dot_10",     BENCH_MAX_SIZE,       &bench_sparse_dot_10 },
+   { "sparse_dot_25",     BENCH_MAX_SIZE,       &bench_sparse_dot_25 },
+   { "sparse_dot_50",     BENCH_MAX_SIZE,       &bench_sparse_dot_50 },
+   { "sparse_axpy_1",     BENCH_MAX_SIZE,       &bench_sparse_axpy_1 },
+   { "sparse_axpy_5",     BENCH_MAX_SIZE,       &bench_sparse_axpy_5 },
+   { "sparse_axpy_10",    BENCH_MAX_SIZE,       &bench_sparse_axpy_10 },
+   { "sparse_axpy_25",    BENCH_MAX_SIZE,       &bench_sparse_axpy_25 },
+   { "sparse_axpy_50",    BENCH_MAX_SIZE,       &bench_sparse_axpy_50 },
+   { "concurrent_push_1", BENCH_MAX_SIZE,       &bench_concurrent_push_1 },
+   { "concurrent_push_2", BENCH_MAX_SIZE,       &bench_concurrent_push_2 },
+   { "concurrent_push_4", BENCH_MAX_SIZE,       &bench_concurrent_push_4 },
+   { "concurrent_push_8", BENCH_MAX_SIZE,       &bench_concurrent_push_8 },
+   { "locked_push_4",     BENCH_MAX_SIZE,       &bench_locked_push_4 }
+};
+
+/*******************************************************************************
+* main: Kr samtliga mtningar eller jmfr tv resultatfiler beroende p
+*       angivna flaggor.
+*       - argc: Antalet argument inlsta frn terminalen vid start.
+*       - argv: Array innehllande argument inlsta frn terminalen.
+*******************************************************************************/
+int main(const int argc,
+         const char** argv)
+{
+   size_t max_size = BENCH_MAX_SIZE;
+   size_t num_samples = BENCH_SAMPLES;
+   double threshold = BENCH_THRESHOLD;
+   const char* filter = 0;
+   const char* output = 0;
+   const char* compare[2] = { 0, 0 };
+   int verify = 0;
+   size_t stress = 0;
+
+   for (int i = 1; i < argc; ++i)
+   {
+      if (!strcmp(argv[i], "--compare") && i + 2 < argc)
+      {
+         compare[0] = argv[++i];
+         compare[1] = argv[++i];
+      }
+      else if (!strcmp(argv[i], "--threshold") && i + 1 < argc)
+      {
+         threshold = atof(argv[++i]);
+      }
+      else if (!strcmp(argv[i], "--max-size") && i + 1 < argc)
+      {
+         max_size = (size_t)strtoull(argv[++i], 0, 10);
+      }
+      else if (!strcmp(argv[i], "--samples") && i + 1 < argc)
+      {
+         num_samples = (size_t)strtoull(argv[++i], 0, 10);
+         if (!num_samples) num_samples = 1;
+      }
+      else if (!strcmp(argv[i], "--filter") && i + 1 < argc)
+      {
+         filter = argv[++i];
+      }
+      else if (!strcmp(argv[i], "--output") && i + 1 < argc)
+      {
+         output = argv[++i];
+      }
+      else if (!strcmp(argv[i], "--verify"))
+      {
+         verify = 1;
+      }
+      else if (!strcmp(argv[i], "--stress") && i + 1 < argc)
+      {
+         stress = (size_t)strtoull(argv[++i], 0, 10);
+         if (!stress) stress = 1;
+      }
+      else
+      {
+         fprintf(stderr, "Error! Invalid command line argument %s!\n", argv[i]);
+         return 1;
+      }
+   }
+
+   if (compare[0])
+   {
+      return bench_compare(compare[0], compare[1], threshold);
+   }
+   else if (verify)
+   {
+      return bench_verify(stdout);
+   }
+   else if (stress)
+   {
+      return bench_stress(stdout, stress);
+   }
+   else
+   {
+      FILE* ostream = output ? fopen(output, "w") : stdout;
+      if (!ostream)
+      {
+         fprintf(stderr, "Error! Could not open file %s!\n", output);
+         return 1;
+      }
+
+      const int status = bench_run(ostream, max_size, num_samples, filter);
+      if (ostream != stdout) fclose(ostream);
+      vector_writer_close(&bench_writer);
+      if (bench_null) fclose(bench_null);
+      vector_parallel_shutdown();
+      return status;
+   }
+}
+
+/*******************************************************************************
+* bench_now: Returnerar aktuell tid i nanosekunder frn en monoton klocka.
+*******************************************************************************/
+static double bench_now(void)
+{
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return now.tv_sec * 1e9 + now.tv_nsec;
+}
+
+/*******************************************************************************
+* bench_value_new: Genererar ett pseudoslumpmssigt vrde av angiven datatyp
+*                  utifrn ett index, s att samma index ger samma vrde.
+*                  - self : Pekare till lagringsplatsen fr vrdet.
+*                  - type : Vrdets datatyp.
+*                  - index: Index som vrdet genereras utifrn.
+*******************************************************************************/
+static void bench_value_new(union bench_value* self,
+                            const enum vector_type type,
+                            const size_t index)
+{
+   unsigned long long x = (unsigned long long)index * 0x9E3779B97F4A7C15ULL + 1;
+   x ^= x >> 31;
+   x *= 0xBF58476D1CE4E5B9ULL;
+   x ^= x >> 29;
+
+   if (type == VECTOR_TYPE_INTEGER)
+   {
+      self->integer = (int)(x & 0x7FFFFFFF) - 0x40000000;
+   }
+   else if (type == VECTOR_TYPE_DOUBLE)
+   {
+      self->decimal = ((double)(x >> 11) / 9007199254740992.0 - 0.5) * 2000.0;
+   }
+   else
+   {
+      self->natural = (size_t)x;
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_fill: Initierar en vektor av angiven datatyp och storlek, fylld med
+*             pseudoslumpmssiga vrden.
+*             - self: Pekare till vektorn.
+*             - type: Vektorns datatyp.
+*             - size: Vektorns storlek.
+*******************************************************************************/
+static void bench_fill(struct vector* self,
+                       const enum vector_type type,
+                       const size_t size)
+{
+   vector_new(self, type);
+   vector_resize(self, size);
+
+   for (size_t i = 0; i < self->size; ++i)
+   {
+      union bench_value value;
+      bench_value_new(&value, type, i);
+      vector_set(self, i, &value);
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_fill_compressible: Initierar en vektor med data typisk fr komprimerad
+*                          lagring: sm id-nummer (0 - 999) fr signerade
+*                          heltal och stigande tidsstmplar fr osignerade
+*                          heltal.
+*                          - self: Pekare till vektorn.
+*                          - type: Vektorns datatyp (int eller size_t).
+*                          - size: Vektorns storlek.
+*******************************************************************************/
+static void bench_fill_compressible(struct vector* self,
+                                    const enum vector_type type,
+                                    const size_t size)
+{
+   size_t timestamp = 1700000000000;
+   bench_fill(self, type, size);
+
+   for (size_t i = 0; i < self->size; ++i)
+   {
+      if (type == VECTOR_TYPE_INTEGER)
+      {
+         self->data.integer[i] = (int)((unsigned)self->data.integer[i] % 1000);
+      }
+      else
+      {
+         timestamp += self->data.natural[i] % 2000;
+         self->data.natural[i] = timestamp;
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_scan_sum: Summerar ett avkodat block vid genomlsning av komprimerade
+*                 vektorer.
+*******************************************************************************/
+static void bench_scan_sum(const void* data,
+                           const size_t size,
+                           void* context)
+{
+   const struct vector_compressed* compressed = (const struct vector_compressed*)((void**)context)[0];
+   size_t* sum = (size_t*)((void**)context)[1];
+
+   if (compressed->type == VECTOR_TYPE_INTEGER)
+   {
+      for (size_t i = 0; i < size; ++i) *sum += (size_t)((const int*)data)[i];
+   }
+   else
+   {
+      for (size_t i = 0; i < size; ++i) *sum += ((const size_t*)data)[i];
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_type_name: Returnerar namnet p angiven datatyp.
+*******************************************************************************/
+static const char* bench_type_name(const enum vector_type type)
+{
+   if (type == VECTOR_TYPE_INTEGER) return "int";
+   else if (type == VECTOR_TYPE_DOUBLE) return "double";
+   else if (type == VECTOR_TYPE_INT8) return "int8";
+   else if (type == VECTOR_TYPE_INT16) return "int16";
+   else if (type == VECTOR_TYPE_INT64) return "int64";
+   else if (type == VECTOR_TYPE_UINT8) return "uint8";
+   else if (type == VECTOR_TYPE_UINT16) return "uint16";
+   else if (type == VECTOR_TYPE_UINT32) return "uint32";
+   else if (type == VECTOR_TYPE_FLOAT) return "float";
+   else return "unsigned";
+}
+
+/*******************************************************************************
+* bench_text: Returnerar en heapallokerad buffert med vektorns element i
+*             textform, ett element per rad, samt lagrar buffertens lngd.
+*             - vector: Pekare till vektorn.
+*             - length: Pekare till lagringsplats fr buffertens lngd.
+*******************************************************************************/
+static char* bench_text(const struct vector* vector,
+                        size_t* length)
+{
+   char* text = (char*)malloc(vector->size * (VECTOR_FORMAT_MAX + 1) + 1);
+   *length = 0;
+   if (!text) return 0;
+
+   for (size_t i = 0; i < vector->size; ++i)
+   {
+      if (vector->type == VECTOR_TYPE_INTEGER)
+      {
+         *length += vector_format_int(text + *length, vector->data.integer[i]);
+      }
+      else if (vector->type == VECTOR_TYPE_DOUBLE)
+      {
+         *length += vector_format_double(text + *length, vector->data.decimal[i]);
+      }
+      else
+      {
+         *length += vector_format_unsigned(text + *length, vector->data.natural[i]);
+      }
+      text[(*length)++] = '\n';
+   }
+   return text;
+}
+
+/*******************************************************************************
+* bench_compare_int: Jmfrelsefunktion fr signerade heltal via qsort.
+*******************************************************************************/
+static int bench_compare_int(const void* first,
+                             const void* second)
+{
+   const int x = *(const int*)first, y = *(const int*)second;
+   return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* bench_compare_double: Jmfrelsefunktion fr flyttal via qsort.
+*******************************************************************************/
+static int bench_compare_double(const void* first,
+                                const void* second)
+{
+   const double x = *(const double*)first, y = *(const double*)second;
+   return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* bench_compare_unsigned: Jmfrelsefunktion fr osignerade heltal via qsort.
+*******************************************************************************/
+static int bench_compare_unsigned(const void* first,
+                                  const void* second)
+{
+   const size_t x = *(const size_t*)first, y = *(const size_t*)second;
+   return (x > y) - (x < y);
+}
+
+/*******************************************************************************
+* bench_push: Mter inmatning av element i en tom vektor via vector_push.
+*******************************************************************************/
+static double bench_push(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   return bench_push_allocator(type, size, num_ops, vector_allocator_default());
+}
+
+/*******************************************************************************
+* bench_pop: Mter borttagning av samtliga element via vector_pop.
+*******************************************************************************/
+static double bench_pop(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < size; ++i) vector_pop(&v);
+   const double stop = bench_now();
+
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_resize: Mter storleksndring av en tom vektor via vector_resize.
+*******************************************************************************/
+static double bench_resize(const enum vector_type type,
+                           const size_t size,
+                           size_t* num_ops)
+{
+   struct vector v;
+   vector_new(&v, type);
+
+   const double start = bench_now();
+   vector_resize(&v, size);
+   const double stop = bench_now();
+
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_copy: Mter kopiering av en vektor via vector_copy.
+*******************************************************************************/
+static double bench_copy(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector source, dest;
+   bench_fill(&source, type, size);
+   vector_new(&dest, type);
+
+   const double start = bench_now();
+   vector_copy(&dest, &source);
+   const double stop = bench_now();
+
+   vector_delete(&source);
+   vector_delete(&dest);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_copy_shared: Mter kopiering via vector_copy av en vektor vars flt
+*                    delas, vilket sker i konstant tid.
+*******************************************************************************/
+static double bench_copy_shared(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops)
+{
+   struct vector source, dest;
+   bench_fill(&source, type, size);
+   vector_set_shared(&source, 1);
+   vector_new(&dest, type);
+
+   const double start = bench_now();
+   vector_copy(&dest, &source);
+   const double stop = bench_now();
+
+   vector_delete(&source);
+   vector_delete(&dest);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_copy_shared_write: Mter kopiering av en vektor vars flt delas fljt
+*                          av en ndring via vector_set, som medfr att
+*                          fltet kopieras.
+*******************************************************************************/
+static double bench_copy_shared_write(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops)
+{
+   struct vector source, dest;
+   bench_fill(&source, type, size);
+   vector_set_shared(&source, 1);
+   vector_new(&dest, type);
+
+   const double start = bench_now();
+   vector_copy(&dest, &source);
+   vector_set(&dest, 0, vector_get(&source, 0));
+   const double stop = bench_now();
+
+   vector_delete(&source);
+   vector_delete(&dest);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_join: Mter sammanslagning av tv vektorer via vector_join.
+*******************************************************************************/
+static double bench_join(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector v1, v2;
+   bench_fill(&v1, type, size);
+   bench_fill(&v2, type, size);
+
+   const double start = bench_now();
+   vector_join(&v1, &v2);
+   const double stop = bench_now();
+
+   vector_delete(&v1);
+   vector_delete(&v2);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_move: Mter frflyttning av innehll mellan tv vektorer via
+*             vector_move. Tiden r oberoende av storleken, frutom att
+*             sm vektorer kopieras mellan de interna buffertarna.
+*******************************************************************************/
+static double bench_move(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector v1, v2;
+   bench_fill(&v1, type, size);
+   vector_new(&v2, type);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < BENCH_MOVES; ++i)
+   {
+      vector_move(&v2, &v1);
+      vector_move(&v1, &v2);
+   }
+   const double stop = bench_now();
+
+   vector_delete(&v1);
+   vector_delete(&v2);
+   *num_ops = 2 * BENCH_MOVES;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_get: Mter lsning av samtliga element via vector_get.
+*******************************************************************************/
+static double bench_get(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   size_t checksum = 0;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < size; ++i)
+   {
+      checksum += *(const unsigned char*)vector_get(&v, i);
+   }
+   const double stop = bench_now();
+
+   bench_sink += checksum;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_set: Mter skrivning av samtliga element via vector_set.
+*******************************************************************************/
+static double bench_set(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   union bench_value value;
+   bench_fill(&v, type, size);
+   bench_value_new(&value, type, size);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < size; ++i) vector_set(&v, i, &value);
+   const double stop = bench_now();
+
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_get_typed: Mter lsning av samtliga element via de typade
+*                  funktionerna vector_int_get, vector_double_get samt
+*                  vector_unsigned_get.
+*******************************************************************************/
+static double bench_get_typed(const enum vector_type type,
+                              const size_t size,
+                              size_t* num_ops)
+{
+   struct vector v;
+   size_t checksum = 0;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   if (type == VECTOR_TYPE_INTEGER)
+   {
+      for (size_t i = 0; i < size; ++i) checksum += (size_t)vector_int_get(&v, i);
+   }
+   else if (type == VECTOR_TYPE_DOUBLE)
+   {
+      double sum = 0.0;
+      for (size_t i = 0; i < size; ++i) sum += vector_double_get(&v, i);
+      checksum = (size_t)(sum != 0.0);
+   }
+   else
+   {
+      for (size_t i = 0; i < size; ++i) checksum += vector_unsigned_get(&v, i);
+   }
+   const double stop = bench_now();
+
+   bench_sink += checksum;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_print: Mter textutskrift via vector_print till /dev/null.
+*******************************************************************************/
+static double bench_print(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops)
+{
+   struct vector v;
+   FILE* ostream = fopen("/dev/null", "w");
+   *num_ops = size;
+   if (!ostream) return 0.0;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_print(&v, ostream);
+   fflush(ostream);
+   const double stop = bench_now();
+
+   fclose(ostream);
+   vector_delete(&v);
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_write: Mter textutskrift via vector_write till /dev/null, fr
+*              jmfrelse med vector_print.
+*******************************************************************************/
+static double bench_write(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops)
+{
+   struct vector v;
+   FILE* ostream = fopen("/dev/null", "w");
+   *num_ops = size;
+   if (!ostream) return 0.0;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_write(&v, ostream, 0);
+   fflush(ostream);
+   const double stop = bench_now();
+
+   fclose(ostream);
+   vector_delete(&v);
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_writer_get: Returnerar en asynkron skrivare till /dev/null, som
+*                   skapas vid frsta anropet och anvnds av samtliga
+*                   mtningar av asynkron utskrift.
+*******************************************************************************/
+static struct vector_writer* bench_writer_get(void)
+{
+   if (!bench_writer)
+   {
+      if (!bench_null) bench_null = fopen("/dev/null", "w");
+      if (!bench_null) return 0;
+      bench_writer = vector_writer_new(fileno(bench_null), BENCH_WRITER_VECTORS, 0);
+   }
+   return bench_writer;
+}
+
+/*******************************************************************************
+* bench_writer_move: Mter anropande trds tid fr att ka vektorer fr
+*                    asynkron utskrift via vector_writer_write_move, vilket
+*                    br vara oberoende av vektorns storlek (jmfr med
+*                    bench_write). Sjlva utskriften ingr inte i mtningen.
+*******************************************************************************/
+static double bench_writer_move(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops)
+{
+   struct vector_writer* writer = bench_writer_get();
+   struct vector v[BENCH_WRITER_VECTORS];
+   *num_ops = BENCH_WRITER_VECTORS;
+   if (!writer) return 0.0;
+
+   for (size_t i = 0; i < BENCH_WRITER_VECTORS; ++i)
+   {
+      bench_fill(&v[i], type, size);
+   }
+
+   const double start = bench_now();
+   for (size_t i = 0; i < BENCH_WRITER_VECTORS; ++i)
+   {
+      vector_writer_write_move(writer, &v[i]);
+   }
+   const double stop = bench_now();
+
+   vector_writer_flush(writer);
+   for (size_t i = 0; i < BENCH_WRITER_VECTORS; ++i)
+   {
+      vector_delete(&v[i]);
+   }
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_writer_snapshot: Mter anropande trds tid fr att ka gonblicksbilder
+*                        av en vektor via vector_writer_write_snapshot, dr
+*                        vektorns flt delas med kn i stllet fr att
+*                        kopieras. Sjlva utskriften ingr inte i mtningen.
+*******************************************************************************/
+static double bench_writer_snapshot(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   struct vector_writer* writer = bench_writer_get();
+   struct vector v;
+   *num_ops = BENCH_WRITER_VECTORS;
+   if (!writer) return 0.0;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < BENCH_WRITER_VECTORS; ++i)
+   {
+      vector_writer_write_snapshot(writer, &v);
+   }
+   const double stop = bench_now();
+
+   vector_writer_flush(writer);
+   vector_delete(&v);
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_parse: Mter inlsning av tal i textform via vector_parse_buffer.
+*******************************************************************************/
+static double bench_parse(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops)
+{
+   struct vector v;
+   size_t length;
+   bench_fill(&v, type, size);
+   char* text = bench_text(&v, &length);
+   vector_delete(&v);
+   vector_new(&v, type);
+   *num_ops = size;
+   if (!text) return 0.0;
+
+   const double start = bench_now();
+   vector_parse_buffer(&v, text, length);
+   const double stop = bench_now();
+
+   free(text);
+   vector_delete(&v);
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_parse_parallel: Mter flertrdad inlsning av tal i textform via
+*                       vector_parse_parallel.
+*******************************************************************************/
+static double bench_parse_parallel(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   struct vector v;
+   size_t length;
+   bench_fill(&v, type, size);
+   char* text = bench_text(&v, &length);
+   vector_delete(&v);
+   vector_new(&v, type);
+   *num_ops = size;
+   if (!text) return 0.0;
+
+   const double start = bench_now();
+   vector_parse_parallel(&v, text, length, 0);
+   const double stop = bench_now();
+
+   free(text);
+   vector_delete(&v);
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sort: Mter sortering av osorterade element via vector_sort.
+*******************************************************************************/
+static double bench_sort(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector v;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_sort(&v);
+   const double stop = bench_now();
+
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_qsort: Mter sortering av osorterade element via qsort, fr jmfrelse
+*              med vector_sort.
+*******************************************************************************/
+static double bench_qsort(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops)
+{
+   struct vector v;
+   int (*compare)(const void*, const void*) =
+      type == VECTOR_TYPE_INTEGER ? &bench_compare_int :
+      type == VECTOR_TYPE_DOUBLE ? &bench_compare_double : &bench_compare_unsigned;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   qsort(v.data.raw, v.size, v.ops->element_size, compare);
+   const double stop = bench_now();
+
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sum: Mter summering av samtliga element via vector_sum.
+*******************************************************************************/
+static double bench_sum(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   union bench_value result;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_sum(&v, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_dot: Mter skalrprodukt av en vektor med sig sjlv via vector_dot.
+*******************************************************************************/
+static double bench_dot(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   union bench_value result;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_dot(&v, &v, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_parallel_reduce: Mter flertrdad summering via vector_parallel_reduce.
+*******************************************************************************/
+static double bench_parallel_reduce(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   struct vector v;
+   union bench_value result;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_parallel_reduce(&v, VECTOR_PARALLEL_SUM, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_save: Mter lagring av en vektor i binr fil via vector_save.
+*******************************************************************************/
+static double bench_save(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector v;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_save(&v, BENCH_FILE);
+   const double stop = bench_now();
+
+   remove(BENCH_FILE);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_load: Mter inlsning av en vektor frn binr fil via vector_load.
+*******************************************************************************/
+static double bench_load(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector v;
+   bench_fill(&v, type, size);
+   vector_save(&v, BENCH_FILE);
+   vector_delete(&v);
+   vector_new(&v, type);
+
+   const double start = bench_now();
+   vector_load(&v, BENCH_FILE);
+   const double stop = bench_now();
+
+   remove(BENCH_FILE);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_map: Mter minnesmappning av en binr fil via vector_map fljt av
+*            summering av samtliga element, s att sidorna faktiskt lses in.
+*******************************************************************************/
+static double bench_map(const enum vector_type type,
+                        const size_t size,
+                        size_t* num_ops)
+{
+   struct vector v;
+   union bench_value result;
+   bench_fill(&v, type, size);
+   vector_save(&v, BENCH_FILE);
+   vector_delete(&v);
+
+   const double start = bench_now();
+   struct vector* mapped = vector_map(BENCH_FILE);
+   if (mapped) vector_sum(mapped, &result);
+   vector_unmap(&mapped);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   remove(BENCH_FILE);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_push_allocator: Mter skapande, fyllning via vector_push samt
+*                       borttagning av en vektor med angiven allokerare.
+*******************************************************************************/
+static double bench_push_allocator(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops,
+                                   const struct vector_allocator* allocator)
+{
+   struct vector v;
+   union bench_value value;
+   bench_value_new(&value, type, size);
+
+   const double start = bench_now();
+   vector_new(&v, type);
+   vector_set_allocator(&v, allocator);
+   for (size_t i = 0; i < size; ++i) vector_push(&v, &value);
+   vector_delete(&v);
+   const double stop = bench_now();
+
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_malloc_allocate: Allokerar ett block via malloc. Blocket r enbart
+*                        justerat enligt malloc och uppfyller drmed inte
+*                        VECTOR_ALIGNMENT, vilket inte pverkar inmatning
+*                        via vector_push.
+*                        - context: Anvnds inte.
+*                        - size   : Blockets storlek i byte.
+*******************************************************************************/
+static void* bench_malloc_allocate(void* context,
+                                   const size_t size)
+{
+   (void)context;
+   return malloc(size);
+}
+
+/*******************************************************************************
+* bench_malloc_reallocate: ndrar storlek p ett block via realloc.
+*                          - context : Anvnds inte.
+*                          - block   : Pekare till blocket.
+*                          - old_size: Blockets nuvarande storlek (anvnds inte).
+*                          - new_size: Blockets nya storlek i byte.
+*******************************************************************************/
+static void* bench_malloc_reallocate(void* context,
+                                     void* block,
+                                     const size_t old_size,
+                                     const size_t new_size)
+{
+   (void)context;
+   (void)old_size;
+   return realloc(block, new_size);
+}
+
+/*******************************************************************************
+* bench_malloc_deallocate: Frigr ett block via free.
+*                          - context: Anvnds inte.
+*                          - block  : Pekare till blocket.
+*                          - size   : Blockets storlek (anvnds inte).
+*******************************************************************************/
+static void bench_malloc_deallocate(void* context,
+                                    void* block,
+                                    const size_t size)
+{
+   (void)context;
+   (void)size;
+   free(block);
+   return;
+}
+
+/*******************************************************************************
+* bench_churn: Mter skapande, fyllning och radering av ett stort antal
+*              kortlivade vektorer med angiven allokerare. Ett antal vektorer
+*              lever samtidigt, dr varje ny vektor erstter en slumpvis vald
+*              levande vektor, vilket ger slumpmssiga livslngder. Vektorernas
+*              storlek vljs slumpvis mellan den interna buffertens kapacitet
+*              och BENCH_CHURN_MAX_GROWTH gnger denna, s att samtliga flt
+*              allokeras via allokeraren och vxer via omallokering. Efter
+*              varje varv raderas samtliga levande vektorer och en eventuell
+*              arena terstlls. Tiden redovisas per skapad vektor.
+*              - type     : Vektorernas datatyp.
+*              - size     : Antalet vektorer som skapas.
+*              - num_ops  : Pekare till antalet utfrda operationer.
+*              - allocator: Allokeraren som anvnds fr vektorernas flt.
+*              - arena    : Arena som terstlls efter varje varv (eller
+*                           nullpekare).
+*******************************************************************************/
+static double bench_churn(const enum vector_type type,
+                          const size_t size,
+                          size_t* num_ops,
+                          const struct vector_allocator* allocator,
+                          struct vector_arena* arena)
+{
+   struct vector live[BENCH_CHURN_LIVE];
+   union bench_value value;
+   const size_t small_size = VECTOR_SMALL_SIZE / vector_ops(type)->element_size;
+   size_t* slots = (size_t*)malloc(sizeof(size_t) * (size ? size : 1));
+   size_t* lengths = (size_t*)malloc(sizeof(size_t) * (size ? size : 1));
+
+   /* Livslngder och storlekar slumpas i frvg, s att enbart vektorerna mts: */
+   for (size_t i = 0; i < size; ++i)
+   {
+      union bench_value random;
+      bench_value_new(&random, VECTOR_TYPE_UNSIGNED, i);
+      slots[i] = random.natural % BENCH_CHURN_LIVE;
+      lengths[i] = small_size + 1 + (random.natural >> 32) % ((BENCH_CHURN_MAX_GROWTH - 1) * small_size);
+   }
+
+   bench_value_new(&value, type, size);
+   for (size_t i = 0; i < BENCH_CHURN_LIVE; ++i) vector_new(&live[i], type);
+
+   const double start = bench_now();
+   for (size_t first = 0; first < size; first += BENCH_CHURN_ROUND)
+   {
+      const size_t last = size - first < BENCH_CHURN_ROUND ? size : first + BENCH_CHURN_ROUND;
+
+      for (size_t i = first; i < last; ++i)
+      {
+         struct vector* v = &live[slots[i]];
+         vector_delete(v);
+         vector_new(v, type);
+         vector_set_allocator(v, allocator);
+         for (size_t j = 0; j < lengths[i]; ++j) vector_push(v, &value);
+      }
+
+      for (size_t i = 0; i < BENCH_CHURN_LIVE; ++i) vector_delete(&live[i]);
+      if (arena) vector_arena_reset(arena);
+   }
+   const double stop = bench_now();
+
+   free(slots);
+   free(lengths);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_churn_malloc: Mter kortlivade vektorer med allokering via malloc,
+*                     realloc och free, som referens fr vriga allokerare.
+*******************************************************************************/
+static double bench_churn_malloc(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops)
+{
+   return bench_churn(type, size, num_ops, &bench_malloc_allocator, 0);
+}
+
+/*******************************************************************************
+* bench_churn_heap: Mter kortlivade vektorer med den inbyggda allokeraren.
+*******************************************************************************/
+static double bench_churn_heap(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops)
+{
+   return bench_churn(type, size, num_ops, vector_allocator_heap(), 0);
+}
+
+/*******************************************************************************
+* bench_churn_arena: Mter kortlivade vektorer med arenaallokeraren.
+*******************************************************************************/
+static double bench_churn_arena(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops)
+{
+   struct vector_arena arena;
+   vector_arena_new(&arena, 0);
+   const double elapsed = bench_churn(type, size, num_ops, &arena.allocator, &arena);
+   vector_arena_delete(&arena);
+   return elapsed;
+}
+
+/*******************************************************************************
+* bench_churn_pool: Mter kortlivade vektorer med poolallokeraren.
+*******************************************************************************/
+static double bench_churn_pool(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops)
+{
+   struct vector_memory_pool pool;
+   vector_memory_pool_new(&pool);
+   const double elapsed = bench_churn(type, size, num_ops, &pool.allocator, 0);
+   vector_memory_pool_delete(&pool);
+   return elapsed;
+}
+
+/*******************************************************************************
+* bench_push_pages: Mter vector_push med frvald allokerare, dr flt strre
+*                   n VECTOR_LARGE_THRESHOLD mappas med eller utan stora
+*                   sidor. Tillvxten sker via mremap i bda fallen.
+*******************************************************************************/
+static double bench_push_pages(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const int huge_pages)
+{
+   vector_allocator_set_huge_pages(huge_pages);
+   const double elapsed = bench_push_allocator(type, size, num_ops, vector_allocator_heap());
+   vector_allocator_set_huge_pages(1);
+   return elapsed;
+}
+
+/*******************************************************************************
+* bench_push_huge_pages: Mter vector_push med stora sidor.
+*******************************************************************************/
+static double bench_push_huge_pages(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   return bench_push_pages(type, size, num_ops, 1);
+}
+
+/*******************************************************************************
+* bench_push_small_pages: Mter vector_push med vanliga sidor.
+*******************************************************************************/
+static double bench_push_small_pages(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops)
+{
+   return bench_push_pages(type, size, num_ops, 0);
+}
+
+/*******************************************************************************
+* bench_scan_pages: Mter summering via vector_sum av en vektor vars flt
+*                   mappats med eller utan stora sidor, dr skillnaden
+*                   utgrs av antalet TLB-missar vid genomlsningen.
+*******************************************************************************/
+static double bench_scan_pages(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const int huge_pages)
+{
+   struct vector v;
+   union bench_value result;
+   vector_allocator_set_huge_pages(huge_pages);
+   bench_fill(&v, type, size);
+   vector_allocator_set_huge_pages(1);
+
+   const double start = bench_now();
+   vector_sum(&v, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_scan_huge_pages: Mter genomlsning av ett flt med stora sidor.
+*******************************************************************************/
+static double bench_scan_huge_pages(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   return bench_scan_pages(type, size, num_ops, 1);
+}
+
+/*******************************************************************************
+* bench_scan_small_pages: Mter genomlsning av ett flt med vanliga sidor.
+*******************************************************************************/
+static double bench_scan_small_pages(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops)
+{
+   return bench_scan_pages(type, size, num_ops, 0);
+}
+
+/*******************************************************************************
+* bench_compress: Mter komprimering via vector_compress.
+*******************************************************************************/
+static double bench_compress(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops)
+{
+   struct vector v;
+   struct vector_compressed compressed;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_compressible(&v, type, size);
+
+   const double start = bench_now();
+   vector_compress(&compressed, &v);
+   const double stop = bench_now();
+
+   bench_ratio = vector_compressed_ratio(&compressed);
+   vector_compressed_delete(&compressed);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_decompress: Mter avkodning till vanlig vektor via vector_decompress.
+*******************************************************************************/
+static double bench_decompress(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops)
+{
+   struct vector v;
+   struct vector_compressed compressed;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_compressible(&v, type, size);
+   vector_compress(&compressed, &v);
+
+   const double start = bench_now();
+   vector_decompress(&compressed, &v);
+   const double stop = bench_now();
+
+   bench_ratio = vector_compressed_ratio(&compressed);
+   vector_compressed_delete(&compressed);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_compressed_scan: Mter summering av en komprimerad vektor via
+*                        blockvis avkodning med vector_compressed_scan.
+*******************************************************************************/
+static double bench_compressed_scan(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   struct vector v;
+   struct vector_compressed compressed;
+   size_t sum = 0;
+   void* context[2] = { &compressed, &sum };
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_compressible(&v, type, size);
+   vector_compress(&compressed, &v);
+
+   const double start = bench_now();
+   vector_compressed_scan(&compressed, &bench_scan_sum, context);
+   const double stop = bench_now();
+
+   bench_sink += sum;
+   bench_ratio = vector_compressed_ratio(&compressed);
+   vector_compressed_delete(&compressed);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_compressed_get: Mter direkttkomst via vector_compressed_get.
+*******************************************************************************/
+static double bench_compressed_get(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   struct vector v;
+   struct vector_compressed compressed;
+   size_t checksum = 0;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_compressible(&v, type, size);
+   vector_compress(&compressed, &v);
+
+   const double start = bench_now();
+   for (size_t i = 0; i < size; ++i)
+   {
+      size_t value = 0;
+      vector_compressed_get(&compressed, i, &value);
+      checksum += value;
+   }
+   const double stop = bench_now();
+
+   bench_sink += checksum;
+   vector_compressed_delete(&compressed);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_plain_scan: Mter summering av motsvarande okomprimerade vektor med
+*                   samma skalra loop, fr jmfrelse med compressed_scan.
+*******************************************************************************/
+static double bench_plain_scan(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops)
+{
+   struct vector v;
+   struct vector_compressed compressed;
+   size_t sum = 0;
+   void* context[2] = { &compressed, &sum };
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_compressible(&v, type, size);
+   compressed.type = type;
+
+   const double start = bench_now();
+   bench_scan_sum(v.data.raw, v.size, context);
+   const double stop = bench_now();
+
+   bench_sink += sum;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_expr: Mter berkningen (x * a + y) * x som ett latt uttryck, vilket
+*             berknas i ett enda pass utan temporra vektorer.
+*******************************************************************************/
+static double bench_expr(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector x, y, result;
+   struct vector_expr expr;
+   union bench_value alpha;
+   bench_fill(&x, type, size);
+   bench_fill(&y, type, size);
+   bench_value_new(&alpha, type, 3);
+   vector_new(&result, type);
+
+   const double start = bench_now();
+   vector_expr_new(&expr, type);
+   const size_t input = vector_expr_input(&expr, &x);
+   const size_t root = vector_expr_binary(&expr, VECTOR_EXPR_MUL,
+      vector_expr_binary(&expr, VECTOR_EXPR_ADD,
+         vector_expr_binary(&expr, VECTOR_EXPR_MUL, input, vector_expr_scalar(&expr, &alpha)),
+         vector_expr_input(&expr, &y)),
+      input);
+   vector_expr_eval(&expr, root, &result);
+   const double stop = bench_now();
+
+   bench_sink += result.size;
+   vector_delete(&x);
+   vector_delete(&y);
+   vector_delete(&result);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_expr_unfused: Mter samma berkning som bench_expr steg fr steg via
+*                     vector_copy, vector_scale, vector_add och vector_mul,
+*                     dr varje steg lser och skriver hela vektorn.
+*******************************************************************************/
+static double bench_expr_unfused(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops)
+{
+   struct vector x, y, result;
+   union bench_value alpha;
+   bench_fill(&x, type, size);
+   bench_fill(&y, type, size);
+   bench_value_new(&alpha, type, 3);
+   vector_new(&result, type);
+
+   const double start = bench_now();
+   vector_copy(&result, &x);
+   vector_scale(&result, &alpha);
+   vector_add(&result, &y);
+   vector_mul(&result, &x);
+   const double stop = bench_now();
+
+   bench_sink += result.size;
+   vector_delete(&x);
+   vector_delete(&y);
+   vector_delete(&result);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_view_sum: Mter summering via en vy ver hela vektorn, vilket skall
+*                 motsvara bench_sum eftersom vyn refererar direkt till fltet.
+*******************************************************************************/
+static double bench_view_sum(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops)
+{
+   struct vector v;
+   struct vector_view view;
+   union bench_value result;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_view_new(&view, &v);
+   vector_view_sum(&view, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_view_sum_strided: Mter summering av vartannat element via en vy med
+*                         stride 2, som summeras blockvis via vector_sum.
+*******************************************************************************/
+static double bench_view_sum_strided(const enum vector_type type,
+                                     const size_t size,
+                                     size_t* num_ops)
+{
+   struct vector v;
+   struct vector_view view, strided;
+   union bench_value result;
+   bench_fill(&v, type, size * 2);
+
+   const double start = bench_now();
+   vector_view_new(&view, &v);
+   vector_view_slice(&strided, &view, 0, size, 2);
+   vector_view_sum(&strided, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_view_sort_split: Mter sortering av en vektor uppdelad i tta vyer,
+*                        motsvarande en uppdelning mellan trdar, dr varje
+*                        del sorteras p plats utan kopiering.
+*******************************************************************************/
+static double bench_view_sort_split(const enum vector_type type,
+                                    const size_t size,
+                                    size_t* num_ops)
+{
+   struct vector v;
+   struct vector_view view, part;
+   bench_fill(&v, type, size);
+
+   const double start = bench_now();
+   vector_view_new(&view, &v);
+
+   for (size_t i = 0; i < 8; ++i)
+   {
+      vector_view_split(&part, &view, 8, i);
+      vector_view_sort(&part);
+   }
+   const double stop = bench_now();
+
+   bench_sink += v.size;
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_compact_type: Returnerar den kompakta datatyp som vektorer av angiven
+*                     datatyp lagras som vid mtning av typomvandling, det
+*                     vill sga float fr flyttal och 16-bitars heltal fr
+*                     vriga datatyper.
+*******************************************************************************/
+static enum vector_type bench_compact_type(const enum vector_type type)
+{
+   if (type == VECTOR_TYPE_INTEGER) return VECTOR_TYPE_INT16;
+   else if (type == VECTOR_TYPE_DOUBLE) return VECTOR_TYPE_FLOAT;
+   else return VECTOR_TYPE_UINT16;
+}
+
+/*******************************************************************************
+* bench_convert_narrow: Mter omvandling av en vektor till kompakt lagring via
+*                       vector_convert, dr heltal begrnsas till mltypens
+*                       intervall.
+*******************************************************************************/
+static double bench_convert_narrow(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   struct vector v, compact;
+   bench_fill(&v, type, size);
+   vector_new(&compact, bench_compact_type(type));
+
+   const double start = bench_now();
+   vector_convert(&compact, &v, compact.type, VECTOR_CONVERT_SATURATE);
+   const double stop = bench_now();
+
+   bench_sink += compact.size;
+   vector_delete(&compact);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_convert_widen: Mter breddning av en kompakt lagrad vektor till
+*                      angiven datatyp via vector_convert, exempelvis infr
+*                      berkningar.
+*******************************************************************************/
+static double bench_convert_widen(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   struct vector v, compact;
+   bench_fill(&v, type, size);
+   vector_new(&compact, bench_compact_type(type));
+   vector_convert(&compact, &v, compact.type, VECTOR_CONVERT_WRAP);
+
+   const double start = bench_now();
+   vector_convert(&v, &compact, type, VECTOR_CONVERT_WRAP);
+   const double stop = bench_now();
+
+   bench_sink += v.size;
+   vector_delete(&compact);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_table_fill: Initierar en tabell med kolumnerna id, timestamp, value,
+*                   weight och flags samt motsvarande array av strukter,
+*                   fyllda med samma pseudoslumpmssiga vrden. Tabellen
+*                   fylls i omgngar om 1000 rader.
+*                   - self: Pekare till tabellen.
+*                   - rows: Pekare till arrayen, som allokeras dynamiskt.
+*                   - size: Antalet rader.
+*******************************************************************************/
+static void bench_table_fill(struct vector_table* self,
+                             struct bench_row** rows,
+                             const size_t size)
+{
+   size_t id[1000], timestamp[1000];
+   double value[1000], weight[1000];
+   int flags[1000];
+   const void* columns[] = { id, timestamp, value, weight, flags };
+
+   vector_table_new(self);
+   vector_table_add_column(self, "id", VECTOR_TYPE_UNSIGNED);
+   vector_table_add_column(self, "timestamp", VECTOR_TYPE_UNSIGNED);
+   vector_table_add_column(self, "value", VECTOR_TYPE_DOUBLE);
+   vector_table_add_column(self, "weight", VECTOR_TYPE_DOUBLE);
+   vector_table_add_column(self, "flags", VECTOR_TYPE_INTEGER);
+   vector_table_reserve(self, size);
+   *rows = (struct bench_row*)malloc(sizeof(struct bench_row) * (size ? size : 1));
+
+   for (size_t first = 0; first < size; first += 1000)
+   {
+      const size_t count = size - first < 1000 ? size - first : 1000;
+
+      for (size_t i = 0; i < count; ++i)
+      {
+         union bench_value random;
+         struct bench_row* row = &(*rows)[first + i];
+         bench_value_new(&random, VECTOR_TYPE_DOUBLE, first + i);
+         row->id = id[i] = first + i;
+         row->timestamp = timestamp[i] = 1700000000000 + first + i;
+         row->value = value[i] = random.decimal;
+         row->weight = weight[i] = 1.0;
+         row->flags = flags[i] = (int)((first + i) * 2654435761u >> 7) & 7;
+      }
+      vector_table_append(self, columns, count);
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_table_scan: Mter filtrering av en kolumnorienterad tabell (flags == 1
+*                   och value > 500, vilket vljer ungefr var 32:a rad) via
+*                   en selektionsvektor, fljt av hmtning av kolumnerna id
+*                   och value fr valda rader. Mtningen utfrs enbart en
+*                   gng (fr datatypen int).
+*******************************************************************************/
+static double bench_table_scan(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops)
+{
+   struct vector_table table;
+   struct bench_row* rows;
+   struct vector selection, id, value;
+   const int flag = 1;
+   const double limit = 500.0;
+   const struct vector_table_predicate where[] =
+   {
+      { "flags", VECTOR_TABLE_EQ, &flag },
+      { "value", VECTOR_TABLE_GT, &limit }
+   };
+   if (type != VECTOR_TYPE_INTEGER) return -1.0;
+   bench_table_fill(&table, &rows, size);
+   vector_new(&selection, VECTOR_TYPE_UNSIGNED);
+   vector_new(&id, VECTOR_TYPE_UNSIGNED);
+   vector_new(&value, VECTOR_TYPE_DOUBLE);
+
+   const double start = bench_now();
+   vector_table_select(&table, where, 2, &selection);
+   vector_table_gather(&id, &table, "id", &selection);
+   vector_table_gather(&value, &table, "value", &selection);
+   const double stop = bench_now();
+
+   bench_sink += id.size + value.size;
+   vector_delete(&selection);
+   vector_delete(&id);
+   vector_delete(&value);
+   vector_table_delete(&table);
+   free(rows);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_aos_scan: Mter samma filtrering som bench_table_scan fr en array av
+*                 strukter, dr hela raden lses fr varje villkor och valda
+*                 id och vrden kopieras till tv vektorer.
+*******************************************************************************/
+static double bench_aos_scan(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops)
+{
+   struct vector_table table;
+   struct bench_row* rows;
+   struct vector id, value;
+   if (type != VECTOR_TYPE_INTEGER) return -1.0;
+   bench_table_fill(&table, &rows, size);
+   vector_table_delete(&table);
+   vector_new(&id, VECTOR_TYPE_UNSIGNED);
+   vector_new(&value, VECTOR_TYPE_DOUBLE);
+
+   const double start = bench_now();
+   size_t count = 0;
+   vector_resize(&id, size);
+   vector_resize(&value, size);
+
+   for (size_t i = 0; i < size; ++i)
+   {
+      if (rows[i].flags == 1 && rows[i].value > 500.0)
+      {
+         id.data.natural[count] = rows[i].id;
+         value.data.decimal[count++] = rows[i].value;
+      }
+   }
+   vector_resize(&id, count);
+   vector_resize(&value, count);
+   const double stop = bench_now();
+
+   bench_sink += id.size + value.size;
+   vector_delete(&id);
+   vector_delete(&value);
+   free(rows);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_fill_keys: Initierar en vektor med nycklar vid mtning av
+*                  hashbaserade operationer, dr varje nyckel i genomsnitt
+*                  frekommer tta gnger.
+*                  - self: Pekare till vektorn.
+*                  - type: Vektorns datatyp (int eller size_t).
+*                  - size: Vektorns storlek.
+*******************************************************************************/
+static void bench_fill_keys(struct vector* self,
+                            const enum vector_type type,
+                            const size_t size)
+{
+   const size_t num_keys = size / 8 + 1;
+   bench_fill(self, type, size);
+
+   for (size_t i = 0; i < self->size; ++i)
+   {
+      if (type == VECTOR_TYPE_INTEGER)
+      {
+         self->data.integer[i] = (int)((unsigned)self->data.integer[i] % num_keys);
+      }
+      else
+      {
+         self->data.natural[i] %= num_keys;
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_distinct: Mter berkning av unika element via vector_distinct.
+*******************************************************************************/
+static double bench_distinct(const enum vector_type type,
+                             const size_t size,
+                             size_t* num_ops)
+{
+   struct vector v, result;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_keys(&v, type, size);
+   vector_new(&result, type);
+
+   const double start = bench_now();
+   vector_distinct(&result, &v);
+   const double stop = bench_now();
+
+   bench_sink += result.size;
+   vector_delete(&result);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sort_distinct: Mter berkning av unika element via kopiering och
+*                      sortering fljt av borttagning av dubbletter, som
+*                      jmfrelse med bench_distinct.
+*******************************************************************************/
+static double bench_sort_distinct(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   struct vector v, result;
+   const size_t element_size = vector_ops(type)->element_size;
+   size_t count = 0;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_keys(&v, type, size);
+   vector_new(&result, type);
+
+   const double start = bench_now();
+   vector_copy(&result, &v);
+   vector_sort(&result);
+   const char* data = (const char*)result.data.raw;
+
+   for (size_t i = 0; i < result.size; ++i)
+   {
+      if (!count || memcmp(data + i * element_size, data + (count - 1) * element_size, element_size))
+      {
+         memmove((char*)result.data.raw + count++ * element_size, data + i * element_size, element_size);
+      }
+   }
+   vector_resize(&result, count);
+   const double stop = bench_now();
+
+   bench_sink += result.size;
+   vector_delete(&result);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_histogram: Mter rkning av frekomster per element via
+*                  vector_histogram.
+*******************************************************************************/
+static double bench_histogram(const enum vector_type type,
+                              const size_t size,
+                              size_t* num_ops)
+{
+   struct vector v, keys, counts;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_keys(&v, type, size);
+   vector_new(&keys, type);
+   vector_new(&counts, VECTOR_TYPE_UNSIGNED);
+
+   const double start = bench_now();
+   vector_histogram(&keys, &counts, &v);
+   const double stop = bench_now();
+
+   bench_sink += keys.size;
+   vector_delete(&keys);
+   vector_delete(&counts);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_group_reduce: Mter summering av flyttal per nyckel via
+*                     vector_group_reduce.
+*******************************************************************************/
+static double bench_group_reduce(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops)
+{
+   struct vector v, values, keys, sums;
+   if (type == VECTOR_TYPE_DOUBLE) return -1.0;
+   bench_fill_keys(&v, type, size);
+   bench_fill(&values, VECTOR_TYPE_DOUBLE, size);
+   vector_new(&keys, type);
+   vector_new(&sums, VECTOR_TYPE_DOUBLE);
+
+   const double start = bench_now();
+   vector_group_reduce(&keys, &sums, &v, &values, VECTOR_PARALLEL_SUM);
+   const double stop = bench_now();
+
+   bench_sink += keys.size;
+   vector_delete(&keys);
+   vector_delete(&sums);
+   vector_delete(&values);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_fill_density: Initierar en vektor dr ungefr angiven andel av
+*                     elementen r nollskilda, utspridda pseudoslumpmssigt.
+*                     - self   : Pekare till vektorn.
+*                     - type   : Vektorns datatyp.
+*                     - size   : Vektorns storlek.
+*                     - percent: Andelen nollskilda element i procent.
+*******************************************************************************/
+static void bench_fill_density(struct vector* self,
+                               const enum vector_type type,
+                               const size_t size,
+                               const size_t percent)
+{
+   const size_t element_size = vector_ops(type)->element_size;
+   bench_fill(self, type, size);
+
+   for (size_t i = 0; i < self->size; ++i)
+   {
+      const unsigned long long x = (unsigned long long)i * 0x9E3779B97F4A7C15ULL;
+      if ((x >> 32) % 100 >= percent)
+      {
+         memset((char*)self->data.raw + i * element_size, 0, element_size);
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_axpy: Mter vector_axpy fr tv tta vektorer, vilket utgr
+*             jmfrelse fr bench_sparse_axpy.
+*******************************************************************************/
+static double bench_axpy(const enum vector_type type,
+                         const size_t size,
+                         size_t* num_ops)
+{
+   struct vector x, y;
+   union bench_value alpha;
+   bench_fill(&x, type, size);
+   bench_fill(&y, type, size);
+   bench_value_new(&alpha, type, 3);
+
+   const double start = bench_now();
+   vector_axpy(&y, &alpha, &x);
+   const double stop = bench_now();
+
+   bench_sink += y.size ? *(const unsigned char*)y.data.raw : 0;
+   vector_delete(&x);
+   vector_delete(&y);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sparse_dot: Mter vector_sparse_dot fr en gles vektor med angiven
+*                   tthet och en tt vektor. Tiden redovisas per element i
+*                   den tta vektorn, vilket gr att resultatet kan jmfras
+*                   direkt med bench_dot fr att hitta brytpunkten.
+*                   - percent: Andelen nollskilda element i procent.
+*******************************************************************************/
+static double bench_sparse_dot(const enum vector_type type,
+                               const size_t size,
+                               size_t* num_ops,
+                               const size_t percent)
+{
+   struct vector x, y;
+   struct vector_sparse sparse;
+   union bench_value result;
+   bench_fill_density(&x, type, size, percent);
+   bench_fill(&y, type, size);
+   vector_sparse_new(&sparse, type, 0);
+   vector_sparse_from_dense(&sparse, &x);
+   vector_delete(&x);
+
+   const double start = bench_now();
+   vector_sparse_dot(&sparse, &y, &result);
+   const double stop = bench_now();
+
+   bench_sink += (size_t)result.integer;
+   vector_sparse_delete(&sparse);
+   vector_delete(&y);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sparse_axpy: Mter vector_sparse_axpy fr en gles vektor med angiven
+*                    tthet, jmfrt per element med bench_axpy.
+*                    - percent: Andelen nollskilda element i procent.
+*******************************************************************************/
+static double bench_sparse_axpy(const enum vector_type type,
+                                const size_t size,
+                                size_t* num_ops,
+                                const size_t percent)
+{
+   struct vector x, y;
+   struct vector_sparse sparse;
+   union bench_value alpha;
+   bench_fill_density(&x, type, size, percent);
+   bench_fill(&y, type, size);
+   bench_value_new(&alpha, type, 3);
+   vector_sparse_new(&sparse, type, 0);
+   vector_sparse_from_dense(&sparse, &x);
+   vector_delete(&x);
+
+   const double start = bench_now();
+   vector_sparse_axpy(&y, &alpha, &sparse);
+   const double stop = bench_now();
+
+   bench_sink += y.size ? *(const unsigned char*)y.data.raw : 0;
+   vector_sparse_delete(&sparse);
+   vector_delete(&y);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_sparse_dot_1: Mter vector_sparse_dot vid 1 procents tthet.
+*******************************************************************************/
+static double bench_sparse_dot_1(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops)
+{
+   return bench_sparse_dot(type, size, num_ops, 1);
+}
+
+/*******************************************************************************
+* bench_sparse_dot_5: Mter vector_sparse_dot vid 5 procents tthet.
+*******************************************************************************/
+static double bench_sparse_dot_5(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops)
+{
+   return bench_sparse_dot(type, size, num_ops, 5);
+}
+
+/*******************************************************************************
+* bench_sparse_dot_10: Mter vector_sparse_dot vid 10 procents tthet.
+*******************************************************************************/
+static double bench_sparse_dot_10(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_sparse_dot(type, size, num_ops, 10);
+}
+
+/*******************************************************************************
+* bench_sparse_dot_25: Mter vector_sparse_dot vid 25 procents tthet.
+*******************************************************************************/
+static double bench_sparse_dot_25(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_sparse_dot(type, size, num_ops, 25);
+}
+
+/*******************************************************************************
+* bench_sparse_dot_50: Mter vector_sparse_dot vid 50 procents tthet.
+*******************************************************************************/
+static double bench_sparse_dot_50(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_sparse_dot(type, size, num_ops, 50);
+}
+
+/*******************************************************************************
+* bench_sparse_axpy_1: Mter vector_sparse_axpy vid 1 procents tthet.
+*******************************************************************************/
+static double bench_sparse_axpy_1(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_sparse_axpy(type, size, num_ops, 1);
+}
+
+/*******************************************************************************
+* bench_sparse_axpy_5: Mter vector_sparse_axpy vid 5 procents tthet.
+*******************************************************************************/
+static double bench_sparse_axpy_5(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_sparse_axpy(type, size, num_ops, 5);
+}
+
+/*******************************************************************************
+* bench_sparse_axpy_10: Mter vector_sparse_axpy vid 10 procents tthet.
+*******************************************************************************/
+static double bench_sparse_axpy_10(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   return bench_sparse_axpy(type, size, num_ops, 10);
+}
+
+/*******************************************************************************
+* bench_sparse_axpy_25: Mter vector_sparse_axpy vid 25 procents tthet.
+*******************************************************************************/
+static double bench_sparse_axpy_25(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   return bench_sparse_axpy(type, size, num_ops, 25);
+}
+
+/*******************************************************************************
+* bench_sparse_axpy_50: Mter vector_sparse_axpy vid 50 procents tthet.
+*******************************************************************************/
+static double bench_sparse_axpy_50(const enum vector_type type,
+                                   const size_t size,
+                                   size_t* num_ops)
+{
+   return bench_sparse_axpy(type, size, num_ops, 50);
+}
+
+/*******************************************************************************
+* bench_producer_run: Matar in angivet antal element (trdfunktion).
+*******************************************************************************/
+static void* bench_producer_run(void* arg)
+{
+   struct bench_producer* self = (struct bench_producer*)arg;
+
+   for (size_t i = 0; i < self->count; ++i)
+   {
+      if (self->concurrent)
+      {
+         vector_concurrent_push(self->concurrent, &self->value, 0);
+      }
+      else
+      {
+         pthread_mutex_lock(self->mutex);
+         vector_push(self->locked, &self->value);
+         pthread_mutex_unlock(self->mutex);
+      }
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* bench_push_threads: Mter samtidig inmatning av totalt angivet antal
+*                     element frn angivet antal trdar, antingen via
+*                     vector_concurrent_push eller via vector_push skyddad av
+*                     ett mutex. Tiden omfattar att trdarna skapas och
+*                     avslutas.
+*******************************************************************************/
+static double bench_push_threads(const enum vector_type type,
+                                 const size_t size,
+                                 size_t* num_ops,
+                                 const size_t num_threads,
+                                 const int locked)
+{
+   struct bench_producer producers[BENCH_MAX_THREADS];
+   pthread_t threads[BENCH_MAX_THREADS];
+   pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+   struct vector_concurrent concurrent;
+   struct vector v;
+
+   vector_concurrent_new(&concurrent, type);
+   vector_new(&v, type);
+
+   for (size_t i = 0; i < num_threads; ++i)
+   {
+      producers[i].concurrent = locked ? 0 : &concurrent;
+      producers[i].locked = &v;
+      producers[i].mutex = &mutex;
+      producers[i].count = size * (i + 1) / num_threads - size * i / num_threads;
+      bench_value_new(&producers[i].value, type, i);
+   }
+
+   const double start = bench_now();
+   for (size_t i = 1; i < num_threads; ++i)
+   {
+      pthread_create(&threads[i], 0, &bench_producer_run, &producers[i]);
+   }
+   bench_producer_run(&producers[0]);
+   for (size_t i = 1; i < num_threads; ++i)
+   {
+      pthread_join(threads[i], 0);
+   }
+   const double stop = bench_now();
+
+   vector_concurrent_delete(&concurrent);
+   vector_delete(&v);
+   *num_ops = size;
+   return stop - start;
+}
+
+/*******************************************************************************
+* bench_concurrent_push_1: Mter vector_concurrent_push med en trd.
+*******************************************************************************/
+static double bench_concurrent_push_1(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops)
+{
+   return bench_push_threads(type, size, num_ops, 1, 0);
+}
+
+/*******************************************************************************
+* bench_concurrent_push_2: Mter vector_concurrent_push med tv trdar.
+*******************************************************************************/
+static double bench_concurrent_push_2(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops)
+{
+   return bench_push_threads(type, size, num_ops, 2, 0);
+}
+
+/*******************************************************************************
+* bench_concurrent_push_4: Mter vector_concurrent_push med fyra trdar.
+*******************************************************************************/
+static double bench_concurrent_push_4(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops)
+{
+   return bench_push_threads(type, size, num_ops, 4, 0);
+}
+
+/*******************************************************************************
+* bench_concurrent_push_8: Mter vector_concurrent_push med tta trdar.
+*******************************************************************************/
+static double bench_concurrent_push_8(const enum vector_type type,
+                                      const size_t size,
+                                      size_t* num_ops)
+{
+   return bench_push_threads(type, size, num_ops, 8, 0);
+}
+
+/*******************************************************************************
+* bench_locked_push_4: Mter vector_push skyddad av ett mutex med fyra
+*                      trdar, fr jmfrelse med vector_concurrent_push.
+*******************************************************************************/
+static double bench_locked_push_4(const enum vector_type type,
+                                  const size_t size,
+                                  size_t* num_ops)
+{
+   return bench_push_threads(type, size, num_ops, 4, 1);
+}
+
+/*******************************************************************************
+* bench_run: Kr samtliga mtningar fr samtliga datatyper och storlekar samt
+*            skriver resultatet i JSON-format. Varje upprepning omfattar
+*            minst BENCH_MIN_OPS operationer, dock som lngst cirka
+*            BENCH_MAX_SAMPLE_TIME ns, dr snabbaste upprepningen redovisas.
+*            - ostream    : Pekare till utstrm fr resultatet.
+*            - max_size   : Strsta vektorstorlek.
+*            - num_samples: Antalet upprepningar per mtning.
+*            - filter     : Text som mtningarnas namn ska innehlla
+*                           (nullpekare = samtliga mtningar).
+*******************************************************************************/
+static int bench_run(FILE* ostream,
+                     const size_t max_size,
+                     const size_t num_samples,
+                     const char* filter)
+{
+   const size_t num_cases = sizeof(bench_cases) / sizeof(bench_cases[0]);
+   int first = 1;
+
+   fprintf(ostream, "{\n  \"benchmarks\": [\n");
+
+   for (const struct bench_case* i = bench_cases; i < bench_cases + num_cases; ++i)
+   {
+      if (filter && !strstr(i->name, filter)) continue;
+
+      for (enum vector_type type = VECTOR_TYPE_INTEGER; type <= VECTOR_TYPE_UNSIGNED; ++type)
+      {
+         for (size_t size = BENCH_MIN_SIZE; size <= max_size && size <= i->max_size; size *= 10)
+         {
+            const size_t rounds = size < BENCH_MIN_OPS ? BENCH_MIN_OPS / size : 1;
+            double best = 0.0;
+            int supported = 1;
+
+            fprintf(stderr, "%s/%s/%zu\n", i->name, bench_type_name(type), size);
+
+            for (size_t sample = 0; sample < num_samples && supported; ++sample)
+            {
+               double elapsed = 0.0;
+               size_t total_ops = 0;
+
+               for (size_t round = 0; round < rounds && elapsed < BENCH_MAX_SAMPLE_TIME; ++round)
+               {
+                  size_t num_ops = 0;
+                  const double time = i->run(type, size, &num_ops);
+                  supported = time >= 0.0;
+                  if (!supported) break;
+                  elapsed += time;
+                  total_ops += num_ops;
+               }
+
+               const double ns_per_op = total_ops ? elapsed / total_ops : 0.0;
+               if (!sample || ns_per_op < best) best = ns_per_op;
+            }
+
+            if (!supported) break;
+            const double ops_per_sec = best > 0.0 ? 1e9 / best : 0.0;
+            const size_t element_size = vector_ops(type)->element_size;
+
+            fprintf(ostream, "%s    {\"name\": \"%s\", \"type\": \"%s\", \"size\": %zu, "
+                    "\"ns_per_op\": %.4f, \"ops_per_sec\": %.1f, \"bytes_per_sec\": %.1f",
+                    first ? "" : ",\n", i->name, bench_type_name(type), size,
+                    best, ops_per_sec, ops_per_sec * element_size);
+            if (bench_ratio > 0.0) fprintf(ostream, ", \"compression_ratio\": %.3f", bench_ratio);
+            fprintf(ostream, "}");
+            bench_ratio = 0.0;
+            fflush(ostream);
+            first = 0;
+         }
+      }
+   }
+
+   fprintf(ostream, "\n  ]\n}\n");
+   return 0;
+}
+
+/*******************************************************************************
+* bench_read: Lser in resultat frn en resultatfil skriven av bench_run och
+*             returnerar antalet inlsta resultat. Arrayen med resultat
+*             allokeras dynamiskt och ska frigras av anroparen.
+*             - path   : Skvg till resultatfilen.
+*             - results: Adressen till pekaren som ska peka p resultaten.
+*******************************************************************************/
+static size_t bench_read(const char* path,
+                         struct bench_result** results)
+{
+   FILE* istream = fopen(path, "r");
+   size_t num_results = 0, capacity = 0;
+   char line[512];
+
+   *results = 0;
+   if (!istream) return 0;
+
+   while (fgets(line, sizeof(line), istream))
+   {
+      struct bench_result result;
+
+      if (sscanf(line, " {\"name\": \"%31[^\"]\", \"type\": \"%15[^\"]\", \"size\": %zu, "
+                 "\"ns_per_op\": %lf", result.name, result.type, &result.size,
+                 &result.ns_per_op) != 4) continue;
+
+      if (num_results == capacity)
+      {
+         capacity = capacity ? capacity * 2 : 64;
+         struct bench_result* copy = (struct bench_result*)realloc(*results, capacity * sizeof(result));
+         if (!copy) break;
+         *results = copy;
+      }
+      (*results)[num_results++] = result;
+   }
+
+   fclose(istream);
+   return num_results;
+}
+
+/*******************************************************************************
+* bench_compare: Jmfr tv resultatfiler och skriver ut frndringen fr
+*                varje mtning som finns i bda filerna. Returnerar 1 ifall
+*                ngon mtning har blivit lngsammare n angiven trskel.
+*                - base_path: Skvg till resultatfilen som jmfrs mot.
+*                - new_path : Skvg till resultatfilen som jmfrs.
+*                - threshold: Tillten frsmring i procent.
+*******************************************************************************/
+static int bench_compare(const char* base_path,
+                         const char* new_path,
+                         const double threshold)
+{
+   struct bench_result* base = 0;
+   struct bench_result* current = 0;
+   const size_t num_base = bench_read(base_path, &base);
+   const size_t num_current = bench_read(new_path, &current);
+   size_t num_regressions = 0, num_compared = 0;
+
+   if (!num_base || !num_current)
+   {
+      fprintf(stderr, "Error! Could not read results from %s!\n", !num_base ? base_path : new_path);
+      free(base);
+      free(current);
+      return 1;
+   }
+
+   printf("%-16s %-9s %10s %12s %12s %9s\n", "name", "type", "size", "base ns/op", "new ns/op", "change");
+
+   for (const struct bench_result* i = current; i < current + num_current; ++i)
+   {
+      for (const struct bench_result* j = base; j < base + num_base; ++j)
+      {
+         if (strcmp(i->name, j->name) || strcmp(i->type, j->type) || i->size != j->size) continue;
+
+         const double change = j->ns_per_op > 0.0 ? (i->ns_per_op / j->ns_per_op - 1.0) * 100.0 : 0.0;
+         const int regression = change > threshold;
+
+         printf("%-16s %-9s %10zu %12.4f %12.4f %+8.1f%%%s\n", i->name, i->type, i->size,
+                j->ns_per_op, i->ns_per_op, change, regression ? "  REGRESSION" : "");
+         num_regressions += (size_t)regression;
+         num_compared++;
+         break;
+      }
+   }
+
+   printf("\n%zu of %zu benchmarks regressed by more than %.1f%%.\n",
+          num_regressions, num_compared, threshold);
+   free(base);
+   free(current);
+   return num_regressions ? 1 : 0;
+}
+
+/*******************************************************************************
+* bench_kernel_compute: Utfr samtliga berkningar i vector_kernels med vald
+*                       instruktionsuppsttning och lagrar resultaten.
+*                       - self : Pekare till resultaten.
+*                       - x    : Pekare till den frsta operanden.
+*                       - y    : Pekare till den andra operanden.
+*                       - alpha: Pekare till skalr av vektorernas datatyp.
+*******************************************************************************/
+static void bench_kernel_compute(struct bench_kernel_result* self,
+                                 const struct vector* x,
+                                 const struct vector* y,
+                                 const void* alpha)
+{
+   memset(self, 0, sizeof(*self));
+
+   self->status[0] = vector_sum(x, &self->value[0]);
+   self->status[1] = vector_min(x, &self->value[1]);
+   self->status[2] = vector_max(x, &self->value[2]);
+   self->status[3] = vector_mean(x, &self->value[3].decimal);
+   self->status[4] = vector_dot(x, y, &self->value[4]);
+
+   for (size_t i = 0; i < BENCH_VERIFY_UPDATES; ++i)
+   {
+      vector_new(&self->vector[i], y->type);
+      vector_copy(&self->vector[i], y);
+   }
+
+   self->status[5] = vector_add(&self->vector[0], x);
+   self->status[6] = vector_mul(&self->vector[1], x);
+   self->status[7] = vector_scale(&self->vector[2], alpha);
+   self->status[8] = vector_axpy(&self->vector[3], alpha, x);
+   return;
+}
+
+/*******************************************************************************
+* bench_kernel_delete: Raderar resultat lagrade av bench_kernel_compute.
+*                      - self: Pekare till resultaten.
+*******************************************************************************/
+static void bench_kernel_delete(struct bench_kernel_result* self)
+{
+   for (size_t i = 0; i < BENCH_VERIFY_UPDATES; ++i)
+   {
+      vector_delete(&self->vector[i]);
+   }
+   return;
+}
+
+/*******************************************************************************
+* bench_kernel_compare: Jmfr tv uppsttningar resultat bytevis och
+*                       returnerar namnet p den frsta berkningen som
+*                       skiljer sig, eller nullpekare om samtliga r lika.
+*                       - self        : Pekare till de frsta resultaten.
+*                       - other       : Pekare till de andra resultaten.
+*                       - element_size: Elementens storlek i byte.
+*******************************************************************************/
+static const char* bench_kernel_compare(const struct bench_kernel_result* self,
+                                        const struct bench_kernel_result* other,
+                                        const size_t element_size)
+{
+   static const char* names[] = { "sum", "min", "max", "mean", "dot", "add", "mul", "scale", "axpy" };
+
+   for (size_t i = 0; i < BENCH_VERIFY_REDUCTIONS + BENCH_VERIFY_UPDATES; ++i)
+   {
+      if (self->status[i] != other->status[i]) return names[i];
+   }
+
+   for (size_t i = 0; i < BENCH_VERIFY_REDUCTIONS; ++i)
+   {
+      if (memcmp(&self->value[i], &other->value[i], sizeof(self->value[i]))) return names[i];
+   }
+
+   for (size_t i = 0; i < BENCH_VERIFY_UPDATES; ++i)
+   {
+      const struct vector* first = &self->vector[i];
+      const struct vector* second = &other->vector[i];
+      if (first->size != second->size ||
+          (first->size && memcmp(first->data.raw, second->data.raw, first->size * element_size)))
+      {
+         return names[BENCH_VERIFY_REDUCTIONS + i];
+      }
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* bench_verify_fill: Initierar en vektor av angiven datatyp och storlek, fylld
+*                    med pseudoslumpmssiga heltal mellan -100 och 100. Talen
+*                    omvandlas till datatypen via vector_convert, dr negativa
+*                    tal slr runt fr osignerade datatyper.
+*                    - self: Pekare till vektorn.
+*                    - type: Vektorns datatyp.
+*                    - size: Vektorns storlek.
+*                    - seed: Startvrde fr de genererade talen.
+*******************************************************************************/
+static void bench_verify_fill(struct vector* self,
+                              const enum vector_type type,
+                              const size_t size,
+                              const size_t seed)
+{
+   struct vector source;
+   vector_new(&source, VECTOR_TYPE_INT64);
+   vector_new(self, type);
+
+   for (size_t i = 0; i < size; ++i)
+   {
+      union bench_value value;
+      bench_value_new(&value, VECTOR_TYPE_UNSIGNED, seed + i);
+      vector_int64_push(&source, (int64_t)(value.natural % 201) - 100);
+   }
+
+   vector_convert(self, &source, type, VECTOR_CONVERT_WRAP);
+   vector_delete(&source);
+   return;
+}
+
+/*******************************************************************************
+* bench_verify_type: Jmfr samtliga berkningar fr angiven datatyp och
+*                    instruktionsuppsttning mot den skalra versionen, fr
+*                    samtliga storlekar upp till BENCH_VERIFY_MAX_SIZE. Det
+*                    omfattar storlekar som inte r jmnt delbara med antalet
+*                    element per varv, s att ven resterande element
+*                    kontrolleras. Returnerar antalet avvikelser.
+*                    - ostream: Utstrm dr avvikelser skrivs ut.
+*                    - isa    : Instruktionsuppsttningen som kontrolleras.
+*                    - type   : Datatypen som kontrolleras.
+*******************************************************************************/
+static int bench_verify_type(FILE* ostream,
+                             const enum vector_isa isa,
+                             const enum vector_type type)
+{
+   const size_t element_size = vector_ops(type)->element_size;
+   int num_errors = 0;
+   struct vector alpha;
+
+   bench_verify_fill(&alpha, type, 1, 0);
+
+   for (size_t size = 0; size <= BENCH_VERIFY_MAX_SIZE; ++size)
+   {
+      struct vector x, y;
+      struct bench_kernel_result expected, result;
+      const char* name = 0;
+
+      bench_verify_fill(&x, type, size, 1);
+      bench_verify_fill(&y, type, size, size + 2);
+
+      vector_kernels_select(VECTOR_ISA_SCALAR);
+      bench_kernel_compute(&expected, &x, &y, alpha.data.raw);
+      vector_kernels_select(isa);
+      bench_kernel_compute(&result, &x, &y, alpha.data.raw);
+
+      if ((name = bench_kernel_compare(&expected, &result, element_size)))
+      {
+         fprintf(ostream, "  %s/%s/%zu differs from scalar\n", name, bench_type_name(type), size);
+         num_errors++;
+      }
+
+      bench_kernel_delete(&expected);
+      bench_kernel_delete(&result);
+      vector_delete(&x);
+      vector_delete(&y);
+   }
+
+   vector_delete(&alpha);
+   return num_errors;
+}
+
+/*******************************************************************************
+* bench_verify: Kontrollerar att berkningarna i vector_kernels ger samma
+*               resultat med samtliga instruktionsuppsttningar som processorn
+*               stdjer som med den skalra versionen, fr samtliga
+*               datatyper. Elementen r sm heltal, vilket gr att ven
+*               flyttalsberkningar blir exakta oavsett summeringsordning,
+*               s att resultaten kan jmfras bytevis. Returnerar 1 ifall
+*               ngon avvikelse hittades.
+*               - ostream: Utstrm dr resultatet skrivs ut.
+*******************************************************************************/
+static int bench_verify(FILE* ostream)
+{
+   static const char* names[] = { "scalar", "sse2", "avx2", "avx512" };
+   const enum vector_isa active = vector_kernels_isa();
+   int num_errors = 0;
+
+   for (enum vector_isa isa = VECTOR_ISA_SSE2; isa <= VECTOR_ISA_AVX512; ++isa)
+   {
+      int errors = 0;
+
+      if (!vector_kernels_supported(isa))
+      {
+         fprintf(ostream, "%s: not supported, skipped\n", names[isa]);
+         continue;
+      }
+
+      for (enum vector_type type = VECTOR_TYPE_INTEGER; type < VECTOR_TYPE_NONE; ++type)
+      {
+         errors += bench_verify_type(ostream, isa, type);
+      }
+
+      fprintf(ostream, "%s: %s\n", names[isa], errors ? "FAILED" : "ok");
+      num_errors += errors;
+   }
+
+   vector_kernels_select(active);
+   return num_errors ? 1 : 0;
+}
+
+/*******************************************************************************
+* bench_stress_check: Kontrollerar ett element vid stresstest, som mste ha
+*                     ett giltigt producentnummer samt ett lpnummer som r
+*                     strre n producentens fregende. Elementen lses i
+*                     indexordning, varfr varje producents element skall
+*                     frekomma i stigande lpnummerordning. Returnerar 1
+*                     vid fel.
+*                     - value: Elementet, producentnummer i de vre 32
+*                              bitarna och lpnummer plus ett i de nedre.
+*                     - count: Antalet element per producent.
+*                     - last : Array med senaste lpnummer plus ett per
+*                              producent.
+*******************************************************************************/
+static int bench_stress_check(const size_t value,
+                              const size_t count,
+                              size_t* last)
+{
+   const size_t producer = value >> 32;
+   const size_t sequence = value & 0xFFFFFFFF;
+   if (!producer || producer > BENCH_STRESS_PRODUCERS) return 1;
+   if (!sequence || sequence > count || sequence <= last[producer - 1]) return 1;
+   last[producer - 1] = sequence;
+   return 0;
+}
+
+/*******************************************************************************
+* bench_stress_produce: Matar in angivet antal element och kontrollerar att
+*                       varje element kan lsas p returnerat index direkt
+*                       efter inmatningen (trdfunktion).
+*******************************************************************************/
+static void* bench_stress_produce(void* arg)
+{
+   struct bench_stress* self = (struct bench_stress*)arg;
+   size_t previous = 0;
+
+   for (size_t i = 1; i <= self->count; ++i)
+   {
+      const size_t value = (self->producer << 32) | i;
+      size_t index = 0;
+
+      if (vector_concurrent_push(self->vector, &value, &index))
+      {
+         self->errors++;
+         break;
+      }
+
+      const size_t* element = (const size_t*)vector_concurrent_get(self->vector, index);
+      if (!element || *element != value || (i > 1 && index <= previous)) self->errors++;
+      previous = index;
+   }
+
+   atomic_fetch_add(self->done, 1);
+   return 0;
+}
+
+/*******************************************************************************
+* bench_stress_read: Lser publicerade element i indexordning medan
+*                    producenterna matar in och kontrollerar varje element.
+*                    Ett opublicerat index lses om tills det publicerats.
+*                    Avslutas nr samtliga producenter r klara och samtliga
+*                    element har lsts (trdfunktion).
+*******************************************************************************/
+static void* bench_stress_read(void* arg)
+{
+   struct bench_stress* self = (struct bench_stress*)arg;
+   const size_t total = self->count * BENCH_STRESS_PRODUCERS;
+   size_t last[BENCH_STRESS_PRODUCERS] = { 0 };
+   size_t next = 0;
+
+   while (next < total)
+   {
+      const int finished = atomic_load(self->done) == BENCH_STRESS_PRODUCERS;
+      const size_t size = vector_concurrent_size(self->vector);
+
+      for (; next < size; ++next)
+      {
+         const size_t* element = (const size_t*)vector_concurrent_get(self->vector, next);
+         if (!element) break;
+         self->errors += (size_t)bench_stress_check(*element, self->count, last);
+      }
+
+      if (finished && next < total)
+      {
+         self->errors += total - next;
+         break;
+      }
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* bench_stress: Stresstestar vector_concurrent med BENCH_STRESS_PRODUCERS
+*               producenter och en lsare. Drefter kontrolleras storleken
+*               samt att vector_concurrent_freeze ger samtliga element exakt
+*               en gng, i stigande lpnummerordning per producent.
+*               Returnerar 1 ifall ngot fel upptcktes.
+*               - ostream: Utstrm dr resultatet skrivs ut.
+*               - count  : Antalet element per producent.
+*******************************************************************************/
+static int bench_stress(FILE* ostream,
+                        const size_t count)
+{
+   struct bench_stress producers[BENCH_STRESS_PRODUCERS];
+   struct bench_stress reader;
+   pthread_t threads[BENCH_STRESS_PRODUCERS + 1];
+   struct vector_concurrent concurrent;
+   struct vector frozen;
+   atomic_size_t done;
+   size_t last[BENCH_STRESS_PRODUCERS] = { 0 };
+   size_t errors = 0;
+
+   if (count > 0xFFFFFFFF)
+   {
+      fprintf(stderr, "Error! At most %lu elements per producer!\n", 0xFFFFFFFFUL);
+      return 1;
+   }
+
+   atomic_init(&done, 0);
+   vector_concurrent_new(&concurrent, VECTOR_TYPE_UNSIGNED);
+   vector_new(&frozen, VECTOR_TYPE_UNSIGNED);
+   reader.vector = &concurrent;
+   reader.done = &done;
+   reader.producer = 0;
+   reader.count = count;
+   reader.errors = 0;
+
+   for (size_t i = 0; i < BENCH_STRESS_PRODUCERS; ++i)
+   {
+      producers[i] = reader;
+      producers[i].producer = i + 1;
+   }
+
+   const double start = bench_now();
+   pthread_create(&threads[0], 0, &bench_stress_read, &reader);
+
+   for (size_t i = 0; i < BENCH_STRESS_PRODUCERS; ++i)
+   {
+      pthread_create(&threads[i + 1], 0, &bench_stress_produce, &producers[i]);
+   }
+
+   for (size_t i = 0; i <= BENCH_STRESS_PRODUCERS; ++i)
+   {
+      pthread_join(threads[i], 0);
+   }
+   const double stop = bench_now();
+
+   for (size_t i = 0; i < BENCH_STRESS_PRODUCERS; ++i)
+   {
+      errors += producers[i].errors;
+   }
+   errors += reader.errors;
+
+   if (vector_concurrent_size(&concurrent) != count * BENCH_STRESS_PRODUCERS ||
+       vector_concurrent_freeze(&concurrent, &frozen) ||
+       frozen.size != count * BENCH_STRESS_PRODUCERS)
+   {
+      errors++;
+   }
+
+   for (size_t i = 0; i < frozen.size; ++i)
+   {
+      errors += (size_t)bench_stress_check(vector_unsigned_get(&frozen, i), count, last);
+   }
+
+   for (size_t i = 0; i < BENCH_STRESS_PRODUCERS; ++i)
+   {
+      errors += (size_t)(last[i] != count);
+   }
+
+   fprintf(ostream, "concurrent stress: %d producers x %zu elements, 1 reader, %.1f ms: %s\n",
+           BENCH_STRESS_PRODUCERS, count, (stop - start) / 1e6, errors ? "FAILED" : "ok");
+   if (errors) fprintf(ostream, "  %zu errors\n", errors);
+
+   vector_concurrent_delete(&concurrent);
+   vector_delete(&frozen);
+   return errors ? 1 : 0;
+}
@@ -53,17 +53,17 @@ int main(const int argc,
 
    for (size_t i = 0; i < v1.size; ++i)
    {
-      vector_set(&v1, i, &integer);
+      vector_int_set(&v1, i, integer);
       integer += 2;
    }
    for (size_t i = 0; i < v2.size; ++i)
    {
-      vector_set(&v2, i, &decimal);
+      vector_double_set(&v2, i, decimal);
       decimal = decimal / 2;
    }
    for (size_t i = 0; i < v3.size; ++i)
    {
-      vector_set(&v3, i, &natural);
+      vector_unsigned_set(&v3, i, natural);
       natural--;
    }
 
@@ -0,0 +1,407 @@
+/*******************************************************************************
+* poly_vector.hpp: Typad C++-klassmall ovanp struct vector, endast bestende
+*                  av en headerfil. Elementtypen anges som mallparameter och
+*                  motsvarande vector_type vljs vid kompilering, vilket gr
+*                  att element lses och skrivs direkt via fltpekaren utan
+*                  typkontroll eller typlsa pekare (jmfr vector_get och
+*                  vector_set). Klassmallen kan instansieras fr int, double
+*                  och size_t samt de kompakta datatyperna (int8_t, int16_t,
+*                  int64_t, uint8_t, uint16_t, uint32_t och float). vriga
+*                  typer ger kompileringsfel.
+*
+*                  - poly_vector<T> ger sin vektor. Den kan flyttas (via
+*                    vector_move), men inte kopieras implicit, eftersom
+*                    kopiering kan misslyckas. Kopiering sker i stllet
+*                    explicit via copy, som returnerar 0 eller 1 likt
+*                    vriga funktioner i biblioteket.
+*                  - poly_vector_ref<T> ger inte sin vektor, utan refererar
+*                    till en befintlig struct vector, exempelvis en vektor
+*                    som skapats och gs av C-kod.
+*
+*                  Bda erbjuder samma grnssnitt: iteratorer i form av
+*                  vanliga pekare (som inte allokerar och fungerar med
+*                  standardbibliotekets algoritmer), direkt indexering samt
+*                  massoperationer som anropar motsvarande C-funktioner, dr
+*                  typberoende val grs vid kompilering via if constexpr.
+*                  Den underliggande vektorn ns via c_vector, s att samtliga
+*                  C-funktioner kan anvndas utan kopiering:
+*
+*                  poly_vector<double> v;
+*                  v.push(1.5);
+*                  v.push(2.5);
+*                  vector_sort(v.c_vector());
+*                  for (double x : v) std::printf("%g\n", x);
+*
+*                  Likt VECTOR_DEFINE_TYPED kontrolleras inte index, och en
+*                  vektor vars flt delas (se vector_set_shared) mste gras
+*                  unik via unshare innan den ndras via indexering eller
+*                  iteratorer. Massoperationer som transform gr fltet unikt
+*                  sjlva. Krver C++17 och att programmet lnkas med
+*                  bibliotekets objektfiler samt flaggan -pthread. Se
+*                  poly_vector_test.cpp fr kompilering och kontroll.
+*******************************************************************************/
+#ifndef POLY_VECTOR_HPP_
+#define POLY_VECTOR_HPP_
+
+/* Inkluderingsdirektiv: */
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+extern "C"
+{
+#include "vector.h"
+#include "vector_convert.h"
+#include "vector_kernels.h"
+#include "vector_parallel.h"
+#include "vector_sort.h"
+}
+
+/*******************************************************************************
+* poly_vector_type: Returnerar vector_type fr angiven elementtyp, eller
+*                   VECTOR_TYPE_NONE om typen inte stds. Berknas vid
+*                   kompilering. Jmfrelsen sker i enumerationens ordning,
+*                   s att size_t vljs fre uint32_t p plattformar dr
+*                   typerna r identiska.
+*******************************************************************************/
+template <typename T>
+constexpr enum vector_type poly_vector_type(void)
+{
+   if constexpr (std::is_same_v<T, int>) return VECTOR_TYPE_INTEGER;
+   else if constexpr (std::is_same_v<T, double>) return VECTOR_TYPE_DOUBLE;
+   else if constexpr (std::is_same_v<T, size_t>) return VECTOR_TYPE_UNSIGNED;
+   else if constexpr (std::is_same_v<T, int8_t>) return VECTOR_TYPE_INT8;
+   else if constexpr (std::is_same_v<T, int16_t>) return VECTOR_TYPE_INT16;
+   else if constexpr (std::is_same_v<T, int64_t>) return VECTOR_TYPE_INT64;
+   else if constexpr (std::is_same_v<T, uint8_t>) return VECTOR_TYPE_UINT8;
+   else if constexpr (std::is_same_v<T, uint16_t>) return VECTOR_TYPE_UINT16;
+   else if constexpr (std::is_same_v<T, uint32_t>) return VECTOR_TYPE_UINT32;
+   else if constexpr (std::is_same_v<T, float>) return VECTOR_TYPE_FLOAT;
+   else return VECTOR_TYPE_NONE;
+}
+
+template <typename T> class poly_vector;
+
+/*******************************************************************************
+* poly_vector_base: Gemensamt grnssnitt fr poly_vector och poly_vector_ref.
+*                   Hrledd klass anges som mallparameter (CRTP) och
+*                   tillhandahller c_vector, vilket gr att inga virtuella
+*                   funktioner eller extra pekare behvs.
+*                   - T      : Elementtyp.
+*                   - Derived: Hrledd klass.
+*******************************************************************************/
+template <typename T, typename Derived>
+class poly_vector_base
+{
+   static_assert(poly_vector_type<T>() != VECTOR_TYPE_NONE,
+                 "poly_vector: elementtypen saknar motsvarande vector_type");
+
+public:
+   using value_type = T;
+   using size_type = size_t;
+   using reference = T&;
+   using const_reference = const T&;
+   using iterator = T*;
+   using const_iterator = const T*;
+
+   static constexpr enum vector_type type = poly_vector_type<T>(); /* Vektorns datatyp. */
+
+   /* Underliggande vektor samt fltpekare: */
+   struct vector* c_vector(void) noexcept { return derived().c_vector(); }
+   const struct vector* c_vector(void) const noexcept { return derived().c_vector(); }
+   T* data(void) noexcept { return static_cast<T*>(c_vector()->data.raw); }
+   const T* data(void) const noexcept { return static_cast<const T*>(c_vector()->data.raw); }
+
+   /* Iteratorer, motsvarande vector_begin och vector_end, men berknade inline
+      eftersom elementens storlek r knd vid kompilering: */
+   T* begin(void) noexcept { return data(); }
+   T* end(void) noexcept { return data() + size(); }
+   const T* begin(void) const noexcept { return data(); }
+   const T* end(void) const noexcept { return data() + size(); }
+   const T* cbegin(void) const noexcept { return data(); }
+   const T* cend(void) const noexcept { return data() + size(); }
+
+   /* Storlek och kapacitet: */
+   size_t size(void) const noexcept { return c_vector()->size; }
+   size_t capacity(void) const noexcept { return vector_capacity(c_vector()); }
+   bool empty(void) const noexcept { return !c_vector()->size; }
+
+   /* Direkt indexering utan kontroll av index: */
+   T& operator[](const size_t index) noexcept { return data()[index]; }
+   const T& operator[](const size_t index) const noexcept { return data()[index]; }
+   T& front(void) noexcept { return data()[0]; }
+   const T& front(void) const noexcept { return data()[0]; }
+   T& back(void) noexcept { return data()[size() - 1]; }
+   const T& back(void) const noexcept { return data()[size() - 1]; }
+
+   /* ndring av storlek, returnerar 0 vid lyckad operation, annars 1: */
+   int push(const T new_element) noexcept
+   {
+      struct vector* self = c_vector();
+      if (self->size == vector_capacity(self)) return vector_push(self, &new_element);
+      data()[self->size++] = new_element;
+      return 0;
+   }
+   int pop(void) noexcept { return vector_pop(c_vector()); }
+   int resize(const size_t new_size) noexcept { return vector_resize(c_vector(), new_size); }
+   int reserve(const size_t new_capacity) noexcept { return vector_reserve(c_vector(), new_capacity); }
+   int shrink_to_fit(void) noexcept { return vector_shrink_to_fit(c_vector()); }
+   void clear(void) noexcept { vector_clear(c_vector()); }
+   int push_range(const T* source, const size_t num_elements) noexcept
+   {
+      return vector_push_range(c_vector(), source, num_elements);
+   }
+   int insert_range(const size_t index, const T* source, const size_t num_elements) noexcept
+   {
+      return vector_insert_range(c_vector(), index, source, num_elements);
+   }
+   int erase_range(const size_t index, const size_t num_elements) noexcept
+   {
+      return vector_erase_range(c_vector(), index, num_elements);
+   }
+
+   /* Allokerare och delat flt: */
+   int set_allocator(const struct vector_allocator* allocator) noexcept
+   {
+      return vector_set_allocator(c_vector(), allocator);
+   }
+   int set_shared(const bool enable) noexcept { return vector_set_shared(c_vector(), enable); }
+   int unshare(void) noexcept { return vector_unshare(c_vector()); }
+   bool is_shared(void) const noexcept { return vector_is_shared(c_vector()); }
+
+   /* Massoperationer via bibliotekets SIMD- och trdade implementeringar: */
+   int sum(T& result) const noexcept { return vector_sum(c_vector(), &result); }
+   int min(T& result) const noexcept { return vector_min(c_vector(), &result); }
+   int max(T& result) const noexcept { return vector_max(c_vector(), &result); }
+   int mean(double& result) const noexcept { return vector_mean(c_vector(), &result); }
+   int scale(const T factor) noexcept { return vector_scale(c_vector(), &factor); }
+   int fill(const T value) noexcept { return vector_parallel_fill(c_vector(), &value); }
+   int sort(void) noexcept { return vector_sort(c_vector()); }
+   int sort_descending(void) noexcept { return vector_sort_descending(c_vector()); }
+   bool is_sorted(void) const noexcept { return vector_is_sorted(c_vector()); }
+   size_t lower_bound(const T value) const noexcept { return vector_lower_bound(c_vector(), &value); }
+   size_t upper_bound(const T value) const noexcept { return vector_upper_bound(c_vector(), &value); }
+   void print(FILE* ostream = stdout) const noexcept { vector_print(c_vector(), ostream); }
+
+   /* Elementvisa operationer med en annan vektor av samma elementtyp, vilket
+      kontrolleras vid kompilering: */
+   template <typename Other>
+   int add(const poly_vector_base<T, Other>& other) noexcept
+   {
+      return vector_add(c_vector(), other.c_vector());
+   }
+
+   template <typename Other>
+   int mul(const poly_vector_base<T, Other>& other) noexcept
+   {
+      return vector_mul(c_vector(), other.c_vector());
+   }
+
+   template <typename Other>
+   int dot(const poly_vector_base<T, Other>& other, T& result) const noexcept
+   {
+      return vector_dot(c_vector(), other.c_vector(), &result);
+   }
+
+   template <typename Other>
+   int axpy(const T alpha, const poly_vector_base<T, Other>& x) noexcept
+   {
+      return vector_axpy(c_vector(), &alpha, x.c_vector());
+   }
+
+   /*****************************************************************************
+   * equal: Indikerar ifall tv vektorer innehller samma element. Heltal
+   *        jmfrs bytevis via memcmp, medan flyttal jmfrs elementvis,
+   *        s att 0.0 och -0.0 rknas som lika och NaN som olika.
+   *****************************************************************************/
+   template <typename Other>
+   bool equal(const poly_vector_base<T, Other>& other) const noexcept
+   {
+      if (size() != other.size()) return false;
+      if constexpr (std::is_integral_v<T>)
+      {
+         return !size() || !std::memcmp(data(), other.data(), size() * sizeof(T));
+      }
+      else
+      {
+         for (size_t i = 0; i < size(); ++i)
+         {
+            if (!(data()[i] == other.data()[i])) return false;
+         }
+         return true;
+      }
+   }
+
+   /*****************************************************************************
+   * transform: Erstter varje element med resultatet av angiven funktion.
+   *            Funktionen inlinas vid kompilering, till skillnad frn
+   *            vector_parallel_transform, som anropar en funktionspekare
+   *            per element. Ett delat flt grs unikt via vector_unshare
+   *            innan det ndras, likt vriga massoperationer. Returnerar 1
+   *            om vektorn r skrivskyddad eller om fltet inte kan kopieras.
+   *            - function: Funktion som tar ett element och returnerar det nya.
+   *****************************************************************************/
+   template <typename Function>
+   int transform(Function function)
+   {
+      struct vector* self = c_vector();
+      if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+
+      for (T& element : *this)
+      {
+         element = function(element);
+      }
+      return 0;
+   }
+
+   /*****************************************************************************
+   * convert: Kopierar vektorns element till en vektor av annan elementtyp.
+   *          Vid samma elementtyp sker en vanlig kopiering, annars anropas
+   *          vector_convert med mltypen vald vid kompilering.
+   *          - dest: Referens till mlvektorn.
+   *          - mode: Hantering av tal som inte ryms i mltypen.
+   *****************************************************************************/
+   template <typename U, typename Other>
+   int convert(poly_vector_base<U, Other>& dest,
+               const enum vector_convert_mode mode = VECTOR_CONVERT_WRAP) const noexcept
+   {
+      if constexpr (std::is_same_v<T, U>)
+      {
+         (void)mode;
+         return vector_copy(dest.c_vector(), c_vector());
+      }
+      else
+      {
+         return vector_convert(dest.c_vector(), c_vector(), poly_vector_type<U>(), mode);
+      }
+   }
+
+protected:
+   poly_vector_base(void) noexcept = default;
+   ~poly_vector_base(void) noexcept = default;
+
+private:
+   Derived& derived(void) noexcept { return static_cast<Derived&>(*this); }
+   const Derived& derived(void) const noexcept { return static_cast<const Derived&>(*this); }
+};
+
+/*******************************************************************************
+* poly_vector: Vektor som ger sitt flt och frigr det vid destruktion.
+*              En flyttad vektor tms och behller sin datatyp, s att den
+*              kan anvndas igen. Befintliga C-vektorer kan tas ver och
+*              lmnas tillbaka via take och release utan att elementen
+*              kopieras.
+*              - T: Elementtyp.
+*******************************************************************************/
+template <typename T>
+class poly_vector : public poly_vector_base<T, poly_vector<T>>
+{
+public:
+   using poly_vector_base<T, poly_vector<T>>::type;
+
+   poly_vector(void) noexcept { vector_new(&vector_, type); }
+   ~poly_vector(void) noexcept { vector_delete(&vector_); }
+
+   poly_vector(poly_vector&& source) noexcept
+   {
+      vector_new(&vector_, type);
+      vector_move(&vector_, &source.vector_);
+      vector_new(&source.vector_, type);
+   }
+
+   poly_vector& operator=(poly_vector&& source) noexcept
+   {
+      if (this != &source)
+      {
+         vector_move(&vector_, &source.vector_);
+         vector_new(&source.vector_, type);
+      }
+      return *this;
+   }
+
+   poly_vector(const poly_vector&) = delete;
+   poly_vector& operator=(const poly_vector&) = delete;
+
+   struct vector* c_vector(void) noexcept { return &vector_; }
+   const struct vector* c_vector(void) const noexcept { return &vector_; }
+
+   /*****************************************************************************
+   * copy: Kopierar innehllet frn en annan vektor av samma elementtyp.
+   *       Delade flt kopieras via referensrkning (se vector_set_shared).
+   *       - source: Referens till vektorn som skall kopieras.
+   *****************************************************************************/
+   template <typename Other>
+   int copy(const poly_vector_base<T, Other>& source) noexcept
+   {
+      return vector_copy(&vector_, source.c_vector());
+   }
+
+   /*****************************************************************************
+   * take: Tar ver innehllet i en C-vektor av samma datatyp via vector_move,
+   *       varefter C-vektorn r tom. Returnerar 1 om datatyperna skiljer sig.
+   *       - source: Pekare till C-vektorn.
+   *****************************************************************************/
+   int take(struct vector* source) noexcept
+   {
+      if (!source || source->type != type) return 1;
+      vector_move(&vector_, source);
+      return 0;
+   }
+
+   /*****************************************************************************
+   * release: Lmnar ver innehllet till en initierad C-vektor via
+   *          vector_move, varefter denna vektor r tom.
+   *          - dest: Pekare till C-vektorn, vars tidigare innehll frigrs.
+   *****************************************************************************/
+   void release(struct vector* dest) noexcept
+   {
+      vector_move(dest, &vector_);
+      vector_new(&vector_, type);
+   }
+
+private:
+   struct vector vector_; /* Underliggande vektor. */
+};
+
+/*******************************************************************************
+* poly_vector_ref: Referens till en befintlig C-vektor, som varken kopieras
+*                  eller frigrs. Referensen knyts till vektorn via bind,
+*                  som kontrollerar datatypen en gng, varefter samtliga
+*                  operationer sker utan typkontroll. Vektorn mste finnas
+*                  kvar s lnge referensen anvnds.
+*                  - T: Elementtyp.
+*******************************************************************************/
+template <typename T>
+class poly_vector_ref : public poly_vector_base<T, poly_vector_ref<T>>
+{
+public:
+   using poly_vector_base<T, poly_vector_ref<T>>::type;
+
+   poly_vector_ref(void) noexcept = default;
+
+   template <typename Other>
+   poly_vector_ref(poly_vector_base<T, Other>& source) noexcept
+      : vector_{source.c_vector()} {}
+
+   /*****************************************************************************
+   * bind: Knyter referensen till angiven C-vektor. Returnerar 1 om vektorn
+   *       saknas eller har en annan datatyp, varvid referensen lmnas orrd.
+   *       - source: Pekare till C-vektorn.
+   *****************************************************************************/
+   int bind(struct vector* source) noexcept
+   {
+      if (!source || source->type != type) return 1;
+      vector_ = source;
+      return 0;
+   }
+
+   bool bound(void) const noexcept { return vector_ != nullptr; }
+   struct vector* c_vector(void) noexcept { return vector_; }
+   const struct vector* c_vector(void) const noexcept { return vector_; }
+
+private:
+   struct vector* vector_ = nullptr; /* Refererad vektor. */
+};
+
+#endif /* POLY_VECTOR_HPP_ */
@@ -0,0 +1,142 @@
+/*******************************************************************************
+* poly_vector_test.cpp: Kontroll av klassmallen poly_vector, som annars inte
+*                       kompileras av ngon versttningsenhet. Programmet
+*                       kontrollerar inmatning, flytt, iteration samt att
+*                       transform inte ndrar vektorer som delar flt med
+*                       den transformerade vektorn. Vid fel skrivs
+*                       misslyckade kontroller ut och programmet avslutas
+*                       med returkod 1.
+*
+*                       Kompilera biblioteket som C och programmet som
+*                       C++17 via GCC och skapa en krbar fil dpt
+*                       poly_vector_test med fljande kommandon:
+*                       $ gcc -O2 -c vector*.c
+*                       $ g++ -std=c++17 -O2 poly_vector_test.cpp vector*.o
+*                         -o poly_vector_test -pthread -lm
+*
+*                       Kr kontrollerna:
+*                       $ ./poly_vector_test
+*******************************************************************************/
+#include "poly_vector.hpp"
+#include <cstdio>
+#include <utility>
+
+/* Makrodefinitioner: */
+#define POLY_VECTOR_TEST_SIZE 1000 /* Antalet element, fler n ryms i intern buffert. */
+
+/* Kontrollerar ett villkor och skriver ut det vid fel: */
+#define POLY_VECTOR_CHECK(condition)                                           \
+   if (!(condition))                                                           \
+   {                                                                           \
+      std::fprintf(stderr, "%s:%d: %s\n", __FILE__, __LINE__, #condition);     \
+      status = 1;                                                              \
+   }
+
+/*******************************************************************************
+* poly_vector_test_push: Kontrollerar inmatning via push, indexering samt
+*                        iteration via range-for fr angiven elementtyp.
+*******************************************************************************/
+template <typename T>
+static int poly_vector_test_push(void)
+{
+   poly_vector<T> v;
+   int status = 0;
+
+   for (size_t i = 0; i < POLY_VECTOR_TEST_SIZE; ++i)
+   {
+      POLY_VECTOR_CHECK(!v.push(static_cast<T>(i % 100)));
+   }
+
+   POLY_VECTOR_CHECK(v.size() == POLY_VECTOR_TEST_SIZE);
+   POLY_VECTOR_CHECK(v.c_vector()->type == poly_vector<T>::type);
+
+   size_t index = 0;
+   for (const T element : v)
+   {
+      POLY_VECTOR_CHECK(element == static_cast<T>(index % 100));
+      POLY_VECTOR_CHECK(v[index] == element);
+      ++index;
+   }
+   POLY_VECTOR_CHECK(index == v.size());
+   return status;
+}
+
+/*******************************************************************************
+* poly_vector_test_move: Kontrollerar flyttkonstruktor och flyttilldelning,
+*                        dr kllan skall tmmas men behlla sin datatyp.
+*******************************************************************************/
+static int poly_vector_test_move(void)
+{
+   poly_vector<double> a;
+   int status = 0;
+
+   for (size_t i = 0; i < POLY_VECTOR_TEST_SIZE; ++i) a.push(i * 0.5);
+   const double* data = a.data();
+
+   poly_vector<double> b(std::move(a));
+   POLY_VECTOR_CHECK(b.size() == POLY_VECTOR_TEST_SIZE && b.data() == data);
+   POLY_VECTOR_CHECK(a.empty() && a.c_vector()->type == VECTOR_TYPE_DOUBLE);
+
+   poly_vector<double> c;
+   c.push(1.0);
+   c = std::move(b);
+   POLY_VECTOR_CHECK(c.size() == POLY_VECTOR_TEST_SIZE && c.data() == data);
+   POLY_VECTOR_CHECK(b.empty() && !b.push(2.0) && b[0] == 2.0);
+   POLY_VECTOR_CHECK(c.back() == (POLY_VECTOR_TEST_SIZE - 1) * 0.5);
+   return status;
+}
+
+/*******************************************************************************
+* poly_vector_test_transform: Kontrollerar att transform gr ett delat flt
+*                             unikt, s att kopian lmnas orrd, samt att
+*                             skrivskyddade vektorer inte ndras.
+*******************************************************************************/
+static int poly_vector_test_transform(void)
+{
+   poly_vector<int> original;
+   poly_vector<int> copy;
+   int status = 0;
+
+   for (int i = 0; i < POLY_VECTOR_TEST_SIZE; ++i) original.push(i);
+   POLY_VECTOR_CHECK(!original.set_shared(true));
+   POLY_VECTOR_CHECK(!copy.copy(original));
+   POLY_VECTOR_CHECK(copy.data() == original.data() && copy.is_shared());
+
+   POLY_VECTOR_CHECK(!original.transform([](const int x) { return -x; }));
+   POLY_VECTOR_CHECK(copy.data() != original.data());
+
+   for (int i = 0; i < POLY_VECTOR_TEST_SIZE; ++i)
+   {
+      POLY_VECTOR_CHECK(original[i] == -i);
+      POLY_VECTOR_CHECK(copy[i] == i);
+   }
+
+   struct vector readonly;
+   vector_new(&readonly, VECTOR_TYPE_INTEGER);
+   readonly.data.integer = copy.data();
+   readonly.size = copy.size();
+   readonly.flags = VECTOR_FLAG_READONLY;
+
+   poly_vector_ref<int> ref;
+   POLY_VECTOR_CHECK(!ref.bind(&readonly));
+   POLY_VECTOR_CHECK(ref.transform([](const int x) { return x + 1; }) == 1);
+   POLY_VECTOR_CHECK(copy[1] == 1);
+   return status; /* Skrivskyddad vektor ger inte sitt flt och raderas inte. */
+}
+
+/*******************************************************************************
+* main: Kr samtliga kontroller och returnerar 1 om ngon misslyckades.
+*******************************************************************************/
+int main(void)
+{
+   int status = 0;
+   status |= poly_vector_test_push<int>();
+   status |= poly_vector_test_push<double>();
+   status |= poly_vector_test_push<size_t>();
+   status |= poly_vector_test_push<int8_t>();
+   status |= poly_vector_test_push<float>();
+   status |= poly_vector_test_move();
+   status |= poly_vector_test_transform();
+   std::printf("%s\n", status ? "poly_vector: FAIL" : "poly_vector: ok");
+   return status;
+}
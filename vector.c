@@ -2,12 +2,144 @@
 * vector.c: Innehller funktioner fr implementering av dynamiska vektorer
 *           av olika datatyper via strukten vector.
 *******************************************************************************/
+#define _GNU_SOURCE
 #include "vector.h"
+#include "vector_stats.h"
+#include <inttypes.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Stora flt mappas via mmap och utkas via mremap, som enbart finns i Linux. */
+#if defined(__linux__)
+#define VECTOR_LARGE_MAPPED
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+/* Makrodefinitioner: */
+#define VECTOR_MIN_CAPACITY 4            /* Minsta kapacitet vid frsta allokeringen. */
+#define VECTOR_HUGE_PAGE_SIZE (2UL << 20) /* Storlek p stora sidor (2 MB). */
+
+/*******************************************************************************
+* vector_shared: Referensrknare fr ett flt som delas mellan vektorer.
+*                Samtliga vektorer som delar fltet pekar p samma rknare
+*                och har samma allokerare. Fltets verkliga kapacitet lagras
+*                hr, eftersom vektorer som ftt fltet via kopiering anger
+*                sin storlek som kapacitet, s att insttning via typade
+*                inline-funktioner alltid gr via vector_push.
+*******************************************************************************/
+struct vector_shared
+{
+   atomic_size_t refcount; /* Antalet vektorer som delar fltet. */
+   size_t capacity;        /* Fltets verkliga kapacitet (antalet element). */
+};
 
 /* Statiska funktioner: */
 static inline void vector_ptr_init(union vector_ptr* self);
+static inline int vector_is_small(const struct vector* self);
 static void vector_ptr_free(union vector_ptr* self,
-                            const enum vector_type type);
+                            const struct vector_allocator* allocator,
+                            const size_t size);
+static int vector_ptr_realloc(union vector_ptr* self,
+                              const struct vector_allocator* allocator,
+                              const size_t element_size,
+                              const size_t old_capacity,
+                              const size_t new_capacity);
+static inline size_t vector_align_up(const size_t size,
+                                     const size_t alignment);
+static void* vector_heap_allocate(void* context,
+                                  const size_t size);
+static void* vector_heap_reallocate(void* context,
+                                    void* block,
+                                    const size_t old_size,
+                                    const size_t new_size);
+static void vector_heap_deallocate(void* context,
+                                   void* block,
+                                   const size_t size);
+#ifdef VECTOR_LARGE_MAPPED
+static void* vector_large_map(const size_t size);
+static void* vector_large_remap(void* block,
+                                const size_t old_size,
+                                const size_t new_size);
+#endif
+static int vector_grow(struct vector* self,
+                       const size_t min_capacity);
+static inline int vector_own(struct vector* self);
+static struct vector_shared* vector_shared_new(const size_t capacity);
+static void vector_shared_release(struct vector* self);
+
+/*******************************************************************************
+* VECTOR_OPS_DEFINE: Genererar funktioner fr kopiering samt utskrift av
+*                    element av en given datatyp, dr elementen skrivs ut p
+*                    var sin rad.
+*                    - name  : Namnsuffix fr de genererade funktionerna.
+*                    - type  : Elementens datatyp.
+*                    - format: Formatstrng fr utskrift av ett element.
+*                    - cast  : Datatyp som elementet omvandlas till vid
+*                              utskrift.
+*******************************************************************************/
+#define VECTOR_OPS_DEFINE(name, type, format, cast)                           \
+static void vector_##name##_assign(void* dest, const void* source)            \
+{                                                                             \
+   *(type*)dest = *(const type*)source;                                       \
+   return;                                                                    \
+}                                                                             \
+                                                                              \
+static void vector_##name##_print(FILE* ostream,                              \
+                                  const void* data,                           \
+                                  const size_t size)                          \
+{                                                                             \
+   const type* elements = (const type*)data;                                  \
+   for (size_t i = 0; i < size; ++i)                                          \
+   {                                                                          \
+      fprintf(ostream, format "\n", (cast)elements[i]);                       \
+   }                                                                          \
+   return;                                                                    \
+}
+
+VECTOR_OPS_DEFINE(int, int, "%d", int)
+VECTOR_OPS_DEFINE(double, double, "%g", double)
+VECTOR_OPS_DEFINE(unsigned, size_t, "%zu", size_t)
+VECTOR_OPS_DEFINE(int8, int8_t, "%d", int)
+VECTOR_OPS_DEFINE(int16, int16_t, "%d", int)
+VECTOR_OPS_DEFINE(int64, int64_t, "%" PRId64, int64_t)
+VECTOR_OPS_DEFINE(uint8, uint8_t, "%u", unsigned)
+VECTOR_OPS_DEFINE(uint16, uint16_t, "%u", unsigned)
+VECTOR_OPS_DEFINE(uint32, uint32_t, "%" PRIu32, uint32_t)
+VECTOR_OPS_DEFINE(float, float, "%g", double)
+
+/*******************************************************************************
+* vector_ops_table: Typbeskrivningar fr respektive datatyp, indexerade via
+*                   enum vector_type. Sista posten avser icke angiven datatyp,
+*                   vars elementstorlek noll medfr att alla operationer nekas.
+*******************************************************************************/
+static const struct vector_ops vector_ops_table[] =
+{
+   { sizeof(int), &vector_int_assign, &vector_int_print },
+   { sizeof(double), &vector_double_assign, &vector_double_print },
+   { sizeof(size_t), &vector_unsigned_assign, &vector_unsigned_print },
+   { sizeof(int8_t), &vector_int8_assign, &vector_int8_print },
+   { sizeof(int16_t), &vector_int16_assign, &vector_int16_print },
+   { sizeof(int64_t), &vector_int64_assign, &vector_int64_print },
+   { sizeof(uint8_t), &vector_uint8_assign, &vector_uint8_print },
+   { sizeof(uint16_t), &vector_uint16_assign, &vector_uint16_print },
+   { sizeof(uint32_t), &vector_uint32_assign, &vector_uint32_print },
+   { sizeof(float), &vector_float_assign, &vector_float_print },
+   { 0, 0, 0 }
+};
+
+/* Allokerare baserad p aligned_alloc samt minnesmappning av stora flt. */
+static const struct vector_allocator vector_heap_allocator =
+{
+   &vector_heap_allocate, &vector_heap_reallocate, &vector_heap_deallocate, 0
+};
+
+/* Allokerare som anvnds fr nya vektorer. */
+static const struct vector_allocator* vector_default_allocator = &vector_heap_allocator;
+
+/* Indikerar ifall stora sidor (transparent huge pages) begrs fr mappade flt. */
+static int vector_huge_pages = 1;
 
 /*******************************************************************************
 * vector_new: Initierar ny tom vektor till angiven datatyp.
@@ -17,24 +149,64 @@ static void vector_ptr_free(union vector_ptr* self,
 void vector_new(struct vector* self,
                 const enum vector_type type)
 {
-   self->type = type;
+   self->type = type < VECTOR_TYPE_NONE ? type : VECTOR_TYPE_NONE;
+   self->ops = vector_ops(self->type);
+   self->allocator = vector_default_allocator;
    vector_ptr_init(&self->data);
    self->size = 0;
+   self->capacity = 0;
+   self->flags = 0;
+   self->shared = 0;
+
+   if (self->ops->element_size)
+   {
+      self->data.raw = self->small.raw;
+   }
    return;
 }
 
 /*******************************************************************************
-* vector_delete: Nollstller angiven vektor och frigr heapallokerat flt.
+* vector_delete: Nollstller angiven vektor och frigr heapallokerat flt via
+*                vektorns allokerare. Ett delat flt frigrs frst nr sista
+*                vektorn som delar det raderas. Allokeraren behlls, frutom
+*                fr skrivskyddade vektorer, som tergr till frvald
+*                allokerare.
 *                - self: Pekare till vektorn.
 *******************************************************************************/
 void vector_delete(struct vector* self)
 {
-   vector_ptr_free(&self->data, self->type);
+   if (vector_is_small(self))
+   {
+      vector_ptr_init(&self->data);
+   }
+   else if (self->shared)
+   {
+      vector_shared_release(self);
+   }
+   else
+   {
+      vector_ptr_free(&self->data, self->allocator, self->capacity * self->ops->element_size);
+   }
+   if (self->flags & VECTOR_FLAG_READONLY) self->allocator = vector_default_allocator;
    self->size = 0;
+   self->capacity = 0;
+   self->shared = 0;
+   self->flags = 0;
    self->type = VECTOR_TYPE_NONE;
+   self->ops = vector_ops(VECTOR_TYPE_NONE);
    return;
 }
 
+/*******************************************************************************
+* vector_ops: Returnerar typbeskrivningen fr angiven datatyp. Ogiltiga
+*             datatyper ger beskrivningen fr icke angiven datatyp.
+*             - type: Datatypen vars beskrivning skall returneras.
+*******************************************************************************/
+const struct vector_ops* vector_ops(const enum vector_type type)
+{
+   return &vector_ops_table[type < VECTOR_TYPE_NONE ? type : VECTOR_TYPE_NONE];
+}
+
 /*******************************************************************************
 * vector_ptr_new: Returnerar pekare till en ny heapallokerad vektor med angiven
 *                 storlek. Vid start r samtliga element oinitierade.
@@ -61,32 +233,109 @@ struct vector* vector_ptr_new(const enum vector_type type,
 void vector_ptr_delete(struct vector** self)
 {
    vector_delete(*self);
+   free(*self);
    *self = 0;
    return;
 }
 
+/*******************************************************************************
+* vector_set_allocator: Byter allokerare fr angiven vektor. Eventuellt
+*                       befintligt innehll flyttas till ett block allokerat
+*                       via den nya allokeraren.
+*                       - self     : Pekare till vektorn.
+*                       - allocator: Pekare till den nya allokeraren
+*                                    (nullpekare medfr frvald allokerare).
+*******************************************************************************/
+int vector_set_allocator(struct vector* self,
+                         const struct vector_allocator* allocator)
+{
+   if (!allocator) allocator = vector_default_allocator;
+   if (self->flags & VECTOR_FLAG_READONLY) return 1;
+   if (allocator == self->allocator) return 0;
+   if (vector_own(self)) return 1;
+
+   if (!vector_is_small(self) && self->capacity)
+   {
+      const size_t size = self->capacity * self->ops->element_size;
+      void* block = allocator->allocate(allocator->context, size);
+      if (!block) return 1;
+      VECTOR_STATS_ALLOCATE(size);
+      memcpy(block, self->data.raw, self->size * self->ops->element_size);
+      VECTOR_STATS_COPY(self->size * self->ops->element_size);
+      vector_ptr_free(&self->data, self->allocator, size);
+      self->data.raw = block;
+   }
+
+   self->allocator = allocator;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_allocator_set_default: Anger allokerare fr vektorer som initieras
+*                               hdanefter. Befintliga vektorer pverkas inte.
+*                               Funktionen r inte trdsker och br anropas
+*                               vid programstart.
+*                               - allocator: Pekare till allokeraren
+*                                            (nullpekare medfr frvald
+*                                            allokerare, se
+*                                            vector_allocator_heap).
+*******************************************************************************/
+void vector_allocator_set_default(const struct vector_allocator* allocator)
+{
+   vector_default_allocator = allocator ? allocator : &vector_heap_allocator;
+   return;
+}
+
+/*******************************************************************************
+* vector_allocator_default: Returnerar allokeraren fr nya vektorer.
+*******************************************************************************/
+const struct vector_allocator* vector_allocator_default(void)
+{
+   return vector_default_allocator;
+}
+
+/*******************************************************************************
+* vector_allocator_heap: Returnerar den inbyggda allokeraren, som anvnds om
+*                        ingen annan allokerare anges. Flt mindre n
+*                        VECTOR_LARGE_THRESHOLD byte allokeras via
+*                        aligned_alloc, medan strre flt lagras i egna
+*                        anonyma minnesmappningar. Mappade flt utkas via
+*                        mremap, vilket flyttar sidtabellsposter i stllet
+*                        fr att kopiera innehllet, s att kostnaden fr
+*                        varje frdubbling inte vxer med fltets storlek.
+*                        Samtliga flt r justerade till VECTOR_ALIGNMENT
+*                        (utom vid minnesbrist, se vector_heap_reallocate).
+*******************************************************************************/
+const struct vector_allocator* vector_allocator_heap(void)
+{
+   return &vector_heap_allocator;
+}
+
+/*******************************************************************************
+* vector_allocator_set_huge_pages: Anger ifall mappade flt skall placeras p
+*                                  grnser fr stora sidor (2 MB) och
+*                                  markeras fr transparent huge pages via
+*                                  madvise, vilket minskar antalet TLB-missar
+*                                  vid genomlsning av stora vektorer.
+*                                  Gller flt som mappas hdanefter och r
+*                                  frvalt aktiverat. Funktionen r inte
+*                                  trdsker och br anropas vid programstart.
+*                                  - enable: 1 fr att begra stora sidor,
+*                                            0 fr vanliga sidor.
+*******************************************************************************/
+void vector_allocator_set_huge_pages(const int enable)
+{
+   vector_huge_pages = enable ? 1 : 0;
+   return;
+}
+
 /*******************************************************************************
 * vector_begin: Returnerar adressen till frsta elementet i angiven vektor.
 *               - self: Pekare till vektorn.
 *******************************************************************************/
 void* vector_begin(const struct vector* self)
 {
-   if (self->type == VECTOR_TYPE_INTEGER)
-   {
-      return self->data.integer;
-   }
-   else if (self->type == VECTOR_TYPE_DOUBLE)
-   {
-      return self->data.decimal;
-   }
-   else if (self->type == VECTOR_TYPE_UNSIGNED)
-   {
-      return self->data.natural;
-   }
-   else
-   {
-      return 0;
-   }
+   return self->data.raw;
 }
 
 /*******************************************************************************
@@ -96,141 +345,233 @@ void* vector_begin(const struct vector* self)
 *******************************************************************************/
 void* vector_end(const struct vector* self)
 {
-   if (self->type == VECTOR_TYPE_INTEGER)
-   {
-      return self->data.integer + self->size;
-   }
-   else if (self->type == VECTOR_TYPE_DOUBLE)
-   {
-      return self->data.decimal + self->size;
-   }
-   else if (self->type == VECTOR_TYPE_UNSIGNED)
-   {
-      return self->data.natural + self->size;
-   }
-   else
-   {
-      return 0;
-   }
+   if (!self->data.raw) return 0;
+   return (char*)self->data.raw + self->size * self->ops->element_size;
 }
 
 /*******************************************************************************
-* vector_resize: ndrar storlek/kapacitet p given vektor.
+* vector_resize: ndrar storlek p given vektor. Vid behov utkas kapaciteten,
+*                minst till angiven storlek och annars geometriskt, s att
+*                upprepade sm kningar inte medfr en omallokering var.
+*                Vid minskning behlls allokerat minne, vilket kan frigras
+*                via vector_shrink_to_fit. Nya element r oinitierade.
 *                - self    : Pekare till vektorn.
-*                - new_size: Vektorns nya storlek/kapacitet.
+*                - new_size: Vektorns nya storlek.
 *******************************************************************************/
 int vector_resize(struct vector* self,
                   const size_t new_size)
 {
-   if (!new_size)
-   {
-      vector_delete(self);
-   }
-   else
+   if (!self->ops->element_size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (vector_own(self)) return 1;
+   if (new_size > vector_capacity(self) && vector_grow(self, new_size)) return 1;
+   self->size = new_size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_reserve: Allokerar minne fr minst angivet antal element utan att
+*                 ndra vektorns storlek. Om kapaciteten redan r tillrcklig
+*                 grs ingenting.
+*                 - self        : Pekare till vektorn.
+*                 - new_capacity: nskad kapacitet (antalet element).
+*******************************************************************************/
+int vector_reserve(struct vector* self,
+                   const size_t new_capacity)
+{
+   if (!self->ops->element_size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (vector_own(self)) return 1;
+   if (new_capacity <= vector_capacity(self)) return 0;
+
+   if (vector_is_small(self))
    {
-      if (self->type == VECTOR_TYPE_INTEGER)
-      {
-         int* copy = (int*)realloc(self->data.integer, sizeof(int) * new_size);
-         if (!copy) return 1;
-         self->data.integer = copy;
-         self->size = new_size;
-      }
-      else if (self->type == VECTOR_TYPE_DOUBLE)
-      {
-         double* copy = (double*)realloc(self->data.decimal, sizeof(double) * new_size);
-         if (!copy) return 1;
-         self->data.decimal = copy;
-         self->size = new_size;
-      }
-      else if (self->type == VECTOR_TYPE_UNSIGNED)
-      {
-         size_t* copy = (size_t*)realloc(self->data.natural, sizeof(size_t) * new_size);
-         if (!copy) return 1;
-         self->data.natural = copy;
-         self->size = new_size;
-      }
-      else
+      union vector_ptr block;
+      struct vector_shared* shared = 0;
+      vector_ptr_init(&block);
+      if (vector_ptr_realloc(&block, self->allocator, self->ops->element_size, 0, new_capacity)) return 1;
+
+      /* Flt som kan delas fr sin referensrknare nr de flyttas till heapen: */
+      if ((self->flags & VECTOR_FLAG_SHARED) && !(shared = vector_shared_new(new_capacity)))
       {
+         vector_ptr_free(&block, self->allocator, new_capacity * self->ops->element_size);
          return 1;
       }
+      memcpy(block.raw, self->small.raw, self->size * self->ops->element_size);
+      VECTOR_STATS_COPY(self->size * self->ops->element_size);
+      self->data = block;
+      self->shared = shared;
    }
+   else if (vector_ptr_realloc(&self->data, self->allocator, self->ops->element_size,
+                               self->capacity, new_capacity))
+   {
+      return 1;
+   }
+   else if (self->shared)
+   {
+      self->shared->capacity = new_capacity;
+   }
+   self->capacity = new_capacity;
    return 0;
 }
 
 /*******************************************************************************
-* vector_push: Lgger till ett nytt element lngst bak i angiven vektor.
-*              - self       : Pekare till vektorn.
-*              - new_element: Pekare till det nya elementet.
+* vector_shrink_to_fit: Minskar vektorns kapacitet till dess storlek och
+*                       frigr drmed oanvnt minne. Om innehllet ryms i
+*                       den interna bufferten flyttas det dit och det
+*                       heapallokerade fltet frigrs helt.
+*                       - self: Pekare till vektorn.
 *******************************************************************************/
-int vector_push(struct vector* self,
-                const void* new_element)
+int vector_shrink_to_fit(struct vector* self)
 {
-   if (self->type == VECTOR_TYPE_INTEGER)
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_own(self))
    {
-      int* copy = (int*)realloc(self->data.integer, sizeof(int) * (self->size + 1));
-      if (!copy) return 1;
-      copy[self->size++] = *(int*)new_element;
-      self->data.integer = copy;
+      return 1;
    }
-   else if (self->type == VECTOR_TYPE_DOUBLE)
+   else if (vector_is_small(self) || self->size == self->capacity)
    {
-      double* copy = (double*)realloc(self->data.decimal, sizeof(double) * (self->size + 1));
-      if (!copy) return 1;
-      copy[self->size++] = *(double*)new_element;
-      self->data.decimal = copy;
+      return 0;
    }
-   else if (self->type == VECTOR_TYPE_UNSIGNED)
+   else if (self->size <= VECTOR_SMALL_SIZE / self->ops->element_size)
    {
-      size_t* copy = (size_t*)realloc(self->data.natural, sizeof(size_t) * (self->size + 1));
-      if (!copy) return 1;
-      copy[self->size++] = *(size_t*)new_element;
-      self->data.natural = copy;
+      /* Bufferten delar minne med kapaciteten och referensrknaren, som lses frst: */
+      union vector_ptr block = self->data;
+      const size_t capacity = self->capacity;
+      struct vector_shared* shared = self->shared;
+      memcpy(self->small.raw, block.raw, self->size * self->ops->element_size);
+      VECTOR_STATS_COPY(self->size * self->ops->element_size);
+      self->data.raw = self->small.raw;
+      vector_ptr_free(&block, self->allocator, capacity * self->ops->element_size);
+      free(shared);
+      return 0;
    }
    else
    {
-      return 1;
+      if (vector_ptr_realloc(&self->data, self->allocator, self->ops->element_size,
+                             self->capacity, self->size)) return 1;
+      if (self->shared) self->shared->capacity = self->size;
+      self->capacity = self->size;
+      return 0;
    }
+}
+
+/*******************************************************************************
+* vector_push: Lgger till ett nytt element lngst bak i angiven vektor.
+*              Kapaciteten frdubblas nr den tar slut, vilket ger amorterat
+*              konstant tid per insttning.
+*              - self       : Pekare till vektorn.
+*              - new_element: Pekare till det nya elementet.
+*******************************************************************************/
+int vector_push(struct vector* self,
+                const void* new_element)
+{
+   VECTOR_STATS_CALL(PUSH, self->type);
+   if (vector_own(self)) return 1;
+   if (self->size == vector_capacity(self) && vector_grow(self, self->size + 1)) return 1;
+   self->ops->assign((char*)self->data.raw + self->size * self->ops->element_size, new_element);
+   self->size++;
    return 0;
 }
 
 /*******************************************************************************
-* vector_pop: Tar bort sista lagrade element i angiven vektor.
+* vector_pop: Tar bort sista lagrade element i angiven vektor. Allokerat minne
+*             behlls fr kommande insttningar.
 *             - self: Pekare till vektorn.
 *******************************************************************************/
 int vector_pop(struct vector* self)
 {
-   if (self->size <= 1)
+   VECTOR_STATS_CALL(POP, self->type);
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_own(self)) return 1;
+   if (self->size) self->size--;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_push_range: Lgger till angivet antal element lngst bak i angiven
+*                    vektor via en blockkopiering och hgst en omallokering.
+*                    - self        : Pekare till vektorn.
+*                    - source      : Pekare till de nya elementen, som mste
+*                                    vara av samma datatyp som vektorn.
+*                    - num_elements: Antalet element som skall lggas till.
+*******************************************************************************/
+int vector_push_range(struct vector* self,
+                      const void* source,
+                      const size_t num_elements)
+{
+   return vector_insert_range(self, self->size, source, num_elements);
+}
+
+/*******************************************************************************
+* vector_insert_range: Lgger in angivet antal element med start p angivet
+*                      index. Efterfljande element flyttas bakt via en
+*                      blockfrflyttning. Kllan fr ligga i vektorns eget flt.
+*                      - self        : Pekare till vektorn.
+*                      - index       : Index dr frsta nya elementet placeras.
+*                      - source      : Pekare till de nya elementen.
+*                      - num_elements: Antalet element som skall lggas in.
+*******************************************************************************/
+int vector_insert_range(struct vector* self,
+                        const size_t index,
+                        const void* source,
+                        const size_t num_elements)
+{
+   const size_t element_size = self->ops->element_size;
+   void* temp = 0;
+
+   if (!element_size || index > self->size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (!num_elements) return 0;
+   if (!source || num_elements > SIZE_MAX - self->size) return 1;
+   if (vector_own(self)) return 1;
+   const size_t capacity = vector_capacity(self);
+
+   if (capacity &&
+       (const char*)source < (char*)vector_begin(self) + capacity * element_size &&
+       (const char*)source + num_elements * element_size > (char*)vector_begin(self))
    {
-      vector_delete(self);
+      temp = malloc(num_elements * element_size);
+      if (!temp) return 1;
+      memcpy(temp, source, num_elements * element_size);
+      VECTOR_STATS_COPY(num_elements * element_size);
+      source = temp;
    }
-   else
+
+   if (self->size + num_elements > capacity &&
+       vector_grow(self, self->size + num_elements))
    {
-      if (self->type == VECTOR_TYPE_INTEGER)
-      {
-         int* copy = (int*)realloc(self->data.integer, sizeof(int) * (self->size - 1));
-         if (!copy) return 1;
-         self->data.integer = copy;
-         self->size--;
-      }
-      else if (self->type == VECTOR_TYPE_DOUBLE)
-      {
-         double* copy = (double*)realloc(self->data.decimal, sizeof(double) * (self->size - 1));
-         if (!copy) return 1;
-         self->data.decimal = copy;
-         self->size--;
-      }
-      else if (self->type == VECTOR_TYPE_UNSIGNED)
-      {
-         size_t* copy = (size_t*)realloc(self->data.natural, sizeof(size_t) * (self->size - 1));
-         if (!copy) return 1;
-         self->data.natural = copy;
-         self->size--;
-      }
-      else
-      {
-         return 1;
-      }
+      free(temp);
+      return 1;
    }
+
+   char* position = (char*)vector_begin(self) + index * element_size;
+   memmove(position + num_elements * element_size, position, (self->size - index) * element_size);
+   memcpy(position, source, num_elements * element_size);
+   VECTOR_STATS_COPY((self->size - index + num_elements) * element_size);
+   self->size += num_elements;
+   free(temp);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_erase_range: Tar bort angivet antal element med start p angivet
+*                     index. Efterfljande element flyttas framt via en
+*                     blockfrflyttning. Allokerat minne behlls.
+*                     - self        : Pekare till vektorn.
+*                     - index       : Index till frsta elementet som tas bort.
+*                     - num_elements: Antalet element som skall tas bort.
+*******************************************************************************/
+int vector_erase_range(struct vector* self,
+                       const size_t index,
+                       const size_t num_elements)
+{
+   const size_t element_size = self->ops->element_size;
+   if (self->flags & VECTOR_FLAG_READONLY) return 1;
+   if (index > self->size || num_elements > self->size - index) return 1;
+   if (!num_elements) return 0;
+   if (vector_own(self)) return 1;
+
+   char* position = (char*)vector_begin(self) + index * element_size;
+   memmove(position, position + num_elements * element_size,
+           (self->size - index - num_elements) * element_size);
+   VECTOR_STATS_COPY((self->size - index - num_elements) * element_size);
+   self->size -= num_elements;
    return 0;
 }
 
@@ -244,20 +585,10 @@ void vector_set(struct vector* self,
                 const size_t index,
                 const void* val)
 {
-   if (index < self->size)
+   VECTOR_STATS_CALL(SET, self->type);
+   if (index < self->size && !(self->flags & VECTOR_FLAG_READONLY) && !vector_own(self))
    {
-      if (self->type == VECTOR_TYPE_INTEGER)
-      {
-         self->data.integer[index] = *(int*)val;
-      }
-      else if (self->type == VECTOR_TYPE_DOUBLE)
-      {
-         self->data.decimal[index] = *(double*)val;
-      }
-      else if (self->type == VECTOR_TYPE_UNSIGNED)
-      {
-         self->data.natural[index] = *(size_t*)val;
-      }
+      self->ops->assign((char*)self->data.raw + index * self->ops->element_size, val);
    }
    return;
 }
@@ -271,31 +602,23 @@ void vector_set(struct vector* self,
 const void* vector_get(const struct vector* self,
                        const size_t index)
 {
-   if (index >= self->size)
-   {
-      return 0;
-   }
-   else
-   {
-      if (self->type == VECTOR_TYPE_INTEGER)
-      {
-         return &self->data.integer[index];
-      }
-      else if (self->type == VECTOR_TYPE_DOUBLE)
-      {
-         return &self->data.decimal[index];
-      }
-      else if (self->type == VECTOR_TYPE_UNSIGNED)
-      {
-         return &self->data.natural[index];
-      }
-   }
-   return 0;
+   VECTOR_STATS_CALL(GET, self->type);
+   if (index >= self->size) return 0;
+   return (const char*)self->data.raw + index * self->ops->element_size;
 }
 
 /*******************************************************************************
 * vector_copy: Kopierar innehllet frn en vektor till en annan. Eventuellt 
-*              tidigare innehll raderas ur vektorn som kopiering sker till.
+*              tidigare innehll raderas ur vektorn som kopiering sker till,
+*              som dock behller sin allokerare. Om kllans flt kan delas
+*              (se vector_set_shared), ligger p heapen och vektorerna har
+*              samma allokerare delas fltet i stllet fr att kopieras,
+*              vilket sker i konstant tid. Kopieringen sker d frst nr
+*              ngon av vektorerna ndras. Flt i den interna bufferten
+*              samt flt med en annan allokerare n mlvektorns kopieras
+*              alltid direkt, men ven d rver kopian egenskapen att
+*              fltet kan delas. Kopiering av en tom vektor lyckas alltid,
+*              ven om kllan saknar datatyp.
 *              - self  : Pekare till den vektor som kopierat innehll skall 
 *                        lagras i.
 *              - source: Pekare till den vektor vars innehll skall kopieras.
@@ -303,23 +626,109 @@ const void* vector_get(const struct vector* self,
 int vector_copy(struct vector* self,
                 const struct vector* source)
 {
+   if (self == source) return 0;
    vector_delete(self);
+   const struct vector_allocator* allocator = self->allocator;
    vector_new(self, source->type);
-   vector_resize(self, source->size);
+   self->allocator = allocator;
 
-   if (self->size == source->size)
+   if (!vector_is_small(source) && source->shared && source->allocator == allocator)
    {
-      for (size_t i = 0; i < self->size; ++i)
+      atomic_fetch_add_explicit(&source->shared->refcount, 1, memory_order_relaxed);
+      self->data = source->data;
+      self->size = source->size;
+      self->capacity = source->size;
+      self->flags = VECTOR_FLAG_SHARED;
+      self->shared = source->shared;
+      return 0;
+   }
+   if (source->size && vector_push_range(self, vector_begin(source), source->size)) return 1;
+   return source->flags & VECTOR_FLAG_SHARED ? vector_set_shared(self, 1) : 0;
+}
+
+/*******************************************************************************
+* vector_set_shared: Anger ifall vektorns flt skall delas vid kopiering via
+*                    vector_copy (copy-on-write). Delade flt har en atomr
+*                    referensrknare, vilket gr att vektorer som delar ett
+*                    flt kan lsas och kopieras frn olika trdar. Frsta
+*                    ndringen av en vektor vars flt delas medfr att
+*                    vektorn fr en egen kopia av fltet. Kopior av vektorn
+*                    rver egenskapen, som nollstlls vid radering.
+*                    - self  : Pekare till vektorn.
+*                    - enable: Indikerar ifall fltet skall kunna delas.
+*******************************************************************************/
+int vector_set_shared(struct vector* self,
+                      const int enable)
+{
+   if (self->flags & VECTOR_FLAG_READONLY) return 1;
+
+   if (enable)
+   {
+      if (self->data.raw && !vector_is_small(self) && !self->shared)
+      {
+         self->shared = vector_shared_new(self->capacity);
+         if (!self->shared) return 1;
+      }
+      self->flags |= VECTOR_FLAG_SHARED;
+   }
+   else
+   {
+      if (vector_own(self)) return 1;
+      if (!vector_is_small(self))
       {
-         vector_set(self, i, vector_get(source, i));
+         free(self->shared);
+         self->shared = 0;
       }
+      self->flags &= ~(unsigned)VECTOR_FLAG_SHARED;
+   }
+   return 0;
+}
 
+/*******************************************************************************
+* vector_unshare: Ger angiven vektor ett eget flt ifall fltet delas med
+*                 andra vektorer. Anropas automatiskt av funktioner som
+*                 ndrar vektorn, men mste anropas innan vektorn ndras
+*                 direkt via fltpekaren eller typade inline-funktioner.
+*                 - self: Pekare till vektorn.
+*******************************************************************************/
+int vector_unshare(struct vector* self)
+{
+   if (vector_is_small(self) || !self->shared) return 0;
+   if (atomic_load_explicit(&self->shared->refcount, memory_order_acquire) == 1)
+   {
+      self->capacity = self->shared->capacity;
       return 0;
    }
-   else
+
+   const size_t element_size = self->ops->element_size;
+   const size_t capacity = self->capacity ? self->capacity : VECTOR_MIN_CAPACITY;
+   struct vector_shared* shared = vector_shared_new(capacity);
+   union vector_ptr block;
+   vector_ptr_init(&block);
+   if (!shared) return 1;
+
+   if (vector_ptr_realloc(&block, self->allocator, element_size, 0, capacity))
    {
+      free(shared);
       return 1;
    }
+   memcpy(block.raw, self->data.raw, self->size * element_size);
+   VECTOR_STATS_COPY(self->size * element_size);
+   vector_shared_release(self);
+   self->data = block;
+   self->capacity = capacity;
+   self->shared = shared;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_is_shared: Indikerar ifall angiven vektors flt delas med andra
+*                   vektorer.
+*                   - self: Pekare till vektorn.
+*******************************************************************************/
+int vector_is_shared(const struct vector* self)
+{
+   return !vector_is_small(self) && self->shared && atomic_load_explicit(&self->shared->refcount, memory_order_acquire) > 1;
 }
 
 /*******************************************************************************
@@ -338,32 +747,13 @@ int vector_join(struct vector* self,
    {
       return vector_copy(self, other_vector);
    }
+   else if (self->type == other_vector->type)
+   {
+      return vector_push_range(self, vector_begin(other_vector), other_vector->size);
+   }
    else
    {
-      if (self->type == other_vector->type)
-      {
-         const size_t offset = self->size;
-         const size_t new_size = self->size + other_vector->size;
-         vector_resize(self, new_size);
-
-         if (self->size == new_size)
-         {
-            for (size_t i = 0; i < other_vector->size; ++i)
-            {
-               vector_set(self, i + offset, vector_get(other_vector, i));
-            }
-
-            return 0;
-         }
-         else
-         {
-            return 1;
-         }
-      }
-      else
-      {
-         return 1;
-      }
+      return 1;
    }
 }
 
@@ -380,15 +770,32 @@ void vector_move(struct vector* self,
                  struct vector* source)
 {
    vector_delete(self);
-   self->data = source->data;
+   if (vector_is_small(source))
+   {
+      memcpy(self->small.raw, source->small.raw, VECTOR_SMALL_SIZE);
+      VECTOR_STATS_COPY(VECTOR_SMALL_SIZE);
+      self->data.raw = self->small.raw;
+   }
+   else
+   {
+      self->data = source->data;
+      self->capacity = source->capacity;
+      self->shared = source->shared;
+   }
    self->type = source->type;
+   self->ops = source->ops;
+   self->allocator = source->allocator;
    self->size = source->size;
+   self->flags = source->flags;
 
-   source->data.integer = 0;
-   source->data.decimal = 0;
-   source->data.natural = 0;
+   vector_ptr_init(&source->data);
    source->type = VECTOR_TYPE_NONE;
+   source->ops = vector_ops(VECTOR_TYPE_NONE);
+   source->allocator = vector_default_allocator;
    source->size = 0;
+   source->capacity = 0;
+   source->flags = 0;
+   source->shared = 0;
    return;
 }
 
@@ -408,21 +815,7 @@ void vector_print(const struct vector* self,
    if (!ostream) ostream = stdout;
    fprintf(ostream, "--------------------------------------------------------------------------------\n");
 
-   for (size_t i = 0; i < self->size; ++i)
-   {
-      if (self->type == VECTOR_TYPE_INTEGER)
-      {
-         fprintf(ostream, "%d\n", self->data.integer[i]);
-      }
-      else if (self->type == VECTOR_TYPE_DOUBLE)
-      {
-         fprintf(ostream, "%g\n", self->data.decimal[i]);
-      }
-      else if (self->type == VECTOR_TYPE_UNSIGNED)
-      {
-         fprintf(ostream, "%zu\n", self->data.natural[i]);
-      }
-   }
+   if (self->ops->print) self->ops->print(ostream, self->data.raw, self->size);
 
    fprintf(ostream, "--------------------------------------------------------------------------------\n\n");
    return;
@@ -440,36 +833,300 @@ void (*vector_clear)(struct vector* self) = &vector_delete;
 *******************************************************************************/
 static inline void vector_ptr_init(union vector_ptr* self)
 {
-   self->integer = 0;
-   self->decimal = 0;
-   self->natural = 0;
+   self->raw = 0;
    return;
 }
 
+/*******************************************************************************
+* vector_is_small: Indikerar ifall angiven vektor lagrar sina element i den
+*                  interna bufferten.
+*                  - self: Pekare till vektorn.
+*******************************************************************************/
+static inline int vector_is_small(const struct vector* self)
+{
+   return self->data.raw == (const void*)self->small.raw;
+}
+
 /*******************************************************************************
 * vector_ptr_free: Frigr minne fr dynamiskt flt.
-*                  - self: Unionpekare till minnet som skall frigras.
-*                  - type: Fltets datatyp (avgr vilken av unionpekarens
-*                          pekar som pekar p det allokerade minnet).
+*                  - self     : Unionpekare till minnet som skall frigras.
+*                  - allocator: Allokeraren som fltet allokerades med.
+*                  - size     : Fltets storlek i byte.
 *******************************************************************************/
 static void vector_ptr_free(union vector_ptr* self,
-                            const enum vector_type type)
+                            const struct vector_allocator* allocator,
+                            const size_t size)
 {
-   if (type == VECTOR_TYPE_INTEGER)
+   if (self->raw)
    {
-      free(self->integer);
+      allocator->deallocate(allocator->context, self->raw, size);
+      VECTOR_STATS_DEALLOCATE(size);
    }
-   else if (type == VECTOR_TYPE_DOUBLE)
+   self->raw = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_ptr_realloc: Omallokerar dynamiskt flt till angiven kapacitet.
+*                     Befintligt innehll bevaras upp till den nya kapaciteten.
+*                     - self        : Unionpekare till fltet.
+*                     - allocator   : Allokeraren som fltet allokeras med.
+*                     - element_size: Storleken p varje element i byte.
+*                     - old_capacity: Fltets nuvarande kapacitet.
+*                     - new_capacity: Fltets nya kapacitet (antalet element).
+*******************************************************************************/
+static int vector_ptr_realloc(union vector_ptr* self,
+                              const struct vector_allocator* allocator,
+                              const size_t element_size,
+                              const size_t old_capacity,
+                              const size_t new_capacity)
+{
+   if (!element_size || new_capacity > SIZE_MAX / element_size) return 1;
+   void* copy = self->raw ?
+      allocator->reallocate(allocator->context, self->raw,
+                            element_size * old_capacity, element_size * new_capacity) :
+      allocator->allocate(allocator->context, element_size * new_capacity);
+   if (!copy) return 1;
+
+   if (self->raw)
    {
-      free(self->decimal);
+      VECTOR_STATS_REALLOCATE(element_size * old_capacity, element_size * new_capacity);
    }
-   else if (type == VECTOR_TYPE_UNSIGNED)
+   else
    {
-      free(self->natural);
+      VECTOR_STATS_ALLOCATE(element_size * new_capacity);
    }
+   self->raw = copy;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_align_up: Avrundar angiven storlek uppt till en multipel av angiven
+*                  justering, eller returnerar noll vid verspill.
+*                  - size     : Storleken som skall avrundas.
+*                  - alignment: Justeringen, som mste vara en tvpotens.
+*******************************************************************************/
+static inline size_t vector_align_up(const size_t size,
+                                     const size_t alignment)
+{
+   return size > SIZE_MAX - (alignment - 1) ? 0 : (size + alignment - 1) & ~(alignment - 1);
+}
+
+/*******************************************************************************
+* vector_heap_allocate: Allokerar ett block justerat till VECTOR_ALIGNMENT.
+*                      Block om minst VECTOR_LARGE_THRESHOLD byte mappas,
+*                      vriga allokeras via aligned_alloc, vars storlek
+*                      mste vara en multipel av justeringen.
+*******************************************************************************/
+static void* vector_heap_allocate(void* context,
+                                  const size_t size)
+{
+   (void)context;
+#ifdef VECTOR_LARGE_MAPPED
+   if (size >= VECTOR_LARGE_THRESHOLD) return vector_large_map(size);
+#endif
+   const size_t aligned_size = vector_align_up(size ? size : 1, VECTOR_ALIGNMENT);
+   return aligned_size ? aligned_alloc(VECTOR_ALIGNMENT, aligned_size) : 0;
+}
+
+/*******************************************************************************
+* vector_heap_reallocate: ndrar storlek p ett block. Mappade block ndras
+*                         via mremap. vriga block ndras i frsta hand via
+*                         realloc, som ofta kan utka blocket p plats utan
+*                         kopiering. Eftersom realloc inte bevarar justeringen
+*                         flyttas blocket till ett nytt justerat block enbart
+*                         om realloc returnerar ett ojusterat block. Om det
+*                         nya blocket d inte kan allokeras returneras det
+*                         ojusterade blocket, s att innehllet bevaras.
+*                         Block som flyttas mellan heapen och en mappning
+*                         kopieras alltid.
+*******************************************************************************/
+static void* vector_heap_reallocate(void* context,
+                                    void* block,
+                                    const size_t old_size,
+                                    const size_t new_size)
+{
+   const size_t copy_size = old_size < new_size ? old_size : new_size;
+#ifdef VECTOR_LARGE_MAPPED
+   if (old_size >= VECTOR_LARGE_THRESHOLD && new_size >= VECTOR_LARGE_THRESHOLD)
+   {
+      return vector_large_remap(block, old_size, new_size);
+   }
+   if (old_size >= VECTOR_LARGE_THRESHOLD || new_size >= VECTOR_LARGE_THRESHOLD)
+   {
+      void* copy = vector_heap_allocate(context, new_size);
+      if (!copy) return 0;
+      memcpy(copy, block, copy_size);
+      vector_heap_deallocate(context, block, old_size);
+      return copy;
+   }
+#endif
+   const size_t aligned_size = vector_align_up(new_size ? new_size : 1, VECTOR_ALIGNMENT);
+   void* moved = aligned_size ? realloc(block, aligned_size) : 0;
+   if (!moved || !((uintptr_t)moved & (VECTOR_ALIGNMENT - 1))) return moved;
+
+   void* copy = vector_heap_allocate(context, new_size);
+   if (!copy) return moved;
+   memcpy(copy, moved, copy_size);
+   free(moved);
+   return copy;
+}
 
-   self->integer = 0;
-   self->decimal = 0;
-   self->natural = 0;
+/*******************************************************************************
+* vector_heap_deallocate: Frigr ett block via munmap eller free beroende p
+*                         blockets storlek.
+*******************************************************************************/
+static void vector_heap_deallocate(void* context,
+                                   void* block,
+                                   const size_t size)
+{
+   (void)context;
+#ifdef VECTOR_LARGE_MAPPED
+   if (size >= VECTOR_LARGE_THRESHOLD)
+   {
+      munmap(block, vector_align_up(size ? size : 1, (size_t)sysconf(_SC_PAGESIZE)));
+      return;
+   }
+#endif
+   free(block);
+   return;
+}
+
+#ifdef VECTOR_LARGE_MAPPED
+/*******************************************************************************
+* vector_large_map: Skapar en anonym mappning om angiven storlek avrundad
+*                   till hela sidor. Om stora sidor r aktiverade mappas
+*                   ytterligare 2 MB, varefter verskottet fre och efter en
+*                   grns fr stora sidor tas bort, och mappningen markeras
+*                   via madvise. Returnerar nullpekare vid fel.
+*                   - size: Storleken i byte.
+*******************************************************************************/
+static void* vector_large_map(const size_t size)
+{
+   const size_t map_size = vector_align_up(size ? size : 1, (size_t)sysconf(_SC_PAGESIZE));
+   const int huge = vector_huge_pages && map_size >= VECTOR_HUGE_PAGE_SIZE;
+   const size_t padding = huge ? VECTOR_HUGE_PAGE_SIZE : 0;
+   if (!map_size || map_size > SIZE_MAX - padding) return 0;
+
+   char* base = (char*)mmap(0, map_size + padding, PROT_READ | PROT_WRITE,
+                            MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (base == (char*)MAP_FAILED) return 0;
+   if (!huge) return base;
+
+   char* block = (char*)(((uintptr_t)base + VECTOR_HUGE_PAGE_SIZE - 1) & ~(uintptr_t)(VECTOR_HUGE_PAGE_SIZE - 1));
+   if (block > base) munmap(base, (size_t)(block - base));
+   if (block < base + padding) munmap(block + map_size, (size_t)(base + padding - block));
+   madvise(block, map_size, MADV_HUGEPAGE);
+   return block;
+}
+
+/*******************************************************************************
+* vector_large_remap: ndrar storlek p en mappning. Mappningen utkas i
+*                     frsta hand p plats. Annars reserveras en ny mappning
+*                     (p en grns fr stora sidor om sdana r aktiverade),
+*                     dit befintliga sidor flyttas via mremap utan kopiering.
+*                     Returnerar nullpekare vid fel, varvid blocket behlls.
+*                     - block   : Pekare till mappningen.
+*                     - old_size: Mappningens nuvarande storlek i byte.
+*                     - new_size: Mappningens nya storlek i byte.
+*******************************************************************************/
+static void* vector_large_remap(void* block,
+                                const size_t old_size,
+                                const size_t new_size)
+{
+   const size_t page_size = (size_t)sysconf(_SC_PAGESIZE);
+   const size_t old_map_size = vector_align_up(old_size ? old_size : 1, page_size);
+   const size_t new_map_size = vector_align_up(new_size ? new_size : 1, page_size);
+   if (!new_map_size) return 0;
+
+   if (new_map_size <= old_map_size)
+   {
+      if (new_map_size < old_map_size) munmap((char*)block + new_map_size, old_map_size - new_map_size);
+      return block;
+   }
+   if (mremap(block, old_map_size, new_map_size, 0) != MAP_FAILED) return block;
+
+   void* target = vector_large_map(new_map_size);
+   if (!target) return 0;
+
+   if (mremap(block, old_map_size, new_map_size, MREMAP_MAYMOVE | MREMAP_FIXED, target) == MAP_FAILED)
+   {
+      munmap(target, new_map_size);
+      return 0;
+   }
+   if (vector_huge_pages && new_map_size >= VECTOR_HUGE_PAGE_SIZE)
+   {
+      madvise(target, new_map_size, MADV_HUGEPAGE);
+   }
+   return target;
+}
+#endif
+
+/*******************************************************************************
+* vector_grow: Utkar vektorns kapacitet geometriskt (frdubbling) s att minst
+*              angivet antal element ryms.
+*              - self        : Pekare till vektorn.
+*              - min_capacity: Minsta kapacitet som krvs.
+*******************************************************************************/
+static int vector_grow(struct vector* self,
+                       const size_t min_capacity)
+{
+   const size_t capacity = vector_capacity(self);
+   size_t new_capacity = capacity ? capacity : VECTOR_MIN_CAPACITY;
+
+   while (new_capacity < min_capacity)
+   {
+      if (new_capacity > SIZE_MAX / 2)
+      {
+         new_capacity = min_capacity;
+         break;
+      }
+      new_capacity *= 2;
+   }
+
+   return vector_reserve(self, new_capacity);
+}
+
+/*******************************************************************************
+* vector_own: Skerstller att vektorn har ett eget flt innan den ndras.
+*             Vektorer vars flt inte kan delas pverkas inte.
+*             - self: Pekare till vektorn.
+*******************************************************************************/
+static inline int vector_own(struct vector* self)
+{
+   return !vector_is_small(self) && self->shared ? vector_unshare(self) : 0;
+}
+
+/*******************************************************************************
+* vector_shared_new: Returnerar en ny referensrknare fr ett flt med angiven
+*                    kapacitet, dr vektorn som anropar r enda garen.
+*                    - capacity: Fltets kapacitet (antalet element).
+*******************************************************************************/
+static struct vector_shared* vector_shared_new(const size_t capacity)
+{
+   struct vector_shared* self = (struct vector_shared*)malloc(sizeof(struct vector_shared));
+   if (!self) return 0;
+   atomic_init(&self->refcount, 1);
+   self->capacity = capacity;
+   return self;
+}
+
+/*******************************************************************************
+* vector_shared_release: Slpper vektorns referens till sitt delade flt.
+*                        Fltet och referensrknaren frigrs av den vektor
+*                        som slpper sista referensen. Vektorns fltpekare
+*                        och referensrknare nollstlls.
+*                        - self: Pekare till vektorn.
+*******************************************************************************/
+static void vector_shared_release(struct vector* self)
+{
+   struct vector_shared* shared = self->shared;
+   if (atomic_fetch_sub_explicit(&shared->refcount, 1, memory_order_acq_rel) == 1)
+   {
+      vector_ptr_free(&self->data, self->allocator, shared->capacity * self->ops->element_size);
+      free(shared);
+   }
+   vector_ptr_init(&self->data);
+   self->shared = 0;
    return;
 }
\ No newline at end of file
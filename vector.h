@@ -1,6 +1,6 @@
 /*******************************************************************************
 * vector.h: Implementering av dynamiska vektorer, som kan lagra bde signerade
-*           och osignerade heltal samt flyttal.
+*           och osignerade heltal av olika bredd samt flyttal.
 *******************************************************************************/
 #ifndef VECTOR_H_
 #define VECTOR_H_
@@ -8,56 +8,201 @@
 /* Inkluderingsdirektiv: */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_SMALL_SIZE 64 /* Storlek p vektorns interna buffert i byte. */
+#define VECTOR_ALIGNMENT 64  /* Justering fr allokerade flt i byte (en cacherad). */
+
+/*******************************************************************************
+* VECTOR_LARGE_THRESHOLD: Storlek i byte frn vilken frvald allokerare
+*                         lagrar flt i egna anonyma minnesmappningar (Linux),
+*                         som utkas via mremap genom att sidor flyttas i
+*                         stllet fr att innehllet kopieras. Kan ndras vid
+*                         kompilering, exempelvis -DVECTOR_LARGE_THRESHOLD=4096
+*                         fr att mappa samtliga flt om minst en sida.
+*******************************************************************************/
+#ifndef VECTOR_LARGE_THRESHOLD
+#define VECTOR_LARGE_THRESHOLD 1048576
+#endif
 
 /*******************************************************************************
 * vector_type: Datatyp fr dynamisk vektor, som kan vljas mellan signerade
-*              och osignerade heltal samt flyttal.
+*              och osignerade heltal samt flyttal. De kompakta datatyperna
+*              ligger efter de ursprungliga, s att vrdena fr dessa r
+*              ofrndrade (exempelvis i filhuvuden frn vector_file).
 *******************************************************************************/
 enum vector_type
 {
-   VECTOR_TYPE_INTEGER,  /* Flt fr lagring av signerade heltal. */
-   VECTOR_TYPE_DOUBLE,   /* Flt fr lagring av flyttal. */
-   VECTOR_TYPE_UNSIGNED, /* Flt fr lagring av osignerade heltal. */
+   VECTOR_TYPE_INTEGER,  /* Flt fr lagring av signerade heltal (int). */
+   VECTOR_TYPE_DOUBLE,   /* Flt fr lagring av flyttal (double). */
+   VECTOR_TYPE_UNSIGNED, /* Flt fr lagring av osignerade heltal (size_t). */
+   VECTOR_TYPE_INT8,     /* Flt fr lagring av signerade 8-bitars heltal. */
+   VECTOR_TYPE_INT16,    /* Flt fr lagring av signerade 16-bitars heltal. */
+   VECTOR_TYPE_INT64,    /* Flt fr lagring av signerade 64-bitars heltal. */
+   VECTOR_TYPE_UINT8,    /* Flt fr lagring av osignerade 8-bitars heltal. */
+   VECTOR_TYPE_UINT16,   /* Flt fr lagring av osignerade 16-bitars heltal. */
+   VECTOR_TYPE_UINT32,   /* Flt fr lagring av osignerade 32-bitars heltal. */
+   VECTOR_TYPE_FLOAT,    /* Flt fr lagring av flyttal med enkel precision. */
    VECTOR_TYPE_NONE      /* Icke angiven datatyp. */
 };
 
+/*******************************************************************************
+* vector_flag: Flaggor som anger egenskaper hos vektorns flt.
+*******************************************************************************/
+enum vector_flag
+{
+   VECTOR_FLAG_READONLY = 0x01, /* Fltet gs inte av vektorn och fr inte ndras. */
+   VECTOR_FLAG_SHARED = 0x02    /* Fltet kan delas vid kopiering (se vector_copy). */
+};
+
 /*******************************************************************************
 * vector_ptr: Union innehllande pekare fr dynamiska flt av olika datatyper,
 *             men allokerar enbart minne fr en pekare.
 *******************************************************************************/
 union vector_ptr
 {
-   int* integer;    /* Pekare till flt innehllande signerade heltal. */
-   double* decimal; /* Pekare till flt innehllande flyttal. */
-   size_t* natural; /* Pekare till flt innehllande osignerade heltal. */
+   int* integer;     /* Pekare till flt innehllande signerade heltal. */
+   double* decimal;  /* Pekare till flt innehllande flyttal. */
+   size_t* natural;  /* Pekare till flt innehllande osignerade heltal. */
+   int8_t* int8;     /* Pekare till flt innehllande signerade 8-bitars heltal. */
+   int16_t* int16;   /* Pekare till flt innehllande signerade 16-bitars heltal. */
+   int64_t* int64;   /* Pekare till flt innehllande signerade 64-bitars heltal. */
+   uint8_t* uint8;   /* Pekare till flt innehllande osignerade 8-bitars heltal. */
+   uint16_t* uint16; /* Pekare till flt innehllande osignerade 16-bitars heltal. */
+   uint32_t* uint32; /* Pekare till flt innehllande osignerade 32-bitars heltal. */
+   float* single;    /* Pekare till flt innehllande flyttal med enkel precision. */
+   void* raw;        /* Typls pekare till fltet. */
 };
 
+/*******************************************************************************
+* vector_small: Intern buffert fr sm vektorer, s att vektorer med upp till
+*               VECTOR_SMALL_SIZE byte data inte behver allokera minne.
+*******************************************************************************/
+union vector_small
+{
+   int integer[VECTOR_SMALL_SIZE / sizeof(int)];          /* Signerade heltal. */
+   double decimal[VECTOR_SMALL_SIZE / sizeof(double)];    /* Flyttal. */
+   size_t natural[VECTOR_SMALL_SIZE / sizeof(size_t)];    /* Osignerade heltal. */
+   int8_t int8[VECTOR_SMALL_SIZE / sizeof(int8_t)];       /* Signerade 8-bitars heltal. */
+   int16_t int16[VECTOR_SMALL_SIZE / sizeof(int16_t)];    /* Signerade 16-bitars heltal. */
+   int64_t int64[VECTOR_SMALL_SIZE / sizeof(int64_t)];    /* Signerade 64-bitars heltal. */
+   uint8_t uint8[VECTOR_SMALL_SIZE / sizeof(uint8_t)];    /* Osignerade 8-bitars heltal. */
+   uint16_t uint16[VECTOR_SMALL_SIZE / sizeof(uint16_t)]; /* Osignerade 16-bitars heltal. */
+   uint32_t uint32[VECTOR_SMALL_SIZE / sizeof(uint32_t)]; /* Osignerade 32-bitars heltal. */
+   float single[VECTOR_SMALL_SIZE / sizeof(float)];       /* Flyttal med enkel precision. */
+   unsigned char raw[VECTOR_SMALL_SIZE];                  /* Buffertens byte. */
+};
+
+/*******************************************************************************
+* vector_ops: Typbeskrivning fr en given datatyp, innehllande elementens
+*             storlek samt funktionspekare fr typberoende operationer.
+*             Beskrivningen vljs en gng vid initiering av vektorn, vilket
+*             gr att vriga funktioner inte behver testa datatypen.
+*******************************************************************************/
+struct vector_ops
+{
+   size_t element_size;                   /* Elementens storlek i byte. */
+   void (*assign)(void* dest,             /* Kopierar ett element. */
+                  const void* source);
+   void (*print)(FILE* ostream,           /* Skriver ut ett antal element. */
+                 const void* data,
+                 const size_t size);
+};
+
+/*******************************************************************************
+* vector_allocator: Allokerare fr vektorers flt, bestende av funktioner fr
+*                   allokering, omallokering och deallokering samt en pekare
+*                   till allokerarens egna data. Storleken p befintliga block
+*                   passeras vid omallokering och deallokering, vilket gr att
+*                   allokeraren inte behver lagra storleken sjlv. Block
+*                   skall vara justerade till VECTOR_ALIGNMENT byte, s att
+*                   SIMD-instruktioner kan anvnda justerade lsningar.
+*******************************************************************************/
+struct vector_allocator
+{
+   void* (*allocate)(void* context,   /* Allokerar ett nytt block. */
+                     const size_t size);
+   void* (*reallocate)(void* context, /* ndrar storlek p ett block. */
+                       void* block,
+                       const size_t old_size,
+                       const size_t new_size);
+   void (*deallocate)(void* context,  /* Frigr ett block. */
+                      void* block,
+                      const size_t size);
+   void* context;                     /* Allokerarens egna data. */
+};
+
+/*******************************************************************************
+* vector_shared: Referensrknare fr flt som delas mellan vektorer, se
+*                vector_set_shared. Definieras i vector.c.
+*******************************************************************************/
+struct vector_shared;
+
 /*******************************************************************************
 * vector: Implementering av dynamisk vektor, som kan lagra element av multipla
 *         datatyper; signerade heltal (int), flyttal (double) samt signerade
-*         heltal (size_t / unsigned long long).
+*         heltal (size_t / unsigned long long). Sm vektorer lagras i den
+*         interna bufferten small, som fltpekaren d pekar p. Bufferten
+*         delar minne med kapaciteten och referensrknaren, som enbart
+*         anvnds fr flt utanfr bufferten, vilket hller nere vektorns
+*         storlek. Kapaciteten skall drfr lsas via vector_capacity.
+*         En vektor fr inte kopieras via tilldelning, utan via vector_copy
+*         eller vector_move.
 *******************************************************************************/
 struct vector
 {
-   union vector_ptr data; /* Pekare till dynamiskt flt. */
-   enum vector_type type; /* Vektorns datatyp. */
-   size_t size;           /* Vektorns storlek (antalet lagrade element). */
+   union vector_ptr data;        /* Pekare till fltet (eventuellt den interna bufferten). */
+   const struct vector_ops* ops; /* Typbeskrivning fr vektorns datatyp. */
+   const struct vector_allocator* allocator; /* Allokerare fr fltet. */
+   size_t size;                  /* Vektorns storlek (antalet lagrade element). */
+   enum vector_type type;        /* Vektorns datatyp. */
+   unsigned flags;               /* Fltets egenskaper (se vector_flag). */
+   union
+   {
+      struct
+      {
+         size_t capacity;              /* Fltets kapacitet (antalet allokerade platser). */
+         struct vector_shared* shared; /* Referensrknare fr delat flt (eller nullpekare). */
+      };
+      union vector_small small;        /* Intern buffert fr sm vektorer. */
+   };
 };
 
 /* Externa funktioner: */
 void vector_new(struct vector* self, 
                 const enum vector_type type);
 void vector_delete(struct vector* self);
+const struct vector_ops* vector_ops(const enum vector_type type);
 struct vector* vector_ptr_new(const enum vector_type type,
                               const size_t size);
 void vector_ptr_delete(struct vector** self);
+int vector_set_allocator(struct vector* self,
+                         const struct vector_allocator* allocator);
+void vector_allocator_set_default(const struct vector_allocator* allocator);
+const struct vector_allocator* vector_allocator_default(void);
+const struct vector_allocator* vector_allocator_heap(void);
+void vector_allocator_set_huge_pages(const int enable);
 void* vector_begin(const struct vector* self);
 void* vector_end(const struct vector* self);
 int vector_resize(struct vector* self,
                   const size_t new_size);
+int vector_reserve(struct vector* self,
+                   const size_t new_capacity);
+int vector_shrink_to_fit(struct vector* self);
 int vector_push(struct vector* self,
                 const void* new_element);
 int vector_pop(struct vector* self);
+int vector_push_range(struct vector* self,
+                      const void* source,
+                      const size_t num_elements);
+int vector_insert_range(struct vector* self,
+                        const size_t index,
+                        const void* source,
+                        const size_t num_elements);
+int vector_erase_range(struct vector* self,
+                       const size_t index,
+                       const size_t num_elements);
 void vector_set(struct vector* self,
                 const size_t index,
                 const void* val);
@@ -65,6 +210,10 @@ const void* vector_get(const struct vector* self,
                        const size_t index);
 int vector_copy(struct vector* self,
                 const struct vector* source);
+int vector_set_shared(struct vector* self,
+                      const int enable);
+int vector_unshare(struct vector* self);
+int vector_is_shared(const struct vector* self);
 int vector_join(struct vector* self,
                 const struct vector* other_vector);
 void vector_move(struct vector* self,
@@ -75,4 +224,75 @@ void vector_print(const struct vector* self,
 /* Funktionspekare: */
 extern void (*vector_clear)(struct vector* self);
 
+/*******************************************************************************
+* vector_capacity: Returnerar vektorns kapacitet (antalet element som ryms
+*                  utan omallokering). Fr vektorer i den interna bufferten
+*                  berknas kapaciteten frn buffertens storlek, eftersom
+*                  medlemmen capacity d delar minne med elementen.
+*                  - self: Pekare till vektorn.
+*******************************************************************************/
+static inline size_t vector_capacity(const struct vector* self)
+{
+   if (self->data.raw == (const void*)self->small.raw)
+   {
+      return VECTOR_SMALL_SIZE / self->ops->element_size;
+   }
+   return self->capacity;
+}
+
+/*******************************************************************************
+* VECTOR_DEFINE_TYPED: Genererar typade inline-funktioner fr en given datatyp,
+*                      exempelvis vector_int_get och vector_double_push.
+*                      Funktionerna kontrollerar varken datatyp eller index,
+*                      vilket gr att loopar kompileras till direkt indexerad
+*                      lsning och skrivning. Anroparen ansvarar fr att
+*                      vektorn har rtt datatyp och att index r giltigt.
+*                      En vektor vars flt delas (se vector_set_shared) mste
+*                      gras unik via vector_unshare innan den ndras via
+*                      vector_xxx_set eller fltpekaren.
+*                      - name  : Namnsuffix fr de genererade funktionerna.
+*                      - type  : Elementens datatyp.
+*                      - member: Motsvarande medlem i union vector_ptr.
+*******************************************************************************/
+#define VECTOR_DEFINE_TYPED(name, type, member)                              \
+static inline type* vector_##name##_data(const struct vector* self)          \
+{                                                                            \
+   return self->data.member;                                                 \
+}                                                                            \
+                                                                             \
+static inline type vector_##name##_get(const struct vector* self,            \
+                                       const size_t index)                   \
+{                                                                            \
+   return self->data.member[index];                                          \
+}                                                                            \
+                                                                             \
+static inline void vector_##name##_set(struct vector* self,                  \
+                                       const size_t index,                   \
+                                       const type val)                       \
+{                                                                            \
+   self->data.member[index] = val;                                           \
+}                                                                            \
+                                                                             \
+static inline int vector_##name##_push(struct vector* self,                  \
+                                       const type new_element)               \
+{                                                                            \
+   const size_t capacity = self->data.member == self->small.member ?         \
+      VECTOR_SMALL_SIZE / sizeof(type) : self->capacity;                     \
+   if (self->size == capacity) return vector_push(self, &new_element);       \
+   self->data.member[self->size++] = new_element;                            \
+   return 0;                                                                 \
+}
+
+/* Typade inline-funktioner: */
+VECTOR_DEFINE_TYPED(int, int, integer)
+VECTOR_DEFINE_TYPED(double, double, decimal)
+VECTOR_DEFINE_TYPED(unsigned, size_t, natural)
+VECTOR_DEFINE_TYPED(int8, int8_t, int8)
+VECTOR_DEFINE_TYPED(int16, int16_t, int16)
+VECTOR_DEFINE_TYPED(int64, int64_t, int64)
+VECTOR_DEFINE_TYPED(uint8, uint8_t, uint8)
+VECTOR_DEFINE_TYPED(uint16, uint16_t, uint16)
+VECTOR_DEFINE_TYPED(uint32, uint32_t, uint32)
+VECTOR_DEFINE_TYPED(float, float, single)
+
 #endif /* VECTOR_H_ */
\ No newline at end of file
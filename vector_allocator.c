@@ -0,0 +1,358 @@
+/*******************************************************************************
+* vector_allocator.c: Innehller arena- och poolallokerare fr vektorer.
+*******************************************************************************/
+#include "vector_allocator.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_ARENA_DEFAULT_BLOCK_SIZE 1048576 /* Frvald blockstorlek (1 MB). */
+#define VECTOR_MEMORY_POOL_MIN_SIZE 64          /* Minsta storleksklassen. */
+#define VECTOR_MEMORY_POOL_SLAB_SIZE 65536      /* Storlek p block som delas upp. */
+
+/* Avrundar angiven storlek uppt till nrmaste justeringsgrns. */
+#define VECTOR_ALIGN_UP(size) (((size) + VECTOR_ALLOCATOR_ALIGNMENT - 1) & \
+                               ~(size_t)(VECTOR_ALLOCATOR_ALIGNMENT - 1))
+
+/*******************************************************************************
+* vector_arena_block: Block i en arena, dr data fljer direkt efter huvudet.
+*******************************************************************************/
+struct vector_arena_block
+{
+   struct vector_arena_block* next; /* Fregende allokerat block. */
+   size_t size;                     /* Antalet byte fr data. */
+   size_t used;                     /* Antalet anvnda byte. */
+};
+
+/*******************************************************************************
+* vector_memory_pool_slab: Stort block som delas upp i lediga block av en
+*                          storleksklass. Data fljer direkt efter huvudet.
+*******************************************************************************/
+struct vector_memory_pool_slab
+{
+   struct vector_memory_pool_slab* next; /* Fregende allokerat block. */
+};
+
+/* Statiska funktioner: */
+static inline char* vector_arena_data(struct vector_arena_block* block);
+static void* vector_arena_allocate(void* context,
+                                   const size_t size);
+static void* vector_arena_reallocate(void* context,
+                                     void* block,
+                                     const size_t old_size,
+                                     const size_t new_size);
+static void vector_arena_deallocate(void* context,
+                                    void* block,
+                                    const size_t size);
+static size_t vector_memory_pool_class(const size_t size);
+static void* vector_memory_pool_allocate(void* context,
+                                         const size_t size);
+static void* vector_memory_pool_reallocate(void* context,
+                                           void* block,
+                                           const size_t old_size,
+                                           const size_t new_size);
+static void vector_memory_pool_deallocate(void* context,
+                                          void* block,
+                                          const size_t size);
+
+/*******************************************************************************
+* vector_arena_new: Initierar en tom arena. Minne allokeras frst vid behov.
+*                   - self      : Pekare till arenan.
+*                   - block_size: Minsta storlek fr arenans block i byte
+*                                 (noll medfr frvald storlek om 1 MB).
+*******************************************************************************/
+void vector_arena_new(struct vector_arena* self,
+                      const size_t block_size)
+{
+   self->allocator.allocate = &vector_arena_allocate;
+   self->allocator.reallocate = &vector_arena_reallocate;
+   self->allocator.deallocate = &vector_arena_deallocate;
+   self->allocator.context = self;
+   self->blocks = 0;
+   self->block_size = block_size ? VECTOR_ALIGN_UP(block_size) : VECTOR_ARENA_DEFAULT_BLOCK_SIZE;
+   self->last = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_arena_reset: Frigr samtliga flt allokerade via arenan p en gng.
+*                     Det senast allokerade blocket behlls fr teranvndning.
+*                     Vektorer som anvnder arenan fr inte anvndas eftert,
+*                     frutom att initieras p nytt.
+*                     - self: Pekare till arenan.
+*******************************************************************************/
+void vector_arena_reset(struct vector_arena* self)
+{
+   if (!self->blocks) return;
+   struct vector_arena_block* block = self->blocks->next;
+
+   while (block)
+   {
+      struct vector_arena_block* next = block->next;
+      free(block);
+      block = next;
+   }
+
+   self->blocks->next = 0;
+   self->blocks->used = 0;
+   self->last = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_arena_delete: Frigr samtliga block tillhrande arenan.
+*                      - self: Pekare till arenan.
+*******************************************************************************/
+void vector_arena_delete(struct vector_arena* self)
+{
+   vector_arena_reset(self);
+   free(self->blocks);
+   self->blocks = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_memory_pool_new: Initierar en tom pool. Minne allokeras frst vid
+*                         behov.
+*                         - self: Pekare till poolen.
+*******************************************************************************/
+void vector_memory_pool_new(struct vector_memory_pool* self)
+{
+   self->allocator.allocate = &vector_memory_pool_allocate;
+   self->allocator.reallocate = &vector_memory_pool_reallocate;
+   self->allocator.deallocate = &vector_memory_pool_deallocate;
+   self->allocator.context = self;
+
+   for (size_t i = 0; i < VECTOR_MEMORY_POOL_CLASSES; ++i)
+   {
+      self->free_lists[i] = 0;
+   }
+
+   self->slabs = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_memory_pool_delete: Frigr samtliga block tillhrande poolen. Stora
+*                            allokeringar, som gjorts via malloc, mste ha
+*                            frigjorts dessfrinnan.
+*                            - self: Pekare till poolen.
+*******************************************************************************/
+void vector_memory_pool_delete(struct vector_memory_pool* self)
+{
+   struct vector_memory_pool_slab* slab = self->slabs;
+
+   while (slab)
+   {
+      struct vector_memory_pool_slab* next = slab->next;
+      free(slab);
+      slab = next;
+   }
+
+   vector_memory_pool_new(self);
+   return;
+}
+
+/*******************************************************************************
+* vector_arena_data: Returnerar adressen till frsta databyten i ett block.
+*******************************************************************************/
+static inline char* vector_arena_data(struct vector_arena_block* block)
+{
+   return (char*)block + VECTOR_ALIGN_UP(sizeof(struct vector_arena_block));
+}
+
+/*******************************************************************************
+* vector_arena_allocate: Allokerar ett flt frn aktuellt block, eller frn
+*                        ett nytt block om aktuellt block r fullt.
+*******************************************************************************/
+static void* vector_arena_allocate(void* context,
+                                   const size_t size)
+{
+   struct vector_arena* self = (struct vector_arena*)context;
+   const size_t aligned_size = VECTOR_ALIGN_UP(size);
+   struct vector_arena_block* block = self->blocks;
+
+   if (!block || block->size - block->used < aligned_size)
+   {
+      const size_t data_size = aligned_size > self->block_size ? aligned_size : self->block_size;
+      const size_t header_size = VECTOR_ALIGN_UP(sizeof(struct vector_arena_block));
+      if (aligned_size < size || data_size > SIZE_MAX - header_size) return 0;
+
+      block = (struct vector_arena_block*)aligned_alloc(VECTOR_ALLOCATOR_ALIGNMENT, header_size + data_size);
+      if (!block) return 0;
+      block->next = self->blocks;
+      block->size = data_size;
+      block->used = 0;
+      self->blocks = block;
+   }
+
+   self->last = vector_arena_data(block) + block->used;
+   block->used += aligned_size;
+   return self->last;
+}
+
+/*******************************************************************************
+* vector_arena_reallocate: Utkar det senast allokerade fltet p plats om
+*                          det ryms i aktuellt block. Annars allokeras ett
+*                          nytt flt dit innehllet kopieras.
+*******************************************************************************/
+static void* vector_arena_reallocate(void* context,
+                                     void* block,
+                                     const size_t old_size,
+                                     const size_t new_size)
+{
+   struct vector_arena* self = (struct vector_arena*)context;
+
+   if (block == self->last)
+   {
+      const size_t offset = (size_t)((char*)block - vector_arena_data(self->blocks));
+      const size_t aligned_size = VECTOR_ALIGN_UP(new_size);
+
+      if (aligned_size >= new_size && aligned_size <= self->blocks->size - offset)
+      {
+         self->blocks->used = offset + aligned_size;
+         return block;
+      }
+   }
+   else if (new_size <= old_size)
+   {
+      return block;
+   }
+
+   void* copy = vector_arena_allocate(context, new_size);
+   if (!copy) return 0;
+   memcpy(copy, block, old_size < new_size ? old_size : new_size);
+   return copy;
+}
+
+/*******************************************************************************
+* vector_arena_deallocate: terlmnar det senast allokerade fltet till
+*                          aktuellt block. vriga flt frigrs frst nr
+*                          arenan nollstlls.
+*******************************************************************************/
+static void vector_arena_deallocate(void* context,
+                                    void* block,
+                                    const size_t size)
+{
+   struct vector_arena* self = (struct vector_arena*)context;
+   (void)size;
+
+   if (block == self->last)
+   {
+      self->blocks->used = (size_t)((char*)block - vector_arena_data(self->blocks));
+      self->last = 0;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_memory_pool_class: Returnerar storleksklassen fr angiven storlek,
+*                           eller VECTOR_MEMORY_POOL_CLASSES om storleken r
+*                           fr stor fr poolen.
+*******************************************************************************/
+static size_t vector_memory_pool_class(const size_t size)
+{
+   size_t class_index = 0;
+   size_t class_size = VECTOR_MEMORY_POOL_MIN_SIZE;
+
+   while (class_size < size && class_index < VECTOR_MEMORY_POOL_CLASSES)
+   {
+      class_size <<= 1;
+      class_index++;
+   }
+   return class_index;
+}
+
+/*******************************************************************************
+* vector_memory_pool_allocate: Tar ett ledigt block ur listan fr aktuell
+*                              storleksklass. Om listan r tom delas ett nytt
+*                              stort block upp i lediga block.
+*******************************************************************************/
+static void* vector_memory_pool_allocate(void* context,
+                                         const size_t size)
+{
+   struct vector_memory_pool* self = (struct vector_memory_pool*)context;
+   const size_t class_index = vector_memory_pool_class(size);
+   if (class_index == VECTOR_MEMORY_POOL_CLASSES)
+   {
+      const struct vector_allocator* heap = vector_allocator_heap();
+      return heap->allocate(heap->context, size);
+   }
+
+   if (!self->free_lists[class_index])
+   {
+      const size_t class_size = (size_t)VECTOR_MEMORY_POOL_MIN_SIZE << class_index;
+      const size_t header_size = VECTOR_ALIGN_UP(sizeof(struct vector_memory_pool_slab));
+      struct vector_memory_pool_slab* slab =
+         (struct vector_memory_pool_slab*)aligned_alloc(VECTOR_ALLOCATOR_ALIGNMENT,
+                                                        header_size + VECTOR_MEMORY_POOL_SLAB_SIZE);
+      if (!slab) return 0;
+      slab->next = self->slabs;
+      self->slabs = slab;
+
+      char* data = (char*)slab + header_size;
+      for (size_t offset = 0; offset + class_size <= VECTOR_MEMORY_POOL_SLAB_SIZE; offset += class_size)
+      {
+         *(void**)(data + offset) = self->free_lists[class_index];
+         self->free_lists[class_index] = data + offset;
+      }
+   }
+
+   void* block = self->free_lists[class_index];
+   self->free_lists[class_index] = *(void**)block;
+   return block;
+}
+
+/*******************************************************************************
+* vector_memory_pool_reallocate: Behller blocket om den nya storleken ryms
+*                                i samma storleksklass, annars flyttas
+*                                innehllet till ett block av rtt klass.
+*******************************************************************************/
+static void* vector_memory_pool_reallocate(void* context,
+                                           void* block,
+                                           const size_t old_size,
+                                           const size_t new_size)
+{
+   const size_t old_class = vector_memory_pool_class(old_size);
+   const size_t new_class = vector_memory_pool_class(new_size);
+
+   if (old_class == VECTOR_MEMORY_POOL_CLASSES && new_class == VECTOR_MEMORY_POOL_CLASSES)
+   {
+      const struct vector_allocator* heap = vector_allocator_heap();
+      return heap->reallocate(heap->context, block, old_size, new_size);
+   }
+   else if (old_class == new_class)
+   {
+      return block;
+   }
+
+   void* copy = vector_memory_pool_allocate(context, new_size);
+   if (!copy) return 0;
+   memcpy(copy, block, old_size < new_size ? old_size : new_size);
+   vector_memory_pool_deallocate(context, block, old_size);
+   return copy;
+}
+
+/*******************************************************************************
+* vector_memory_pool_deallocate: Lgger tillbaka blocket i listan fr dess
+*                                storleksklass.
+*******************************************************************************/
+static void vector_memory_pool_deallocate(void* context,
+                                          void* block,
+                                          const size_t size)
+{
+   struct vector_memory_pool* self = (struct vector_memory_pool*)context;
+   const size_t class_index = vector_memory_pool_class(size);
+
+   if (class_index == VECTOR_MEMORY_POOL_CLASSES)
+   {
+      const struct vector_allocator* heap = vector_allocator_heap();
+      heap->deallocate(heap->context, block, size);
+   }
+   else
+   {
+      *(void**)block = self->free_lists[class_index];
+      self->free_lists[class_index] = block;
+   }
+   return;
+}
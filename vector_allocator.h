@@ -0,0 +1,62 @@
+/*******************************************************************************
+* vector_allocator.h: Allokerare som kan anvndas fr vektorers flt via
+*                     vector_set_allocator eller vector_allocator_set_default,
+*                     fr att undvika fragmentering av heapen nr ett stort
+*                     antal kortlivade vektorer skapas och raderas.
+*
+*                     - vector_arena: Allokerar genom att flytta fram en
+*                       pekare i stora block. Enskilda flt frigrs inte
+*                       (frutom det senast allokerade), utan allt minne
+*                       frigrs samtidigt via vector_arena_reset.
+*                     - vector_memory_pool: Delar in allokeringar i
+*                       storleksklasser (tvpotenser frn 64 byte till
+*                       64 kB) med en lista ver lediga block per klass.
+*                       Strre allokeringar sker via vector_allocator_heap.
+*
+*                     Bda allokerarna returnerar block justerade till
+*                     VECTOR_ALIGNMENT byte.
+*
+*                     Ingen av allokerarna r trdsker. Allokeraren mste
+*                     leva lngre n samtliga vektorer som anvnder den.
+*******************************************************************************/
+#ifndef VECTOR_ALLOCATOR_H_
+#define VECTOR_ALLOCATOR_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_ALLOCATOR_ALIGNMENT VECTOR_ALIGNMENT /* Justering fr samtliga block i byte. */
+#define VECTOR_MEMORY_POOL_CLASSES 11                /* Antalet storleksklasser (64 B - 64 kB). */
+
+/*******************************************************************************
+* vector_arena: Arenaallokerare, dr minne tas frn stora block i tur och
+*               ordning och frigrs samtidigt.
+*******************************************************************************/
+struct vector_arena
+{
+   struct vector_allocator allocator; /* Allokerare som anvnds av vektorer. */
+   struct vector_arena_block* blocks; /* Allokerade block, senaste frst. */
+   size_t block_size;                 /* Minsta storlek fr nya block. */
+   void* last;                        /* Senast allokerade flt. */
+};
+
+/*******************************************************************************
+* vector_memory_pool: Poolallokerare med storleksklasser.
+*******************************************************************************/
+struct vector_memory_pool
+{
+   struct vector_allocator allocator;                  /* Allokerare som anvnds av vektorer. */
+   void* free_lists[VECTOR_MEMORY_POOL_CLASSES];       /* Lediga block per storleksklass. */
+   struct vector_memory_pool_slab* slabs;              /* Stora block som delats upp. */
+};
+
+/* Externa funktioner: */
+void vector_arena_new(struct vector_arena* self,
+                      const size_t block_size);
+void vector_arena_reset(struct vector_arena* self);
+void vector_arena_delete(struct vector_arena* self);
+void vector_memory_pool_new(struct vector_memory_pool* self);
+void vector_memory_pool_delete(struct vector_memory_pool* self);
+
+#endif /* VECTOR_ALLOCATOR_H_ */
@@ -0,0 +1,476 @@
+/*******************************************************************************
+* vector_compressed.c: Innehller funktioner fr komprimering, avkodning och
+*                      genomlsning av bitpackade heltalsvektorer.
+*******************************************************************************/
+#include "vector_compressed.h"
+#include <string.h>
+
+/* Statiska funktioner: */
+static inline int vector_compressed_supported(const enum vector_type type);
+static inline uint64_t vector_compressed_key(const struct vector* source,
+                                             const size_t index);
+static void vector_compressed_store(const enum vector_type type,
+                                    void* dest,
+                                    const uint64_t* keys,
+                                    const size_t count);
+static inline unsigned vector_compressed_bits(const uint64_t value);
+static inline size_t vector_compressed_words(const size_t count,
+                                             const unsigned bits);
+static inline void vector_compressed_pack(uint64_t* words,
+                                          const size_t position,
+                                          const uint64_t value,
+                                          const unsigned bits);
+static inline uint64_t vector_compressed_unpack(const uint64_t* words,
+                                                const size_t position,
+                                                const unsigned bits);
+static inline uint64_t vector_compressed_window(const uint64_t* words,
+                                                const size_t position);
+static inline size_t vector_compressed_count(const struct vector_compressed* self,
+                                             const size_t block);
+static void vector_compressed_analyze(struct vector_compressed_block* block,
+                                      const uint64_t* keys,
+                                      const size_t count);
+static size_t vector_compressed_decode_keys(const struct vector_compressed* self,
+                                            const size_t block,
+                                            uint64_t* keys);
+
+/*******************************************************************************
+* vector_compress: Komprimerar angiven vektor blockvis. Kodningen vljs per
+*                  block: deltalge fr sorterade block dr det ger frre
+*                  bitar per element, annars referenslge. Komprimeringen
+*                  sker i tv pass, dr frsta passet bestmmer blockens
+*                  kodning och drmed exakt minnesbehov.
+*                  - self  : Pekare till den komprimerade vektorn.
+*                  - source: Pekare till vektorn som skall komprimeras
+*                            (valfri heltalstyp).
+*******************************************************************************/
+int vector_compress(struct vector_compressed* self,
+                    const struct vector* source)
+{
+   uint64_t keys[VECTOR_COMPRESSED_BLOCK_SIZE];
+
+   self->type = source->type;
+   self->size = 0;
+   self->num_blocks = 0;
+   self->blocks = 0;
+   self->words = 0;
+   self->num_words = 0;
+
+   if (!vector_compressed_supported(source->type)) return 1;
+   if (!source->size) return 0;
+
+   const size_t num_blocks = (source->size + VECTOR_COMPRESSED_BLOCK_SIZE - 1) / VECTOR_COMPRESSED_BLOCK_SIZE;
+   self->blocks = (struct vector_compressed_block*)malloc(num_blocks * sizeof(struct vector_compressed_block));
+   if (!self->blocks) return 1;
+   self->size = source->size;
+   self->num_blocks = num_blocks;
+
+   for (size_t i = 0; i < num_blocks; ++i)
+   {
+      const size_t first = i * VECTOR_COMPRESSED_BLOCK_SIZE;
+      const size_t count = vector_compressed_count(self, i);
+
+      for (size_t j = 0; j < count; ++j) keys[j] = vector_compressed_key(source, first + j);
+      vector_compressed_analyze(&self->blocks[i], keys, count);
+      self->blocks[i].offset = self->num_words;
+      self->num_words += vector_compressed_words(count, self->blocks[i].bits);
+   }
+
+   /* Ett extra utfyllnadsord gr att avkodningen alltid kan lsa nsta ord: */
+   self->words = (uint64_t*)calloc(self->num_words + 1, sizeof(uint64_t));
+   if (!self->words)
+   {
+      vector_compressed_delete(self);
+      return 1;
+   }
+
+   for (size_t i = 0; i < num_blocks; ++i)
+   {
+      const struct vector_compressed_block* block = &self->blocks[i];
+      const size_t first = i * VECTOR_COMPRESSED_BLOCK_SIZE;
+      const size_t count = vector_compressed_count(self, i);
+      uint64_t* words = self->words + block->offset;
+      uint64_t previous = block->reference;
+      if (!block->bits) continue;
+
+      for (size_t j = 0; j < count; ++j)
+      {
+         const uint64_t key = vector_compressed_key(source, first + j);
+         const uint64_t value = block->mode == VECTOR_COMPRESSED_DELTA ?
+            key - previous : key - block->reference;
+         vector_compressed_pack(words, j * block->bits, value, block->bits);
+         previous = key;
+      }
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_compressed_delete: Frigr minnet fr angiven komprimerad vektor och
+*                           nollstller den.
+*                           - self: Pekare till den komprimerade vektorn.
+*******************************************************************************/
+void vector_compressed_delete(struct vector_compressed* self)
+{
+   free(self->blocks);
+   free(self->words);
+   self->blocks = 0;
+   self->words = 0;
+   self->size = 0;
+   self->num_blocks = 0;
+   self->num_words = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_decompress: Avkodar samtliga element till en vanlig vektor, dr
+*                    blocken avkodas direkt in i vektorns flt. Eventuellt
+*                    tidigare innehll i mlvektorn raderas.
+*                    - self: Pekare till den komprimerade vektorn.
+*                    - dest: Pekare till mlvektorn.
+*******************************************************************************/
+int vector_decompress(const struct vector_compressed* self,
+                      struct vector* dest)
+{
+   if (dest->flags & VECTOR_FLAG_READONLY) return 1;
+   vector_delete(dest);
+   vector_new(dest, self->type);
+   if (vector_resize(dest, self->size)) return 1;
+
+   for (size_t i = 0; i < self->num_blocks; ++i)
+   {
+      vector_compressed_decode_block(self, i, (char*)dest->data.raw +
+         i * VECTOR_COMPRESSED_BLOCK_SIZE * dest->ops->element_size);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_compressed_get: Lser elementet p angivet index via blockets huvud.
+*                        I referenslge lses elementet direkt, medan
+*                        deltalge krver summering frn blockets brjan.
+*                        - self : Pekare till den komprimerade vektorn.
+*                        - index: Index till elementet.
+*                        - value: Pekare till lagringsplats fr elementet.
+*******************************************************************************/
+int vector_compressed_get(const struct vector_compressed* self,
+                          const size_t index,
+                          void* value)
+{
+   if (index >= self->size) return 1;
+   const struct vector_compressed_block* block = &self->blocks[index / VECTOR_COMPRESSED_BLOCK_SIZE];
+   const size_t position = index % VECTOR_COMPRESSED_BLOCK_SIZE;
+   const uint64_t* words = self->words + block->offset;
+   uint64_t key = block->reference;
+
+   if (block->mode == VECTOR_COMPRESSED_DELTA)
+   {
+      for (size_t i = 1; i <= position; ++i)
+      {
+         key += vector_compressed_unpack(words, i * block->bits, block->bits);
+      }
+   }
+   else
+   {
+      key += vector_compressed_unpack(words, position * block->bits, block->bits);
+   }
+
+   vector_compressed_store(self->type, value, &key, 1);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_compressed_decode_block: Avkodar angivet block till en buffert och
+*                                 returnerar antalet avkodade element.
+*                                 - self : Pekare till den komprimerade vektorn.
+*                                 - block: Blockets nummer.
+*                                 - dest : Pekare till bufferten, som mste
+*                                          rymma VECTOR_COMPRESSED_BLOCK_SIZE
+*                                          element av vektorns datatyp.
+*******************************************************************************/
+size_t vector_compressed_decode_block(const struct vector_compressed* self,
+                                      const size_t block,
+                                      void* dest)
+{
+   uint64_t keys[VECTOR_COMPRESSED_BLOCK_SIZE];
+   const size_t count = vector_compressed_decode_keys(self, block, keys);
+
+   vector_compressed_store(self->type, dest, keys, count);
+   return count;
+}
+
+/*******************************************************************************
+* vector_compressed_scan: Avkodar ett block i taget till en intern buffert och
+*                         anropar angiven funktion fr varje block, vilket
+*                         ger sekventiell genomlsning utan att hela vektorn
+*                         avkodas.
+*                         - self    : Pekare till den komprimerade vektorn.
+*                         - callback: Funktion som anropas med blockets
+*                                     avkodade element och deras antal.
+*                         - context : Data som passeras till funktionen.
+*******************************************************************************/
+int vector_compressed_scan(const struct vector_compressed* self,
+                           void (*callback)(const void* data,
+                                            const size_t size,
+                                            void* context),
+                           void* context)
+{
+   uint64_t buffer[VECTOR_COMPRESSED_BLOCK_SIZE];
+
+   if (!callback) return 1;
+
+   for (size_t i = 0; i < self->num_blocks; ++i)
+   {
+      const size_t count = vector_compressed_decode_block(self, i, buffer);
+      callback(buffer, count, context);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_compressed_bytes: Returnerar antalet byte som den komprimerade
+*                          vektorn upptar, inklusive blockhuvuden.
+*                          - self: Pekare till den komprimerade vektorn.
+*******************************************************************************/
+size_t vector_compressed_bytes(const struct vector_compressed* self)
+{
+   return sizeof(*self) + self->num_blocks * sizeof(struct vector_compressed_block) +
+          (self->num_words + 1) * sizeof(uint64_t);
+}
+
+/*******************************************************************************
+* vector_compressed_ratio: Returnerar kvoten mellan elementens okomprimerade
+*                          storlek och den komprimerade vektorns storlek.
+*                          - self: Pekare till den komprimerade vektorn.
+*******************************************************************************/
+double vector_compressed_ratio(const struct vector_compressed* self)
+{
+   return (double)(self->size * vector_ops(self->type)->element_size) /
+          vector_compressed_bytes(self);
+}
+
+/*******************************************************************************
+* vector_compressed_supported: Indikerar ifall angiven datatyp r en
+*                              heltalstyp, som kan komprimeras.
+*******************************************************************************/
+static inline int vector_compressed_supported(const enum vector_type type)
+{
+   return type < VECTOR_TYPE_NONE && type != VECTOR_TYPE_DOUBLE && type != VECTOR_TYPE_FLOAT;
+}
+
+/*******************************************************************************
+* vector_compressed_key: Returnerar elementet p angivet index som osignerad
+*                        nyckel, dr signerade heltal fr teckenbiten
+*                        inverterad.
+*******************************************************************************/
+static inline uint64_t vector_compressed_key(const struct vector* source,
+                                             const size_t index)
+{
+   switch (source->type)
+   {
+      case VECTOR_TYPE_INTEGER: return (uint32_t)source->data.integer[index] ^ 0x80000000U;
+      case VECTOR_TYPE_INT8: return (uint8_t)source->data.int8[index] ^ 0x80U;
+      case VECTOR_TYPE_INT16: return (uint16_t)source->data.int16[index] ^ 0x8000U;
+      case VECTOR_TYPE_INT64: return (uint64_t)source->data.int64[index] ^ 0x8000000000000000ULL;
+      case VECTOR_TYPE_UINT8: return source->data.uint8[index];
+      case VECTOR_TYPE_UINT16: return source->data.uint16[index];
+      case VECTOR_TYPE_UINT32: return source->data.uint32[index];
+      default: return (uint64_t)source->data.natural[index];
+   }
+}
+
+/* Omvandlar nycklar till element av en given datatyp genom att teckenbiten sign terstlls. */
+#define VECTOR_COMPRESSED_STORE_LOOP(type, key_type, sign)                      \
+{                                                                               \
+   type* values = (type*)dest;                                                  \
+   for (size_t i = 0; i < count; ++i) values[i] = (type)((key_type)keys[i] ^ (sign)); \
+}
+
+/*******************************************************************************
+* vector_compressed_store: Omvandlar nycklar till element av angiven datatyp,
+*                          motsvarande vector_compressed_key.
+*                          - type : Elementens datatyp.
+*                          - dest : Pekare till frsta elementet.
+*                          - keys : Pekare till nycklarna.
+*                          - count: Antalet nycklar.
+*******************************************************************************/
+static void vector_compressed_store(const enum vector_type type,
+                                    void* dest,
+                                    const uint64_t* keys,
+                                    const size_t count)
+{
+   switch (type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_COMPRESSED_STORE_LOOP(int, uint32_t, 0x80000000U) break;
+      case VECTOR_TYPE_INT8: VECTOR_COMPRESSED_STORE_LOOP(int8_t, uint8_t, 0x80U) break;
+      case VECTOR_TYPE_INT16: VECTOR_COMPRESSED_STORE_LOOP(int16_t, uint16_t, 0x8000U) break;
+      case VECTOR_TYPE_INT64: VECTOR_COMPRESSED_STORE_LOOP(int64_t, uint64_t, 0x8000000000000000ULL) break;
+      case VECTOR_TYPE_UINT8: VECTOR_COMPRESSED_STORE_LOOP(uint8_t, uint8_t, 0U) break;
+      case VECTOR_TYPE_UINT16: VECTOR_COMPRESSED_STORE_LOOP(uint16_t, uint16_t, 0U) break;
+      case VECTOR_TYPE_UINT32: VECTOR_COMPRESSED_STORE_LOOP(uint32_t, uint32_t, 0U) break;
+      default: VECTOR_COMPRESSED_STORE_LOOP(size_t, size_t, 0U) break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_compressed_bits: Returnerar antalet bitar som krvs fr angivet vrde.
+*******************************************************************************/
+static inline unsigned vector_compressed_bits(const uint64_t value)
+{
+   return value ? 64 - (unsigned)__builtin_clzll(value) : 0;
+}
+
+/*******************************************************************************
+* vector_compressed_words: Returnerar antalet 64-bitars ord som krvs fr
+*                          angivet antal element av angiven bitbredd.
+*******************************************************************************/
+static inline size_t vector_compressed_words(const size_t count,
+                                             const unsigned bits)
+{
+   return (count * bits + 63) / 64;
+}
+
+/*******************************************************************************
+* vector_compressed_pack: Skriver ett vrde p angiven bitposition. Ett vrde
+*                         som korsar en ordgrns delas mellan tv ord.
+*******************************************************************************/
+static inline void vector_compressed_pack(uint64_t* words,
+                                          const size_t position,
+                                          const uint64_t value,
+                                          const unsigned bits)
+{
+   const size_t word = position / 64;
+   const unsigned shift = position % 64;
+   words[word] |= value << shift;
+   if (shift + bits > 64) words[word + 1] |= value >> (64 - shift);
+   return;
+}
+
+/*******************************************************************************
+* vector_compressed_unpack: Lser ett vrde frn angiven bitposition.
+*******************************************************************************/
+static inline uint64_t vector_compressed_unpack(const uint64_t* words,
+                                                const size_t position,
+                                                const unsigned bits)
+{
+   if (!bits) return 0;
+   const size_t word = position / 64;
+   const unsigned shift = position % 64;
+   uint64_t value = words[word] >> shift;
+   if (shift + bits > 64) value |= words[word + 1] << (64 - shift);
+   return bits < 64 ? value & (((uint64_t)1 << bits) - 1) : value;
+}
+
+/*******************************************************************************
+* vector_compressed_window: Returnerar 64 bitar med start p angiven
+*                           bitposition utan villkorssatser. Nsta ord lses
+*                           alltid, vilket krver ett extra utfyllnadsord
+*                           efter sista blocket. Skiftet sker i tv steg fr
+*                           att undvika odefinierat skift med 64 bitar.
+*******************************************************************************/
+static inline uint64_t vector_compressed_window(const uint64_t* words,
+                                                const size_t position)
+{
+   const size_t word = position / 64;
+   const unsigned shift = position % 64;
+   return (words[word] >> shift) | ((words[word + 1] << 1) << (63 - shift));
+}
+
+/*******************************************************************************
+* vector_compressed_count: Returnerar antalet element i angivet block.
+*******************************************************************************/
+static inline size_t vector_compressed_count(const struct vector_compressed* self,
+                                             const size_t block)
+{
+   const size_t first = block * VECTOR_COMPRESSED_BLOCK_SIZE;
+   return self->size - first < VECTOR_COMPRESSED_BLOCK_SIZE ?
+      self->size - first : VECTOR_COMPRESSED_BLOCK_SIZE;
+}
+
+/*******************************************************************************
+* vector_compressed_analyze: Vljer kodning och bitbredd fr ett block.
+*                            Deltalge vljs enbart fr block sorterade i
+*                            stigande ordning dr strsta differensen mellan
+*                            intilliggande element krver frre bitar n
+*                            spannet mellan minsta och strsta vrde.
+*                            - block: Pekare till blockets huvud.
+*                            - keys : Blockets element som nycklar.
+*                            - count: Antalet element i blocket.
+*******************************************************************************/
+static void vector_compressed_analyze(struct vector_compressed_block* block,
+                                      const uint64_t* keys,
+                                      const size_t count)
+{
+   uint64_t min = keys[0], max = keys[0], max_delta = 0;
+   int sorted = 1;
+
+   for (size_t i = 1; i < count; ++i)
+   {
+      if (keys[i] < min) min = keys[i];
+      if (keys[i] > max) max = keys[i];
+      if (keys[i] < keys[i - 1]) sorted = 0;
+      else if (keys[i] - keys[i - 1] > max_delta) max_delta = keys[i] - keys[i - 1];
+   }
+
+   const unsigned for_bits = vector_compressed_bits(max - min);
+   const unsigned delta_bits = vector_compressed_bits(max_delta);
+
+   if (sorted && delta_bits < for_bits)
+   {
+      block->mode = VECTOR_COMPRESSED_DELTA;
+      block->bits = (uint8_t)delta_bits;
+      block->reference = keys[0];
+   }
+   else
+   {
+      block->mode = VECTOR_COMPRESSED_FOR;
+      block->bits = (uint8_t)for_bits;
+      block->reference = min;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_compressed_decode_keys: Avkodar angivet block till nycklar och
+*                                returnerar antalet avkodade element. Varje
+*                                element lses via ett 64-bitars fnster,
+*                                vilket undviker villkorssatser i loopen.
+*                                - self : Pekare till den komprimerade vektorn.
+*                                - block: Blockets nummer.
+*                                - keys : Buffert fr avkodade nycklar.
+*******************************************************************************/
+static size_t vector_compressed_decode_keys(const struct vector_compressed* self,
+                                            const size_t block,
+                                            uint64_t* keys)
+{
+   const struct vector_compressed_block* header = &self->blocks[block];
+   const size_t count = vector_compressed_count(self, block);
+   const uint64_t* words = self->words + header->offset;
+   const unsigned bits = header->bits;
+
+   if (!bits)
+   {
+      for (size_t i = 0; i < count; ++i) keys[i] = header->reference;
+      return count;
+   }
+
+   const uint64_t mask = bits < 64 ? ((uint64_t)1 << bits) - 1 : ~(uint64_t)0;
+
+   if (header->mode == VECTOR_COMPRESSED_DELTA)
+   {
+      uint64_t sum = header->reference;
+      for (size_t i = 0, position = 0; i < count; ++i, position += bits)
+      {
+         keys[i] = sum += vector_compressed_window(words, position) & mask;
+      }
+   }
+   else
+   {
+      for (size_t i = 0, position = 0; i < count; ++i, position += bits)
+      {
+         keys[i] = header->reference + (vector_compressed_window(words, position) & mask);
+      }
+   }
+   return count;
+}
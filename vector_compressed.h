@@ -0,0 +1,88 @@
+/*******************************************************************************
+* vector_compressed.h: Komprimerad lagring av heltalsvektorer (samtliga
+*                      heltalstyper). Elementen delas upp i block om
+*                      VECTOR_COMPRESSED_BLOCK_SIZE element, som vart och ett
+*                      bitpackas med det minsta antal bitar per element som
+*                      krvs i ett av tv lgen:
+*
+*                      - Referenslge (frame of reference): Varje element
+*                        lagras som differensen mot blockets minsta vrde.
+*                        Lmpligt fr exempelvis sm id-nummer.
+*                      - Deltalge: Varje element lagras som differensen mot
+*                        fregende element. Anvnds enbart fr block som r
+*                        sorterade i stigande ordning, exempelvis tidsstmplar.
+*
+*                      Lget vljs per block, dr det lge som ger minst antal
+*                      bitar anvnds. Varje block har ett eget huvud med
+*                      referensvrde, bitbredd och position, vilket ger
+*                      direkttkomst till godtyckligt element. Vid sekventiell
+*                      genomlsning avkodas ett block i taget till en buffert.
+*
+*                      Signerade heltal omvandlas till osignerade nycklar med
+*                      inverterad teckenbit, vilket bevarar ordningen.
+*******************************************************************************/
+#ifndef VECTOR_COMPRESSED_H_
+#define VECTOR_COMPRESSED_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include <stdint.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_COMPRESSED_BLOCK_SIZE 128 /* Antalet element per block. */
+
+/*******************************************************************************
+* vector_compressed_mode: Kodning av ett block.
+*******************************************************************************/
+enum vector_compressed_mode
+{
+   VECTOR_COMPRESSED_FOR,  /* Differenser mot blockets minsta vrde. */
+   VECTOR_COMPRESSED_DELTA /* Differenser mot fregende element. */
+};
+
+/*******************************************************************************
+* vector_compressed_block: Huvud fr ett komprimerat block.
+*******************************************************************************/
+struct vector_compressed_block
+{
+   uint64_t reference; /* Minsta vrde (referenslge) eller frsta vrde (deltalge). */
+   size_t offset;      /* Position fr blockets frsta ord i fltet words. */
+   uint8_t bits;       /* Antalet bitar per element (0 - 64). */
+   uint8_t mode;       /* Blockets kodning (se vector_compressed_mode). */
+};
+
+/*******************************************************************************
+* vector_compressed: Komprimerad heltalsvektor, som inte kan ndras efter att
+*                    den skapats.
+*******************************************************************************/
+struct vector_compressed
+{
+   enum vector_type type;                  /* Elementens datatyp. */
+   size_t size;                            /* Antalet element. */
+   size_t num_blocks;                      /* Antalet block. */
+   struct vector_compressed_block* blocks; /* Blockhuvuden. */
+   uint64_t* words;                        /* Bitpackade element. */
+   size_t num_words;                       /* Antalet 64-bitars ord. */
+};
+
+/* Externa funktioner: */
+int vector_compress(struct vector_compressed* self,
+                    const struct vector* source);
+void vector_compressed_delete(struct vector_compressed* self);
+int vector_decompress(const struct vector_compressed* self,
+                      struct vector* dest);
+int vector_compressed_get(const struct vector_compressed* self,
+                          const size_t index,
+                          void* value);
+size_t vector_compressed_decode_block(const struct vector_compressed* self,
+                                      const size_t block,
+                                      void* dest);
+int vector_compressed_scan(const struct vector_compressed* self,
+                           void (*callback)(const void* data,
+                                            const size_t size,
+                                            void* context),
+                           void* context);
+size_t vector_compressed_bytes(const struct vector_compressed* self);
+double vector_compressed_ratio(const struct vector_compressed* self);
+
+#endif /* VECTOR_COMPRESSED_H_ */
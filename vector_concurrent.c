@@ -0,0 +1,235 @@
+/*******************************************************************************
+* vector_concurrent.c: Innehller funktioner fr segmenterade vektorer med
+*                      samtidig inmatning frn flera trdar.
+*******************************************************************************/
+#include "vector_concurrent.h"
+#include "vector_stats.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Statiska funktioner: */
+static inline size_t vector_concurrent_segment(const size_t index,
+                                               size_t* offset);
+static inline size_t vector_concurrent_capacity(const size_t segment);
+static inline atomic_uchar* vector_concurrent_flags(const struct vector_concurrent* self,
+                                                   void* segment,
+                                                   const size_t capacity);
+static void* vector_concurrent_allocate(struct vector_concurrent* self,
+                                        const size_t segment);
+
+/*******************************************************************************
+* vector_concurrent_new: Initierar ny tom segmenterad vektor till angiven
+*                        datatyp. Segment allokeras frst vid behov.
+*                        - self: Pekare till vektorn.
+*                        - type: Vektorns datatyp.
+*******************************************************************************/
+void vector_concurrent_new(struct vector_concurrent* self,
+                           const enum vector_type type)
+{
+   self->type = type < VECTOR_TYPE_NONE ? type : VECTOR_TYPE_NONE;
+   self->ops = vector_ops(self->type);
+   atomic_init(&self->reserved, 0);
+
+   for (size_t i = 0; i < VECTOR_CONCURRENT_SEGMENTS; ++i)
+   {
+      atomic_init(&self->segments[i], 0);
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_concurrent_delete: Frigr samtliga segment och nollstller vektorn.
+*                           Ingen annan trd fr anvnda vektorn under tiden.
+*                           - self: Pekare till vektorn.
+*******************************************************************************/
+void vector_concurrent_delete(struct vector_concurrent* self)
+{
+   for (size_t i = 0; i < VECTOR_CONCURRENT_SEGMENTS; ++i)
+   {
+      void* segment = atomic_load_explicit(&self->segments[i], memory_order_relaxed);
+      if (segment)
+      {
+         free(segment);
+         VECTOR_STATS_DEALLOCATE(vector_concurrent_capacity(i) * (self->ops->element_size + 1));
+      }
+      atomic_store_explicit(&self->segments[i], 0, memory_order_relaxed);
+   }
+   atomic_store_explicit(&self->reserved, 0, memory_order_relaxed);
+   return;
+}
+
+/*******************************************************************************
+* vector_concurrent_push: Lgger till ett nytt element och publicerar det.
+*                         Funktionen kan anropas samtidigt frn flera trdar
+*                         och anvnder inga ls; indexet reserveras atomrt
+*                         och elementets adress ndras aldrig drefter. Om ett
+*                         segment inte kan allokeras frblir det reserverade
+*                         indexet opublicerat.
+*                         - self       : Pekare till vektorn.
+*                         - new_element: Pekare till det nya elementet.
+*                         - index      : Pekare till lagringsplats fr det
+*                                        nya elementets index (nullpekare
+*                                        om indexet inte behvs).
+*******************************************************************************/
+int vector_concurrent_push(struct vector_concurrent* self,
+                           const void* new_element,
+                           size_t* index)
+{
+   size_t offset;
+   if (!self->ops->element_size) return 1;
+
+   const size_t i = atomic_fetch_add_explicit(&self->reserved, 1, memory_order_relaxed);
+   const size_t segment = vector_concurrent_segment(i, &offset);
+   if (segment >= VECTOR_CONCURRENT_SEGMENTS) return 1;
+
+   void* data = atomic_load_explicit(&self->segments[segment], memory_order_acquire);
+   if (!data && !(data = vector_concurrent_allocate(self, segment))) return 1;
+
+   self->ops->assign((char*)data + offset * self->ops->element_size, new_element);
+   atomic_store_explicit(&vector_concurrent_flags(self, data, vector_concurrent_capacity(segment))[offset],
+                         1, memory_order_release);
+   if (index) *index = i;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_concurrent_get: Returnerar pekare till publicerat element p angivet
+*                        index, eller nullpekare om elementet inte finns
+*                        eller nnu inte har publicerats. Lsningen sker
+*                        utan vntan och kan ske samtidigt med inmatning.
+*                        - self : Pekare till vektorn.
+*                        - index: Index till elementet.
+*******************************************************************************/
+const void* vector_concurrent_get(const struct vector_concurrent* self,
+                                  const size_t index)
+{
+   size_t offset;
+   const size_t segment = vector_concurrent_segment(index, &offset);
+   if (segment >= VECTOR_CONCURRENT_SEGMENTS) return 0;
+
+   void* data = atomic_load_explicit(&self->segments[segment], memory_order_acquire);
+   if (!data) return 0;
+
+   atomic_uchar* flags = vector_concurrent_flags(self, data, vector_concurrent_capacity(segment));
+   if (!atomic_load_explicit(&flags[offset], memory_order_acquire)) return 0;
+   return (const char*)data + offset * self->ops->element_size;
+}
+
+/*******************************************************************************
+* vector_concurrent_size: Returnerar antalet reserverade index. Samtliga r
+*                         publicerade frst nr pgende inmatning r klar.
+*                         - self: Pekare till vektorn.
+*******************************************************************************/
+size_t vector_concurrent_size(const struct vector_concurrent* self)
+{
+   return atomic_load_explicit(&self->reserved, memory_order_acquire);
+}
+
+/*******************************************************************************
+* vector_concurrent_freeze: verfr samtliga element till en vanlig vektor
+*                           via en blockkopiering per segment, varefter den
+*                           segmenterade vektorn tms. Eventuellt tidigare
+*                           innehll i mlvektorn raderas. Ingen inmatning fr
+*                           pg under tiden. Om ngot reserverat element
+*                           saknas lmnas bda vektorerna ofrndrade.
+*                           - self: Pekare till den segmenterade vektorn.
+*                           - dest: Pekare till mlvektorn.
+*******************************************************************************/
+int vector_concurrent_freeze(struct vector_concurrent* self,
+                             struct vector* dest)
+{
+   const size_t size = vector_concurrent_size(self);
+   size_t remaining = size;
+
+   for (size_t i = 0; i < size; ++i)
+   {
+      if (!vector_concurrent_get(self, i)) return 1;
+   }
+
+   if (dest->flags & VECTOR_FLAG_READONLY) return 1;
+   vector_delete(dest);
+   vector_new(dest, self->type);
+   if (vector_reserve(dest, size)) return 1;
+
+   for (size_t i = 0; remaining; ++i)
+   {
+      const size_t capacity = vector_concurrent_capacity(i);
+      const size_t count = remaining < capacity ? remaining : capacity;
+      vector_push_range(dest, atomic_load_explicit(&self->segments[i], memory_order_acquire), count);
+      remaining -= count;
+   }
+
+   vector_concurrent_delete(self);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_concurrent_segment: Returnerar segmentet fr angivet index samt
+*                            indexets position i segmentet.
+*                            - index : Elementets index.
+*                            - offset: Lagringsplats fr positionen.
+*******************************************************************************/
+static inline size_t vector_concurrent_segment(const size_t index,
+                                               size_t* offset)
+{
+   if (index > SIZE_MAX - VECTOR_CONCURRENT_FIRST_SEGMENT) return VECTOR_CONCURRENT_SEGMENTS;
+   const size_t position = index + VECTOR_CONCURRENT_FIRST_SEGMENT;
+   const size_t high_bit = sizeof(unsigned long long) * 8 - 1 - __builtin_clzll(position);
+   const size_t segment = high_bit - (size_t)__builtin_ctz(VECTOR_CONCURRENT_FIRST_SEGMENT);
+   *offset = position - ((size_t)1 << high_bit);
+   return segment;
+}
+
+/*******************************************************************************
+* vector_concurrent_capacity: Returnerar antalet element i angivet segment.
+*******************************************************************************/
+static inline size_t vector_concurrent_capacity(const size_t segment)
+{
+   return (size_t)VECTOR_CONCURRENT_FIRST_SEGMENT << segment;
+}
+
+/*******************************************************************************
+* vector_concurrent_flags: Returnerar pekare till segmentets
+*                          publiceringsflaggor, som fljer efter elementen.
+*******************************************************************************/
+static inline atomic_uchar* vector_concurrent_flags(const struct vector_concurrent* self,
+                                                   void* segment,
+                                                   const size_t capacity)
+{
+   return (atomic_uchar*)((char*)segment + capacity * self->ops->element_size);
+}
+
+/*******************************************************************************
+* vector_concurrent_allocate: Allokerar angivet segment med nollstllda
+*                             flaggor, justerat till VECTOR_ALIGNMENT, och
+*                             installerar det atomrt. Om en annan trd hann
+*                             frst frigrs det nya segmentet och den andra
+*                             trdens segment returneras.
+*                             - self   : Pekare till vektorn.
+*                             - segment: Segmentets nummer.
+*******************************************************************************/
+static void* vector_concurrent_allocate(struct vector_concurrent* self,
+                                        const size_t segment)
+{
+   const size_t capacity = vector_concurrent_capacity(segment);
+   if (capacity > SIZE_MAX / (self->ops->element_size + 1)) return 0;
+
+   const size_t size = capacity * (self->ops->element_size + 1);
+   const size_t aligned_size = (size + VECTOR_ALIGNMENT - 1) & ~(size_t)(VECTOR_ALIGNMENT - 1);
+   if (aligned_size < size) return 0;
+
+   void* expected = 0;
+   void* data = aligned_alloc(VECTOR_ALIGNMENT, aligned_size);
+   if (!data) return 0;
+   memset(data, 0, size);
+
+   if (!atomic_compare_exchange_strong_explicit(&self->segments[segment], &expected, data,
+                                                memory_order_acq_rel, memory_order_acquire))
+   {
+      free(data);
+      return expected;
+   }
+
+   VECTOR_STATS_ALLOCATE(size);
+   return data;
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* vector_concurrent.h: Vektor fr samtidig inmatning frn flera trdar, dr
+*                      element enbart kan lggas till. Elementen lagras i
+*                      segment vars storlek frdubblas (64, 128, 256 ...
+*                      element) och som aldrig flyttas, vilket gr att
+*                      elementens adresser r stabila under vektorns livstid.
+*
+*                      Inmatning sker utan ls genom att varje trd atomrt
+*                      reserverar nsta index. Saknade segment allokeras av
+*                      den trd som frst behver dem. Ett element publiceras
+*                      nr det har skrivits, varefter det kan lsas av andra
+*                      trdar utan vntan. Opublicerade element lses som
+*                      nullpekare, vilket innebr att reserverade index kan
+*                      saknas tillflligt medan inmatning pgr.
+*
+*                      Nr all inmatning r klar kan innehllet verfras
+*                      till en vanlig sammanhngande vektor via
+*                      vector_concurrent_freeze.
+*
+*                      Programmet mste lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_CONCURRENT_H_
+#define VECTOR_CONCURRENT_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include <stdatomic.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_CONCURRENT_FIRST_SEGMENT 64 /* Antalet element i frsta segmentet. */
+#define VECTOR_CONCURRENT_SEGMENTS 58      /* Strsta antalet segment. */
+
+/*******************************************************************************
+* vector_concurrent: Segmenterad vektor fr samtidig inmatning. Segment k
+*                    rymmer VECTOR_CONCURRENT_FIRST_SEGMENT << k element,
+*                    fljt av en publiceringsflagga per element.
+*******************************************************************************/
+struct vector_concurrent
+{
+   _Atomic(void*) segments[VECTOR_CONCURRENT_SEGMENTS]; /* Allokerade segment. */
+   const struct vector_ops* ops;                        /* Operationer fr datatypen. */
+   enum vector_type type;                               /* Vektorns datatyp. */
+   atomic_size_t reserved;                              /* Antalet reserverade index. */
+};
+
+/* Externa funktioner: */
+void vector_concurrent_new(struct vector_concurrent* self,
+                           const enum vector_type type);
+void vector_concurrent_delete(struct vector_concurrent* self);
+int vector_concurrent_push(struct vector_concurrent* self,
+                           const void* new_element,
+                           size_t* index);
+const void* vector_concurrent_get(const struct vector_concurrent* self,
+                                  const size_t index);
+size_t vector_concurrent_size(const struct vector_concurrent* self);
+int vector_concurrent_freeze(struct vector_concurrent* self,
+                             struct vector* dest);
+
+#endif /* VECTOR_CONCURRENT_H_ */
@@ -0,0 +1,330 @@
+/*******************************************************************************
+* vector_convert.c: Innehller funktioner fr omvandling av vektorer mellan
+*                   datatyper. Omvandlingarna genereras fr samtliga par av
+*                   datatyper och instruktionsuppsttningar via makron, dr
+*                   varje omvandling r en enkel loop som kompilatorn
+*                   verstter till SIMD-instruktioner (exempelvis pmovsx
+*                   vid breddning och packs vid mttad smalning).
+*******************************************************************************/
+#include "vector_convert.h"
+#include "vector_kernels.h"
+#include <float.h>
+#include <limits.h>
+#include <stdint.h>
+
+/* Makrodefinitioner: */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_CONVERT_X86 1 /* SIMD-versioner genereras fr x86-processorer. */
+#endif
+
+/* Strsta av tv datatypers minsta vrden respektive minsta av deras strsta vrden. */
+#define VECTOR_CONVERT_LOW(min1, min2)                                          \
+   ((int64_t)(min1) > (int64_t)(min2) ? (int64_t)(min1) : (int64_t)(min2))
+#define VECTOR_CONVERT_HIGH(max1, max2)                                         \
+   ((uint64_t)(max1) < (uint64_t)(max2) ? (uint64_t)(max1) : (uint64_t)(max2))
+
+/* Antalet element per varv fr angiven registerbredd i byte, utifrn den bredaste datatypen. */
+#define VECTOR_CONVERT_LANES(bytes, ftype, ttype)                               \
+   ((bytes) ? 2 * (bytes) / (sizeof(ftype) > sizeof(ttype) ? sizeof(ftype) : sizeof(ttype)) : 1)
+
+/*******************************************************************************
+* VECTOR_CONVERT_LOOP: Utfr angiven sats fr index i frn 0 till size, dr
+*                      huvudloopen behandlar lanes element per varv. Den inre
+*                      loopen har konstant lngd, vilket gr att kompilatorn
+*                      verstter den till SIMD-instruktioner, som i
+*                      vector_expr.
+*******************************************************************************/
+#define VECTOR_CONVERT_LOOP(lanes, size, ...)                                   \
+do                                                                              \
+{                                                                               \
+   size_t first = 0;                                                            \
+   for (; first + (lanes) <= (size); first += (lanes))                          \
+   {                                                                            \
+      for (size_t lane = 0; lane < (lanes); ++lane)                             \
+      {                                                                         \
+         const size_t i = first + lane;                                         \
+         __VA_ARGS__;                                                           \
+      }                                                                         \
+   }                                                                            \
+   for (size_t i = first; i < (size); ++i) { __VA_ARGS__; }                     \
+} while (0)
+
+/*******************************************************************************
+* vector_convert_table: Omvandlingar frn en given datatyp till samtliga
+*                       datatyper (indexerade via vector_type) fr en given
+*                       instruktionsuppsttning.
+*******************************************************************************/
+struct vector_convert_table
+{
+   void (*to[VECTOR_TYPE_NONE])(void* restrict dest, const void* restrict source,
+                                const size_t size, const int saturate);
+};
+
+/*******************************************************************************
+* VECTOR_CONVERT_INTEGER: Genererar omvandling mellan tv heltalstyper. Vid
+*                         mttnad begrnsas talen frst till det intervall
+*                         som ryms i bda datatyperna, uttryckt i klltypen,
+*                         annars omvandlas talen via mltypens osignerade
+*                         motsvarighet s att de slr runt.
+*                         - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                         - attr : Attribut som anger mlarkitektur.
+*                         - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                         - fname: Namnsuffix fr klltypen.
+*                         - ftype: Klltypen.
+*                         - fmin : Klltypens minsta vrde.
+*                         - fmax : Klltypens strsta vrde.
+*                         - tname: Namnsuffix fr mltypen.
+*                         - ttype: Mltypen.
+*                         - tuint: Osignerad datatyp av mltypens bredd.
+*                         - tmin : Mltypens minsta vrde.
+*                         - tmax : Mltypens strsta vrde.
+*******************************************************************************/
+#define VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax,      \
+                               tname, ttype, tuint, tmin, tmax)                 \
+static attr void vector_convert_##fname##_##tname##_##isa(void* restrict dest,  \
+                                                          const void* restrict source, \
+                                                          const size_t size,    \
+                                                          const int saturate)   \
+{                                                                               \
+   enum { lanes = VECTOR_CONVERT_LANES(bytes, ftype, ttype) };                  \
+   ttype* z = (ttype*)dest;                                                     \
+   const ftype* x = (const ftype*)source;                                       \
+   if (saturate)                                                                \
+   {                                                                            \
+      const ftype low = (ftype)VECTOR_CONVERT_LOW(fmin, tmin);                  \
+      const ftype high = (ftype)VECTOR_CONVERT_HIGH(fmax, tmax);                \
+      VECTOR_CONVERT_LOOP(lanes, size,                                          \
+         z[i] = (ttype)(x[i] < low ? low : x[i] > high ? high : x[i]));         \
+   }                                                                            \
+   else                                                                         \
+   {                                                                            \
+      VECTOR_CONVERT_LOOP(lanes, size, z[i] = (ttype)(tuint)x[i]);              \
+   }                                                                            \
+}
+
+/*******************************************************************************
+* VECTOR_CONVERT_TRUNCATE: Genererar omvandling frn flyttal till heltal, dr
+*                          talen avrundas mot noll och alltid begrnsas till
+*                          mltypens intervall. NaN ger noll. Grnserna
+*                          avrundas uppt till nrmaste flyttal (exempelvis
+*                          2^31 fr INT_MAX), vilket gr att tal under
+*                          grnsen alltid ryms i mltypen.
+*                          - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                          - attr : Attribut som anger mlarkitektur.
+*                          - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                          - fname: Namnsuffix fr klltypen.
+*                          - ftype: Klltypen.
+*                          - tname: Namnsuffix fr mltypen.
+*                          - ttype: Mltypen.
+*                          - tmin : Mltypens minsta vrde.
+*                          - tmax : Mltypens strsta vrde.
+*******************************************************************************/
+#define VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, tname, ttype, tmin, tmax) \
+static attr void vector_convert_##fname##_##tname##_##isa(void* restrict dest,  \
+                                                          const void* restrict source, \
+                                                          const size_t size,    \
+                                                          const int saturate)   \
+{                                                                               \
+   enum { lanes = VECTOR_CONVERT_LANES(bytes, ftype, ttype) };                  \
+   ttype* z = (ttype*)dest;                                                     \
+   const ftype* x = (const ftype*)source;                                       \
+   const ftype low = (ftype)(tmin);                                             \
+   const ftype high = (ftype)(tmax);                                            \
+   (void)saturate;                                                              \
+   VECTOR_CONVERT_LOOP(lanes, size,                                             \
+      z[i] = x[i] != x[i] ? (ttype)0 : x[i] <= low ? (ttype)(tmin) :            \
+             x[i] >= high ? (ttype)(tmax) : (ttype)x[i]);                       \
+}
+
+/*******************************************************************************
+* VECTOR_CONVERT_CAST: Genererar omvandling dr samtliga tal ryms i mltypen
+*                      (heltal till flyttal samt breddning av flyttal).
+*                      - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                      - attr : Attribut som anger mlarkitektur.
+*                      - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                      - fname: Namnsuffix fr klltypen.
+*                      - ftype: Klltypen.
+*                      - tname: Namnsuffix fr mltypen.
+*                      - ttype: Mltypen.
+*******************************************************************************/
+#define VECTOR_CONVERT_CAST(isa, attr, bytes, fname, ftype, tname, ttype)       \
+static attr void vector_convert_##fname##_##tname##_##isa(void* restrict dest,  \
+                                                          const void* restrict source, \
+                                                          const size_t size,    \
+                                                          const int saturate)   \
+{                                                                               \
+   enum { lanes = VECTOR_CONVERT_LANES(bytes, ftype, ttype) };                  \
+   ttype* z = (ttype*)dest;                                                     \
+   const ftype* x = (const ftype*)source;                                       \
+   (void)saturate;                                                              \
+   VECTOR_CONVERT_LOOP(lanes, size, z[i] = (ttype)x[i]);                        \
+}
+
+/*******************************************************************************
+* VECTOR_CONVERT_NARROW: Genererar smalning mellan flyttalstyper, dr tal
+*                        utanfr mltypens intervall begrnsas till strsta
+*                        ndliga vrde vid mttnad och annars ger ondligheten.
+*                        - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                        - attr : Attribut som anger mlarkitektur.
+*                        - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                        - fname: Namnsuffix fr klltypen.
+*                        - ftype: Klltypen.
+*                        - tname: Namnsuffix fr mltypen.
+*                        - ttype: Mltypen.
+*                        - tmax : Mltypens strsta ndliga vrde.
+*******************************************************************************/
+#define VECTOR_CONVERT_NARROW(isa, attr, bytes, fname, ftype, tname, ttype, tmax) \
+static attr void vector_convert_##fname##_##tname##_##isa(void* restrict dest,  \
+                                                          const void* restrict source, \
+                                                          const size_t size,    \
+                                                          const int saturate)   \
+{                                                                               \
+   enum { lanes = VECTOR_CONVERT_LANES(bytes, ftype, ttype) };                  \
+   ttype* z = (ttype*)dest;                                                     \
+   const ftype* x = (const ftype*)source;                                       \
+   const ftype high = (ftype)(tmax);                                            \
+   if (saturate)                                                                \
+   {                                                                            \
+      VECTOR_CONVERT_LOOP(lanes, size,                                          \
+         z[i] = (ttype)(x[i] < -high ? -high : x[i] > high ? high : x[i]));     \
+   }                                                                            \
+   else                                                                         \
+   {                                                                            \
+      VECTOR_CONVERT_LOOP(lanes, size, z[i] = (ttype)x[i]);                     \
+   }                                                                            \
+}
+
+/* Genererar omvandlingar frn en heltalstyp till samtliga datatyper. */
+#define VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, int, int, unsigned, INT_MIN, INT_MAX) \
+VECTOR_CONVERT_CAST(isa, attr, bytes, fname, ftype, double, double)             \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, unsigned, size_t, size_t, 0, SIZE_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, int8, int8_t, uint8_t, INT8_MIN, INT8_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, int16, int16_t, uint16_t, INT16_MIN, INT16_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, int64, int64_t, uint64_t, INT64_MIN, INT64_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, uint8, uint8_t, uint8_t, 0, UINT8_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, uint16, uint16_t, uint16_t, 0, UINT16_MAX) \
+VECTOR_CONVERT_INTEGER(isa, attr, bytes, fname, ftype, fmin, fmax, uint32, uint32_t, uint32_t, 0, UINT32_MAX) \
+VECTOR_CONVERT_CAST(isa, attr, bytes, fname, ftype, float, float)
+
+/* Genererar omvandlingar frn en flyttalstyp till samtliga heltalstyper. */
+#define VECTOR_CONVERT_FROM_FLOATING(isa, attr, bytes, fname, ftype)            \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, int, int, INT_MIN, INT_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, unsigned, size_t, 0, SIZE_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, int8, int8_t, INT8_MIN, INT8_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, int16, int16_t, INT16_MIN, INT16_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, int64, int64_t, INT64_MIN, INT64_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, uint8, uint8_t, 0, UINT8_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, uint16, uint16_t, 0, UINT16_MAX) \
+VECTOR_CONVERT_TRUNCATE(isa, attr, bytes, fname, ftype, uint32, uint32_t, 0, UINT32_MAX)
+
+/* Genererar omvandlingar fr samtliga par av datatyper fr en instruktionsuppsttning. */
+#define VECTOR_CONVERT_DEFINE_ALL(isa, attr, bytes)                             \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, int, int, INT_MIN, INT_MAX)       \
+VECTOR_CONVERT_FROM_FLOATING(isa, attr, bytes, double, double)                  \
+VECTOR_CONVERT_CAST(isa, attr, bytes, double, double, double, double)           \
+VECTOR_CONVERT_NARROW(isa, attr, bytes, double, double, float, float, FLT_MAX)  \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, unsigned, size_t, 0, SIZE_MAX)    \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, int8, int8_t, INT8_MIN, INT8_MAX) \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, int16, int16_t, INT16_MIN, INT16_MAX) \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, int64, int64_t, INT64_MIN, INT64_MAX) \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, uint8, uint8_t, 0, UINT8_MAX)     \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, uint16, uint16_t, 0, UINT16_MAX)  \
+VECTOR_CONVERT_FROM_INTEGER(isa, attr, bytes, uint32, uint32_t, 0, UINT32_MAX)  \
+VECTOR_CONVERT_FROM_FLOATING(isa, attr, bytes, float, float)                    \
+VECTOR_CONVERT_CAST(isa, attr, bytes, float, float, double, double)             \
+VECTOR_CONVERT_CAST(isa, attr, bytes, float, float, float, float)
+
+/* Initierar omvandlingar frn angiven datatyp fr en instruktionsuppsttning. */
+#define VECTOR_CONVERT_TABLE(isa, fname)                                        \
+{                                                                               \
+   {                                                                            \
+      &vector_convert_##fname##_int_##isa, &vector_convert_##fname##_double_##isa, \
+      &vector_convert_##fname##_unsigned_##isa, &vector_convert_##fname##_int8_##isa, \
+      &vector_convert_##fname##_int16_##isa, &vector_convert_##fname##_int64_##isa, \
+      &vector_convert_##fname##_uint8_##isa, &vector_convert_##fname##_uint16_##isa, \
+      &vector_convert_##fname##_uint32_##isa, &vector_convert_##fname##_float_##isa \
+   }                                                                            \
+}
+
+/* Initierar omvandlingar frn samtliga datatyper (indexerade via vector_type). */
+#define VECTOR_CONVERT_TABLES(isa)                                              \
+{                                                                               \
+   VECTOR_CONVERT_TABLE(isa, int),                                              \
+   VECTOR_CONVERT_TABLE(isa, double),                                           \
+   VECTOR_CONVERT_TABLE(isa, unsigned),                                         \
+   VECTOR_CONVERT_TABLE(isa, int8),                                             \
+   VECTOR_CONVERT_TABLE(isa, int16),                                            \
+   VECTOR_CONVERT_TABLE(isa, int64),                                            \
+   VECTOR_CONVERT_TABLE(isa, uint8),                                            \
+   VECTOR_CONVERT_TABLE(isa, uint16),                                           \
+   VECTOR_CONVERT_TABLE(isa, uint32),                                           \
+   VECTOR_CONVERT_TABLE(isa, float)                                             \
+}
+
+/* Omvandlingar fr respektive instruktionsuppsttning: */
+VECTOR_CONVERT_DEFINE_ALL(scalar, , 0)
+static const struct vector_convert_table vector_convert_scalar[] = VECTOR_CONVERT_TABLES(scalar);
+
+#ifdef VECTOR_CONVERT_X86
+VECTOR_CONVERT_DEFINE_ALL(sse2, __attribute__((target("sse2"))), 16)
+VECTOR_CONVERT_DEFINE_ALL(avx2, __attribute__((target("avx2"))), 32)
+VECTOR_CONVERT_DEFINE_ALL(avx512, __attribute__((target("avx512f,avx512dq"))), 64)
+static const struct vector_convert_table vector_convert_sse2[] = VECTOR_CONVERT_TABLES(sse2);
+static const struct vector_convert_table vector_convert_avx2[] = VECTOR_CONVERT_TABLES(avx2);
+static const struct vector_convert_table vector_convert_avx512[] = VECTOR_CONVERT_TABLES(avx512);
+#endif /* VECTOR_CONVERT_X86 */
+
+/* Statiska funktioner: */
+static const struct vector_convert_table* vector_convert_get(const enum vector_type type);
+
+/*******************************************************************************
+* vector_convert: Omvandlar samtliga element i en vektor till angiven datatyp
+*                 och lagrar resultatet i mlvektorn, vars tidigare innehll
+*                 raderas. Mlvektorn behller sin allokerare och kan vara
+*                 samma vektor som kllvektorn.
+*                 - dest  : Pekare till mlvektorn.
+*                 - source: Pekare till vektorn som skall omvandlas.
+*                 - type  : Mlvektorns datatyp.
+*                 - mode  : Hantering av tal som inte ryms i mltypen (se
+*                           vector_convert_mode).
+*******************************************************************************/
+int vector_convert(struct vector* dest,
+                   const struct vector* source,
+                   const enum vector_type type,
+                   const enum vector_convert_mode mode)
+{
+   struct vector copy;
+   const struct vector_convert_table* table = vector_convert_get(source->type);
+   if (!table || type >= VECTOR_TYPE_NONE || (dest->flags & VECTOR_FLAG_READONLY)) return 1;
+   vector_new(&copy, type);
+   copy.allocator = dest->allocator;
+
+   if (source->size && vector_resize(&copy, source->size))
+   {
+      vector_delete(&copy);
+      return 1;
+   }
+
+   table->to[type](copy.data.raw, source->data.raw, source->size, mode == VECTOR_CONVERT_SATURATE);
+   vector_move(dest, &copy);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_convert_get: Returnerar omvandlingarna frn angiven datatyp fr den
+*                     instruktionsuppsttning som valts i vector_kernels,
+*                     eller nullpekare om datatypen saknar std.
+*                     - type: Kllvektorns datatyp.
+*******************************************************************************/
+static const struct vector_convert_table* vector_convert_get(const enum vector_type type)
+{
+   if (type >= VECTOR_TYPE_NONE) return 0;
+#ifdef VECTOR_CONVERT_X86
+   const enum vector_isa isa = vector_kernels_isa();
+   if (isa == VECTOR_ISA_AVX512) return &vector_convert_avx512[type];
+   if (isa == VECTOR_ISA_AVX2) return &vector_convert_avx2[type];
+   if (isa == VECTOR_ISA_SSE2) return &vector_convert_sse2[type];
+#endif /* VECTOR_CONVERT_X86 */
+   return &vector_convert_scalar[type];
+}
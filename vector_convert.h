@@ -0,0 +1,48 @@
+/*******************************************************************************
+* vector_convert.h: Omvandling av vektorer mellan datatyper, exempelvis fr
+*                   att lagra data kompakt (8- eller 16-bitars heltal samt
+*                   flyttal med enkel precision) och bredda det enbart infr
+*                   berkningar. Omvandlingen genereras fr samtliga par av
+*                   datatyper och instruktionsuppsttningar, dr
+*                   instruktionsuppsttning fljer valet i vector_kernels.
+*
+*                   Breddning r alltid exakt, frutom omvandling av stora
+*                   heltal till flyttal, som avrundas till nrmaste flyttal.
+*                   Vid smalning av heltal vljs mellan tv lgen:
+*
+*                   - VECTOR_CONVERT_WRAP: Talet slr runt, det vill sga
+*                     enbart de lgsta bitarna behlls (som vid typomvandling
+*                     i C), exempelvis 300 -> 44 fr uint8.
+*                   - VECTOR_CONVERT_SATURATE: Talet begrnsas till
+*                     mltypens intervall, exempelvis 300 -> 255 och -1 -> 0
+*                     fr uint8.
+*
+*                   Omvandling frn flyttal till heltal avrundar mot noll och
+*                   begrnsas alltid till mltypens intervall, dr NaN ger
+*                   noll, eftersom omvandling av tal utanfr intervallet
+*                   annars r odefinierad. Omvandling frn double till float
+*                   ger ondligheten fr tal utanfr intervallet, eller
+*                   strsta ndliga vrde vid VECTOR_CONVERT_SATURATE.
+*******************************************************************************/
+#ifndef VECTOR_CONVERT_H_
+#define VECTOR_CONVERT_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_convert_mode: Hantering av tal som inte ryms i mltypen.
+*******************************************************************************/
+enum vector_convert_mode
+{
+   VECTOR_CONVERT_WRAP,    /* Heltal slr runt (de lgsta bitarna behlls). */
+   VECTOR_CONVERT_SATURATE /* Talen begrnsas till mltypens intervall. */
+};
+
+/* Externa funktioner: */
+int vector_convert(struct vector* dest,
+                   const struct vector* source,
+                   const enum vector_type type,
+                   const enum vector_convert_mode mode);
+
+#endif /* VECTOR_CONVERT_H_ */
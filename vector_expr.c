@@ -0,0 +1,749 @@
+/*******************************************************************************
+* vector_expr.c: Innehller funktioner fr uppbyggnad och berkning av lata
+*                uttryck ver vektorer. Operationerna genereras per datatyp
+*                och instruktionsuppsttning via makron, dr varje operation
+*                r en enkel loop ver ett block, vilket kompilatorn
+*                verstter till SIMD-instruktioner. Instruktionsuppsttning
+*                fljer valet i vector_kernels, via vilken ven blocken
+*                reduceras.
+*******************************************************************************/
+#include "vector_expr.h"
+#include "vector_kernels.h"
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_EXPR_BLOCK_SIZE 1024 /* Antalet element som berknas per block. */
+
+/*******************************************************************************
+* vector_expr_sink: Mottagare av uttryckets berknade block, antingen en
+*                   mlvektor eller en pgende reduktion.
+*******************************************************************************/
+struct vector_expr_sink
+{
+   struct vector* dest;                      /* Mlvektor (eller nullpekare). */
+   enum vector_parallel_reduction reduction; /* Reduktion vid reducering. */
+   union vector_small result;                /* Reduktionens delresultat. */
+   size_t size;                              /* Antalet mottagna element. */
+};
+
+/*******************************************************************************
+* vector_expr_kernels: Operationer fr en given datatyp.
+*******************************************************************************/
+struct vector_expr_kernels
+{
+   void (*unary)(const enum vector_expr_op op, void* restrict dest,
+                 const void* x, const size_t size);
+   void (*binary)(const enum vector_expr_op op, void* restrict dest,
+                  const void* x, const void* y, const size_t size);
+   size_t (*filter)(void* dest, const void* x,
+                    const void* condition, const size_t size);
+   void (*combine)(const enum vector_parallel_reduction reduction,
+                   void* result, const void* partial);
+};
+
+/*******************************************************************************
+* VECTOR_EXPR_LOOP: Utfr angiven sats fr index i frn 0 till size, dr
+*                   huvudloopen behandlar lanes element per varv. Den inre
+*                   loopen har konstant lngd, vilket gr att kompilatorn
+*                   verstter den till SIMD-instruktioner utan att behva
+*                   kontrollera antalet element, som i vector_kernels.
+*******************************************************************************/
+#define VECTOR_EXPR_LOOP(lanes, size, ...)                                    \
+do                                                                            \
+{                                                                             \
+   size_t first = 0;                                                          \
+   for (; first + (lanes) <= (size); first += (lanes))                        \
+   {                                                                          \
+      for (size_t lane = 0; lane < (lanes); ++lane)                           \
+      {                                                                       \
+         const size_t i = first + lane;                                       \
+         __VA_ARGS__;                                                         \
+      }                                                                       \
+   }                                                                          \
+   for (size_t i = first; i < (size); ++i) { __VA_ARGS__; }                   \
+} while (0)
+
+/* Antalet element per varv fr angiven registerbredd i byte. */
+#define VECTOR_EXPR_LANES(bytes, type) ((bytes) ? 2 * (bytes) / sizeof(type) : 1)
+
+/*******************************************************************************
+* VECTOR_EXPR_DEFINE: Genererar samtliga operationer fr en given datatyp och
+*                     instruktionsuppsttning. Switchsatsen ligger utanfr
+*                     looparna, s att varje operation blir en egen loop.
+*                     Resultatet skrivs alltid till en egen buffert, vilket
+*                     gr att mlpekaren kan deklareras som restrict.
+*                     - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                     - attr : Attribut som anger mlarkitektur.
+*                     - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                     - name : Namnsuffix fr datatypen.
+*                     - type : Elementens datatyp.
+*                     - wrap : Datatyp fr aritmetik (osignerad fr heltal,
+*                              s att spill slr runt i stllet fr att vara
+*                              odefinierat, och minst unsigned fr heltal
+*                              smalare n int).
+*******************************************************************************/
+#define VECTOR_EXPR_DEFINE(isa, attr, bytes, name, type, wrap)                \
+static attr void vector_expr_unary_##name##_##isa(const enum vector_expr_op op, \
+                                                  void* restrict dest,        \
+                                                  const void* source,         \
+                                                  const size_t size)          \
+{                                                                             \
+   enum { lanes = VECTOR_EXPR_LANES(bytes, type) };                           \
+   type* z = (type*)dest;                                                     \
+   const type* x = (const type*)source;                                       \
+   switch (op)                                                                \
+   {                                                                          \
+      case VECTOR_EXPR_NEG:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)-(wrap)x[i]);             \
+         break;                                                               \
+      case VECTOR_EXPR_ABS:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = vector_expr_abs_##name(x[i]));  \
+         break;                                                               \
+      default:                                                                \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] == 0));             \
+         break;                                                               \
+   }                                                                          \
+}                                                                             \
+                                                                              \
+static attr void vector_expr_binary_##name##_##isa(const enum vector_expr_op op, \
+                                                   void* restrict dest,       \
+                                                   const void* left,          \
+                                                   const void* right,         \
+                                                   const size_t size)         \
+{                                                                             \
+   enum { lanes = VECTOR_EXPR_LANES(bytes, type) };                           \
+   type* z = (type*)dest;                                                     \
+   const type* x = (const type*)left;                                         \
+   const type* y = (const type*)right;                                        \
+   switch (op)                                                                \
+   {                                                                          \
+      case VECTOR_EXPR_ADD:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)((wrap)x[i] + (wrap)y[i])); \
+         break;                                                               \
+      case VECTOR_EXPR_SUB:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)((wrap)x[i] - (wrap)y[i])); \
+         break;                                                               \
+      case VECTOR_EXPR_MUL:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)((wrap)x[i] * (wrap)y[i])); \
+         break;                                                               \
+      case VECTOR_EXPR_DIV:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = vector_expr_div_##name(x[i], y[i])); \
+         break;                                                               \
+      case VECTOR_EXPR_MIN:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = x[i] < y[i] ? x[i] : y[i]);     \
+         break;                                                               \
+      case VECTOR_EXPR_MAX:                                                   \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = x[i] > y[i] ? x[i] : y[i]);     \
+         break;                                                               \
+      case VECTOR_EXPR_LT:                                                    \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] < y[i]));           \
+         break;                                                               \
+      case VECTOR_EXPR_LE:                                                    \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] <= y[i]));          \
+         break;                                                               \
+      case VECTOR_EXPR_GT:                                                    \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] > y[i]));           \
+         break;                                                               \
+      case VECTOR_EXPR_GE:                                                    \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] >= y[i]));          \
+         break;                                                               \
+      case VECTOR_EXPR_EQ:                                                    \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] == y[i]));          \
+         break;                                                               \
+      default:                                                                \
+         VECTOR_EXPR_LOOP(lanes, size, z[i] = (type)(x[i] != y[i]));          \
+         break;                                                               \
+   }                                                                          \
+}
+
+/* Genererar operationer fr samtliga datatyper fr en instruktionsuppsttning. */
+#define VECTOR_EXPR_DEFINE_ALL(isa, attr, bytes)                              \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, int, int, unsigned)                      \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, double, double, double)                  \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, unsigned, size_t, size_t)                \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, int8, int8_t, unsigned)                  \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, int16, int16_t, unsigned)                \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, int64, int64_t, uint64_t)                \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, uint8, uint8_t, unsigned)                \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, uint16, uint16_t, unsigned)              \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, uint32, uint32_t, uint32_t)              \
+VECTOR_EXPR_DEFINE(isa, attr, bytes, float, float, float)
+
+/* Initierar operationer fr angiven datatyp och instruktionsuppsttning. */
+#define VECTOR_EXPR_TABLE(isa, name)                                          \
+{                                                                             \
+   &vector_expr_unary_##name##_##isa, &vector_expr_binary_##name##_##isa,     \
+   &vector_expr_filter_##name, &vector_expr_combine_##name                    \
+}
+
+/* Initierar operationer fr samtliga datatyper (indexerade via vector_type). */
+#define VECTOR_EXPR_TABLES(isa)                                               \
+{                                                                             \
+   VECTOR_EXPR_TABLE(isa, int),                                               \
+   VECTOR_EXPR_TABLE(isa, double),                                            \
+   VECTOR_EXPR_TABLE(isa, unsigned),                                          \
+   VECTOR_EXPR_TABLE(isa, int8),                                              \
+   VECTOR_EXPR_TABLE(isa, int16),                                             \
+   VECTOR_EXPR_TABLE(isa, int64),                                             \
+   VECTOR_EXPR_TABLE(isa, uint8),                                             \
+   VECTOR_EXPR_TABLE(isa, uint16),                                            \
+   VECTOR_EXPR_TABLE(isa, uint32),                                            \
+   VECTOR_EXPR_TABLE(isa, float)                                              \
+}
+
+/*******************************************************************************
+* VECTOR_EXPR_DEFINE_COMMON: Genererar operationer som inte kan vektoriseras
+*                            och drmed r gemensamma fr samtliga
+*                            instruktionsuppsttningar.
+*                            - name: Namnsuffix fr datatypen.
+*                            - type: Elementens datatyp.
+*                            - wrap: Datatyp fr aritmetik.
+*******************************************************************************/
+#define VECTOR_EXPR_DEFINE_COMMON(name, type, wrap)                           \
+static size_t vector_expr_filter_##name(void* dest,                           \
+                                        const void* source,                   \
+                                        const void* condition,                \
+                                        const size_t size)                    \
+{                                                                             \
+   type* z = (type*)dest;                                                     \
+   const type* x = (const type*)source;                                       \
+   const type* c = (const type*)condition;                                    \
+   size_t num_selected = 0;                                                   \
+   for (size_t i = 0; i < size; ++i)                                          \
+   {                                                                          \
+      z[num_selected] = x[i];                                                 \
+      num_selected += c[i] != 0;                                              \
+   }                                                                          \
+   return num_selected;                                                       \
+}                                                                             \
+                                                                              \
+static void vector_expr_combine_##name(const enum vector_parallel_reduction reduction, \
+                                       void* result,                          \
+                                       const void* partial)                   \
+{                                                                             \
+   type* acc = (type*)result;                                                 \
+   const type value = *(const type*)partial;                                  \
+   if (reduction == VECTOR_PARALLEL_SUM) *acc = (type)((wrap)*acc + (wrap)value); \
+   else if (reduction == VECTOR_PARALLEL_MIN) *acc = value < *acc ? value : *acc; \
+   else *acc = value > *acc ? value : *acc;                                   \
+}
+
+/*******************************************************************************
+* VECTOR_EXPR_DEFINE_SIGNED: Genererar absolutbelopp och division fr
+*                            signerade heltal, dr minsta mjliga vrde slr
+*                            runt till sig sjlvt vid absolutbelopp samt
+*                            division med -1, och division med noll ger noll.
+*                            - name: Namnsuffix fr datatypen.
+*                            - type: Elementens datatyp.
+*                            - wrap: Datatyp fr aritmetik.
+*******************************************************************************/
+#define VECTOR_EXPR_DEFINE_SIGNED(name, type, wrap)                           \
+static inline type vector_expr_abs_##name(const type x)                       \
+{                                                                             \
+   return x < 0 ? (type)-(wrap)x : x;                                         \
+}                                                                             \
+                                                                              \
+static inline type vector_expr_div_##name(const type x,                       \
+                                          const type y)                       \
+{                                                                             \
+   if (y == 0) return 0;                                                      \
+   if (y == -1) return (type)-(wrap)x;                                        \
+   return (type)(x / y);                                                      \
+}
+
+/*******************************************************************************
+* VECTOR_EXPR_DEFINE_UNSIGNED: Genererar absolutbelopp (talet ofrndrat)
+*                              och division fr osignerade heltal, dr
+*                              division med noll ger noll.
+*                              - name: Namnsuffix fr datatypen.
+*                              - type: Elementens datatyp.
+*******************************************************************************/
+#define VECTOR_EXPR_DEFINE_UNSIGNED(name, type)                               \
+static inline type vector_expr_abs_##name(const type x)                       \
+{                                                                             \
+   return x;                                                                  \
+}                                                                             \
+                                                                              \
+static inline type vector_expr_div_##name(const type x,                       \
+                                          const type y)                       \
+{                                                                             \
+   return y ? (type)(x / y) : 0;                                              \
+}
+
+/*******************************************************************************
+* VECTOR_EXPR_DEFINE_FLOAT: Genererar absolutbelopp och division fr flyttal,
+*                           dr divisionen sker enligt IEEE 754.
+*                           - name: Namnsuffix fr datatypen.
+*                           - type: Elementens datatyp.
+*******************************************************************************/
+#define VECTOR_EXPR_DEFINE_FLOAT(name, type)                                  \
+static inline type vector_expr_abs_##name(const type x)                       \
+{                                                                             \
+   return x < 0 ? -x : x;                                                     \
+}                                                                             \
+                                                                              \
+static inline type vector_expr_div_##name(const type x,                       \
+                                          const type y)                       \
+{                                                                             \
+   return x / y;                                                              \
+}
+
+/* Statiska funktioner: */
+static size_t vector_expr_add(struct vector_expr* self,
+                              const struct vector_expr_node* node);
+static int vector_expr_operand(const struct vector_expr* self,
+                               const size_t operand);
+static const struct vector_expr_kernels* vector_expr_kernels_get(const enum vector_type type);
+static int vector_expr_run(const struct vector_expr* self,
+                           const size_t root,
+                           struct vector_expr_sink* sink);
+static void vector_expr_consume(struct vector_expr_sink* sink,
+                                const struct vector_expr_kernels* kernels,
+                                const enum vector_type type,
+                                const void* data,
+                                const size_t size);
+
+/* Typberoende operationer: */
+VECTOR_EXPR_DEFINE_SIGNED(int, int, unsigned)
+VECTOR_EXPR_DEFINE_FLOAT(double, double)
+VECTOR_EXPR_DEFINE_UNSIGNED(unsigned, size_t)
+VECTOR_EXPR_DEFINE_SIGNED(int8, int8_t, unsigned)
+VECTOR_EXPR_DEFINE_SIGNED(int16, int16_t, unsigned)
+VECTOR_EXPR_DEFINE_SIGNED(int64, int64_t, uint64_t)
+VECTOR_EXPR_DEFINE_UNSIGNED(uint8, uint8_t)
+VECTOR_EXPR_DEFINE_UNSIGNED(uint16, uint16_t)
+VECTOR_EXPR_DEFINE_UNSIGNED(uint32, uint32_t)
+VECTOR_EXPR_DEFINE_FLOAT(float, float)
+VECTOR_EXPR_DEFINE_COMMON(int, int, unsigned)
+VECTOR_EXPR_DEFINE_COMMON(double, double, double)
+VECTOR_EXPR_DEFINE_COMMON(unsigned, size_t, size_t)
+VECTOR_EXPR_DEFINE_COMMON(int8, int8_t, unsigned)
+VECTOR_EXPR_DEFINE_COMMON(int16, int16_t, unsigned)
+VECTOR_EXPR_DEFINE_COMMON(int64, int64_t, uint64_t)
+VECTOR_EXPR_DEFINE_COMMON(uint8, uint8_t, unsigned)
+VECTOR_EXPR_DEFINE_COMMON(uint16, uint16_t, unsigned)
+VECTOR_EXPR_DEFINE_COMMON(uint32, uint32_t, uint32_t)
+VECTOR_EXPR_DEFINE_COMMON(float, float, float)
+VECTOR_EXPR_DEFINE_ALL(scalar, , 0)
+static const struct vector_expr_kernels vector_expr_scalar_kernels[] = VECTOR_EXPR_TABLES(scalar);
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_EXPR_X86 1 /* SIMD-versioner genereras fr x86-processorer. */
+VECTOR_EXPR_DEFINE_ALL(sse2, __attribute__((target("sse2"))), 16)
+VECTOR_EXPR_DEFINE_ALL(avx2, __attribute__((target("avx2"))), 32)
+VECTOR_EXPR_DEFINE_ALL(avx512, __attribute__((target("avx512f,avx512dq"))), 64)
+static const struct vector_expr_kernels vector_expr_sse2_kernels[] = VECTOR_EXPR_TABLES(sse2);
+static const struct vector_expr_kernels vector_expr_avx2_kernels[] = VECTOR_EXPR_TABLES(avx2);
+static const struct vector_expr_kernels vector_expr_avx512_kernels[] = VECTOR_EXPR_TABLES(avx512);
+#endif /* VECTOR_EXPR_X86 */
+
+/*******************************************************************************
+* vector_expr_new: Initierar ett tomt uttryck av angiven datatyp.
+*                  - self: Pekare till uttrycket.
+*                  - type: Uttryckets datatyp.
+*******************************************************************************/
+void vector_expr_new(struct vector_expr* self,
+                     const enum vector_type type)
+{
+   self->type = type;
+   self->num_nodes = 0;
+   self->error = vector_expr_kernels_get(type) ? 0 : 1;
+   return;
+}
+
+/*******************************************************************************
+* vector_expr_input: Lgger till en nod som lser elementen i angiven vektor.
+*                    Vektorn lses frst vid berkning och fr drmed ndras
+*                    fram till dess, s lnge datatypen r ofrndrad.
+*                    - self : Pekare till uttrycket.
+*                    - input: Pekare till vektorn, som mste ha uttryckets
+*                             datatyp.
+*******************************************************************************/
+size_t vector_expr_input(struct vector_expr* self,
+                         const struct vector* input)
+{
+   struct vector_expr_node node = { 0 };
+   if (!input || input->type != self->type)
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = VECTOR_EXPR_INPUT;
+   node.input = input;
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_scalar: Lgger till en nod med ett konstant vrde, som anvnds
+*                     fr samtliga element.
+*                     - self : Pekare till uttrycket.
+*                     - value: Pekare till vrdet, som mste vara av
+*                              uttryckets datatyp.
+*******************************************************************************/
+size_t vector_expr_scalar(struct vector_expr* self,
+                          const void* value)
+{
+   struct vector_expr_node node = { 0 };
+   if (!value || self->error)
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = VECTOR_EXPR_SCALAR;
+   memcpy(&node.scalar, value, vector_ops(self->type)->element_size);
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_unary: Lgger till en unr operation (VECTOR_EXPR_NEG,
+*                    VECTOR_EXPR_ABS eller VECTOR_EXPR_NOT).
+*                    - self   : Pekare till uttrycket.
+*                    - op     : Operationen som skall utfras.
+*                    - operand: Index till operanden.
+*******************************************************************************/
+size_t vector_expr_unary(struct vector_expr* self,
+                         const enum vector_expr_op op,
+                         const size_t operand)
+{
+   struct vector_expr_node node = { 0 };
+   if (op < VECTOR_EXPR_NEG || op > VECTOR_EXPR_NOT || vector_expr_operand(self, operand))
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = op;
+   node.left = operand;
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_binary: Lgger till en binr operation (aritmetik, minsta och
+*                     strsta vrde eller jmfrelse) mellan tv operander.
+*                     - self : Pekare till uttrycket.
+*                     - op   : Operationen som skall utfras.
+*                     - left : Index till frsta operanden.
+*                     - right: Index till andra operanden.
+*******************************************************************************/
+size_t vector_expr_binary(struct vector_expr* self,
+                          const enum vector_expr_op op,
+                          const size_t left,
+                          const size_t right)
+{
+   struct vector_expr_node node = { 0 };
+   if (op < VECTOR_EXPR_ADD || op > VECTOR_EXPR_NE ||
+       vector_expr_operand(self, left) || vector_expr_operand(self, right))
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = op;
+   node.left = left;
+   node.right = right;
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_map: Lgger till en nod som anropar angiven funktion. Funktionen
+*                  anropas en gng per block och skriver resultatet fr
+*                  blockets element till dest, vilket gr att loopen i
+*                  funktionen kan vektoriseras.
+*                  - self   : Pekare till uttrycket.
+*                  - operand: Index till operanden.
+*                  - map    : Funktion som berknar size element av
+*                             uttryckets datatyp frn source till dest.
+*                  - context: Data som passeras till funktionen.
+*******************************************************************************/
+size_t vector_expr_map(struct vector_expr* self,
+                       const size_t operand,
+                       void (*map)(void* dest, const void* source,
+                                   const size_t size, void* context),
+                       void* context)
+{
+   struct vector_expr_node node = { 0 };
+   if (!map || vector_expr_operand(self, operand))
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = VECTOR_EXPR_MAP;
+   node.left = operand;
+   node.map = map;
+   node.context = context;
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_filter: Lgger till en nod som enbart behller de element vars
+*                     villkor r skilt frn noll. Eftersom antalet element
+*                     ndras kan filtret enbart anvndas som uttryckets rot,
+*                     det vill sga inte som operand till andra noder.
+*                     - self     : Pekare till uttrycket.
+*                     - value    : Index till noden vars element filtreras.
+*                     - condition: Index till noden som anger villkoret,
+*                                  exempelvis en jmfrelse.
+*******************************************************************************/
+size_t vector_expr_filter(struct vector_expr* self,
+                          const size_t value,
+                          const size_t condition)
+{
+   struct vector_expr_node node = { 0 };
+   if (vector_expr_operand(self, value) || vector_expr_operand(self, condition))
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   node.op = VECTOR_EXPR_FILTER;
+   node.left = value;
+   node.right = condition;
+   return vector_expr_add(self, &node);
+}
+
+/*******************************************************************************
+* vector_expr_eval: Berknar uttrycket med angiven rot och lagrar resultatet
+*                   i angiven vektor. Eventuellt tidigare innehll erstts.
+*                   Mlvektorn fr ven vara en av uttryckets operander,
+*                   eftersom varje block lses innan det skrivs ver.
+*                   - self: Pekare till uttrycket.
+*                   - root: Index till noden vars vrde skall berknas.
+*                   - dest: Pekare till mlvektorn.
+*******************************************************************************/
+int vector_expr_eval(const struct vector_expr* self,
+                     const size_t root,
+                     struct vector* dest)
+{
+   struct vector_expr_sink sink = { 0 };
+   if (!dest || (dest->flags & VECTOR_FLAG_READONLY)) return 1;
+   sink.dest = dest;
+   if (vector_expr_run(self, root, &sink)) return 1;
+   return vector_resize(dest, sink.size);
+}
+
+/*******************************************************************************
+* vector_expr_reduce: Berknar uttrycket med angiven rot och reducerar
+*                     resultatet till ett enda vrde, utan att elementen
+*                     lagras. Minsta och strsta vrde krver minst ett
+*                     element.
+*                     - self     : Pekare till uttrycket.
+*                     - root     : Index till noden vars vrde skall reduceras.
+*                     - reduction: Reduktionen som skall utfras.
+*                     - result   : Pekare till variabel av uttryckets datatyp
+*                                  dr resultatet skall lagras.
+*******************************************************************************/
+int vector_expr_reduce(const struct vector_expr* self,
+                       const size_t root,
+                       const enum vector_parallel_reduction reduction,
+                       void* result)
+{
+   struct vector_expr_sink sink = { 0 };
+   if (!result || reduction > VECTOR_PARALLEL_MAX) return 1;
+   sink.reduction = reduction;
+   if (vector_expr_run(self, root, &sink)) return 1;
+   if (!sink.size && reduction != VECTOR_PARALLEL_SUM) return 1;
+   memcpy(result, &sink.result, vector_ops(self->type)->element_size);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_expr_add: Lgger till en nod sist i uttrycket och returnerar dess
+*                  index, eller VECTOR_EXPR_INVALID om uttrycket r fullt
+*                  eller redan innehller ett fel.
+*******************************************************************************/
+static size_t vector_expr_add(struct vector_expr* self,
+                              const struct vector_expr_node* node)
+{
+   if (self->error || self->num_nodes == VECTOR_EXPR_MAX_NODES)
+   {
+      self->error = 1;
+      return VECTOR_EXPR_INVALID;
+   }
+   self->nodes[self->num_nodes] = *node;
+   return self->num_nodes++;
+}
+
+/*******************************************************************************
+* vector_expr_operand: Kontrollerar att angivet index refererar till en nod
+*                      som fr anvndas som operand, det vill sga en
+*                      befintlig nod som inte r ett filter.
+*******************************************************************************/
+static int vector_expr_operand(const struct vector_expr* self,
+                               const size_t operand)
+{
+   if (operand >= self->num_nodes) return 1;
+   return self->nodes[operand].op == VECTOR_EXPR_FILTER;
+}
+
+/*******************************************************************************
+* vector_expr_kernels_get: Returnerar operationerna fr angiven datatyp och
+*                          den instruktionsuppsttning som valts i
+*                          vector_kernels, eller nullpekare om datatypen
+*                          saknar std.
+*******************************************************************************/
+static const struct vector_expr_kernels* vector_expr_kernels_get(const enum vector_type type)
+{
+   if (type >= VECTOR_TYPE_NONE) return 0;
+#ifdef VECTOR_EXPR_X86
+   const enum vector_isa isa = vector_kernels_isa();
+   if (isa == VECTOR_ISA_AVX512) return &vector_expr_avx512_kernels[type];
+   if (isa == VECTOR_ISA_AVX2) return &vector_expr_avx2_kernels[type];
+   if (isa == VECTOR_ISA_SSE2) return &vector_expr_sse2_kernels[type];
+#endif /* VECTOR_EXPR_X86 */
+   return &vector_expr_scalar_kernels[type];
+}
+
+/*******************************************************************************
+* vector_expr_run: Berknar uttrycket med angiven rot block fr block och
+*                  passerar varje berknat block till angiven mottagare.
+*                  Enbart noder som roten r beroende av berknas. Noder
+*                  som lser vektorer pekar direkt in i vektorns flt,
+*                  medan vriga noder fr en buffert fr ett block var.
+*                  Konstanter fylls i sina buffertar en gng fre loopen.
+*******************************************************************************/
+static int vector_expr_run(const struct vector_expr* self,
+                           const size_t root,
+                           struct vector_expr_sink* sink)
+{
+   const struct vector_expr_kernels* kernels = vector_expr_kernels_get(self->type);
+   unsigned char needed[VECTOR_EXPR_MAX_NODES] = { 0 };
+   const void* values[VECTOR_EXPR_MAX_NODES] = { 0 };
+   unsigned char* buffers[VECTOR_EXPR_MAX_NODES] = { 0 };
+   size_t size = VECTOR_EXPR_INVALID;
+   size_t num_buffers = 0;
+
+   if (!kernels || self->error || root >= self->num_nodes) return 1;
+   const size_t element_size = vector_ops(self->type)->element_size;
+   const size_t block_bytes = VECTOR_EXPR_BLOCK_SIZE * element_size;
+
+   /* Markerar noder som roten r beroende av och kontrollerar operanderna: */
+   needed[root] = 1;
+   for (size_t i = root + 1; i-- > 0;)
+   {
+      const struct vector_expr_node* node = &self->nodes[i];
+      if (!needed[i]) continue;
+
+      if (node->op == VECTOR_EXPR_INPUT)
+      {
+         if (node->input->type != self->type) return 1;
+         if (size == VECTOR_EXPR_INVALID) size = node->input->size;
+         else if (node->input->size != size) return 1;
+      }
+      else if (node->op != VECTOR_EXPR_SCALAR)
+      {
+         needed[node->left] = 1;
+         if (node->op == VECTOR_EXPR_FILTER || node->op >= VECTOR_EXPR_ADD) needed[node->right] = 1;
+      }
+      if (node->op != VECTOR_EXPR_INPUT) num_buffers++;
+   }
+   if (size == VECTOR_EXPR_INVALID) return 1;
+
+   if (sink->dest)
+   {
+      if (sink->dest->type != self->type)
+      {
+         vector_delete(sink->dest);
+         vector_new(sink->dest, self->type);
+      }
+      if (vector_resize(sink->dest, size)) return 1;
+   }
+
+   unsigned char* scratch = (unsigned char*)malloc(num_buffers * block_bytes);
+   if (num_buffers && !scratch) return 1;
+
+   for (size_t i = 0, j = 0; i <= root; ++i)
+   {
+      if (!needed[i] || self->nodes[i].op == VECTOR_EXPR_INPUT) continue;
+      buffers[i] = scratch + j++ * block_bytes;
+      values[i] = buffers[i];
+
+      /* Konstanter fylls genom att det ifyllda omrdet kopieras och dubbleras: */
+      if (self->nodes[i].op == VECTOR_EXPR_SCALAR)
+      {
+         memcpy(buffers[i], &self->nodes[i].scalar, element_size);
+         for (size_t filled = element_size; filled < block_bytes; filled *= 2)
+         {
+            memcpy(buffers[i] + filled, buffers[i], filled < block_bytes - filled ? filled : block_bytes - filled);
+         }
+      }
+   }
+
+   for (size_t first = 0; first < size; first += VECTOR_EXPR_BLOCK_SIZE)
+   {
+      const size_t count = size - first < VECTOR_EXPR_BLOCK_SIZE ? size - first : VECTOR_EXPR_BLOCK_SIZE;
+      size_t num_results = count;
+
+      for (size_t i = 0; i <= root; ++i)
+      {
+         const struct vector_expr_node* node = &self->nodes[i];
+         if (!needed[i]) continue;
+
+         switch (node->op)
+         {
+            case VECTOR_EXPR_INPUT:
+               values[i] = (const char*)node->input->data.raw + first * element_size;
+               break;
+            case VECTOR_EXPR_SCALAR:
+               break;
+            case VECTOR_EXPR_MAP:
+               node->map(buffers[i], values[node->left], count, node->context);
+               break;
+            case VECTOR_EXPR_FILTER:
+               num_results = kernels->filter(buffers[i], values[node->left],
+                                             values[node->right], count);
+               break;
+            case VECTOR_EXPR_NEG:
+            case VECTOR_EXPR_ABS:
+            case VECTOR_EXPR_NOT:
+               kernels->unary(node->op, buffers[i], values[node->left], count);
+               break;
+            default:
+               kernels->binary(node->op, buffers[i], values[node->left],
+                               values[node->right], count);
+               break;
+         }
+      }
+      vector_expr_consume(sink, kernels, self->type, values[root], num_results);
+   }
+
+   free(scratch);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_expr_consume: Tar emot ett berknat block. Vid berkning till en
+*                      vektor kopieras blocket direkt efter tidigare block,
+*                      vilket aldrig skriver ver element som nnu inte har
+*                      lsts. Vid reduktion reduceras blocket via
+*                      vector_kernels och kombineras med tidigare block.
+*******************************************************************************/
+static void vector_expr_consume(struct vector_expr_sink* sink,
+                                const struct vector_expr_kernels* kernels,
+                                const enum vector_type type,
+                                const void* data,
+                                const size_t size)
+{
+   if (!size) return;
+
+   if (sink->dest)
+   {
+      const size_t element_size = sink->dest->ops->element_size;
+      memmove((char*)sink->dest->data.raw + sink->size * element_size, data, size * element_size);
+   }
+   else
+   {
+      struct vector block;
+      union vector_small partial;
+      vector_new(&block, type);
+      block.data.raw = (void*)data;
+      block.size = size;
+      block.capacity = size;
+      block.flags = VECTOR_FLAG_READONLY;
+
+      if (sink->reduction == VECTOR_PARALLEL_SUM) vector_sum(&block, &partial);
+      else if (sink->reduction == VECTOR_PARALLEL_MIN) vector_min(&block, &partial);
+      else vector_max(&block, &partial);
+
+      if (sink->size) kernels->combine(sink->reduction, &sink->result, &partial);
+      else sink->result = partial;
+   }
+   sink->size += size;
+   return;
+}
@@ -0,0 +1,130 @@
+/*******************************************************************************
+* vector_expr.h: Lata uttryck ver vektorer, dr en kedja av elementvisa
+*                operationer (aritmetik, jmfrelser, egna funktioner samt
+*                filtrering) byggs upp som en liten graf och berknas frst
+*                nr resultatet efterfrgas. Berkningen sker i ett enda
+*                pass, block fr block, dr varje nod berknas fr ett block
+*                innan nsta block pbrjas. Mellanresultat ryms drmed i
+*                processorns cacheminne och inga temporra vektorer skapas.
+*
+*                Samtliga operander i ett uttryck har uttryckets datatyp och
+*                samma storlek. Heltal berknas med modulr aritmetik och
+*                heltalsdivision med noll ger resultatet noll. Jmfrelser
+*                ger 1 om villkoret r uppfyllt, annars 0, vilket gr att
+*                resultatet kan anvndas bde som filter och i aritmetik.
+*
+*                Nodfunktionerna returnerar nodens index i uttrycket, eller
+*                VECTOR_EXPR_INVALID vid fel. Felet sparas i uttrycket och
+*                fljer med till berkningen, vilket gr att anrop kan
+*                nstlas utan kontroll av varje delresultat:
+*
+*                vector_expr_new(&e, VECTOR_TYPE_DOUBLE);
+*                root = vector_expr_binary(&e, VECTOR_EXPR_ADD,
+*                          vector_expr_binary(&e, VECTOR_EXPR_MUL,
+*                             vector_expr_input(&e, &x),
+*                             vector_expr_scalar(&e, &alpha)),
+*                          vector_expr_input(&e, &y));
+*                vector_expr_eval(&e, root, &result);
+*******************************************************************************/
+#ifndef VECTOR_EXPR_H_
+#define VECTOR_EXPR_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include "vector_parallel.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_EXPR_MAX_NODES 32         /* Strsta antalet noder i ett uttryck. */
+#define VECTOR_EXPR_INVALID ((size_t)-1) /* Returneras av nodfunktioner vid fel. */
+
+/*******************************************************************************
+* vector_expr_op: Nodtyper i ett uttryck. Unra operationer skapas via
+*                 vector_expr_unary och binra via vector_expr_binary, medan
+*                 vriga nodtyper har egna funktioner.
+*******************************************************************************/
+enum vector_expr_op
+{
+   VECTOR_EXPR_INPUT,  /* Elementen i en vektor. */
+   VECTOR_EXPR_SCALAR, /* Ett konstant vrde. */
+   VECTOR_EXPR_MAP,    /* Egen funktion som anropas blockvis. */
+   VECTOR_EXPR_FILTER, /* Element vars villkor r skilt frn noll. */
+   VECTOR_EXPR_NEG,    /* -x */
+   VECTOR_EXPR_ABS,    /* |x| */
+   VECTOR_EXPR_NOT,    /* 1 om x r noll, annars 0. */
+   VECTOR_EXPR_ADD,    /* x + y */
+   VECTOR_EXPR_SUB,    /* x - y */
+   VECTOR_EXPR_MUL,    /* x * y */
+   VECTOR_EXPR_DIV,    /* x / y */
+   VECTOR_EXPR_MIN,    /* Minsta av x och y. */
+   VECTOR_EXPR_MAX,    /* Strsta av x och y. */
+   VECTOR_EXPR_LT,     /* x < y */
+   VECTOR_EXPR_LE,     /* x <= y */
+   VECTOR_EXPR_GT,     /* x > y */
+   VECTOR_EXPR_GE,     /* x >= y */
+   VECTOR_EXPR_EQ,     /* x == y */
+   VECTOR_EXPR_NE      /* x != y */
+};
+
+/*******************************************************************************
+* vector_expr_node: Nod i ett uttryck. Operander refereras via index till
+*                   tidigare noder, vilket gr att noderna alltid ligger i
+*                   en ordning dr operanderna berknas frst.
+*******************************************************************************/
+struct vector_expr_node
+{
+   enum vector_expr_op op;         /* Nodtyp. */
+   size_t left;                    /* Index till frsta operanden. */
+   size_t right;                   /* Index till andra operanden. */
+   const struct vector* input;     /* Vektor fr VECTOR_EXPR_INPUT. */
+   union vector_small scalar;      /* Vrde fr VECTOR_EXPR_SCALAR. */
+   void (*map)(void* dest,         /* Funktion fr VECTOR_EXPR_MAP. */
+               const void* source,
+               const size_t size,
+               void* context);
+   void* context;                  /* Data som passeras till funktionen. */
+};
+
+/*******************************************************************************
+* vector_expr: Uttryck bestende av upp till VECTOR_EXPR_MAX_NODES noder.
+*              Uttrycket allokerar inget minne frrn det berknas och
+*              behver drfr inte raderas.
+*******************************************************************************/
+struct vector_expr
+{
+   enum vector_type type;  /* Uttryckets datatyp. */
+   size_t num_nodes;       /* Antalet noder. */
+   int error;              /* Indikerar ifall en nod inte kunde skapas. */
+   struct vector_expr_node nodes[VECTOR_EXPR_MAX_NODES]; /* Uttryckets noder. */
+};
+
+/* Externa funktioner: */
+void vector_expr_new(struct vector_expr* self,
+                     const enum vector_type type);
+size_t vector_expr_input(struct vector_expr* self,
+                         const struct vector* input);
+size_t vector_expr_scalar(struct vector_expr* self,
+                          const void* value);
+size_t vector_expr_unary(struct vector_expr* self,
+                         const enum vector_expr_op op,
+                         const size_t operand);
+size_t vector_expr_binary(struct vector_expr* self,
+                          const enum vector_expr_op op,
+                          const size_t left,
+                          const size_t right);
+size_t vector_expr_map(struct vector_expr* self,
+                       const size_t operand,
+                       void (*map)(void* dest, const void* source,
+                                   const size_t size, void* context),
+                       void* context);
+size_t vector_expr_filter(struct vector_expr* self,
+                          const size_t value,
+                          const size_t condition);
+int vector_expr_eval(const struct vector_expr* self,
+                     const size_t root,
+                     struct vector* dest);
+int vector_expr_reduce(const struct vector_expr* self,
+                       const size_t root,
+                       const enum vector_parallel_reduction reduction,
+                       void* result);
+
+#endif /* VECTOR_EXPR_H_ */
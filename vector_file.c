@@ -0,0 +1,281 @@
+/*******************************************************************************
+* vector_file.c: Innehller funktioner fr att spara, lsa in samt
+*                minnesmappa vektorer i binrt format.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector_file.h"
+#include "vector_stats.h"
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Statiska funktioner: */
+static uint8_t vector_file_endianness(void);
+static int vector_file_check(const struct vector_file_header* header,
+                             const int native_only);
+static void vector_file_swap(void* data,
+                             const size_t size,
+                             const size_t element_size);
+static void* vector_mapping_allocate(void* context,
+                                     const size_t size);
+static void* vector_mapping_reallocate(void* context,
+                                       void* block,
+                                       const size_t old_size,
+                                       const size_t new_size);
+static void vector_mapping_deallocate(void* context,
+                                      void* block,
+                                      const size_t size);
+
+/* Allokerare fr mappade vektorer, som enbart kan ta bort mappningen. */
+static const struct vector_allocator vector_mapping_allocator =
+{
+   &vector_mapping_allocate, &vector_mapping_reallocate, &vector_mapping_deallocate, 0
+};
+
+/*******************************************************************************
+* vector_save: Sparar angiven vektor i binrt format i angiven fil. Eventuellt
+*              tidigare innehll i filen skrivs ver.
+*              - self: Pekare till vektorn.
+*              - path: Skvg till filen.
+*******************************************************************************/
+int vector_save(const struct vector* self,
+                const char* path)
+{
+   struct vector_file_header header;
+   if (!self->ops->element_size) return 1;
+
+   memset(&header, 0, sizeof(header));
+   memcpy(header.magic, "PVEC", 4);
+   header.version = VECTOR_FILE_VERSION;
+   header.endianness = vector_file_endianness();
+   header.type = (uint8_t)self->type;
+   header.element_size = (uint32_t)self->ops->element_size;
+   header.size = (uint64_t)self->size;
+
+   FILE* ostream = fopen(path, "wb");
+   if (!ostream) return 1;
+
+   int status = fwrite(&header, sizeof(header), 1, ostream) != 1;
+   if (!status && self->size)
+   {
+      status = fwrite(self->data.raw, self->ops->element_size, self->size, ostream) != self->size;
+   }
+   if (fclose(ostream)) status = 1;
+   return status;
+}
+
+/*******************************************************************************
+* vector_load: Lser in en vektor frn angiven fil som en egen kopia, som
+*              drmed kan ndras. Filer sparade med motsatt byteordning
+*              omvandlas vid inlsning. Filer vars huvud anger fler element
+*              n filen innehller avvisas innan minne reserveras.
+*              Eventuellt tidigare innehll i vektorn raderas.
+*              - self: Pekare till vektorn som innehllet skall lagras i.
+*              - path: Skvg till filen.
+*******************************************************************************/
+int vector_load(struct vector* self,
+                const char* path)
+{
+   struct vector_file_header header;
+   struct stat info;
+   FILE* istream = fopen(path, "rb");
+   if (!istream) return 1;
+
+   if (fread(&header, sizeof(header), 1, istream) == 1 &&
+       header.endianness != vector_file_endianness())
+   {
+      vector_file_swap(&header.version, 1, sizeof(header.version));
+      vector_file_swap(&header.element_size, 1, sizeof(header.element_size));
+      vector_file_swap(&header.size, 1, sizeof(header.size));
+   }
+
+   /* Antalet element kontrolleras mot filens storlek innan minne reserveras: */
+   if (ferror(istream) || feof(istream) || vector_file_check(&header, 0) ||
+       (!fstat(fileno(istream), &info) && S_ISREG(info.st_mode) &&
+        header.size > ((uint64_t)info.st_size - VECTOR_FILE_HEADER_SIZE) / header.element_size))
+   {
+      fclose(istream);
+      return 1;
+   }
+
+   vector_delete(self);
+   const struct vector_allocator* allocator = self->allocator;
+   vector_new(self, (enum vector_type)header.type);
+   self->allocator = allocator;
+
+   if (header.size > SIZE_MAX || vector_resize(self, (size_t)header.size) ||
+       fread(self->data.raw, self->ops->element_size, self->size, istream) != self->size)
+   {
+      vector_delete(self);
+      fclose(istream);
+      return 1;
+   }
+
+   if (header.endianness != vector_file_endianness())
+   {
+      vector_file_swap(self->data.raw, self->size, self->ops->element_size);
+   }
+
+   fclose(istream);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_map: Minnesmappar angiven fil och returnerar en heapallokerad,
+*             skrivskyddad vektor vars flt pekar direkt in i mappningen.
+*             Ingen kopiering eller tolkning sker, vilket gr att ven mycket
+*             stora filer ppnas direkt; sidorna lses in vid frsta tkomst.
+*             Filen mste ha samma byteordning som processorn. Mappningen
+*             tas bort nr vektorn raderas. Vid fel returneras en nullpekare.
+*             - path: Skvg till filen.
+*******************************************************************************/
+struct vector* vector_map(const char* path)
+{
+   struct vector_file_header header;
+   struct stat info;
+   const int fd = open(path, O_RDONLY);
+   if (fd < 0) return 0;
+
+   if (fstat(fd, &info) || (uint64_t)info.st_size < VECTOR_FILE_HEADER_SIZE ||
+       pread(fd, &header, sizeof(header), 0) != (ssize_t)sizeof(header) ||
+       vector_file_check(&header, 1) ||
+       header.size > ((uint64_t)info.st_size - VECTOR_FILE_HEADER_SIZE) / header.element_size)
+   {
+      close(fd);
+      return 0;
+   }
+
+   const size_t length = VECTOR_FILE_HEADER_SIZE + (size_t)header.size * header.element_size;
+   void* mapping = mmap(0, length, PROT_READ, MAP_SHARED, fd, 0);
+   close(fd);
+   if (mapping == MAP_FAILED) return 0;
+
+   struct vector* self = (struct vector*)malloc(sizeof(struct vector));
+   if (!self)
+   {
+      munmap(mapping, length);
+      return 0;
+   }
+
+   vector_new(self, (enum vector_type)header.type);
+   self->allocator = &vector_mapping_allocator;
+   self->data.raw = (char*)mapping + VECTOR_FILE_HEADER_SIZE;
+   self->size = (size_t)header.size;
+   self->capacity = self->size;
+   self->flags = VECTOR_FLAG_READONLY;
+
+   /* Mappningen frigrs som ett flt vid radering och rknas drfr som en allokering: */
+   VECTOR_STATS_ALLOCATE(self->capacity * self->ops->element_size);
+   return self;
+}
+
+/*******************************************************************************
+* vector_unmap: Tar bort mappningen fr en vektor skapad via vector_map samt
+*               frigr vektorn, motsvarande vector_ptr_delete. Adressen till
+*               vektorpekaren passeras fr att kunna nollstlla pekaren.
+*               - self: Adressen till vektorpekaren.
+*******************************************************************************/
+void vector_unmap(struct vector** self)
+{
+   if (*self) vector_ptr_delete(self);
+   return;
+}
+
+/*******************************************************************************
+* vector_file_endianness: Returnerar processorns byteordning.
+*******************************************************************************/
+static uint8_t vector_file_endianness(void)
+{
+   const uint16_t probe = 1;
+   uint8_t first;
+   memcpy(&first, &probe, 1);
+   return first ? VECTOR_FILE_LITTLE_ENDIAN : VECTOR_FILE_BIG_ENDIAN;
+}
+
+/*******************************************************************************
+* vector_file_check: Kontrollerar att ett filhuvud r giltigt och att
+*                    datatypen har samma elementstorlek som i aktuellt bygge.
+*                    Huvudets tal mste ha processorns byteordning.
+*                    - header     : Pekare till filhuvudet.
+*                    - native_only: Indikerar ifall enbart processorns
+*                                   byteordning godtas (vid minnesmappning).
+*******************************************************************************/
+static int vector_file_check(const struct vector_file_header* header,
+                             const int native_only)
+{
+   if (memcmp(header->magic, "PVEC", 4)) return 1;
+   if (header->endianness != VECTOR_FILE_LITTLE_ENDIAN &&
+       header->endianness != VECTOR_FILE_BIG_ENDIAN) return 1;
+   if (native_only && header->endianness != vector_file_endianness()) return 1;
+   if (header->version != VECTOR_FILE_VERSION) return 1;
+   if (header->type >= VECTOR_TYPE_NONE) return 1;
+   if (header->element_size != vector_ops((enum vector_type)header->type)->element_size) return 1;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_file_swap: Vnder byteordningen fr samtliga element i ett flt.
+*                   - data        : Pekare till fltet.
+*                   - size        : Antalet element.
+*                   - element_size: Elementens storlek i byte.
+*******************************************************************************/
+static void vector_file_swap(void* data,
+                             const size_t size,
+                             const size_t element_size)
+{
+   unsigned char* bytes = (unsigned char*)data;
+
+   for (size_t i = 0; i < size; ++i, bytes += element_size)
+   {
+      for (size_t j = 0; j < element_size / 2; ++j)
+      {
+         const unsigned char temp = bytes[j];
+         bytes[j] = bytes[element_size - 1 - j];
+         bytes[element_size - 1 - j] = temp;
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_mapping_allocate: Mappade vektorer kan inte allokera nytt minne.
+*******************************************************************************/
+static void* vector_mapping_allocate(void* context,
+                                     const size_t size)
+{
+   (void)context;
+   (void)size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_mapping_reallocate: Mappade vektorer kan inte ndra storlek.
+*******************************************************************************/
+static void* vector_mapping_reallocate(void* context,
+                                       void* block,
+                                       const size_t old_size,
+                                       const size_t new_size)
+{
+   (void)context;
+   (void)block;
+   (void)old_size;
+   (void)new_size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_mapping_deallocate: Tar bort mappningen, som inleds av filhuvudet
+*                            direkt fre vektorns flt.
+*                            - block: Pekare till vektorns flt.
+*                            - size : Fltets storlek i byte.
+*******************************************************************************/
+static void vector_mapping_deallocate(void* context,
+                                      void* block,
+                                      const size_t size)
+{
+   (void)context;
+   munmap((char*)block - VECTOR_FILE_HEADER_SIZE, VECTOR_FILE_HEADER_SIZE + size);
+   return;
+}
@@ -0,0 +1,50 @@
+/*******************************************************************************
+* vector_file.h: Binrt filformat fr vektorer. Filen bestr av ett huvud om
+*                64 byte (magiskt tal, formatversion, byteordning, datatyp,
+*                elementstorlek samt antalet element) fljt av elementen i
+*                rtt format. Huvudets storlek gr att elementen hamnar p en
+*                64-bytesgrns ven nr filen minnesmappas.
+*
+*                Filer kan lsas in som en egen kopia via vector_load, eller
+*                minnesmappas via vector_map, dr den returnerade vektorn
+*                pekar direkt in i mappningen utan kopiering eller tolkning.
+*                En mappad vektor r skrivskyddad och mappningen tas bort nr
+*                vektorn raderas, exempelvis via vector_unmap.
+*******************************************************************************/
+#ifndef VECTOR_FILE_H_
+#define VECTOR_FILE_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include <stdint.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_FILE_VERSION 1         /* Aktuell formatversion. */
+#define VECTOR_FILE_HEADER_SIZE 64    /* Filhuvudets storlek i byte. */
+#define VECTOR_FILE_LITTLE_ENDIAN 1   /* Minst signifikanta byte frst. */
+#define VECTOR_FILE_BIG_ENDIAN 2      /* Mest signifikanta byte frst. */
+
+/*******************************************************************************
+* vector_file_header: Filhuvud som inleder varje vektorfil.
+*******************************************************************************/
+struct vector_file_header
+{
+   char magic[4];         /* Magiskt tal "PVEC". */
+   uint16_t version;      /* Formatversion. */
+   uint8_t endianness;    /* Byteordning fr samtliga tal i filen. */
+   uint8_t type;          /* Vektorns datatyp (enum vector_type). */
+   uint32_t element_size; /* Elementens storlek i byte. */
+   uint32_t reserved;     /* Reserverat, stts till noll. */
+   uint64_t size;         /* Antalet element. */
+   uint8_t padding[40];   /* Utfyllnad till VECTOR_FILE_HEADER_SIZE byte. */
+};
+
+/* Externa funktioner: */
+int vector_save(const struct vector* self,
+                const char* path);
+int vector_load(struct vector* self,
+                const char* path);
+struct vector* vector_map(const char* path);
+void vector_unmap(struct vector** self);
+
+#endif /* VECTOR_FILE_H_ */
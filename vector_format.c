@@ -0,0 +1,574 @@
+/*******************************************************************************
+* vector_format.c: Innehller funktioner fr snabb textutskrift av vektorer.
+*                  Flyttal formateras via Grisu2 enligt Florian Loitsch,
+*                  "Printing Floating-Point Numbers Quickly and Accurately
+*                  with Integers" (PLDI 2010).
+*******************************************************************************/
+#include "vector_format.h"
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_WRITE_BUFFER_SIZE 65536 /* Storlek p mellanlagringsbufferten. */
+
+/*******************************************************************************
+* vector_diyfp: Flyttal med 64-bitars signifikand f och exponent e, vilket
+*               representerar talet f * 2^e.
+*******************************************************************************/
+struct vector_diyfp
+{
+   uint64_t f; /* Signifikand. */
+   int e;      /* Binr exponent. */
+};
+
+/* Tvsiffriga decimala tal 00 - 99, fr utskrift av tv siffror i taget. */
+static const char vector_digit_pairs[201] =
+   "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+   "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+   "8081828384858687888990919293949596979899";
+
+/* Tiopotenser 10^0 - 10^19. */
+static const uint64_t vector_pow10[] =
+{
+   1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL,
+   100000000ULL, 1000000000ULL, 10000000000ULL, 100000000000ULL,
+   1000000000000ULL, 10000000000000ULL, 100000000000000ULL,
+   1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+   1000000000000000000ULL, 10000000000000000000ULL
+};
+
+/* Normaliserade tiopotenser 10^k fr k = -348, -340, ..., 340 (signifikander). */
+static const uint64_t vector_cached_powers_f[] =
+{
+   0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+   0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+   0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+   0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+   0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+   0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+   0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+   0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+   0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+   0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+   0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+   0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+   0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+   0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+   0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+   0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+   0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+   0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+   0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+   0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+   0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+   0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+   0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+   0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+   0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+   0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+   0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+   0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+   0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+/* Normaliserade tiopotenser 10^k fr k = -348, -340, ..., 340 (exponenter). */
+static const int16_t vector_cached_powers_e[] =
+{
+   -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+   -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+   -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+   -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+   56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+   375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+   694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+   1013, 1039, 1066
+};
+
+/* Statiska funktioner: */
+static size_t vector_format_digits(char* dest,
+                                   uint64_t value);
+static struct vector_diyfp vector_diyfp_multiply(const struct vector_diyfp lhs,
+                                                 const struct vector_diyfp rhs);
+static struct vector_diyfp vector_diyfp_normalize(struct vector_diyfp self);
+static struct vector_diyfp vector_diyfp_from_double(const double value,
+                                                    int* lower_closer);
+static struct vector_diyfp vector_diyfp_from_float(const float value,
+                                                   int* lower_closer);
+static size_t vector_format_floating(char* dest,
+                                     const double value,
+                                     const int single);
+static void vector_grisu_round(char* buffer,
+                               const int length,
+                               const uint64_t delta,
+                               uint64_t rest,
+                               const uint64_t ten_kappa,
+                               const uint64_t wp_w);
+static int vector_grisu2(const struct vector_diyfp v,
+                         const int lower_closer,
+                         char* buffer,
+                         int* decimal_exponent);
+static size_t vector_format_exponent(char* dest,
+                                     int exponent);
+
+/*******************************************************************************
+* vector_write: Skriver ut samtliga element i angiven vektor via angiven
+*               utstrm. Texten mellanlagras i en buffert som skrivs ut med
+*               ett anrop till fwrite per fylld buffert. Elementen skiljs t
+*               av vald separator. Endast radvis utskrift avslutas med en
+*               radbrytning, vriga separatorer skrivs enbart mellan elementen.
+*               - self   : Pekare till vektorn.
+*               - ostream: Pekare till angiven utstrm (stdout som default).
+*               - options: Instllningar fr utskriften (nullpekare medfr
+*                          ett element per rad utan sidhuvud och sidfot).
+*******************************************************************************/
+int vector_write(const struct vector* self,
+                 FILE* ostream,
+                 const struct vector_write_options* options)
+{
+   static const struct vector_write_options default_options = { VECTOR_SEPARATOR_NEWLINE, 0, 0 };
+   if (!options) options = &default_options;
+   if (!ostream) ostream = stdout;
+   if (self->type >= VECTOR_TYPE_NONE) return 1;
+
+   char* buffer = (char*)malloc(VECTOR_WRITE_BUFFER_SIZE);
+   if (!buffer) return 1;
+
+   const char separator = options->separator == VECTOR_SEPARATOR_COMMA ? ',' :
+                          options->separator == VECTOR_SEPARATOR_SPACE ? ' ' : '\n';
+   const size_t limit = VECTOR_WRITE_BUFFER_SIZE - VECTOR_FORMAT_MAX - 1;
+   size_t length = 0;
+   int status = 0;
+
+   if (options->header) fputs(options->header, ostream);
+
+   for (size_t i = 0; i < self->size; ++i)
+   {
+      if (length > limit)
+      {
+         if (fwrite(buffer, 1, length, ostream) != length) status = 1;
+         length = 0;
+      }
+
+      char* dest = buffer + length;
+      switch (self->type)
+      {
+         case VECTOR_TYPE_INTEGER: length += vector_format_int(dest, self->data.integer[i]); break;
+         case VECTOR_TYPE_DOUBLE: length += vector_format_double(dest, self->data.decimal[i]); break;
+         case VECTOR_TYPE_INT8: length += vector_format_int(dest, self->data.int8[i]); break;
+         case VECTOR_TYPE_INT16: length += vector_format_int(dest, self->data.int16[i]); break;
+         case VECTOR_TYPE_INT64: length += vector_format_int64(dest, self->data.int64[i]); break;
+         case VECTOR_TYPE_UINT8: length += vector_format_unsigned(dest, self->data.uint8[i]); break;
+         case VECTOR_TYPE_UINT16: length += vector_format_unsigned(dest, self->data.uint16[i]); break;
+         case VECTOR_TYPE_UINT32: length += vector_format_unsigned(dest, self->data.uint32[i]); break;
+         case VECTOR_TYPE_FLOAT: length += vector_format_float(dest, self->data.single[i]); break;
+         default: length += vector_format_unsigned(dest, self->data.natural[i]); break;
+      }
+      buffer[length++] = separator;
+   }
+
+   if (length && separator != '\n') length--;
+   if (fwrite(buffer, 1, length, ostream) != length) status = 1;
+   if (options->footer) fputs(options->footer, ostream);
+   free(buffer);
+   return status;
+}
+
+/*******************************************************************************
+* vector_format_int: Skriver ett signerat heltal som text till angiven adress
+*                    och returnerar antalet skrivna tecken (utan nolltecken).
+*                    - dest : Adressen dit texten skrivs (minst
+*                             VECTOR_FORMAT_MAX tecken).
+*                    - value: Talet som skall skrivas.
+*******************************************************************************/
+size_t vector_format_int(char* dest,
+                         const int value)
+{
+   return vector_format_int64(dest, value);
+}
+
+/*******************************************************************************
+* vector_format_int64: Skriver ett signerat 64-bitars heltal som text till
+*                      angiven adress och returnerar antalet skrivna tecken.
+*                      - dest : Adressen dit texten skrivs (minst
+*                               VECTOR_FORMAT_MAX tecken).
+*                      - value: Talet som skall skrivas.
+*******************************************************************************/
+size_t vector_format_int64(char* dest,
+                           const int64_t value)
+{
+   if (value < 0)
+   {
+      *dest = '-';
+      return 1 + vector_format_digits(dest + 1, (uint64_t)0 - (uint64_t)value);
+   }
+   return vector_format_digits(dest, (uint64_t)value);
+}
+
+/*******************************************************************************
+* vector_format_unsigned: Skriver ett osignerat heltal som text till angiven
+*                         adress och returnerar antalet skrivna tecken.
+*                         - dest : Adressen dit texten skrivs (minst
+*                                  VECTOR_FORMAT_MAX tecken).
+*                         - value: Talet som skall skrivas.
+*******************************************************************************/
+size_t vector_format_unsigned(char* dest,
+                              const size_t value)
+{
+   return vector_format_digits(dest, (uint64_t)value);
+}
+
+/*******************************************************************************
+* vector_format_double: Skriver ett flyttal som text till angiven adress och
+*                       returnerar antalet skrivna tecken. Tal vars storlek
+*                       ligger mellan 1e-6 och 1e21 skrivs i decimalform,
+*                       vriga i exponentform, exempelvis 1.5e+300.
+*                       - dest : Adressen dit texten skrivs (minst
+*                                VECTOR_FORMAT_MAX tecken).
+*                       - value: Talet som skall skrivas.
+*******************************************************************************/
+size_t vector_format_double(char* dest,
+                            const double value)
+{
+   return vector_format_floating(dest, value, 0);
+}
+
+/*******************************************************************************
+* vector_format_float: Skriver ett flyttal med enkel precision som text till
+*                      angiven adress och returnerar antalet skrivna tecken.
+*                      Siffrorna r de kortaste som lses tillbaka till exakt
+*                      samma tal i enkel precision, exempelvis 0.1 i stllet
+*                      fr 0.10000000149011612.
+*                      - dest : Adressen dit texten skrivs (minst
+*                               VECTOR_FORMAT_MAX tecken).
+*                      - value: Talet som skall skrivas.
+*******************************************************************************/
+size_t vector_format_float(char* dest,
+                           const float value)
+{
+   return vector_format_floating(dest, value, 1);
+}
+
+/*******************************************************************************
+* vector_format_floating: Skriver ett flyttal som text via Grisu2, dr
+*                         avrundningsintervallet tas fram fr angiven
+*                         precision. Anvnds av vector_format_double samt
+*                         vector_format_float.
+*                         - dest  : Adressen dit texten skrivs.
+*                         - value : Talet som skall skrivas.
+*                         - single: Indikerar ifall talet har enkel precision.
+*******************************************************************************/
+static size_t vector_format_floating(char* dest,
+                                     const double value,
+                                     const int single)
+{
+   char digits[20];
+   char* s = dest;
+   int exponent = 0;
+
+   if (value != value)
+   {
+      memcpy(dest, "nan", 3);
+      return 3;
+   }
+   if (signbit(value)) *s++ = '-';
+   if (value == 0.0)
+   {
+      *s++ = '0';
+      return (size_t)(s - dest);
+   }
+   if (value == HUGE_VAL || value == -HUGE_VAL)
+   {
+      memcpy(s, "inf", 3);
+      return (size_t)(s - dest) + 3;
+   }
+
+   const double magnitude = value < 0 ? -value : value;
+   int lower_closer = 0;
+   const struct vector_diyfp v = single ? vector_diyfp_from_float((float)magnitude, &lower_closer)
+                                        : vector_diyfp_from_double(magnitude, &lower_closer);
+   const int length = vector_grisu2(v, lower_closer, digits, &exponent);
+   const int point = length + exponent; /* Decimalpunktens position. */
+
+   if (length <= point && point <= 21)
+   {
+      memcpy(s, digits, (size_t)length);
+      memset(s + length, '0', (size_t)(point - length));
+      s += point;
+   }
+   else if (0 < point && point <= 21)
+   {
+      memcpy(s, digits, (size_t)point);
+      s[point] = '.';
+      memcpy(s + point + 1, digits + point, (size_t)(length - point));
+      s += length + 1;
+   }
+   else if (-6 < point && point <= 0)
+   {
+      s[0] = '0';
+      s[1] = '.';
+      memset(s + 2, '0', (size_t)-point);
+      memcpy(s + 2 - point, digits, (size_t)length);
+      s += 2 - point + length;
+   }
+   else
+   {
+      *s++ = digits[0];
+      if (length > 1)
+      {
+         *s++ = '.';
+         memcpy(s, digits + 1, (size_t)(length - 1));
+         s += length - 1;
+      }
+      *s++ = 'e';
+      s += vector_format_exponent(s, point - 1);
+   }
+   return (size_t)(s - dest);
+}
+
+/*******************************************************************************
+* vector_format_digits: Skriver ett osignerat heltal tv siffror i taget,
+*                       bakifrn, och returnerar antalet skrivna tecken.
+*                       - dest : Adressen dit siffrorna skrivs.
+*                       - value: Talet som skall skrivas.
+*******************************************************************************/
+static size_t vector_format_digits(char* dest,
+                                   uint64_t value)
+{
+   char temp[20];
+   char* end = temp + sizeof(temp);
+   char* s = end;
+
+   while (value >= 100)
+   {
+      const unsigned pair = (unsigned)(value % 100) * 2;
+      value /= 100;
+      *--s = vector_digit_pairs[pair + 1];
+      *--s = vector_digit_pairs[pair];
+   }
+   if (value >= 10)
+   {
+      const unsigned pair = (unsigned)value * 2;
+      *--s = vector_digit_pairs[pair + 1];
+      *--s = vector_digit_pairs[pair];
+   }
+   else
+   {
+      *--s = (char)('0' + value);
+   }
+
+   memcpy(dest, s, (size_t)(end - s));
+   return (size_t)(end - s);
+}
+
+/*******************************************************************************
+* vector_format_exponent: Skriver en decimal exponent med tecken, exempelvis
+*                         +21 eller -7, och returnerar antalet skrivna tecken.
+*                         - dest    : Adressen dit exponenten skrivs.
+*                         - exponent: Exponenten som skall skrivas.
+*******************************************************************************/
+static size_t vector_format_exponent(char* dest,
+                                     int exponent)
+{
+   dest[0] = exponent < 0 ? '-' : '+';
+   if (exponent < 0) exponent = -exponent;
+   return 1 + vector_format_digits(dest + 1, (uint64_t)exponent);
+}
+
+/*******************************************************************************
+* vector_diyfp_multiply: Multiplicerar tv flyttal och avrundar produktens
+*                        128-bitars signifikand till de 64 hgsta bitarna.
+*******************************************************************************/
+static struct vector_diyfp vector_diyfp_multiply(const struct vector_diyfp lhs,
+                                                 const struct vector_diyfp rhs)
+{
+   const uint64_t mask = 0xFFFFFFFFULL;
+   const uint64_t a = lhs.f >> 32, b = lhs.f & mask;
+   const uint64_t c = rhs.f >> 32, d = rhs.f & mask;
+   const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+   uint64_t temp = (bd >> 32) + (ad & mask) + (bc & mask);
+   temp += 1ULL << 31;
+   struct vector_diyfp result = { ac + (ad >> 32) + (bc >> 32) + (temp >> 32), lhs.e + rhs.e + 64 };
+   return result;
+}
+
+/*******************************************************************************
+* vector_diyfp_normalize: Skiftar signifikanden s att dess hgsta bit r satt.
+*******************************************************************************/
+static struct vector_diyfp vector_diyfp_normalize(struct vector_diyfp self)
+{
+   while (!(self.f & (1ULL << 63)))
+   {
+      self.f <<= 1;
+      self.e--;
+   }
+   return self;
+}
+
+/*******************************************************************************
+* vector_grisu_round: Justerar sista siffran s att resultatet hamnar s nra
+*                     det exakta vrdet som mjligt inom avrundningsintervallet.
+*******************************************************************************/
+static void vector_grisu_round(char* buffer,
+                               const int length,
+                               const uint64_t delta,
+                               uint64_t rest,
+                               const uint64_t ten_kappa,
+                               const uint64_t wp_w)
+{
+   while (rest < wp_w && delta - rest >= ten_kappa &&
+          (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w))
+   {
+      buffer[length - 1]--;
+      rest += ten_kappa;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_diyfp_from_double: Omvandlar ett positivt, ndligt flyttal till
+*                           signifikand och exponent.
+*                           - value       : Talet som skall omvandlas.
+*                           - lower_closer: Pekare till variabel som anger
+*                                           ifall undre grnsen fr
+*                                           avrundningsintervallet ligger
+*                                           nrmare talet (tvpotenser).
+*******************************************************************************/
+static struct vector_diyfp vector_diyfp_from_double(const double value,
+                                                    int* lower_closer)
+{
+   const uint64_t hidden_bit = 1ULL << 52;
+   const uint64_t significand_mask = hidden_bit - 1;
+   uint64_t bits;
+   memcpy(&bits, &value, sizeof(bits));
+
+   const int biased_exponent = (int)((bits >> 52) & 0x7FF);
+   struct vector_diyfp v;
+   if (biased_exponent)
+   {
+      v.f = (bits & significand_mask) + hidden_bit;
+      v.e = biased_exponent - 1075;
+   }
+   else
+   {
+      v.f = bits & significand_mask;
+      v.e = -1074;
+   }
+   *lower_closer = v.f == hidden_bit;
+   return v;
+}
+
+/*******************************************************************************
+* vector_diyfp_from_float: Omvandlar ett positivt, ndligt flyttal med enkel
+*                          precision till signifikand och exponent.
+*                          - value       : Talet som skall omvandlas.
+*                          - lower_closer: Pekare till variabel som anger
+*                                          ifall undre grnsen fr
+*                                          avrundningsintervallet ligger
+*                                          nrmare talet (tvpotenser).
+*******************************************************************************/
+static struct vector_diyfp vector_diyfp_from_float(const float value,
+                                                   int* lower_closer)
+{
+   const uint32_t hidden_bit = 1UL << 23;
+   const uint32_t significand_mask = hidden_bit - 1;
+   uint32_t bits;
+   memcpy(&bits, &value, sizeof(bits));
+
+   const int biased_exponent = (int)((bits >> 23) & 0xFF);
+   struct vector_diyfp v;
+   if (biased_exponent)
+   {
+      v.f = (bits & significand_mask) + hidden_bit;
+      v.e = biased_exponent - 150;
+   }
+   else
+   {
+      v.f = bits & significand_mask;
+      v.e = -149;
+   }
+   *lower_closer = v.f == hidden_bit;
+   return v;
+}
+
+/*******************************************************************************
+* vector_grisu2: Tar fram decimala siffror fr ett positivt, ndligt flyttal
+*                s att value = siffror * 10^decimal_exponent. Returnerar
+*                antalet siffror (hgst 17).
+*                - v               : Talets signifikand och exponent.
+*                - lower_closer    : Indikerar ifall undre grnsen fr
+*                                    avrundningsintervallet ligger nrmare.
+*                - buffer          : Buffert dr siffrorna lagras.
+*                - decimal_exponent: Pekare till den decimala exponenten.
+*******************************************************************************/
+static int vector_grisu2(const struct vector_diyfp v,
+                         const int lower_closer,
+                         char* buffer,
+                         int* decimal_exponent)
+{
+   /* Tar fram normaliserade grnser fr avrundningsintervallet: */
+   const struct vector_diyfp plus = vector_diyfp_normalize((struct vector_diyfp){ (v.f << 1) + 1, v.e - 1 });
+   struct vector_diyfp minus = lower_closer ? (struct vector_diyfp){ (v.f << 2) - 1, v.e - 2 }
+                                            : (struct vector_diyfp){ (v.f << 1) - 1, v.e - 1 };
+   minus.f <<= minus.e - plus.e;
+   minus.e = plus.e;
+
+   /* Skalar talet med en lagrad tiopotens s att exponenten hamnar rtt: */
+   const double dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+   int k = (int)dk;
+   if (dk - k > 0.0) k++;
+   const unsigned index = (unsigned)((k >> 3) + 1);
+   const struct vector_diyfp cached = { vector_cached_powers_f[index], vector_cached_powers_e[index] };
+   *decimal_exponent = -(-348 + (int)index * 8);
+
+   const struct vector_diyfp w = vector_diyfp_multiply(vector_diyfp_normalize(v), cached);
+   struct vector_diyfp wp = vector_diyfp_multiply(plus, cached);
+   struct vector_diyfp wm = vector_diyfp_multiply(minus, cached);
+   wm.f++;
+   wp.f--;
+
+   /* Genererar siffror s lnge de ligger utanfr avrundningsintervallet: */
+   uint64_t delta = wp.f - wm.f;
+   const struct vector_diyfp one = { 1ULL << -wp.e, wp.e };
+   const uint64_t wp_w = wp.f - w.f;
+   uint32_t p1 = (uint32_t)(wp.f >> -one.e);
+   uint64_t p2 = wp.f & (one.f - 1);
+   int kappa = 1;
+   int length = 0;
+
+   while (kappa < 10 && p1 >= vector_pow10[kappa]) kappa++;
+
+   while (kappa > 0)
+   {
+      const uint32_t divisor = (uint32_t)vector_pow10[kappa - 1];
+      const uint32_t digit = p1 / divisor;
+      p1 %= divisor;
+      if (digit || length) buffer[length++] = (char)('0' + digit);
+      kappa--;
+
+      const uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+      if (rest <= delta)
+      {
+         *decimal_exponent += kappa;
+         vector_grisu_round(buffer, length, delta, rest, vector_pow10[kappa] << -one.e, wp_w);
+         return length;
+      }
+   }
+
+   while (1)
+   {
+      p2 *= 10;
+      delta *= 10;
+      const char digit = (char)(p2 >> -one.e);
+      if (digit || length) buffer[length++] = (char)('0' + digit);
+      p2 &= one.f - 1;
+      kappa--;
+
+      if (p2 < delta)
+      {
+         *decimal_exponent += kappa;
+         vector_grisu_round(buffer, length, delta, p2, one.f, wp_w * vector_pow10[-kappa]);
+         return length;
+      }
+   }
+}
@@ -0,0 +1,54 @@
+/*******************************************************************************
+* vector_format.h: Snabb textutskrift av vektorer. Talen formateras via egna
+*                  funktioner i stllet fr printf, dr heltal skrivs tv
+*                  siffror i taget och flyttal skrivs med Grisu2-algoritmen,
+*                  som ger den kortaste siffersekvens som lses tillbaka till
+*                  exakt samma flyttal (i ett ftal fall en siffra lngre).
+*                  Utskriften mellanlagras i en stor buffert som skrivs ut
+*                  med ett anrop till fwrite nr den blir full.
+*******************************************************************************/
+#ifndef VECTOR_FORMAT_H_
+#define VECTOR_FORMAT_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_FORMAT_MAX 32 /* Maximalt antal tecken fr ett formaterat tal. */
+
+/*******************************************************************************
+* vector_separator: Tecken som skiljer elementen t vid utskrift.
+*******************************************************************************/
+enum vector_separator
+{
+   VECTOR_SEPARATOR_NEWLINE, /* Ett element per rad. */
+   VECTOR_SEPARATOR_COMMA,   /* Kommaseparerade element p en rad. */
+   VECTOR_SEPARATOR_SPACE    /* Blankstegsseparerade element p en rad. */
+};
+
+/*******************************************************************************
+* vector_write_options: Instllningar fr utskrift via vector_write.
+*******************************************************************************/
+struct vector_write_options
+{
+   enum vector_separator separator; /* Tecken mellan elementen. */
+   const char* header;              /* Text fre elementen (nullpekare = ingen). */
+   const char* footer;              /* Text efter elementen (nullpekare = ingen). */
+};
+
+/* Externa funktioner: */
+int vector_write(const struct vector* self,
+                 FILE* ostream,
+                 const struct vector_write_options* options);
+size_t vector_format_int(char* dest,
+                         const int value);
+size_t vector_format_int64(char* dest,
+                           const int64_t value);
+size_t vector_format_unsigned(char* dest,
+                              const size_t value);
+size_t vector_format_double(char* dest,
+                            const double value);
+size_t vector_format_float(char* dest,
+                           const float value);
+
+#endif /* VECTOR_FORMAT_H_ */
@@ -0,0 +1,878 @@
+/*******************************************************************************
+* vector_hash.c: Innehller hashbaserade operationer ver vektorer av
+*                heltal. Nycklarna lses blockvis och breddas till 64 bitar,
+*                vilket gr att samma hashtabell anvnds fr samtliga
+*                heltalstyper. Hashvrdet berknas via multiplikation med
+*                en udda konstant (Fibonacci-hashning), dr de hgsta bitarna
+*                frst vljer partition och de nrmast fljande vljer plats
+*                i partitionens tabell.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector_hash.h"
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_HASH_BLOCK_SIZE 1024                  /* Antalet nycklar per block vid inlsning. */
+#define VECTOR_HASH_MIN_CAPACITY 1024                /* Hashtabellens minsta antal platser. */
+#define VECTOR_HASH_PARTITION_BITS 6                 /* Antalet hashbitar som vljer partition. */
+#define VECTOR_HASH_PARTITIONS (1 << VECTOR_HASH_PARTITION_BITS) /* Antalet partitioner. */
+#define VECTOR_HASH_MAX_THREADS 16                   /* Strsta antalet trdar vid partitionering. */
+#define VECTOR_HASH_DEFAULT_CACHE_SIZE 8388608       /* Antagen storlek p L3-cachen i byte. */
+#define VECTOR_HASH_MULTIPLIER 0x9E3779B97F4A7C15ULL /* 2^64 delat med det gyllene snittet. */
+#define VECTOR_HASH_PREFETCH_DISTANCE 16             /* Antalet nycklar som platser lses in i frvg. */
+
+/* Lser in platsen fr en kommande nyckel i cacheminnet medan aktuell nyckel sks. */
+#if defined(__GNUC__) || defined(__clang__)
+#define VECTOR_HASH_PREFETCH(self, keys, i, count)                              \
+   if ((i) + VECTOR_HASH_PREFETCH_DISTANCE < (count))                           \
+      __builtin_prefetch(&(self)->slots[vector_hash_index((self), (keys)[(i) + VECTOR_HASH_PREFETCH_DISTANCE])])
+#else
+#define VECTOR_HASH_PREFETCH(self, keys, i, count)
+#endif
+
+/* Lser angivet antal element av angiven datatyp och breddar dem till 64 bitar. */
+#define VECTOR_HASH_LOAD(dest, source, member, wide, first, count)              \
+   for (size_t i = 0; i < (count); ++i)                                         \
+      (dest)[i] = (uint64_t)(wide)(source)->data.member[(first) + i]
+
+/* Lagrar angivet antal breddade nycklar som element av angiven datatyp. */
+#define VECTOR_HASH_STORE(dest, member, type, wide, keys, first, count)         \
+   for (size_t i = 0; i < (count); ++i)                                         \
+      (dest)->data.member[(first) + i] = (type)(wide)(keys)[i]
+
+/*******************************************************************************
+* vector_hash_mode: Operation som utfrs per nyckel.
+*******************************************************************************/
+enum vector_hash_mode
+{
+   VECTOR_HASH_DISTINCT, /* Enbart unika nycklar. */
+   VECTOR_HASH_COUNT,    /* Antalet frekomster per nyckel. */
+   VECTOR_HASH_SUM,      /* Summan av vrdena per nyckel. */
+   VECTOR_HASH_MIN,      /* Minsta vrdet per nyckel. */
+   VECTOR_HASH_MAX       /* Strsta vrdet per nyckel. */
+};
+
+/*******************************************************************************
+* vector_hash_slot: Plats i hashtabellen, innehllande nyckeln samt index
+*                   till dess grupp plus ett, dr noll indikerar tom plats.
+*******************************************************************************/
+struct vector_hash_slot
+{
+   uint64_t key; /* Nyckel (breddad till 64 bitar). */
+   size_t group; /* Gruppens index plus ett (0 = tom plats). */
+};
+
+/*******************************************************************************
+* vector_hash: Hashtabell med ppen adressering och linjr sondering, dr
+*              grupperna lagras ttt i den ordning de skapats.
+*******************************************************************************/
+struct vector_hash
+{
+   struct vector_hash_slot* slots; /* Tabellens platser. */
+   size_t capacity;                /* Antalet platser (tvpotens). */
+   unsigned shift;                 /* 64 minus antalet bitar som vljer plats. */
+   unsigned skip;                  /* Antalet hga hashbitar som vljer partition. */
+   enum vector_hash_mode mode;     /* Operation som utfrs per nyckel. */
+   uint64_t* keys;                 /* Gruppernas nycklar. */
+   size_t* counts;                 /* Antalet frekomster per grupp (VECTOR_HASH_COUNT). */
+   double* values;                 /* Reducerat vrde per grupp (VECTOR_HASH_SUM - MAX). */
+   size_t num_groups;              /* Antalet grupper. */
+   size_t group_capacity;          /* Antalet grupper som ryms i flten. */
+};
+
+/*******************************************************************************
+* vector_hash_task: Deluppgift vid partitionerad berkning, som frst rknar
+*                   och frdelar nycklarna i ett block av indata samt sedan
+*                   bygger tabellerna fr var num_tasks:e partition.
+*******************************************************************************/
+struct vector_hash_task
+{
+   const struct vector* key_vector; /* Vektorn med nycklar. */
+   const double* values;            /* Vrden per nyckel (eller nullpekare). */
+   size_t first;                    /* Index till blockets frsta element. */
+   size_t size;                     /* Antalet element i blocket. */
+   size_t offsets[VECTOR_HASH_PARTITIONS]; /* Antal, sedan skrivposition, per partition. */
+   uint64_t* partition_keys;        /* Nycklar ordnade per partition. */
+   double* partition_values;        /* Vrden ordnade per partition (eller nullpekare). */
+   const size_t* starts;            /* Index till respektive partitions frsta nyckel. */
+   struct vector_hash* tables;      /* Tabell per partition. */
+   enum vector_hash_mode mode;      /* Operation som utfrs per nyckel. */
+   size_t index;                    /* Deluppgiftens index. */
+   size_t num_tasks;                /* Antalet deluppgifter. */
+   int error;                       /* Indikerar ifall minnet inte rckte. */
+};
+
+/* Statiska variabler: */
+static size_t vector_hash_threshold = 0; /* Minsta storlek i byte fr partitionering (0 = L3-cachen). */
+
+/* Statiska funktioner: */
+static int vector_hash_supported(const enum vector_type type);
+static size_t vector_hash_min_bytes(void);
+static int vector_hash_run(const struct vector* key_vector,
+                           const struct vector* values,
+                           const enum vector_hash_mode mode,
+                           struct vector* keys,
+                           struct vector* results);
+static int vector_hash_serial(struct vector_hash* table,
+                              const struct vector* key_vector,
+                              const double* values);
+static int vector_hash_partitioned(struct vector_hash* tables,
+                                   const struct vector* key_vector,
+                                   const double* values,
+                                   const enum vector_hash_mode mode,
+                                   const size_t num_tasks);
+static int vector_hash_output(const struct vector_hash* tables,
+                              const size_t num_tables,
+                              const enum vector_type type,
+                              struct vector* keys,
+                              struct vector* results);
+static void vector_hash_load(uint64_t* dest,
+                             const struct vector* source,
+                             const size_t first,
+                             const size_t count);
+static void vector_hash_store(struct vector* dest,
+                              const uint64_t* keys,
+                              const size_t first,
+                              const size_t count);
+static int vector_hash_init(struct vector_hash* self,
+                            const enum vector_hash_mode mode,
+                            const unsigned skip);
+static void vector_hash_free(struct vector_hash* self);
+static inline size_t vector_hash_index(const struct vector_hash* self,
+                                       const uint64_t key);
+static inline size_t vector_hash_partition(const uint64_t key);
+static int vector_hash_rehash(struct vector_hash* self);
+static int vector_hash_add_group(struct vector_hash* self,
+                                 const uint64_t key,
+                                 const double value);
+static inline size_t vector_hash_lookup(struct vector_hash* self,
+                                        const uint64_t key,
+                                        const double value);
+static int vector_hash_insert(struct vector_hash* self,
+                              const uint64_t* keys,
+                              const double* values,
+                              const size_t count);
+static void vector_hash_count_run(const size_t index,
+                                  void* context);
+static void vector_hash_scatter_run(const size_t index,
+                                    void* context);
+static void vector_hash_build_run(const size_t index,
+                                  void* context);
+
+/*******************************************************************************
+* vector_distinct: Lagrar samtliga unika element i kllvektorn i mlvektorn,
+*                  vars tidigare innehll raderas. Mlvektorn fr kllvektorns
+*                  datatyp, behller sin allokerare och kan vara samma vektor
+*                  som kllvektorn.
+*                  - dest  : Pekare till mlvektorn.
+*                  - source: Pekare till vektorn som lses.
+*******************************************************************************/
+int vector_distinct(struct vector* dest,
+                    const struct vector* source)
+{
+   return vector_hash_run(source, 0, VECTOR_HASH_DISTINCT, dest, 0);
+}
+
+/*******************************************************************************
+* vector_histogram: Rknar antalet frekomster av varje unikt element i
+*                   kllvektorn. De unika elementen lagras i keys, som fr
+*                   kllvektorns datatyp, och motsvarande antal i counts, som
+*                   fr datatypen VECTOR_TYPE_UNSIGNED. Mlvektorernas
+*                   tidigare innehll raderas.
+*                   - keys  : Pekare till vektorn fr unika element.
+*                   - counts: Pekare till vektorn fr antalet frekomster.
+*                   - source: Pekare till vektorn som lses.
+*******************************************************************************/
+int vector_histogram(struct vector* keys,
+                     struct vector* counts,
+                     const struct vector* source)
+{
+   if (keys == counts) return 1;
+   return vector_hash_run(source, 0, VECTOR_HASH_COUNT, keys, counts);
+}
+
+/*******************************************************************************
+* vector_group_reduce: Grupperar vrdena i en vektor av flyttal utifrn
+*                      motsvarande element i en vektor av nycklar och
+*                      berknar summan, minsta eller strsta vrdet per
+*                      grupp. De unika nycklarna lagras i keys, som fr
+*                      nyckelvektorns datatyp, och resultatet per nyckel i
+*                      results, som fr datatypen VECTOR_TYPE_DOUBLE.
+*                      Mlvektorernas tidigare innehll raderas.
+*                      - keys      : Pekare till vektorn fr unika nycklar.
+*                      - results   : Pekare till vektorn fr resultaten.
+*                      - key_vector: Pekare till vektorn med nycklar.
+*                      - values    : Pekare till vektorn med vrden (double),
+*                                    lika stor som nyckelvektorn.
+*                      - reduction : Reduktion som utfrs per grupp.
+*******************************************************************************/
+int vector_group_reduce(struct vector* keys,
+                        struct vector* results,
+                        const struct vector* key_vector,
+                        const struct vector* values,
+                        const enum vector_parallel_reduction reduction)
+{
+   enum vector_hash_mode mode;
+   if (keys == results || values->type != VECTOR_TYPE_DOUBLE || values->size != key_vector->size) return 1;
+
+   switch (reduction)
+   {
+      case VECTOR_PARALLEL_SUM: mode = VECTOR_HASH_SUM; break;
+      case VECTOR_PARALLEL_MIN: mode = VECTOR_HASH_MIN; break;
+      case VECTOR_PARALLEL_MAX: mode = VECTOR_HASH_MAX; break;
+      default: return 1;
+   }
+   return vector_hash_run(key_vector, values, mode, keys, results);
+}
+
+/*******************************************************************************
+* vector_hash_set_threshold: Anger minsta storlek p indata (nycklar samt
+*                            eventuella vrden) fr partitionerad
+*                            flertrdad berkning.
+*                            - min_bytes: Minsta storlek i byte (0 medfr
+*                                         storleken p processorns L3-cache).
+*******************************************************************************/
+void vector_hash_set_threshold(const size_t min_bytes)
+{
+   vector_hash_threshold = min_bytes;
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_supported: Indikerar ifall angiven datatyp kan anvndas som
+*                        nyckel, vilket gller samtliga heltalstyper.
+*                        - type: Nycklarnas datatyp.
+*******************************************************************************/
+static int vector_hash_supported(const enum vector_type type)
+{
+   return type < VECTOR_TYPE_NONE && type != VECTOR_TYPE_DOUBLE && type != VECTOR_TYPE_FLOAT;
+}
+
+/*******************************************************************************
+* vector_hash_min_bytes: Returnerar minsta storlek p indata i byte fr
+*                        partitionerad berkning, vilket som standard r
+*                        storleken p processorns L3-cache.
+*******************************************************************************/
+static size_t vector_hash_min_bytes(void)
+{
+   if (vector_hash_threshold) return vector_hash_threshold;
+#ifdef _SC_LEVEL3_CACHE_SIZE
+   const long cache_size = sysconf(_SC_LEVEL3_CACHE_SIZE);
+   if (cache_size > 0) return (size_t)cache_size;
+#endif /* _SC_LEVEL3_CACHE_SIZE */
+   return VECTOR_HASH_DEFAULT_CACHE_SIZE;
+}
+
+/*******************************************************************************
+* vector_hash_run: Utfr angiven operation och lagrar resultatet. Indata
+*                  strre n angiven trskel partitioneras och behandlas av
+*                  samtliga trdar, ven om enbart en trd finns, s att
+*                  ordningen enbart beror p indata. vriga indata behandlas
+*                  i en enda tabell.
+*                  - key_vector: Pekare till vektorn med nycklar.
+*                  - values    : Pekare till vektorn med vrden (eller
+*                                nullpekare).
+*                  - mode      : Operation som utfrs per nyckel.
+*                  - keys      : Pekare till vektorn fr unika nycklar.
+*                  - results   : Pekare till vektorn fr resultat per nyckel
+*                                (nullpekare vid VECTOR_HASH_DISTINCT).
+*******************************************************************************/
+static int vector_hash_run(const struct vector* key_vector,
+                           const struct vector* values,
+                           const enum vector_hash_mode mode,
+                           struct vector* keys,
+                           struct vector* results)
+{
+   struct vector_hash tables[VECTOR_HASH_PARTITIONS];
+   const double* data = values ? values->data.decimal : 0;
+   size_t num_tables = 1;
+   int error;
+
+   if (!vector_hash_supported(key_vector->type) || (keys->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (results && (results->flags & VECTOR_FLAG_READONLY)) return 1;
+
+   const size_t bytes = key_vector->size *
+                        (key_vector->ops->element_size + (values ? sizeof(double) : 0));
+
+   if (bytes >= vector_hash_min_bytes())
+   {
+      size_t num_tasks = vector_parallel_threads();
+      if (num_tasks > VECTOR_HASH_MAX_THREADS) num_tasks = VECTOR_HASH_MAX_THREADS;
+      num_tables = VECTOR_HASH_PARTITIONS;
+      error = vector_hash_partitioned(tables, key_vector, data, mode, num_tasks);
+   }
+   else
+   {
+      error = vector_hash_init(&tables[0], mode, 0);
+      if (!error) error = vector_hash_serial(&tables[0], key_vector, data);
+   }
+
+   if (!error) error = vector_hash_output(tables, num_tables, key_vector->type, keys, results);
+
+   for (size_t i = 0; i < num_tables; ++i)
+   {
+      vector_hash_free(&tables[i]);
+   }
+   return error;
+}
+
+/*******************************************************************************
+* vector_hash_serial: Lgger in samtliga nycklar i en enda tabell, block fr
+*                     block.
+*                     - table     : Pekare till tabellen.
+*                     - key_vector: Pekare till vektorn med nycklar.
+*                     - values    : Pekare till vrden (eller nullpekare).
+*******************************************************************************/
+static int vector_hash_serial(struct vector_hash* table,
+                              const struct vector* key_vector,
+                              const double* values)
+{
+   uint64_t block[VECTOR_HASH_BLOCK_SIZE];
+
+   for (size_t first = 0; first < key_vector->size; first += VECTOR_HASH_BLOCK_SIZE)
+   {
+      const size_t count = key_vector->size - first < VECTOR_HASH_BLOCK_SIZE ?
+                           key_vector->size - first : VECTOR_HASH_BLOCK_SIZE;
+      vector_hash_load(block, key_vector, first, count);
+      if (vector_hash_insert(table, block, values ? values + first : 0, count)) return 1;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_hash_partitioned: Delar upp nycklarna i VECTOR_HASH_PARTITIONS
+*                          partitioner utifrn hashvrdets hgsta bitar och
+*                          bygger en tabell per partition. Indata delas upp i
+*                          ett block per deluppgift, dr varje deluppgift
+*                          frst rknar antalet nycklar per partition och
+*                          sedan kopierar sina nycklar till respektive
+*                          partition i ursprunglig ordning. Faserna utfrs
+*                          via trdpoolen (se vector_parallel_for). Samtliga
+*                          tabeller initieras ven vid fel, s att de kan
+*                          frigras.
+*                          - tables    : Pekare till tabellerna.
+*                          - key_vector: Pekare till vektorn med nycklar.
+*                          - values    : Pekare till vrden (eller nullpekare).
+*                          - mode      : Operation som utfrs per nyckel.
+*                          - num_tasks : Antalet deluppgifter.
+*******************************************************************************/
+static int vector_hash_partitioned(struct vector_hash* tables,
+                                   const struct vector* key_vector,
+                                   const double* values,
+                                   const enum vector_hash_mode mode,
+                                   const size_t num_tasks)
+{
+   struct vector_hash_task tasks[VECTOR_HASH_MAX_THREADS];
+   size_t starts[VECTOR_HASH_PARTITIONS + 1];
+   const size_t size = key_vector->size;
+   int error = 0;
+
+   for (size_t p = 0; p < VECTOR_HASH_PARTITIONS; ++p)
+   {
+      if (vector_hash_init(&tables[p], mode, VECTOR_HASH_PARTITION_BITS)) error = 1;
+   }
+
+   uint64_t* partition_keys = (uint64_t*)malloc(size * sizeof(uint64_t));
+   double* partition_values = values ? (double*)malloc(size * sizeof(double)) : 0;
+
+   if (error || !partition_keys || (values && !partition_values))
+   {
+      free(partition_keys);
+      free(partition_values);
+      return 1;
+   }
+
+   for (size_t i = 0; i < num_tasks; ++i)
+   {
+      tasks[i].key_vector = key_vector;
+      tasks[i].values = values;
+      tasks[i].first = size * i / num_tasks;
+      tasks[i].size = size * (i + 1) / num_tasks - tasks[i].first;
+      tasks[i].partition_keys = partition_keys;
+      tasks[i].partition_values = partition_values;
+      tasks[i].starts = starts;
+      tasks[i].tables = tables;
+      tasks[i].mode = mode;
+      tasks[i].index = i;
+      tasks[i].num_tasks = num_tasks;
+      tasks[i].error = 0;
+   }
+
+   vector_parallel_for(num_tasks, &vector_hash_count_run, tasks);
+
+   /* Varje deluppgift skriver sina nycklar efter fregende i samma partition: */
+   starts[0] = 0;
+
+   for (size_t p = 0, offset = 0; p < VECTOR_HASH_PARTITIONS; ++p)
+   {
+      for (size_t i = 0; i < num_tasks; ++i)
+      {
+         const size_t count = tasks[i].offsets[p];
+         tasks[i].offsets[p] = offset;
+         offset += count;
+      }
+      starts[p + 1] = offset;
+   }
+
+   vector_parallel_for(num_tasks, &vector_hash_scatter_run, tasks);
+   vector_parallel_for(num_tasks, &vector_hash_build_run, tasks);
+
+   for (size_t i = 0; i < num_tasks; ++i)
+   {
+      if (tasks[i].error) error = 1;
+   }
+   free(partition_keys);
+   free(partition_values);
+   return error;
+}
+
+/*******************************************************************************
+* vector_hash_output: Lagrar gruppernas nycklar och resultat frn angivna
+*                     tabeller i tur och ordning i mlvektorerna, som byggs
+*                     upp i temporra vektorer med mlvektorernas allokerare
+*                     och flyttas dit frst nr samtliga element kopierats.
+*                     - tables    : Pekare till tabellerna.
+*                     - num_tables: Antalet tabeller.
+*                     - type      : Nycklarnas datatyp.
+*                     - keys      : Pekare till vektorn fr unika nycklar.
+*                     - results   : Pekare till vektorn fr resultat per
+*                                   nyckel (eller nullpekare).
+*******************************************************************************/
+static int vector_hash_output(const struct vector_hash* tables,
+                              const size_t num_tables,
+                              const enum vector_type type,
+                              struct vector* keys,
+                              struct vector* results)
+{
+   struct vector key_copy, result_copy;
+   size_t num_groups = 0;
+   const int counts = tables[0].mode == VECTOR_HASH_COUNT;
+
+   for (size_t i = 0; i < num_tables; ++i)
+   {
+      num_groups += tables[i].num_groups;
+   }
+
+   vector_new(&key_copy, type);
+   vector_new(&result_copy, counts ? VECTOR_TYPE_UNSIGNED : VECTOR_TYPE_DOUBLE);
+   key_copy.allocator = keys->allocator;
+   if (results) result_copy.allocator = results->allocator;
+
+   if (num_groups && (vector_resize(&key_copy, num_groups) ||
+                      (results && vector_resize(&result_copy, num_groups))))
+   {
+      vector_delete(&key_copy);
+      vector_delete(&result_copy);
+      return 1;
+   }
+
+   for (size_t i = 0, first = 0; i < num_tables; first += tables[i++].num_groups)
+   {
+      const struct vector_hash* table = &tables[i];
+      vector_hash_store(&key_copy, table->keys, first, table->num_groups);
+      if (!results || !table->num_groups) continue;
+
+      if (counts)
+      {
+         memcpy(result_copy.data.natural + first, table->counts, table->num_groups * sizeof(size_t));
+      }
+      else
+      {
+         memcpy(result_copy.data.decimal + first, table->values, table->num_groups * sizeof(double));
+      }
+   }
+
+   vector_move(keys, &key_copy);
+
+   if (results)
+   {
+      vector_move(results, &result_copy);
+   }
+   else
+   {
+      vector_delete(&result_copy);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_hash_load: Lser angivet antal element ur en vektor och breddar dem
+*                   till 64 bitar, dr signerade tal teckenutkas.
+*                   - dest  : Pekare till fltet fr breddade nycklar.
+*                   - source: Pekare till vektorn som lses.
+*                   - first : Index till frsta elementet.
+*                   - count : Antalet element.
+*******************************************************************************/
+static void vector_hash_load(uint64_t* dest,
+                             const struct vector* source,
+                             const size_t first,
+                             const size_t count)
+{
+   switch (source->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_HASH_LOAD(dest, source, integer, int64_t, first, count); break;
+      case VECTOR_TYPE_UNSIGNED: VECTOR_HASH_LOAD(dest, source, natural, uint64_t, first, count); break;
+      case VECTOR_TYPE_INT8: VECTOR_HASH_LOAD(dest, source, int8, int64_t, first, count); break;
+      case VECTOR_TYPE_INT16: VECTOR_HASH_LOAD(dest, source, int16, int64_t, first, count); break;
+      case VECTOR_TYPE_INT64: VECTOR_HASH_LOAD(dest, source, int64, int64_t, first, count); break;
+      case VECTOR_TYPE_UINT8: VECTOR_HASH_LOAD(dest, source, uint8, uint64_t, first, count); break;
+      case VECTOR_TYPE_UINT16: VECTOR_HASH_LOAD(dest, source, uint16, uint64_t, first, count); break;
+      case VECTOR_TYPE_UINT32: VECTOR_HASH_LOAD(dest, source, uint32, uint64_t, first, count); break;
+      default: break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_store: Lagrar angivet antal breddade nycklar i en vektor av
+*                    nycklarnas ursprungliga datatyp.
+*                    - dest : Pekare till vektorn.
+*                    - keys : Pekare till de breddade nycklarna.
+*                    - first: Index i vektorn till frsta nyckeln.
+*                    - count: Antalet nycklar.
+*******************************************************************************/
+static void vector_hash_store(struct vector* dest,
+                              const uint64_t* keys,
+                              const size_t first,
+                              const size_t count)
+{
+   switch (dest->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_HASH_STORE(dest, integer, int, int64_t, keys, first, count); break;
+      case VECTOR_TYPE_UNSIGNED: VECTOR_HASH_STORE(dest, natural, size_t, uint64_t, keys, first, count); break;
+      case VECTOR_TYPE_INT8: VECTOR_HASH_STORE(dest, int8, int8_t, int64_t, keys, first, count); break;
+      case VECTOR_TYPE_INT16: VECTOR_HASH_STORE(dest, int16, int16_t, int64_t, keys, first, count); break;
+      case VECTOR_TYPE_INT64: VECTOR_HASH_STORE(dest, int64, int64_t, int64_t, keys, first, count); break;
+      case VECTOR_TYPE_UINT8: VECTOR_HASH_STORE(dest, uint8, uint8_t, uint64_t, keys, first, count); break;
+      case VECTOR_TYPE_UINT16: VECTOR_HASH_STORE(dest, uint16, uint16_t, uint64_t, keys, first, count); break;
+      case VECTOR_TYPE_UINT32: VECTOR_HASH_STORE(dest, uint32, uint32_t, uint64_t, keys, first, count); break;
+      default: break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_init: Initierar en tom hashtabell med VECTOR_HASH_MIN_CAPACITY
+*                   platser. Tabellen kan frigras ven om initieringen
+*                   misslyckas.
+*                   - self: Pekare till tabellen.
+*                   - mode: Operation som utfrs per nyckel.
+*                   - skip: Antalet hga hashbitar som vljer partition och
+*                           drfr inte anvnds fr att vlja plats.
+*******************************************************************************/
+static int vector_hash_init(struct vector_hash* self,
+                            const enum vector_hash_mode mode,
+                            const unsigned skip)
+{
+   unsigned bits = 0;
+   while (((size_t)1 << bits) < VECTOR_HASH_MIN_CAPACITY) ++bits;
+
+   self->capacity = VECTOR_HASH_MIN_CAPACITY;
+   self->shift = 64 - bits;
+   self->skip = skip;
+   self->mode = mode;
+   self->keys = 0;
+   self->counts = 0;
+   self->values = 0;
+   self->num_groups = 0;
+   self->group_capacity = 0;
+   self->slots = (struct vector_hash_slot*)calloc(self->capacity, sizeof(struct vector_hash_slot));
+   return self->slots ? 0 : 1;
+}
+
+/*******************************************************************************
+* vector_hash_free: Frigr minnet som allokerats fr en hashtabell.
+*                   - self: Pekare till tabellen.
+*******************************************************************************/
+static void vector_hash_free(struct vector_hash* self)
+{
+   free(self->slots);
+   free(self->keys);
+   free(self->counts);
+   free(self->values);
+   self->slots = 0;
+   self->keys = 0;
+   self->counts = 0;
+   self->values = 0;
+   self->num_groups = 0;
+   self->group_capacity = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_index: Returnerar platsen dr skning efter angiven nyckel
+*                    pbrjas, utifrn hashvrdets bitar efter de bitar som
+*                    vljer partition.
+*                    - self: Pekare till tabellen.
+*                    - key : Nyckeln.
+*******************************************************************************/
+static inline size_t vector_hash_index(const struct vector_hash* self,
+                                       const uint64_t key)
+{
+   return (size_t)(((key * VECTOR_HASH_MULTIPLIER) << self->skip) >> self->shift);
+}
+
+/*******************************************************************************
+* vector_hash_partition: Returnerar partitionen fr angiven nyckel utifrn
+*                        hashvrdets hgsta bitar.
+*                        - key: Nyckeln.
+*******************************************************************************/
+static inline size_t vector_hash_partition(const uint64_t key)
+{
+   return (size_t)((key * VECTOR_HASH_MULTIPLIER) >> (64 - VECTOR_HASH_PARTITION_BITS));
+}
+
+/*******************************************************************************
+* vector_hash_rehash: Frdubblar antalet platser i tabellen och lgger in
+*                     samtliga grupper p nytt utifrn gruppernas nycklar.
+*                     - self: Pekare till tabellen.
+*******************************************************************************/
+static int vector_hash_rehash(struct vector_hash* self)
+{
+   const size_t capacity = self->capacity * 2;
+   struct vector_hash_slot* slots =
+      (struct vector_hash_slot*)calloc(capacity, sizeof(struct vector_hash_slot));
+   if (!slots) return 1;
+
+   free(self->slots);
+   self->slots = slots;
+   self->capacity = capacity;
+   self->shift--;
+
+   for (size_t group = 0; group < self->num_groups; ++group)
+   {
+      size_t i = vector_hash_index(self, self->keys[group]);
+      while (self->slots[i].group) i = (i + 1) & (capacity - 1);
+      self->slots[i].key = self->keys[group];
+      self->slots[i].group = group + 1;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_hash_add_group: Skapar en ny grupp fr angiven nyckel, dr flten
+*                        fr grupper frdubblas vid behov. Gruppens resultat
+*                        initieras till noll, frutom minsta och strsta
+*                        vrde som initieras till frsta vrdet.
+*                        - self : Pekare till tabellen.
+*                        - key  : Gruppens nyckel.
+*                        - value: Frsta vrdet i gruppen.
+*******************************************************************************/
+static int vector_hash_add_group(struct vector_hash* self,
+                                 const uint64_t key,
+                                 const double value)
+{
+   if (self->num_groups == self->group_capacity)
+   {
+      const size_t capacity = self->group_capacity ? 2 * self->group_capacity : VECTOR_HASH_MIN_CAPACITY;
+      uint64_t* keys = (uint64_t*)realloc(self->keys, capacity * sizeof(uint64_t));
+      if (!keys) return 1;
+      self->keys = keys;
+
+      if (self->mode == VECTOR_HASH_COUNT)
+      {
+         size_t* counts = (size_t*)realloc(self->counts, capacity * sizeof(size_t));
+         if (!counts) return 1;
+         self->counts = counts;
+      }
+      else if (self->mode != VECTOR_HASH_DISTINCT)
+      {
+         double* values = (double*)realloc(self->values, capacity * sizeof(double));
+         if (!values) return 1;
+         self->values = values;
+      }
+      self->group_capacity = capacity;
+   }
+
+   self->keys[self->num_groups] = key;
+   if (self->counts) self->counts[self->num_groups] = 0;
+   if (self->values) self->values[self->num_groups] = self->mode == VECTOR_HASH_SUM ? 0.0 : value;
+   self->num_groups++;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_hash_lookup: Returnerar index till gruppen fr angiven nyckel, dr
+*                     en ny grupp skapas om nyckeln saknas. Tabellen
+*                     frdubblas innan den blir mer n halvfull, vilket
+*                     hller sonderingssekvenserna korta. Returnerar
+*                     SIZE_MAX om minnet inte rcker.
+*                     - self : Pekare till tabellen.
+*                     - key  : Nyckeln.
+*                     - value: Frsta vrdet i gruppen om den skapas.
+*******************************************************************************/
+static inline size_t vector_hash_lookup(struct vector_hash* self,
+                                        const uint64_t key,
+                                        const double value)
+{
+   size_t i = vector_hash_index(self, key);
+
+   while (self->slots[i].group)
+   {
+      if (self->slots[i].key == key) return self->slots[i].group - 1;
+      i = (i + 1) & (self->capacity - 1);
+   }
+
+   if (2 * (self->num_groups + 1) > self->capacity)
+   {
+      if (vector_hash_rehash(self)) return SIZE_MAX;
+      i = vector_hash_index(self, key);
+      while (self->slots[i].group) i = (i + 1) & (self->capacity - 1);
+   }
+
+   if (vector_hash_add_group(self, key, value)) return SIZE_MAX;
+   self->slots[i].key = key;
+   self->slots[i].group = self->num_groups;
+   return self->num_groups - 1;
+}
+
+/*******************************************************************************
+* vector_hash_insert: Lgger in angivna nycklar i tabellen och uppdaterar
+*                     respektive grupps resultat. Switchsatsen ligger utanfr
+*                     looparna, s att varje operation blir en egen loop.
+*                     Platserna fr kommande nycklar lses in i frvg, vilket
+*                     dljer vntetiden vid cachemissar i stora tabeller.
+*                     - self  : Pekare till tabellen.
+*                     - keys  : Pekare till de breddade nycklarna.
+*                     - values: Pekare till motsvarande vrden (eller
+*                               nullpekare).
+*                     - count : Antalet nycklar.
+*******************************************************************************/
+static int vector_hash_insert(struct vector_hash* self,
+                              const uint64_t* keys,
+                              const double* values,
+                              const size_t count)
+{
+   switch (self->mode)
+   {
+      case VECTOR_HASH_DISTINCT:
+         for (size_t i = 0; i < count; ++i)
+         {
+            VECTOR_HASH_PREFETCH(self, keys, i, count);
+            if (vector_hash_lookup(self, keys[i], 0.0) == SIZE_MAX) return 1;
+         }
+         break;
+      case VECTOR_HASH_COUNT:
+         for (size_t i = 0; i < count; ++i)
+         {
+            VECTOR_HASH_PREFETCH(self, keys, i, count);
+            const size_t group = vector_hash_lookup(self, keys[i], 0.0);
+            if (group == SIZE_MAX) return 1;
+            self->counts[group]++;
+         }
+         break;
+      case VECTOR_HASH_SUM:
+         for (size_t i = 0; i < count; ++i)
+         {
+            VECTOR_HASH_PREFETCH(self, keys, i, count);
+            const size_t group = vector_hash_lookup(self, keys[i], values[i]);
+            if (group == SIZE_MAX) return 1;
+            self->values[group] += values[i];
+         }
+         break;
+      case VECTOR_HASH_MIN:
+         for (size_t i = 0; i < count; ++i)
+         {
+            VECTOR_HASH_PREFETCH(self, keys, i, count);
+            const size_t group = vector_hash_lookup(self, keys[i], values[i]);
+            if (group == SIZE_MAX) return 1;
+            if (values[i] < self->values[group]) self->values[group] = values[i];
+         }
+         break;
+      case VECTOR_HASH_MAX:
+         for (size_t i = 0; i < count; ++i)
+         {
+            VECTOR_HASH_PREFETCH(self, keys, i, count);
+            const size_t group = vector_hash_lookup(self, keys[i], values[i]);
+            if (group == SIZE_MAX) return 1;
+            if (values[i] > self->values[group]) self->values[group] = values[i];
+         }
+         break;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_hash_count_run: Rknar antalet nycklar per partition i blocket
+*                        (deluppgift i trdpoolen).
+*                        - index  : Deluppgiftens index.
+*                        - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_hash_count_run(const size_t index,
+                                  void* context)
+{
+   struct vector_hash_task* task = (struct vector_hash_task*)context + index;
+   uint64_t block[VECTOR_HASH_BLOCK_SIZE];
+   memset(task->offsets, 0, sizeof(task->offsets));
+
+   for (size_t first = 0; first < task->size; first += VECTOR_HASH_BLOCK_SIZE)
+   {
+      const size_t count = task->size - first < VECTOR_HASH_BLOCK_SIZE ?
+                           task->size - first : VECTOR_HASH_BLOCK_SIZE;
+      vector_hash_load(block, task->key_vector, task->first + first, count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+         task->offsets[vector_hash_partition(block[i])]++;
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_scatter_run: Kopierar blockets nycklar och vrden till
+*                          respektive partition, med brjan p den
+*                          skrivposition som berknats fr blocket
+*                          (deluppgift i trdpoolen).
+*                          - index  : Deluppgiftens index.
+*                          - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_hash_scatter_run(const size_t index,
+                                    void* context)
+{
+   struct vector_hash_task* task = (struct vector_hash_task*)context + index;
+   uint64_t block[VECTOR_HASH_BLOCK_SIZE];
+
+   for (size_t first = 0; first < task->size; first += VECTOR_HASH_BLOCK_SIZE)
+   {
+      const size_t count = task->size - first < VECTOR_HASH_BLOCK_SIZE ?
+                           task->size - first : VECTOR_HASH_BLOCK_SIZE;
+      vector_hash_load(block, task->key_vector, task->first + first, count);
+
+      for (size_t i = 0; i < count; ++i)
+      {
+         const size_t position = task->offsets[vector_hash_partition(block[i])]++;
+         task->partition_keys[position] = block[i];
+         if (task->values) task->partition_values[position] = task->values[task->first + first + i];
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_hash_build_run: Bygger tabellerna fr var num_tasks:e partition,
+*                        med brjan p deluppgiftens index (deluppgift i
+*                        trdpoolen).
+*                        - index  : Deluppgiftens index.
+*                        - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_hash_build_run(const size_t index,
+                                  void* context)
+{
+   struct vector_hash_task* task = (struct vector_hash_task*)context + index;
+
+   for (size_t p = task->index; p < VECTOR_HASH_PARTITIONS; p += task->num_tasks)
+   {
+      const size_t first = task->starts[p];
+      const double* values = task->partition_values ? task->partition_values + first : 0;
+
+      if (vector_hash_insert(&task->tables[p], task->partition_keys + first, values,
+                             task->starts[p + 1] - first))
+      {
+         task->error = 1;
+      }
+   }
+   return;
+}
@@ -0,0 +1,43 @@
+/*******************************************************************************
+* vector_hash.h: Hashbaserade operationer ver vektorer av heltal; unika
+*                element (distinct), antalet frekomster per element
+*                (histogram) samt summa, minsta eller strsta vrde per
+*                nyckel (group by). Nycklarna lagras i en hashtabell med
+*                ppen adressering och linjr sondering, vars storlek alltid
+*                r en tvpotens. Tabellen bestr av ett enda sammanhngande
+*                flt, dr grupperna lagras ttt i separata flt, vilket gr
+*                att ingen allokering sker per nyckel.
+*
+*                Nycklarna lagras i den ordning de frst frekommer. Fr
+*                indata strre n processorns L3-cache delas nycklarna frst
+*                upp i partitioner utifrn sitt hashvrde, varefter varje
+*                partition behandlas i en egen tabell som ryms i cacheminnet,
+*                frdelat p flera trdar. Nycklarna lagras d partition fr
+*                partition, i den ordning de frst frekommer inom
+*                partitionen. Antalet partitioner r fast, vilket gr att
+*                resultatet blir detsamma oavsett antalet trdar.
+*
+*                Samtliga heltalstyper stds som nycklar. Programmet mste
+*                lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_HASH_H_
+#define VECTOR_HASH_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include "vector_parallel.h"
+
+/* Externa funktioner: */
+int vector_distinct(struct vector* dest,
+                    const struct vector* source);
+int vector_histogram(struct vector* keys,
+                     struct vector* counts,
+                     const struct vector* source);
+int vector_group_reduce(struct vector* keys,
+                        struct vector* results,
+                        const struct vector* key_vector,
+                        const struct vector* values,
+                        const enum vector_parallel_reduction reduction);
+void vector_hash_set_threshold(const size_t min_bytes);
+
+#endif /* VECTOR_HASH_H_ */
@@ -0,0 +1,551 @@
+/*******************************************************************************
+* vector_kernels.c: Innehller numeriska berkningar fr vektorer, dr varje
+*                   berkning genereras fr samtliga instruktionsuppsttningar
+*                   via makron. Varje version anvnder ett antal oberoende
+*                   delresultat (tv SIMD-register brett), vilket kompilatorn
+*                   verstter till SIMD-instruktioner fr angiven mlarkitektur.
+*                   Elementvisa operationer tar restrict-pekare, varfr
+*                   verlappande vektorer kopieras innan berkningen.
+*******************************************************************************/
+#include "vector_kernels.h"
+#include <stdint.h>
+
+/* Makrodefinitioner: */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_KERNELS_X86 1 /* SIMD-versioner genereras fr x86-processorer. */
+#endif
+
+/* Antalet oberoende delresultat fr angiven registerbredd i byte. */
+#define VECTOR_KERNEL_LANES(bytes, type) ((bytes) ? 2 * (bytes) / sizeof(type) : 1)
+
+/*******************************************************************************
+* VECTOR_KERNEL_LOOP: Utfr angiven sats fr index i frn 0 till size, dr
+*                     huvudloopen behandlar lanes element per varv. Den inre
+*                     loopen har konstant lngd, vilket gr att kompilatorn
+*                     verstter den till SIMD-instruktioner ven vid -O2,
+*                     dr loopar med oknt antal varv inte vektoriseras.
+*******************************************************************************/
+#define VECTOR_KERNEL_LOOP(lanes, size, ...)                                    \
+do                                                                              \
+{                                                                               \
+   size_t first = 0;                                                            \
+   for (; first + (lanes) <= (size); first += (lanes))                          \
+   {                                                                            \
+      for (size_t lane = 0; lane < (lanes); ++lane)                             \
+      {                                                                         \
+         const size_t i = first + lane;                                         \
+         __VA_ARGS__;                                                           \
+      }                                                                         \
+   }                                                                            \
+   for (size_t i = first; i < (size); ++i) { __VA_ARGS__; }                     \
+} while (0)
+
+/*******************************************************************************
+* vector_kernel_table: Funktionspekare till berkningar fr en given datatyp
+*                      och instruktionsuppsttning.
+*******************************************************************************/
+struct vector_kernel_table
+{
+   void (*sum)(const void* x, const size_t n, void* result);
+   void (*min)(const void* x, const size_t n, void* result);
+   void (*max)(const void* x, const size_t n, void* result);
+   double (*mean)(const void* x, const size_t n);
+   void (*dot)(const void* x, const void* y, const size_t n, void* result);
+   void (*add)(void* restrict y, const void* restrict x, const size_t n);
+   void (*mul)(void* restrict y, const void* restrict x, const size_t n);
+   void (*scale)(void* restrict y, const size_t n, const void* factor);
+   void (*axpy)(void* restrict y, const void* alpha, const void* restrict x, const size_t n);
+};
+
+/*******************************************************************************
+* VECTOR_KERNELS_DEFINE: Genererar samtliga berkningar fr en given datatyp
+*                        och instruktionsuppsttning.
+*                        - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                        - attr : Attribut som anger mlarkitektur.
+*                        - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                        - name : Namnsuffix fr datatypen.
+*                        - type : Elementens datatyp.
+*                        - wrap : Datatyp fr aritmetik (osignerad fr heltal,
+*                                 s att spill slr runt i stllet fr att
+*                                 vara odefinierat). Heltal smalare n int
+*                                 berknas som unsigned, eftersom de annars
+*                                 befordras till int vid multiplikation.
+*******************************************************************************/
+#define VECTOR_KERNELS_DEFINE(isa, attr, bytes, name, type, wrap)               \
+static attr void vector_##name##_sum_##isa(const void* data,                    \
+                                           const size_t n,                      \
+                                           void* result)                        \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   const type* x = (const type*)data;                                           \
+   wrap acc[lanes] = { 0 };                                                     \
+   size_t i = 0;                                                                \
+   for (; i + lanes <= n; i += lanes)                                           \
+      for (size_t j = 0; j < lanes; ++j) acc[j] += (wrap)x[i + j];              \
+   for (size_t j = 1; j < lanes; ++j) acc[0] += acc[j];                         \
+   for (; i < n; ++i) acc[0] += (wrap)x[i];                                     \
+   *(type*)result = (type)acc[0];                                               \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_min_##isa(const void* data,                    \
+                                           const size_t n,                      \
+                                           void* result)                        \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   const type* x = (const type*)data;                                           \
+   type acc[lanes];                                                             \
+   size_t i = lanes;                                                            \
+   if (n < lanes)                                                               \
+   {                                                                            \
+      for (size_t j = 0; j < lanes; ++j) acc[j] = x[0];                         \
+      i = 1;                                                                    \
+   }                                                                            \
+   else                                                                         \
+   {                                                                            \
+      for (size_t j = 0; j < lanes; ++j) acc[j] = x[j];                         \
+   }                                                                            \
+   for (; i + lanes <= n; i += lanes)                                           \
+      for (size_t j = 0; j < lanes; ++j)                                        \
+         acc[j] = x[i + j] < acc[j] ? x[i + j] : acc[j];                        \
+   for (size_t j = 1; j < lanes; ++j) acc[0] = acc[j] < acc[0] ? acc[j] : acc[0]; \
+   for (; i < n; ++i) acc[0] = x[i] < acc[0] ? x[i] : acc[0];                   \
+   *(type*)result = acc[0];                                                     \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_max_##isa(const void* data,                    \
+                                           const size_t n,                      \
+                                           void* result)                        \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   const type* x = (const type*)data;                                           \
+   type acc[lanes];                                                             \
+   size_t i = lanes;                                                            \
+   if (n < lanes)                                                               \
+   {                                                                            \
+      for (size_t j = 0; j < lanes; ++j) acc[j] = x[0];                         \
+      i = 1;                                                                    \
+   }                                                                            \
+   else                                                                         \
+   {                                                                            \
+      for (size_t j = 0; j < lanes; ++j) acc[j] = x[j];                         \
+   }                                                                            \
+   for (; i + lanes <= n; i += lanes)                                           \
+      for (size_t j = 0; j < lanes; ++j)                                        \
+         acc[j] = x[i + j] > acc[j] ? x[i + j] : acc[j];                        \
+   for (size_t j = 1; j < lanes; ++j) acc[0] = acc[j] > acc[0] ? acc[j] : acc[0]; \
+   for (; i < n; ++i) acc[0] = x[i] > acc[0] ? x[i] : acc[0];                   \
+   *(type*)result = acc[0];                                                     \
+}                                                                               \
+                                                                                \
+static attr double vector_##name##_mean_##isa(const void* data,                 \
+                                              const size_t n)                   \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, double) };                         \
+   const type* x = (const type*)data;                                           \
+   double acc[lanes] = { 0 };                                                   \
+   size_t i = 0;                                                                \
+   for (; i + lanes <= n; i += lanes)                                           \
+      for (size_t j = 0; j < lanes; ++j) acc[j] += (double)x[i + j];            \
+   for (size_t j = 1; j < lanes; ++j) acc[0] += acc[j];                         \
+   for (; i < n; ++i) acc[0] += (double)x[i];                                   \
+   return acc[0] / (double)n;                                                   \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_dot_##isa(const void* data_x,                  \
+                                           const void* data_y,                  \
+                                           const size_t n,                      \
+                                           void* result)                        \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   const type* x = (const type*)data_x;                                         \
+   const type* y = (const type*)data_y;                                         \
+   wrap acc[lanes] = { 0 };                                                     \
+   size_t i = 0;                                                                \
+   for (; i + lanes <= n; i += lanes)                                           \
+      for (size_t j = 0; j < lanes; ++j)                                        \
+         acc[j] += (wrap)x[i + j] * (wrap)y[i + j];                             \
+   for (size_t j = 1; j < lanes; ++j) acc[0] += acc[j];                         \
+   for (; i < n; ++i) acc[0] += (wrap)x[i] * (wrap)y[i];                        \
+   *(type*)result = (type)acc[0];                                               \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_add_##isa(void* restrict data_y,               \
+                                           const void* restrict data_x,         \
+                                           const size_t n)                      \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   type* restrict y = (type*)data_y;                                            \
+   const type* restrict x = (const type*)data_x;                                \
+   VECTOR_KERNEL_LOOP(lanes, n, y[i] = (type)((wrap)y[i] + (wrap)x[i]));        \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_mul_##isa(void* restrict data_y,               \
+                                           const void* restrict data_x,         \
+                                           const size_t n)                      \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   type* restrict y = (type*)data_y;                                            \
+   const type* restrict x = (const type*)data_x;                                \
+   VECTOR_KERNEL_LOOP(lanes, n, y[i] = (type)((wrap)y[i] * (wrap)x[i]));        \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_scale_##isa(void* restrict data_y,             \
+                                             const size_t n,                    \
+                                             const void* factor)                \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   type* restrict y = (type*)data_y;                                            \
+   const wrap a = (wrap)*(const type*)factor;                                   \
+   VECTOR_KERNEL_LOOP(lanes, n, y[i] = (type)((wrap)y[i] * a));                 \
+}                                                                               \
+                                                                                \
+static attr void vector_##name##_axpy_##isa(void* restrict data_y,              \
+                                            const void* alpha,                  \
+                                            const void* restrict data_x,        \
+                                            const size_t n)                     \
+{                                                                               \
+   enum { lanes = VECTOR_KERNEL_LANES(bytes, type) };                           \
+   type* restrict y = (type*)data_y;                                            \
+   const type* restrict x = (const type*)data_x;                                \
+   const wrap a = (wrap)*(const type*)alpha;                                    \
+   VECTOR_KERNEL_LOOP(lanes, n, y[i] = (type)(a * (wrap)x[i] + (wrap)y[i]));    \
+}
+
+/* Genererar berkningar fr samtliga datatyper fr en instruktionsuppsttning. */
+#define VECTOR_KERNELS_DEFINE_ALL(isa, attr, bytes)                             \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, int, int, unsigned)                     \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, double, double, double)                 \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, unsigned, size_t, size_t)               \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, int8, int8_t, unsigned)                 \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, int16, int16_t, unsigned)               \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, int64, int64_t, uint64_t)               \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, uint8, uint8_t, unsigned)               \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, uint16, uint16_t, unsigned)             \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, uint32, uint32_t, uint32_t)             \
+VECTOR_KERNELS_DEFINE(isa, attr, bytes, float, float, float)
+
+/* Initierar en funktionstabell fr angiven datatyp och instruktionsuppsttning. */
+#define VECTOR_KERNELS_TABLE(isa, name)                                         \
+{                                                                               \
+   &vector_##name##_sum_##isa, &vector_##name##_min_##isa,                      \
+   &vector_##name##_max_##isa, &vector_##name##_mean_##isa,                     \
+   &vector_##name##_dot_##isa, &vector_##name##_add_##isa,                      \
+   &vector_##name##_mul_##isa, &vector_##name##_scale_##isa,                    \
+   &vector_##name##_axpy_##isa                                                  \
+}
+
+/* Initierar funktionstabeller fr samtliga datatyper (indexerade via vector_type). */
+#define VECTOR_KERNELS_TABLES(isa)                                              \
+{                                                                               \
+   VECTOR_KERNELS_TABLE(isa, int),                                              \
+   VECTOR_KERNELS_TABLE(isa, double),                                           \
+   VECTOR_KERNELS_TABLE(isa, unsigned),                                         \
+   VECTOR_KERNELS_TABLE(isa, int8),                                             \
+   VECTOR_KERNELS_TABLE(isa, int16),                                            \
+   VECTOR_KERNELS_TABLE(isa, int64),                                            \
+   VECTOR_KERNELS_TABLE(isa, uint8),                                            \
+   VECTOR_KERNELS_TABLE(isa, uint16),                                           \
+   VECTOR_KERNELS_TABLE(isa, uint32),                                           \
+   VECTOR_KERNELS_TABLE(isa, float)                                             \
+}
+
+/* Berkningar fr respektive instruktionsuppsttning: */
+VECTOR_KERNELS_DEFINE_ALL(scalar, , 0)
+static const struct vector_kernel_table vector_kernels_scalar[] = VECTOR_KERNELS_TABLES(scalar);
+
+#ifdef VECTOR_KERNELS_X86
+VECTOR_KERNELS_DEFINE_ALL(sse2, __attribute__((target("sse2"))), 16)
+VECTOR_KERNELS_DEFINE_ALL(avx2, __attribute__((target("avx2"))), 32)
+VECTOR_KERNELS_DEFINE_ALL(avx512, __attribute__((target("avx512f,avx512dq"))), 64)
+static const struct vector_kernel_table vector_kernels_sse2[] = VECTOR_KERNELS_TABLES(sse2);
+static const struct vector_kernel_table vector_kernels_avx2[] = VECTOR_KERNELS_TABLES(avx2);
+static const struct vector_kernel_table vector_kernels_avx512[] = VECTOR_KERNELS_TABLES(avx512);
+#endif /* VECTOR_KERNELS_X86 */
+
+/* Statiska variabler: */
+static enum vector_isa vector_kernels_active = VECTOR_ISA_SCALAR;
+
+/* Statiska funktioner: */
+static const struct vector_kernel_table* vector_kernels_get(const enum vector_type type);
+static int vector_kernels_operand(const struct vector* self,
+                                  const struct vector* other,
+                                  struct vector* temp,
+                                  const void** data);
+
+/*******************************************************************************
+* vector_sum: Berknar summan av samtliga element i angiven vektor.
+*             - self  : Pekare till vektorn.
+*             - result: Pekare till variabel av vektorns datatyp dr summan
+*                       skall lagras.
+*******************************************************************************/
+int vector_sum(const struct vector* self,
+               void* result)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !result) return 1;
+   kernels->sum(self->data.raw, self->size, result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_min: Tar fram det minsta elementet i angiven vektor.
+*             - self  : Pekare till vektorn (fr inte vara tom).
+*             - result: Pekare till variabel av vektorns datatyp dr minsta
+*                       elementet skall lagras.
+*******************************************************************************/
+int vector_min(const struct vector* self,
+               void* result)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !result || !self->size) return 1;
+   kernels->min(self->data.raw, self->size, result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_max: Tar fram det strsta elementet i angiven vektor.
+*             - self  : Pekare till vektorn (fr inte vara tom).
+*             - result: Pekare till variabel av vektorns datatyp dr strsta
+*                       elementet skall lagras.
+*******************************************************************************/
+int vector_max(const struct vector* self,
+               void* result)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !result || !self->size) return 1;
+   kernels->max(self->data.raw, self->size, result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_mean: Berknar medelvrdet av elementen i angiven vektor. Summeringen
+*              sker med flyttal, s att heltalsvektorer inte kan sl runt.
+*              - self  : Pekare till vektorn (fr inte vara tom).
+*              - result: Pekare till variabel dr medelvrdet skall lagras.
+*******************************************************************************/
+int vector_mean(const struct vector* self,
+                double* result)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !result || !self->size) return 1;
+   *result = kernels->mean(self->data.raw, self->size);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_add: Adderar elementen i en vektor till motsvarande element i en
+*             annan vektor. Vektorerna mste ha samma datatyp och storlek.
+*             - self : Pekare till vektorn som resultatet lagras i.
+*             - other: Pekare till vektorn vars element skall adderas.
+*******************************************************************************/
+int vector_add(struct vector* self,
+               const struct vector* other)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   const void* data = 0;
+   struct vector temp;
+   if (!kernels || self->type != other->type || self->size != other->size) return 1;
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (vector_kernels_operand(self, other, &temp, &data)) return 1;
+   kernels->add(self->data.raw, data, self->size);
+   vector_delete(&temp);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_mul: Multiplicerar elementen i en vektor med motsvarande element i en
+*             annan vektor. Vektorerna mste ha samma datatyp och storlek.
+*             - self : Pekare till vektorn som resultatet lagras i.
+*             - other: Pekare till vektorn vars element utgr faktorer.
+*******************************************************************************/
+int vector_mul(struct vector* self,
+               const struct vector* other)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   const void* data = 0;
+   struct vector temp;
+   if (!kernels || self->type != other->type || self->size != other->size) return 1;
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (vector_kernels_operand(self, other, &temp, &data)) return 1;
+   kernels->mul(self->data.raw, data, self->size);
+   vector_delete(&temp);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_scale: Multiplicerar samtliga element i angiven vektor med en skalr.
+*               - self  : Pekare till vektorn.
+*               - factor: Pekare till skalren, som mste vara av samma
+*                         datatyp som vektorn.
+*******************************************************************************/
+int vector_scale(struct vector* self,
+                 const void* factor)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !factor || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (vector_unshare(self)) return 1;
+   kernels->scale(self->data.raw, self->size, factor);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_dot: Berknar skalrprodukten av tv vektorer, som mste ha samma
+*             datatyp och storlek.
+*             - self  : Pekare till den frsta vektorn.
+*             - other : Pekare till den andra vektorn.
+*             - result: Pekare till variabel av vektorernas datatyp dr
+*                       skalrprodukten skall lagras.
+*******************************************************************************/
+int vector_dot(const struct vector* self,
+               const struct vector* other,
+               void* result)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   if (!kernels || !result || self->type != other->type || self->size != other->size) return 1;
+   kernels->dot(self->data.raw, other->data.raw, self->size, result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_axpy: Berknar self = alpha * x + self elementvis. Vektorerna mste
+*              ha samma datatyp och storlek.
+*              - self : Pekare till vektorn som resultatet lagras i.
+*              - alpha: Pekare till skalren, som mste vara av samma datatyp
+*                       som vektorerna.
+*              - x    : Pekare till vektorn som skalas och adderas.
+*******************************************************************************/
+int vector_axpy(struct vector* self,
+                const void* alpha,
+                const struct vector* x)
+{
+   const struct vector_kernel_table* kernels = vector_kernels_get(self->type);
+   const void* data = 0;
+   struct vector temp;
+   if (!kernels || !alpha || self->type != x->type || self->size != x->size) return 1;
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (vector_kernels_operand(self, x, &temp, &data)) return 1;
+   kernels->axpy(self->data.raw, alpha, data, self->size);
+   vector_delete(&temp);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_kernels_supported: Indikerar ifall angiven instruktionsuppsttning
+*                           stds av processorn samt av aktuellt bygge.
+*                           - isa: Instruktionsuppsttningen som kontrolleras.
+*******************************************************************************/
+int vector_kernels_supported(const enum vector_isa isa)
+{
+   if (isa == VECTOR_ISA_SCALAR) return 1;
+#ifdef VECTOR_KERNELS_X86
+   __builtin_cpu_init();
+   if (isa == VECTOR_ISA_SSE2)
+   {
+      return __builtin_cpu_supports("sse2") ? 1 : 0;
+   }
+   else if (isa == VECTOR_ISA_AVX2)
+   {
+      return __builtin_cpu_supports("avx2") ? 1 : 0;
+   }
+   else if (isa == VECTOR_ISA_AVX512)
+   {
+      return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") ? 1 : 0;
+   }
+#endif /* VECTOR_KERNELS_X86 */
+   return 0;
+}
+
+/*******************************************************************************
+* vector_kernels_select: Vljer instruktionsuppsttning fr berkningarna,
+*                        exempelvis fr att jmfra SIMD-versionerna mot den
+*                        skalra versionen. Vid start vljs den snabbaste
+*                        instruktionsuppsttningen som processorn stdjer.
+*                        - isa: Instruktionsuppsttningen som skall anvndas.
+*******************************************************************************/
+int vector_kernels_select(const enum vector_isa isa)
+{
+   if (!vector_kernels_supported(isa)) return 1;
+   vector_kernels_active = isa;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_kernels_isa: Returnerar vald instruktionsuppsttning.
+*******************************************************************************/
+enum vector_isa vector_kernels_isa(void)
+{
+   return vector_kernels_active;
+}
+
+#ifdef VECTOR_KERNELS_X86
+/*******************************************************************************
+* vector_kernels_init: Vljer den snabbaste instruktionsuppsttningen som
+*                      processorn stdjer. Anropas automatiskt vid start.
+*******************************************************************************/
+__attribute__((constructor)) static void vector_kernels_init(void)
+{
+   if (!vector_kernels_select(VECTOR_ISA_AVX512)) return;
+   if (!vector_kernels_select(VECTOR_ISA_AVX2)) return;
+   vector_kernels_select(VECTOR_ISA_SSE2);
+   return;
+}
+#endif /* VECTOR_KERNELS_X86 */
+
+/*******************************************************************************
+* vector_kernels_get: Returnerar funktionstabellen fr angiven datatyp och vald
+*                     instruktionsuppsttning. Fr datatyper som saknar
+*                     berkningar returneras en nullpekare.
+*                     - type: Vektorns datatyp.
+*******************************************************************************/
+static const struct vector_kernel_table* vector_kernels_get(const enum vector_type type)
+{
+   if (type >= VECTOR_TYPE_NONE) return 0;
+#ifdef VECTOR_KERNELS_X86
+   if (vector_kernels_active == VECTOR_ISA_AVX512)
+   {
+      return &vector_kernels_avx512[type];
+   }
+   else if (vector_kernels_active == VECTOR_ISA_AVX2)
+   {
+      return &vector_kernels_avx2[type];
+   }
+   else if (vector_kernels_active == VECTOR_ISA_SSE2)
+   {
+      return &vector_kernels_sse2[type];
+   }
+#endif /* VECTOR_KERNELS_X86 */
+   return &vector_kernels_scalar[type];
+}
+
+/*******************************************************************************
+* vector_kernels_operand: Tar fram pekare till operandens element. Om dessa
+*                         verlappar mlvektorns element, exempelvis vid
+*                         vector_add(v, v) eller verlappande vyer, kopieras
+*                         de frst till en temporr vektor, eftersom de
+*                         elementvisa berkningarna tar restrict-pekare.
+*                         - self : Pekare till mlvektorn.
+*                         - other: Pekare till operanden.
+*                         - temp : Pekare till temporr vektor, som initieras
+*                                  hr och raderas av anroparen.
+*                         - data : Pekare till variabel dr pekaren till
+*                                  elementen skall lagras.
+*******************************************************************************/
+static int vector_kernels_operand(const struct vector* self,
+                                  const struct vector* other,
+                                  struct vector* temp,
+                                  const void** data)
+{
+   const size_t bytes = self->size * self->ops->element_size;
+   const uintptr_t y = (uintptr_t)self->data.raw;
+   const uintptr_t x = (uintptr_t)other->data.raw;
+   vector_new(temp, other->type);
+   *data = other->data.raw;
+   if (!bytes || x + bytes <= y || y + bytes <= x) return 0;
+   if (vector_push_range(temp, other->data.raw, other->size))
+   {
+      vector_delete(temp);
+      return 1;
+   }
+   *data = temp->data.raw;
+   return 0;
+}
@@ -0,0 +1,59 @@
+/*******************************************************************************
+* vector_kernels.h: Numeriska berkningar (reduktioner samt elementvisa
+*                   operationer) fr vektorer av samtliga datatyper. Varje
+*                   berkning finns i en skalr version samt i versioner fr
+*                   instruktionsuppsttningarna SSE2, AVX2 och AVX-512, dr
+*                   den snabbaste som processorn stdjer vljs automatiskt
+*                   vid programstart via instruktionen cpuid.
+*
+*                   Resultat av reduktioner lagras som vektorns datatyp,
+*                   frutom medelvrdet, som alltid lagras som flyttal.
+*                   Heltalsberkningar sker med modulr aritmetik, vilket
+*                   innebr att spill slr runt i stllet fr att vara
+*                   odefinierat. Flyttalsreduktioner summeras i flera
+*                   parallella delsummor, vilket gr att resultatet kan
+*                   skilja sig marginellt mellan olika instruktionsuppsttningar.
+*******************************************************************************/
+#ifndef VECTOR_KERNELS_H_
+#define VECTOR_KERNELS_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_isa: Instruktionsuppsttningar som berkningarna kan utfras med.
+*******************************************************************************/
+enum vector_isa
+{
+   VECTOR_ISA_SCALAR, /* Skalr implementering, fungerar p alla processorer. */
+   VECTOR_ISA_SSE2,   /* 128-bitars SIMD-instruktioner. */
+   VECTOR_ISA_AVX2,   /* 256-bitars SIMD-instruktioner. */
+   VECTOR_ISA_AVX512  /* 512-bitars SIMD-instruktioner. */
+};
+
+/* Externa funktioner: */
+int vector_sum(const struct vector* self,
+               void* result);
+int vector_min(const struct vector* self,
+               void* result);
+int vector_max(const struct vector* self,
+               void* result);
+int vector_mean(const struct vector* self,
+                double* result);
+int vector_add(struct vector* self,
+               const struct vector* other);
+int vector_mul(struct vector* self,
+               const struct vector* other);
+int vector_scale(struct vector* self,
+                 const void* factor);
+int vector_dot(const struct vector* self,
+               const struct vector* other,
+               void* result);
+int vector_axpy(struct vector* self,
+                const void* alpha,
+                const struct vector* x);
+int vector_kernels_supported(const enum vector_isa isa);
+int vector_kernels_select(const enum vector_isa isa);
+enum vector_isa vector_kernels_isa(void);
+
+#endif /* VECTOR_KERNELS_H_ */
@@ -0,0 +1,652 @@
+/*******************************************************************************
+* vector_parallel.c: Innehller en trdpool samt flertrdade operationer fr
+*                    vektorer. Anropande trd deltar i arbetet tillsammans med
+*                    poolens arbetartrdar, som hmtar block ett i taget.
+*                    Trdar som utfr ett jobb markeras, s att operationer
+*                    som anropas inifrn ett jobb utfrs seriellt i stllet
+*                    fr att vnta p poolen, vilket annars ger ddlge.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector_parallel.h"
+#include "vector_kernels.h"
+#include <pthread.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_PARALLEL_CHUNK_SIZE 65536          /* Antalet element per block. */
+#define VECTOR_PARALLEL_DEFAULT_THRESHOLD 1048576 /* Minsta storlek fr trdning. */
+
+/*******************************************************************************
+* vector_parallel_job: Jobb som delas upp i block och frdelas mellan trdar.
+*******************************************************************************/
+struct vector_parallel_job
+{
+   void (*run)(struct vector_parallel_job* self, /* Behandlar ett block. */
+               void* data,
+               const size_t size,
+               const size_t chunk);
+   const struct vector* vector;                  /* Vektorn som behandlas. */
+   const void* operand;                          /* Vrde eller operand. */
+   void (*callback)(void* element, void* context); /* Anvndarens funktion. */
+   void (*task)(const size_t index, void* context); /* Anvndarens deluppgift. */
+   void* context;                                /* Data till anvndarens funktion. */
+   enum vector_parallel_op op;                   /* Inbyggd transformering. */
+   enum vector_parallel_reduction reduction;     /* Inbyggd reduktion. */
+   void* partials;                               /* Delresultat, ett per block. */
+   size_t num_chunks;                            /* Antalet block. */
+};
+
+/*******************************************************************************
+* vector_pool: Trdpool med arbetartrdar som vntar p jobb.
+*******************************************************************************/
+struct vector_pool
+{
+   pthread_t* threads;                /* Arbetartrdar. */
+   size_t num_threads;                /* Antalet arbetartrdar. */
+   pthread_mutex_t mutex;             /* Skyddar poolens tillstnd. */
+   pthread_cond_t work;               /* Signaleras nr ett jobb finns. */
+   pthread_cond_t done;               /* Signaleras nr ett jobb r klart. */
+   struct vector_parallel_job* job;   /* Aktuellt jobb (nullpekare om inget). */
+   size_t next_chunk;                 /* Nsta block att behandla. */
+   size_t done_chunks;                /* Antalet frdiga block. */
+   int started;                       /* Indikerar ifall poolen r startad. */
+   int stop;                          /* Indikerar att trdarna skall avslutas. */
+};
+
+/* Statiska variabler: */
+static struct vector_pool vector_pool =
+{
+   0, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER,
+   PTHREAD_COND_INITIALIZER, 0, 0, 0, 0, 0
+};
+static pthread_mutex_t vector_pool_submit = PTHREAD_MUTEX_INITIALIZER;
+static size_t vector_parallel_threshold = VECTOR_PARALLEL_DEFAULT_THRESHOLD;
+static size_t vector_parallel_num_threads = 0;  /* Angivet antal trdar (0 = antalet krnor). */
+static _Thread_local int vector_parallel_busy = 0; /* Indikerar att trden utfr ett jobb. */
+
+/* Statiska funktioner: */
+static void vector_parallel_run(struct vector_parallel_job* job);
+static void vector_parallel_chunk(struct vector_parallel_job* job,
+                                  const size_t chunk);
+static void* vector_pool_worker(void* arg);
+static int vector_pool_start(size_t num_threads);
+static size_t vector_pool_size(const size_t num_threads);
+static void vector_pool_stop(void);
+static void vector_parallel_fill_chunk(struct vector_parallel_job* self,
+                                       void* data,
+                                       const size_t size,
+                                       const size_t chunk);
+static void vector_parallel_transform_chunk(struct vector_parallel_job* self,
+                                            void* data,
+                                            const size_t size,
+                                            const size_t chunk);
+static void vector_parallel_op_chunk(struct vector_parallel_job* self,
+                                     void* data,
+                                     const size_t size,
+                                     const size_t chunk);
+static void vector_parallel_reduce_chunk(struct vector_parallel_job* self,
+                                         void* data,
+                                         const size_t size,
+                                         const size_t chunk);
+static int vector_parallel_reduce_range(const struct vector* self,
+                                        const enum vector_parallel_reduction reduction,
+                                        void* data,
+                                        const size_t size,
+                                        void* result);
+static void vector_parallel_task_chunk(struct vector_parallel_job* self,
+                                       void* data,
+                                       const size_t size,
+                                       const size_t chunk);
+
+/*******************************************************************************
+* vector_parallel_fill: Tilldelar samtliga element i angiven vektor ett givet
+*                       vrde.
+*                       - self : Pekare till vektorn.
+*                       - value: Pekare till vrdet, som mste vara av samma
+*                                datatyp som vektorn.
+*******************************************************************************/
+int vector_parallel_fill(struct vector* self,
+                         const void* value)
+{
+   struct vector_parallel_job job = { 0 };
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (!self->ops->element_size || !value) return 1;
+   job.run = &vector_parallel_fill_chunk;
+   job.vector = self;
+   job.operand = value;
+   vector_parallel_run(&job);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_parallel_transform: Anropar angiven funktion fr samtliga element i
+*                            angiven vektor. Funktionen anropas frn flera
+*                            trdar samtidigt och mste drmed vara trdsker.
+*                            - self    : Pekare till vektorn.
+*                            - callback: Funktion som anropas med adressen
+*                                        till varje element.
+*                            - context : Data som passeras till funktionen.
+*******************************************************************************/
+int vector_parallel_transform(struct vector* self,
+                              void (*callback)(void* element, void* context),
+                              void* context)
+{
+   struct vector_parallel_job job = { 0 };
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (!self->ops->element_size || !callback) return 1;
+   job.run = &vector_parallel_transform_chunk;
+   job.vector = self;
+   job.callback = callback;
+   job.context = context;
+   vector_parallel_run(&job);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_parallel_transform_op: Utfr en inbyggd transformering p samtliga
+*                               element i angiven vektor. Heltal berknas med
+*                               modulr aritmetik.
+*                               - self   : Pekare till vektorn.
+*                               - op     : Transformeringen som skall utfras.
+*                               - operand: Pekare till operanden, som mste
+*                                          vara av vektorns datatyp (ignoreras
+*                                          fr VECTOR_PARALLEL_OP_SQUARE).
+*******************************************************************************/
+int vector_parallel_transform_op(struct vector* self,
+                                 const enum vector_parallel_op op,
+                                 const void* operand)
+{
+   struct vector_parallel_job job = { 0 };
+   if ((self->flags & VECTOR_FLAG_READONLY) || vector_unshare(self)) return 1;
+   if (self->type >= VECTOR_TYPE_NONE) return 1;
+   if (!operand && op != VECTOR_PARALLEL_OP_SQUARE) return 1;
+   job.run = &vector_parallel_op_chunk;
+   job.vector = self;
+   job.operand = operand;
+   job.op = op;
+   vector_parallel_run(&job);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_parallel_reduce: Utfr en inbyggd reduktion ver samtliga element i
+*                         angiven vektor. Varje block reduceras var fr sig,
+*                         varefter delresultaten reduceras i blockordning.
+*                         - self     : Pekare till vektorn.
+*                         - reduction: Reduktionen som skall utfras.
+*                         - result   : Pekare till variabel av vektorns
+*                                      datatyp dr resultatet skall lagras.
+*******************************************************************************/
+int vector_parallel_reduce(const struct vector* self,
+                           const enum vector_parallel_reduction reduction,
+                           void* result)
+{
+   struct vector_parallel_job job = { 0 };
+   const size_t num_chunks = (self->size + VECTOR_PARALLEL_CHUNK_SIZE - 1) / VECTOR_PARALLEL_CHUNK_SIZE;
+
+   if (self->type >= VECTOR_TYPE_NONE || !result) return 1;
+   if (num_chunks <= 1)
+   {
+      return vector_parallel_reduce_range(self, reduction, self->data.raw, self->size, result);
+   }
+
+   job.partials = malloc(num_chunks * self->ops->element_size);
+   if (!job.partials) return 1;
+   job.run = &vector_parallel_reduce_chunk;
+   job.vector = self;
+   job.reduction = reduction;
+   vector_parallel_run(&job);
+
+   const int status = vector_parallel_reduce_range(self, reduction, job.partials, num_chunks, result);
+   free(job.partials);
+   return status;
+}
+
+/*******************************************************************************
+* vector_parallel_for: Utfr angivet antal deluppgifter via trdpoolen, dr
+*                      anropande trd deltar i arbetet. Deluppgifterna utfrs
+*                      i godtycklig ordning och kan kras samtidigt, men
+*                      samtliga r klara nr funktionen returnerar. Trskeln
+*                      fr flertrdning gller inte, utan anroparen avgr
+*                      sjlv ifall arbetet r tillrckligt stort.
+*                      - num_tasks: Antalet deluppgifter.
+*                      - task     : Funktion som anropas med deluppgiftens
+*                                   index (0 till num_tasks - 1).
+*                      - context  : Data som passeras till funktionen.
+*******************************************************************************/
+int vector_parallel_for(const size_t num_tasks,
+                        void (*task)(const size_t index, void* context),
+                        void* context)
+{
+   struct vector_parallel_job job = { 0 };
+   if (!task) return 1;
+   job.run = &vector_parallel_task_chunk;
+   job.task = task;
+   job.context = context;
+   job.num_chunks = num_tasks;
+   vector_parallel_run(&job);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_parallel_set_threads: Anger det totala antalet trdar som anvnds,
+*                              inklusive anropande trd. Befintlig trdpool
+*                              avslutas och en ny startas. Vid vrdet noll
+*                              anvnds antalet tillgngliga processorkrnor.
+*                              Kan inte anropas inifrn ett jobb.
+*                              - num_threads: Det totala antalet trdar.
+*******************************************************************************/
+int vector_parallel_set_threads(const size_t num_threads)
+{
+   if (vector_parallel_busy) return 1;
+   pthread_mutex_lock(&vector_pool_submit);
+   vector_pool_stop();
+   pthread_mutex_lock(&vector_pool.mutex);
+   vector_parallel_num_threads = num_threads;
+   pthread_mutex_unlock(&vector_pool.mutex);
+   const int status = vector_pool_start(num_threads);
+   pthread_mutex_unlock(&vector_pool_submit);
+   return status;
+}
+
+/*******************************************************************************
+* vector_parallel_threads: Returnerar det angivna totala antalet trdar,
+*                          inklusive anropande trd, utan att starta
+*                          trdpoolen.
+*******************************************************************************/
+size_t vector_parallel_threads(void)
+{
+   pthread_mutex_lock(&vector_pool.mutex);
+   const size_t num_threads = vector_parallel_num_threads;
+   pthread_mutex_unlock(&vector_pool.mutex);
+   return vector_pool_size(num_threads);
+}
+
+/*******************************************************************************
+* vector_parallel_set_threshold: Anger minsta antalet element som krvs fr
+*                                att en operation skall utfras flertrdat.
+*                                Mindre vektorer behandlas seriellt.
+*                                - min_size: Minsta antalet element.
+*******************************************************************************/
+void vector_parallel_set_threshold(const size_t min_size)
+{
+   pthread_mutex_lock(&vector_pool_submit);
+   vector_parallel_threshold = min_size;
+   pthread_mutex_unlock(&vector_pool_submit);
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_shutdown: Avslutar trdpoolens arbetartrdar och frigr
+*                           tillhrande minne. Poolen startas p nytt vid
+*                           nsta flertrdade operation. Anrop inifrn ett
+*                           jobb ignoreras.
+*******************************************************************************/
+void vector_parallel_shutdown(void)
+{
+   if (vector_parallel_busy) return;
+   pthread_mutex_lock(&vector_pool_submit);
+   vector_pool_stop();
+   pthread_mutex_unlock(&vector_pool_submit);
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_run: Utfr angivet jobb blockvis. Ifall jobbet bestr av
+*                      ett enda block, vektorn r mindre n trskeln,
+*                      trdpoolen saknar arbetartrdar eller anropet sker
+*                      inifrn ett annat jobb, behandlas samtliga block i
+*                      anropande trd. Poolen startas frst nr ett jobb
+*                      faktiskt skall delas upp. Poolen utfr ett jobb i taget,
+*                      varfr ett nstlat jobb annars skulle vnta p sig
+*                      sjlvt. Jobb utan vektor (se vector_parallel_for) har
+*                      redan angivet antal block och omfattas inte av trskeln.
+*                      - job: Pekare till jobbet.
+*******************************************************************************/
+static void vector_parallel_run(struct vector_parallel_job* job)
+{
+   const size_t size = job->vector ? job->vector->size : 0;
+   if (job->vector) job->num_chunks = (size + VECTOR_PARALLEL_CHUNK_SIZE - 1) / VECTOR_PARALLEL_CHUNK_SIZE;
+
+   if (!vector_parallel_busy) pthread_mutex_lock(&vector_pool_submit);
+   const int serial = vector_parallel_busy || job->num_chunks <= 1 ||
+                      (job->vector && size < vector_parallel_threshold);
+   if (!serial && !vector_pool.started) vector_pool_start(vector_parallel_num_threads);
+
+   if (serial || !vector_pool.num_threads)
+   {
+      if (!vector_parallel_busy) pthread_mutex_unlock(&vector_pool_submit);
+      for (size_t i = 0; i < job->num_chunks; ++i)
+      {
+         vector_parallel_chunk(job, i);
+      }
+      return;
+   }
+
+   vector_parallel_busy = 1;
+
+   pthread_mutex_lock(&vector_pool.mutex);
+   vector_pool.job = job;
+   vector_pool.next_chunk = 0;
+   vector_pool.done_chunks = 0;
+   pthread_cond_broadcast(&vector_pool.work);
+
+   while (vector_pool.next_chunk < job->num_chunks)
+   {
+      const size_t chunk = vector_pool.next_chunk++;
+      pthread_mutex_unlock(&vector_pool.mutex);
+      vector_parallel_chunk(job, chunk);
+      pthread_mutex_lock(&vector_pool.mutex);
+      vector_pool.done_chunks++;
+   }
+
+   while (vector_pool.done_chunks < job->num_chunks)
+   {
+      pthread_cond_wait(&vector_pool.done, &vector_pool.mutex);
+   }
+
+   vector_pool.job = 0;
+   pthread_mutex_unlock(&vector_pool.mutex);
+   vector_parallel_busy = 0;
+   pthread_mutex_unlock(&vector_pool_submit);
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_chunk: Behandlar angivet block i ett jobb.
+*                        - job  : Pekare till jobbet.
+*                        - chunk: Blockets index.
+*******************************************************************************/
+static void vector_parallel_chunk(struct vector_parallel_job* job,
+                                  const size_t chunk)
+{
+   if (!job->vector)
+   {
+      job->run(job, 0, 0, chunk);
+      return;
+   }
+
+   const size_t first = chunk * VECTOR_PARALLEL_CHUNK_SIZE;
+   const size_t remaining = job->vector->size - first;
+   const size_t size = remaining < VECTOR_PARALLEL_CHUNK_SIZE ? remaining : VECTOR_PARALLEL_CHUNK_SIZE;
+   char* data = (char*)job->vector->data.raw + first * job->vector->ops->element_size;
+   job->run(job, data, size, chunk);
+   return;
+}
+
+/*******************************************************************************
+* vector_pool_worker: Arbetartrdarnas huvudloop, dr block hmtas och
+*                     behandlas tills poolen avslutas.
+*                     - arg: Anvnds ej.
+*******************************************************************************/
+static void* vector_pool_worker(void* arg)
+{
+   (void)arg;
+   vector_parallel_busy = 1;
+   pthread_mutex_lock(&vector_pool.mutex);
+
+   while (1)
+   {
+      while (!vector_pool.stop &&
+             (!vector_pool.job || vector_pool.next_chunk >= vector_pool.job->num_chunks))
+      {
+         pthread_cond_wait(&vector_pool.work, &vector_pool.mutex);
+      }
+
+      if (vector_pool.stop) break;
+
+      struct vector_parallel_job* job = vector_pool.job;
+      const size_t chunk = vector_pool.next_chunk++;
+      pthread_mutex_unlock(&vector_pool.mutex);
+      vector_parallel_chunk(job, chunk);
+      pthread_mutex_lock(&vector_pool.mutex);
+
+      if (++vector_pool.done_chunks == job->num_chunks)
+      {
+         pthread_cond_signal(&vector_pool.done);
+      }
+   }
+
+   pthread_mutex_unlock(&vector_pool.mutex);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_pool_start: Startar trdpoolen. Anropande trd rknas som en av
+*                    trdarna, varfr en arbetartrd frre skapas. Anropas
+*                    med vector_pool_submit lst.
+*                    - num_threads: Det totala antalet trdar (noll medfr
+*                                   antalet tillgngliga processorkrnor).
+*******************************************************************************/
+static int vector_pool_start(size_t num_threads)
+{
+   num_threads = vector_pool_size(num_threads);
+   vector_pool.started = 1;
+   vector_pool.num_threads = 0;
+   if (num_threads <= 1) return 0;
+
+   vector_pool.threads = (pthread_t*)malloc(sizeof(pthread_t) * (num_threads - 1));
+   if (!vector_pool.threads) return 1;
+
+   for (size_t i = 0; i < num_threads - 1; ++i)
+   {
+      if (pthread_create(&vector_pool.threads[i], 0, &vector_pool_worker, 0)) return 1;
+      vector_pool.num_threads++;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_pool_size: Returnerar det totala antalet trdar fr angivet vrde,
+*                   dr noll medfr antalet tillgngliga processorkrnor.
+*                   - num_threads: Angivet antal trdar.
+*******************************************************************************/
+static size_t vector_pool_size(const size_t num_threads)
+{
+   if (!num_threads)
+   {
+      const long num_cores = sysconf(_SC_NPROCESSORS_ONLN);
+      return num_cores > 0 ? (size_t)num_cores : 1;
+   }
+   return num_threads;
+}
+
+/*******************************************************************************
+* vector_pool_stop: Avslutar samtliga arbetartrdar och vntar in dem.
+*                   Anropas med vector_pool_submit lst.
+*******************************************************************************/
+static void vector_pool_stop(void)
+{
+   pthread_mutex_lock(&vector_pool.mutex);
+   vector_pool.stop = 1;
+   pthread_cond_broadcast(&vector_pool.work);
+   pthread_mutex_unlock(&vector_pool.mutex);
+
+   for (size_t i = 0; i < vector_pool.num_threads; ++i)
+   {
+      pthread_join(vector_pool.threads[i], 0);
+   }
+
+   free(vector_pool.threads);
+   vector_pool.threads = 0;
+   vector_pool.num_threads = 0;
+   vector_pool.started = 0;
+   vector_pool.stop = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_fill_chunk: Tilldelar samtliga element i ett block angivet
+*                             vrde. Vrdet kopieras som ett bitmnster av
+*                             elementens storlek.
+*******************************************************************************/
+static void vector_parallel_fill_chunk(struct vector_parallel_job* self,
+                                       void* data,
+                                       const size_t size,
+                                       const size_t chunk)
+{
+   const size_t element_size = self->vector->ops->element_size;
+   (void)chunk;
+
+   if (element_size == sizeof(uint8_t))
+   {
+      memset(data, *(const unsigned char*)self->operand, size);
+   }
+   else if (element_size == sizeof(uint16_t))
+   {
+      uint16_t pattern;
+      memcpy(&pattern, self->operand, sizeof(pattern));
+      for (size_t i = 0; i < size; ++i) ((uint16_t*)data)[i] = pattern;
+   }
+   else if (element_size == sizeof(uint32_t))
+   {
+      uint32_t pattern;
+      memcpy(&pattern, self->operand, sizeof(pattern));
+      for (size_t i = 0; i < size; ++i) ((uint32_t*)data)[i] = pattern;
+   }
+   else if (element_size == sizeof(uint64_t))
+   {
+      uint64_t pattern;
+      memcpy(&pattern, self->operand, sizeof(pattern));
+      for (size_t i = 0; i < size; ++i) ((uint64_t*)data)[i] = pattern;
+   }
+   else
+   {
+      for (size_t i = 0; i < size; ++i)
+      {
+         memcpy((char*)data + i * element_size, self->operand, element_size);
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_transform_chunk: Anropar anvndarens funktion fr samtliga
+*                                  element i ett block.
+*******************************************************************************/
+static void vector_parallel_transform_chunk(struct vector_parallel_job* self,
+                                            void* data,
+                                            const size_t size,
+                                            const size_t chunk)
+{
+   const size_t element_size = self->vector->ops->element_size;
+   (void)chunk;
+
+   for (size_t i = 0; i < size; ++i)
+   {
+      self->callback((char*)data + i * element_size, self->context);
+   }
+   return;
+}
+
+/* Genererar en inbyggd transformering fr en given datatyp. */
+#define VECTOR_PARALLEL_OP_LOOP(type, wrap)                                     \
+{                                                                               \
+   type* x = (type*)data;                                                       \
+   const wrap a = self->operand ? (wrap)*(const type*)self->operand : (wrap)0;  \
+   if (self->op == VECTOR_PARALLEL_OP_ADD)                                      \
+      for (size_t i = 0; i < size; ++i) x[i] = (type)((wrap)x[i] + a);          \
+   else if (self->op == VECTOR_PARALLEL_OP_MUL)                                 \
+      for (size_t i = 0; i < size; ++i) x[i] = (type)((wrap)x[i] * a);          \
+   else if (self->op == VECTOR_PARALLEL_OP_SQUARE)                              \
+      for (size_t i = 0; i < size; ++i) x[i] = (type)((wrap)x[i] * (wrap)x[i]); \
+}
+
+/*******************************************************************************
+* vector_parallel_op_chunk: Utfr en inbyggd transformering p ett block.
+*******************************************************************************/
+static void vector_parallel_op_chunk(struct vector_parallel_job* self,
+                                     void* data,
+                                     const size_t size,
+                                     const size_t chunk)
+{
+   (void)chunk;
+
+   switch (self->vector->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_PARALLEL_OP_LOOP(int, unsigned) break;
+      case VECTOR_TYPE_DOUBLE: VECTOR_PARALLEL_OP_LOOP(double, double) break;
+      case VECTOR_TYPE_UNSIGNED: VECTOR_PARALLEL_OP_LOOP(size_t, size_t) break;
+      case VECTOR_TYPE_INT8: VECTOR_PARALLEL_OP_LOOP(int8_t, unsigned) break;
+      case VECTOR_TYPE_INT16: VECTOR_PARALLEL_OP_LOOP(int16_t, unsigned) break;
+      case VECTOR_TYPE_INT64: VECTOR_PARALLEL_OP_LOOP(int64_t, uint64_t) break;
+      case VECTOR_TYPE_UINT8: VECTOR_PARALLEL_OP_LOOP(uint8_t, unsigned) break;
+      case VECTOR_TYPE_UINT16: VECTOR_PARALLEL_OP_LOOP(uint16_t, unsigned) break;
+      case VECTOR_TYPE_UINT32: VECTOR_PARALLEL_OP_LOOP(uint32_t, uint32_t) break;
+      case VECTOR_TYPE_FLOAT: VECTOR_PARALLEL_OP_LOOP(float, float) break;
+      default: break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_reduce_chunk: Reducerar ett block och lagrar delresultatet
+*                               p blockets plats bland delresultaten.
+*******************************************************************************/
+static void vector_parallel_reduce_chunk(struct vector_parallel_job* self,
+                                         void* data,
+                                         const size_t size,
+                                         const size_t chunk)
+{
+   void* partial = (char*)self->partials + chunk * self->vector->ops->element_size;
+   vector_parallel_reduce_range(self->vector, self->reduction, data, size, partial);
+   return;
+}
+
+/*******************************************************************************
+* vector_parallel_reduce_range: Reducerar ett antal element av angiven vektors
+*                               datatyp via numeriska berkningar i
+*                               vector_kernels.
+*                               - self     : Vektorn som anger datatyp.
+*                               - reduction: Reduktionen som skall utfras.
+*                               - data     : Pekare till frsta elementet.
+*                               - size     : Antalet element.
+*                               - result   : Pekare till resultatet.
+*******************************************************************************/
+static int vector_parallel_reduce_range(const struct vector* self,
+                                        const enum vector_parallel_reduction reduction,
+                                        void* data,
+                                        const size_t size,
+                                        void* result)
+{
+   struct vector range;
+   vector_new(&range, self->type);
+   range.data.raw = data;
+   range.size = size;
+   range.capacity = size;
+   range.flags = VECTOR_FLAG_READONLY;
+
+   if (reduction == VECTOR_PARALLEL_SUM)
+   {
+      return vector_sum(&range, result);
+   }
+   else if (reduction == VECTOR_PARALLEL_MIN)
+   {
+      return vector_min(&range, result);
+   }
+   else if (reduction == VECTOR_PARALLEL_MAX)
+   {
+      return vector_max(&range, result);
+   }
+   else
+   {
+      return 1;
+   }
+}
+
+/*******************************************************************************
+* vector_parallel_task_chunk: Utfr deluppgiften med blockets index, se
+*                             vector_parallel_for.
+*******************************************************************************/
+static void vector_parallel_task_chunk(struct vector_parallel_job* self,
+                                       void* data,
+                                       const size_t size,
+                                       const size_t chunk)
+{
+   (void)data;
+   (void)size;
+   self->task(chunk, self->context);
+   return;
+}
@@ -0,0 +1,62 @@
+/*******************************************************************************
+* vector_parallel.h: Flertrdade operationer (fyllning, transformering samt
+*                    reduktion) fr stora vektorer via en trdpool baserad p
+*                    POSIX-trdar. Vektorn delas upp i block av fast storlek,
+*                    oberoende av antalet trdar, och delresultat kombineras i
+*                    blockordning. Drmed blir flyttalsreduktioner
+*                    reproducerbara oavsett antalet trdar. Vektorer mindre
+*                    n angiven trskel behandlas seriellt i anropande trd,
+*                    liksom operationer som anropas inifrn en annan
+*                    flertrdad operation (exempelvis frn en funktion
+*                    passerad till vector_parallel_transform).
+*
+*                    Programmet mste lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_PARALLEL_H_
+#define VECTOR_PARALLEL_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_parallel_op: Inbyggda transformeringar, som utfrs elementvis med
+*                     en operand av vektorns datatyp.
+*******************************************************************************/
+enum vector_parallel_op
+{
+   VECTOR_PARALLEL_OP_ADD,   /* element = element + operand. */
+   VECTOR_PARALLEL_OP_MUL,   /* element = element * operand. */
+   VECTOR_PARALLEL_OP_SQUARE /* element = element * element (ingen operand). */
+};
+
+/*******************************************************************************
+* vector_parallel_reduction: Inbyggda reduktioner.
+*******************************************************************************/
+enum vector_parallel_reduction
+{
+   VECTOR_PARALLEL_SUM, /* Summan av samtliga element. */
+   VECTOR_PARALLEL_MIN, /* Minsta elementet. */
+   VECTOR_PARALLEL_MAX  /* Strsta elementet. */
+};
+
+/* Externa funktioner: */
+int vector_parallel_fill(struct vector* self,
+                         const void* value);
+int vector_parallel_transform(struct vector* self,
+                              void (*callback)(void* element, void* context),
+                              void* context);
+int vector_parallel_transform_op(struct vector* self,
+                                 const enum vector_parallel_op op,
+                                 const void* operand);
+int vector_parallel_reduce(const struct vector* self,
+                           const enum vector_parallel_reduction reduction,
+                           void* result);
+int vector_parallel_for(const size_t num_tasks,
+                        void (*task)(const size_t index, void* context),
+                        void* context);
+int vector_parallel_set_threads(const size_t num_threads);
+size_t vector_parallel_threads(void);
+void vector_parallel_set_threshold(const size_t min_size);
+void vector_parallel_shutdown(void);
+
+#endif /* VECTOR_PARALLEL_H_ */
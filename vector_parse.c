@@ -0,0 +1,593 @@
+/*******************************************************************************
+* vector_parse.c: Innehller funktioner fr inlsning av tal i textform till
+*                 vektorer, frn strm, buffert eller minnesmappad fil.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector_parse.h"
+#include "vector_parallel.h"
+#include <errno.h>
+#include <limits.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_PARSE_SAMPLE_SIZE 65536 /* Antalet byte som tolkas innan kapacitet reserveras. */
+#define VECTOR_PARSE_MIN_PART 1048576  /* Minsta antalet byte per del. */
+#define VECTOR_PARSE_MAX_THREADS 64    /* Strsta antalet delar. */
+
+/*******************************************************************************
+* vector_parse_task: Del av en buffert som tolkas i en egen trd till en
+*                    egen delvektor.
+*******************************************************************************/
+struct vector_parse_task
+{
+   struct vector part; /* Delvektor fr tolkade element. */
+   const char* begin;  /* Pekare till delens frsta tecken. */
+   const char* end;    /* Pekare till tecknet efter delens sista tecken. */
+   int status;         /* Resultat av tolkningen (0 vid lyckad tolkning). */
+};
+
+/* Statiska funktioner: */
+static inline int vector_parse_is_separator(const char c);
+static const char* vector_parse_integer(const char* s,
+                                        const char* end,
+                                        const uint64_t max,
+                                        int64_t* value);
+static const char* vector_parse_natural(const char* s,
+                                        const char* end,
+                                        const uint64_t max,
+                                        uint64_t* value);
+static const char* vector_parse_double(const char* s,
+                                       const char* end,
+                                       double* value);
+static int vector_parse_block(struct vector* self,
+                              const char* begin,
+                              const char* end);
+static void vector_parse_reserve(struct vector* self,
+                                 const size_t num_parsed,
+                                 const size_t bytes_parsed,
+                                 const size_t bytes_remaining);
+static void vector_parse_task_run(const size_t index,
+                                  void* context);
+
+/* Statiska variabler: */
+static const double vector_parse_pow10[] =
+{
+   1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+   1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*******************************************************************************
+* vector_parse: Lser in samtliga tal frn angiven strm och lgger till dem
+*               sist i angiven vektor. Strmmen lses i stora block, dr ett
+*               tal som delas av blockgrnsen flyttas till nsta block. Om
+*               strmmen r en vanlig fil reserveras kapacitet efter frsta
+*               blocket utifrn filens terstende storlek.
+*               - self   : Pekare till vektorn.
+*               - istream: Pekare till angiven instrm.
+*******************************************************************************/
+int vector_parse(struct vector* self,
+                 FILE* istream)
+{
+   const size_t old_size = self->size;
+   size_t carry = 0, bytes_remaining = 0;
+   struct stat info;
+
+   if (!self->ops->element_size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   char* buffer = (char*)malloc(VECTOR_PARSE_BLOCK_SIZE);
+   if (!buffer) return 1;
+
+   if (!fstat(fileno(istream), &info) && S_ISREG(info.st_mode))
+   {
+      const long position = ftell(istream);
+      if (position >= 0 && info.st_size > position) bytes_remaining = (size_t)(info.st_size - position);
+   }
+
+   for (;;)
+   {
+      const size_t num_read = fread(buffer + carry, 1, VECTOR_PARSE_BLOCK_SIZE - carry, istream);
+      const size_t length = carry + num_read;
+      const int eof = num_read < VECTOR_PARSE_BLOCK_SIZE - carry;
+      const char* stop = buffer + length;
+
+      if (eof && ferror(istream)) break;
+
+      /* Tolkar enbart fram till sista avgrnsaren om mer data terstr: */
+      if (!eof)
+      {
+         while (stop > buffer && !vector_parse_is_separator(stop[-1])) --stop;
+         if (stop == buffer) break;
+      }
+
+      const size_t num_before = self->size;
+      if (vector_parse_block(self, buffer, stop)) break;
+
+      if (bytes_remaining && !eof && bytes_remaining > (size_t)(stop - buffer))
+      {
+         vector_parse_reserve(self, self->size - num_before, (size_t)(stop - buffer),
+                              bytes_remaining - (size_t)(stop - buffer));
+         bytes_remaining = 0;
+      }
+
+      carry = (size_t)(buffer + length - stop);
+      memmove(buffer, stop, carry);
+
+      if (eof)
+      {
+         free(buffer);
+         return 0;
+      }
+   }
+
+   free(buffer);
+   vector_resize(self, old_size);
+   return 1;
+}
+
+/*******************************************************************************
+* vector_parse_buffer: Lser in samtliga tal frn angiven buffert och lgger
+*                      till dem sist i angiven vektor. Efter de frsta
+*                      VECTOR_PARSE_SAMPLE_SIZE byten reserveras kapacitet
+*                      fr resten av bufferten utifrn antalet tolkade tal.
+*                      Bufferten behver inte vara nollterminerad.
+*                      - self  : Pekare till vektorn.
+*                      - buffer: Pekare till bufferten.
+*                      - size  : Buffertens storlek i byte.
+*******************************************************************************/
+int vector_parse_buffer(struct vector* self,
+                        const char* buffer,
+                        const size_t size)
+{
+   const size_t old_size = self->size;
+   const char* end = buffer + size;
+   const char* split = end;
+
+   if (!self->ops->element_size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+
+   if (size > VECTOR_PARSE_SAMPLE_SIZE)
+   {
+      split = buffer + VECTOR_PARSE_SAMPLE_SIZE;
+      while (split < end && !vector_parse_is_separator(*split)) ++split;
+   }
+
+   if (vector_parse_block(self, buffer, split))
+   {
+      vector_resize(self, old_size);
+      return 1;
+   }
+
+   if (split < end)
+   {
+      vector_parse_reserve(self, self->size - old_size, (size_t)(split - buffer), (size_t)(end - split));
+
+      if (vector_parse_block(self, split, end))
+      {
+         vector_resize(self, old_size);
+         return 1;
+      }
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_parse_parallel: Lser in samtliga tal frn angiven buffert
+*                        flertrdat. Bufferten delas upp vid avgrnsare i
+*                        angivet antal lika stora delar (minst 1 MB per del),
+*                        som tolkas till var sin delvektor via trdpoolen
+*                        (se vector_parallel_for). Delvektorerna lggs sedan
+*                        till i ordning sist i angiven vektor.
+*                        - self       : Pekare till vektorn.
+*                        - buffer     : Pekare till bufferten.
+*                        - size       : Buffertens storlek i byte.
+*                        - num_threads: Antalet delar (0 medfr samma antal
+*                                       som vector_parallel_threads).
+*******************************************************************************/
+int vector_parse_parallel(struct vector* self,
+                          const char* buffer,
+                          const size_t size,
+                          size_t num_threads)
+{
+   struct vector_parse_task tasks[VECTOR_PARSE_MAX_THREADS];
+   const char* end = buffer + size;
+   size_t total = 0;
+   int status = 0;
+
+   if (!num_threads) num_threads = vector_parallel_threads();
+   if (num_threads > size / VECTOR_PARSE_MIN_PART) num_threads = size / VECTOR_PARSE_MIN_PART;
+   if (num_threads > VECTOR_PARSE_MAX_THREADS) num_threads = VECTOR_PARSE_MAX_THREADS;
+   if (num_threads < 2) return vector_parse_buffer(self, buffer, size);
+   if (!self->ops->element_size || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+
+   for (size_t i = 0; i < num_threads; ++i)
+   {
+      const char* split = i + 1 < num_threads ? buffer + size / num_threads * (i + 1) : end;
+      while (split < end && !vector_parse_is_separator(*split)) ++split;
+
+      vector_new(&tasks[i].part, self->type);
+      tasks[i].begin = i ? tasks[i - 1].end : buffer;
+      tasks[i].end = split > tasks[i].begin ? split : tasks[i].begin;
+      tasks[i].status = 0;
+   }
+
+   vector_parallel_for(num_threads, &vector_parse_task_run, tasks);
+
+   for (size_t i = 0; i < num_threads; ++i)
+   {
+      status |= tasks[i].status;
+      total += tasks[i].part.size;
+   }
+
+   if (!status && !vector_reserve(self, self->size + total))
+   {
+      for (size_t i = 0; i < num_threads; ++i)
+      {
+         vector_push_range(self, tasks[i].part.data.raw, tasks[i].part.size);
+      }
+   }
+   else
+   {
+      status = 1;
+   }
+
+   for (size_t i = 0; i < num_threads; ++i)
+   {
+      vector_delete(&tasks[i].part);
+   }
+   return status;
+}
+
+/*******************************************************************************
+* vector_parse_file: Minnesmappar angiven fil och lser in samtliga tal via
+*                    vector_parse_parallel, vilket undviker kopiering till
+*                    en lsbuffert.
+*                    - self       : Pekare till vektorn.
+*                    - path       : Skvg till filen.
+*                    - num_threads: Antalet delar (0 medfr samma antal som
+*                                   vector_parallel_threads, 1 medfr
+*                                   inlsning i anropande trd).
+*******************************************************************************/
+int vector_parse_file(struct vector* self,
+                      const char* path,
+                      const size_t num_threads)
+{
+   struct stat info;
+   const int fd = open(path, O_RDONLY);
+   if (fd < 0) return 1;
+
+   if (fstat(fd, &info) || !S_ISREG(info.st_mode))
+   {
+      close(fd);
+      return 1;
+   }
+   if (!info.st_size)
+   {
+      close(fd);
+      return 0;
+   }
+
+   const size_t size = (size_t)info.st_size;
+   void* mapping = mmap(0, size, PROT_READ, MAP_PRIVATE, fd, 0);
+   close(fd);
+   if (mapping == MAP_FAILED) return 1;
+
+   posix_madvise(mapping, size, POSIX_MADV_SEQUENTIAL);
+   const int status = vector_parse_parallel(self, (const char*)mapping, size, num_threads);
+   munmap(mapping, size);
+   return status;
+}
+
+/*******************************************************************************
+* vector_parse_is_separator: Indikerar ifall angivet tecken skiljer tal t.
+*******************************************************************************/
+static inline int vector_parse_is_separator(const char c)
+{
+   return c == '\n' || c == ',' || c == ' ' || c == '\r' || c == '\t';
+}
+
+/*******************************************************************************
+* vector_parse_integer: Tolkar ett signerat heltal och returnerar pekare till
+*                       tecknet efter talet, eller nullpekare om talet r
+*                       ogiltigt, inte fljs av en avgrnsare eller ligger
+*                       utanfr intervallet [-max - 1, max].
+*                       - s    : Pekare till talets frsta tecken.
+*                       - end  : Pekare till tecknet efter buffertens slut.
+*                       - max  : Strsta tilltna vrde (exempelvis INT_MAX).
+*                       - value: Pekare till lagringsplats fr talet.
+*******************************************************************************/
+static const char* vector_parse_integer(const char* s,
+                                        const char* end,
+                                        const uint64_t max,
+                                        int64_t* value)
+{
+   const int negative = *s == '-';
+   const uint64_t limit = max + (uint64_t)negative;
+   uint64_t x = 0;
+
+   if (*s == '-' || *s == '+') ++s;
+   const char* digits = s;
+
+   while (s < end && (unsigned)(*s - '0') < 10)
+   {
+      const uint64_t digit = (uint64_t)(*s - '0');
+      if (x > (limit - digit) / 10) return 0;
+      x = x * 10 + digit;
+      ++s;
+   }
+
+   if (s == digits || (s < end && !vector_parse_is_separator(*s))) return 0;
+   *value = negative && x ? -(int64_t)(x - 1) - 1 : (int64_t)x;
+   return s;
+}
+
+/*******************************************************************************
+* vector_parse_natural: Tolkar ett osignerat heltal och returnerar pekare
+*                       till tecknet efter talet, eller nullpekare om talet
+*                       r ogiltigt, inte fljs av en avgrnsare eller r
+*                       strre n angivet strsta vrde.
+*                       - s    : Pekare till talets frsta tecken.
+*                       - end  : Pekare till tecknet efter buffertens slut.
+*                       - max  : Strsta tilltna vrde (exempelvis SIZE_MAX).
+*                       - value: Pekare till lagringsplats fr talet.
+*******************************************************************************/
+static const char* vector_parse_natural(const char* s,
+                                        const char* end,
+                                        const uint64_t max,
+                                        uint64_t* value)
+{
+   uint64_t x = 0;
+   if (*s == '+') ++s;
+   const char* digits = s;
+
+   while (s < end && (unsigned)(*s - '0') < 10)
+   {
+      const uint64_t digit = (uint64_t)(*s - '0');
+      if (x > (max - digit) / 10) return 0;
+      x = x * 10 + digit;
+      ++s;
+   }
+
+   if (s == digits || (s < end && !vector_parse_is_separator(*s))) return 0;
+   *value = x;
+   return s;
+}
+
+/*******************************************************************************
+* vector_parse_double: Tolkar ett flyttal och returnerar pekare till tecknet
+*                      efter talet, eller nullpekare om talet r ogiltigt
+*                      eller ligger utanfr datatypens intervall (exempelvis
+*                      1e400). Uttryckligen angiven ondlighet (inf) godtas.
+*                      Tal med hgst 19 signifikanta siffror, en mantissa
+*                      som ryms exakt i ett flyttal samt en tiopotens mellan
+*                      -22 och 22 berknas exakt via en multiplikation eller
+*                      division. vriga tal tolkas via strtod.
+*                      - s    : Pekare till talets frsta tecken.
+*                      - end  : Pekare till tecknet efter buffertens slut.
+*                      - value: Pekare till lagringsplats fr talet.
+*******************************************************************************/
+static const char* vector_parse_double(const char* s,
+                                       const char* end,
+                                       double* value)
+{
+   const char* token = s;
+   const int negative = *s == '-';
+   uint64_t mantissa = 0;
+   int num_digits = 0, exponent = 0, exact = 1;
+
+   if (*s == '-' || *s == '+') ++s;
+   const char* digits = s;
+
+   for (; s < end && (unsigned)(*s - '0') < 10; ++s)
+   {
+      if (num_digits < 19)
+      {
+         mantissa = mantissa * 10 + (unsigned)(*s - '0');
+         num_digits += mantissa != 0;
+      }
+      else
+      {
+         exact = 0;
+      }
+   }
+
+   if (s < end && *s == '.')
+   {
+      for (++s; s < end && (unsigned)(*s - '0') < 10; ++s)
+      {
+         if (num_digits < 19)
+         {
+            mantissa = mantissa * 10 + (unsigned)(*s - '0');
+            num_digits += mantissa != 0;
+            exponent--;
+         }
+         else
+         {
+            exact = 0;
+         }
+      }
+   }
+   if (s == digits || (s == digits + 1 && *digits == '.')) exact = 0;
+
+   if (exact && s < end && (*s == 'e' || *s == 'E'))
+   {
+      const char* position = ++s;
+      const int exponent_negative = s < end && *s == '-';
+      int x = 0;
+
+      if (s < end && (*s == '-' || *s == '+')) ++s;
+      const char* exponent_digits = s;
+      for (; s < end && (unsigned)(*s - '0') < 10; ++s)
+      {
+         if (x < 100000) x = x * 10 + (*s - '0');
+      }
+
+      if (s == exponent_digits) s = position, exact = 0;
+      exponent += exponent_negative ? -x : x;
+   }
+
+   if (exact && (s == end || vector_parse_is_separator(*s)) &&
+       mantissa <= ((uint64_t)1 << 53) && exponent >= -22 && exponent <= 22)
+   {
+      const double x = (double)mantissa;
+      *value = exponent < 0 ? x / vector_parse_pow10[-exponent] : x * vector_parse_pow10[exponent];
+      if (negative) *value = -*value;
+      return s;
+   }
+   else
+   {
+      char copy[VECTOR_PARSE_MAX_TOKEN];
+      char* stop = 0;
+      size_t length = 0;
+
+      while (token + length < end && !vector_parse_is_separator(token[length])) ++length;
+      if (length >= sizeof(copy)) return 0;
+
+      memcpy(copy, token, length);
+      copy[length] = '\0';
+      errno = 0;
+      *value = strtod(copy, &stop);
+      if (isinf(*value) && errno == ERANGE) return 0;
+      return stop == copy + length && length ? token + length : 0;
+   }
+}
+
+/*******************************************************************************
+* vector_parse_float: Tolkar ett flyttal med enkel precision via
+*                     vector_parse_double. ndliga tal som avrundas till
+*                     ondligheten ger nullpekare, likt vector_parse_double.
+*******************************************************************************/
+static const char* vector_parse_float(const char* s,
+                                      const char* end,
+                                      float* value)
+{
+   const double limit = 0x1.ffffffp127; /* Minsta belopp som avrundas till ondligheten. */
+   double x;
+   if (!(s = vector_parse_double(s, end, &x))) return 0;
+   if (isfinite(x) && (x >= limit || x <= -limit)) return 0;
+   *value = (float)x;
+   return s;
+}
+
+/*******************************************************************************
+* VECTOR_PARSE_DEFINE: Genererar en funktion som tolkar ett heltal av en given
+*                      datatyp via vector_parse_integer eller
+*                      vector_parse_natural, med datatypens strsta vrde som
+*                      grns.
+*                      - name : Namnsuffix fr den genererade funktionen.
+*                      - type : Elementens datatyp.
+*                      - wide : Datatyp som talet tolkas till (int64_t fr
+*                               signerade och uint64_t fr osignerade heltal).
+*                      - parse: Funktionen som tolkar talet.
+*                      - max  : Datatypens strsta vrde.
+*******************************************************************************/
+#define VECTOR_PARSE_DEFINE(name, type, wide, parse, max)                       \
+static const char* vector_parse_##name(const char* s,                           \
+                                       const char* end,                         \
+                                       type* value)                             \
+{                                                                               \
+   wide x;                                                                      \
+   if (!(s = parse(s, end, (uint64_t)(max), &x))) return 0;                     \
+   *value = (type)x;                                                            \
+   return s;                                                                    \
+}
+
+VECTOR_PARSE_DEFINE(int, int, int64_t, vector_parse_integer, INT_MAX)
+VECTOR_PARSE_DEFINE(unsigned, size_t, uint64_t, vector_parse_natural, SIZE_MAX)
+VECTOR_PARSE_DEFINE(int8, int8_t, int64_t, vector_parse_integer, INT8_MAX)
+VECTOR_PARSE_DEFINE(int16, int16_t, int64_t, vector_parse_integer, INT16_MAX)
+VECTOR_PARSE_DEFINE(int64, int64_t, int64_t, vector_parse_integer, INT64_MAX)
+VECTOR_PARSE_DEFINE(uint8, uint8_t, uint64_t, vector_parse_natural, UINT8_MAX)
+VECTOR_PARSE_DEFINE(uint16, uint16_t, uint64_t, vector_parse_natural, UINT16_MAX)
+VECTOR_PARSE_DEFINE(uint32, uint32_t, uint64_t, vector_parse_natural, UINT32_MAX)
+
+/*******************************************************************************
+* VECTOR_PARSE_LOOP: Tolkar samtliga tal i ett block fr en given datatyp och
+*                    lgger till dem via motsvarande typade push-funktion.
+*                    - name : Namnsuffix fr den typade push-funktionen.
+*                    - type : Elementens datatyp.
+*                    - parse: Funktionen som tolkar ett tal.
+*******************************************************************************/
+#define VECTOR_PARSE_LOOP(name, type, parse)                                    \
+{                                                                               \
+   type value;                                                                  \
+   while (begin < end)                                                          \
+   {                                                                            \
+      if (vector_parse_is_separator(*begin))                                    \
+      {                                                                         \
+         ++begin;                                                               \
+         continue;                                                              \
+      }                                                                         \
+      if (!(begin = parse(begin, end, &value))) return 1;                       \
+      if (vector_##name##_push(self, value)) return 1;                          \
+   }                                                                            \
+   return 0;                                                                    \
+}
+
+/*******************************************************************************
+* vector_parse_block: Tolkar samtliga tal i angivet block och lgger till dem
+*                     sist i angiven vektor.
+*                     - self : Pekare till vektorn.
+*                     - begin: Pekare till blockets frsta tecken.
+*                     - end  : Pekare till tecknet efter blockets sista tecken.
+*******************************************************************************/
+static int vector_parse_block(struct vector* self,
+                              const char* begin,
+                              const char* end)
+{
+   switch (self->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_PARSE_LOOP(int, int, vector_parse_int)
+      case VECTOR_TYPE_DOUBLE: VECTOR_PARSE_LOOP(double, double, vector_parse_double)
+      case VECTOR_TYPE_UNSIGNED: VECTOR_PARSE_LOOP(unsigned, size_t, vector_parse_unsigned)
+      case VECTOR_TYPE_INT8: VECTOR_PARSE_LOOP(int8, int8_t, vector_parse_int8)
+      case VECTOR_TYPE_INT16: VECTOR_PARSE_LOOP(int16, int16_t, vector_parse_int16)
+      case VECTOR_TYPE_INT64: VECTOR_PARSE_LOOP(int64, int64_t, vector_parse_int64)
+      case VECTOR_TYPE_UINT8: VECTOR_PARSE_LOOP(uint8, uint8_t, vector_parse_uint8)
+      case VECTOR_TYPE_UINT16: VECTOR_PARSE_LOOP(uint16, uint16_t, vector_parse_uint16)
+      case VECTOR_TYPE_UINT32: VECTOR_PARSE_LOOP(uint32, uint32_t, vector_parse_uint32)
+      case VECTOR_TYPE_FLOAT: VECTOR_PARSE_LOOP(float, float, vector_parse_float)
+      default: return 1;
+   }
+}
+
+/*******************************************************************************
+* vector_parse_reserve: Reserverar kapacitet fr terstende tal, uppskattat
+*                       utifrn antalet tal per byte hittills plus 1/16 i
+*                       marginal. Misslyckad reservering ignoreras, eftersom
+*                       vektorn d vxer vid behov i stllet.
+*                       - self           : Pekare till vektorn.
+*                       - num_parsed     : Antalet tolkade tal.
+*                       - bytes_parsed   : Antalet tolkade byte.
+*                       - bytes_remaining: Antalet terstende byte.
+*******************************************************************************/
+static void vector_parse_reserve(struct vector* self,
+                                 const size_t num_parsed,
+                                 const size_t bytes_parsed,
+                                 const size_t bytes_remaining)
+{
+   if (!num_parsed || !bytes_parsed) return;
+   const double estimate = (double)bytes_remaining * num_parsed / bytes_parsed * 17 / 16;
+   if (estimate < (double)(SIZE_MAX / self->ops->element_size - self->size))
+   {
+      vector_reserve(self, self->size + (size_t)estimate);
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_parse_task_run: Tolkar en del av en buffert (deluppgift i
+*                        trdpoolen).
+*                        - index  : Delens index.
+*                        - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_parse_task_run(const size_t index,
+                                  void* context)
+{
+   struct vector_parse_task* task = (struct vector_parse_task*)context + index;
+   task->status = vector_parse_buffer(&task->part, task->begin, (size_t)(task->end - task->begin));
+   return;
+}
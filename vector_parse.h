@@ -0,0 +1,48 @@
+/*******************************************************************************
+* vector_parse.h: Snabb inlsning av tal i textform till vektorer, motsvarande
+*                 omvndningen av vector_print och vector_write. Talen skiljs
+*                 t av blanksteg, tabbar, radbrytningar och/eller kommatecken
+*                 och tolkas via egna funktioner i stllet fr scanf. Heltal
+*                 tolkas siffra fr siffra med kontroll av spill, medan flyttal
+*                 med hgst 19 signifikanta siffror och en tiopotens mellan
+*                 -22 och 22 berknas exakt direkt. vriga flyttal (samt nan
+*                 och inf) tolkas via strtod.
+*
+*                 Inlsta element lggs till sist i vektorn, vars datatyp
+*                 avgr hur talen tolkas. Vid fel (ogiltigt tal eller spill,
+*                 dr ven ndliga flyttal som 1e400 rknas som spill)
+*                 terstlls vektorn till sin ursprungliga storlek.
+*
+*                 Stora filer kan lsas in flertrdat via vector_parse_file,
+*                 dr filen minnesmappas och delas upp vid avgrnsare i lika
+*                 stora delar som tolkas via den gemensamma trdpoolen
+*                 (vector_parallel), varefter delvektorerna sls samman i
+*                 ordning.
+*
+*                 Programmet mste lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_PARSE_H_
+#define VECTOR_PARSE_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_PARSE_BLOCK_SIZE 1048576 /* Blockstorlek vid inlsning frn strm. */
+#define VECTOR_PARSE_MAX_TOKEN 128      /* Maximalt antal tecken per flyttal. */
+
+/* Externa funktioner: */
+int vector_parse(struct vector* self,
+                 FILE* istream);
+int vector_parse_buffer(struct vector* self,
+                        const char* buffer,
+                        const size_t size);
+int vector_parse_parallel(struct vector* self,
+                          const char* buffer,
+                          const size_t size,
+                          size_t num_threads);
+int vector_parse_file(struct vector* self,
+                      const char* path,
+                      const size_t num_threads);
+
+#endif /* VECTOR_PARSE_H_ */
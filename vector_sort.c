@@ -0,0 +1,615 @@
+/*******************************************************************************
+* vector_sort.c: Innehller funktioner fr sortering och binrskning av
+*                vektorer. Sorteringen sker p 8-, 16-, 32- eller 64-bitars
+*                osignerade nycklar, som genereras p plats i vektorns flt
+*                och omvandlas tillbaka efter sorteringen.
+*******************************************************************************/
+#include "vector_sort.h"
+#include "vector_parallel.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_SORT_INSERTION_LIMIT 64        /* Strsta storlek fr insttningssortering. */
+#define VECTOR_SORT_PARALLEL_THRESHOLD 1048576 /* Minsta storlek fr flertrdad sortering. */
+#define VECTOR_SORT_MAX_THREADS 16            /* Strsta antalet block vid flertrdad sortering. */
+
+/*******************************************************************************
+* vector_sort_task: Deluppgift vid flertrdad sortering, antingen sortering av
+*                   ett block eller sammanfogning av tv intilliggande block.
+*******************************************************************************/
+struct vector_sort_task
+{
+   void* data;       /* Pekare till blockets frsta nyckel. */
+   void* temp;       /* Pekare till motsvarande plats i temporr buffert. */
+   size_t size;      /* Antalet nycklar i blocket. */
+   size_t middle;    /* Antalet nycklar i frsta delen (vid sammanfogning). */
+   size_t width;     /* Nycklarnas storlek i byte (1, 2, 4 eller 8). */
+};
+
+/* Statiska funktioner: */
+static int vector_sort_keys(void* data,
+                            const size_t size,
+                            const size_t width);
+static void vector_sort_task_run(const size_t index,
+                                 void* context);
+static void vector_merge_task_run(const size_t index,
+                                  void* context);
+static int vector_sort_signed(void* data,
+                              const size_t size,
+                              const size_t width);
+static int vector_sort_floating(void* data,
+                                const size_t size,
+                                const size_t width);
+static size_t vector_sort_trim_nan(const void* data,
+                                   const size_t size,
+                                   const size_t width);
+static void vector_sort_reverse(void* data,
+                                const size_t size,
+                                const size_t width);
+
+/*******************************************************************************
+* VECTOR_SORT_DEFINE: Genererar radixsortering, insttningssortering samt
+*                     sammanfogning fr osignerade nycklar av angiven bredd,
+*                     samt omvandling av signerade heltal till nycklar genom
+*                     att teckenbiten inverteras.
+*                     - bits: Nycklarnas storlek i bitar (8, 16, 32 eller 64).
+*******************************************************************************/
+#define VECTOR_SORT_DEFINE(bits)                                                \
+static void vector_insertion_sort_u##bits(uint##bits##_t* data,                 \
+                                          const size_t size)                    \
+{                                                                               \
+   for (size_t i = 1; i < size; ++i)                                            \
+   {                                                                            \
+      const uint##bits##_t key = data[i];                                       \
+      size_t j = i;                                                             \
+      for (; j > 0 && data[j - 1] > key; --j) data[j] = data[j - 1];            \
+      data[j] = key;                                                            \
+   }                                                                            \
+}                                                                               \
+                                                                                \
+static void vector_radix_sort_u##bits(uint##bits##_t* data,                     \
+                                      uint##bits##_t* temp,                     \
+                                      const size_t size)                        \
+{                                                                               \
+   enum { passes = bits / 8 };                                                  \
+   size_t counts[passes][256];                                                  \
+   uint##bits##_t* source = data;                                               \
+   uint##bits##_t* dest = temp;                                                 \
+                                                                                \
+   if (size <= VECTOR_SORT_INSERTION_LIMIT)                                     \
+   {                                                                            \
+      vector_insertion_sort_u##bits(data, size);                                \
+      return;                                                                   \
+   }                                                                            \
+                                                                                \
+   memset(counts, 0, sizeof(counts));                                           \
+   for (size_t i = 0; i < size; ++i)                                            \
+      for (size_t pass = 0; pass < passes; ++pass)                              \
+         counts[pass][(data[i] >> (pass * 8)) & 0xFF]++;                        \
+                                                                                \
+   for (size_t pass = 0; pass < passes; ++pass)                                 \
+   {                                                                            \
+      const size_t shift = pass * 8;                                            \
+      if (counts[pass][(data[0] >> shift) & 0xFF] == size) continue;            \
+                                                                                \
+      size_t offset = 0;                                                        \
+      for (size_t digit = 0; digit < 256; ++digit)                              \
+      {                                                                         \
+         const size_t count = counts[pass][digit];                              \
+         counts[pass][digit] = offset;                                          \
+         offset += count;                                                       \
+      }                                                                         \
+                                                                                \
+      for (size_t i = 0; i < size; ++i)                                         \
+         dest[counts[pass][(source[i] >> shift) & 0xFF]++] = source[i];         \
+                                                                                \
+      uint##bits##_t* swap = source;                                            \
+      source = dest;                                                            \
+      dest = swap;                                                              \
+   }                                                                            \
+                                                                                \
+   if (source != data) memcpy(data, source, size * sizeof(*data));              \
+}                                                                               \
+                                                                                \
+static void vector_merge_u##bits(const uint##bits##_t* first,                   \
+                                 const size_t first_size,                       \
+                                 const uint##bits##_t* second,                  \
+                                 const size_t second_size,                      \
+                                 uint##bits##_t* dest)                          \
+{                                                                               \
+   size_t i = 0, j = 0, k = 0;                                                  \
+   while (i < first_size && j < second_size)                                    \
+      dest[k++] = second[j] < first[i] ? second[j++] : first[i++];              \
+   while (i < first_size) dest[k++] = first[i++];                               \
+   while (j < second_size) dest[k++] = second[j++];                             \
+}                                                                               \
+                                                                                \
+static void vector_flip_sign_u##bits(uint##bits##_t* data,                      \
+                                     const size_t size)                         \
+{                                                                               \
+   const uint##bits##_t sign = (uint##bits##_t)(1ULL << (bits - 1));           \
+   for (size_t i = 0; i < size; ++i) data[i] ^= sign;                           \
+}
+
+/*******************************************************************************
+* VECTOR_SORT_FLOAT_DEFINE: Genererar omvandling mellan flyttal och nycklar
+*                           av samma bredd, dr positiva tal fr teckenbiten
+*                           satt och negativa tal fr samtliga bitar
+*                           inverterade, samt flyttning av NaN sist i fltet.
+*                           Bitmnstren kopieras via memcpy, s att flyttal
+*                           aldrig lses via en heltalspekare.
+*                           - bits: Flyttalens storlek i bitar (32 eller 64).
+*                           - type: Flyttalens datatyp.
+*******************************************************************************/
+#define VECTOR_SORT_FLOAT_DEFINE(bits, type)                                    \
+static size_t vector_partition_nan_f##bits(type* data,                          \
+                                           const size_t size)                   \
+{                                                                               \
+   size_t count = 0;                                                            \
+   for (size_t i = 0; i < size; ++i)                                            \
+   {                                                                            \
+      if (data[i] == data[i])                                                   \
+      {                                                                         \
+         const type temp = data[count];                                         \
+         data[count++] = data[i];                                               \
+         data[i] = temp;                                                        \
+      }                                                                         \
+   }                                                                            \
+   return count;                                                                \
+}                                                                               \
+                                                                                \
+static void vector_float_encode_u##bits(void* data,                             \
+                                        const size_t size)                      \
+{                                                                               \
+   const uint##bits##_t sign = (uint##bits##_t)1 << (bits - 1);                 \
+   for (size_t i = 0; i < size; ++i)                                            \
+   {                                                                            \
+      const type value = ((const type*)data)[i];                               \
+      uint##bits##_t key;                                                       \
+      memcpy(&key, &value, sizeof(key));                                        \
+      ((uint##bits##_t*)data)[i] = (key & sign) ? ~key : key | sign;            \
+   }                                                                            \
+}                                                                               \
+                                                                                \
+static void vector_float_decode_u##bits(void* data,                             \
+                                        const size_t size)                      \
+{                                                                               \
+   const uint##bits##_t sign = (uint##bits##_t)1 << (bits - 1);                 \
+   for (size_t i = 0; i < size; ++i)                                            \
+   {                                                                            \
+      const uint##bits##_t key = ((const uint##bits##_t*)data)[i];              \
+      const uint##bits##_t pattern = (key & sign) ? key & ~sign : ~key;         \
+      type value;                                                               \
+      memcpy(&value, &pattern, sizeof(value));                                  \
+      ((type*)data)[i] = value;                                                 \
+   }                                                                            \
+}
+
+VECTOR_SORT_DEFINE(8)
+VECTOR_SORT_DEFINE(16)
+VECTOR_SORT_DEFINE(32)
+VECTOR_SORT_DEFINE(64)
+VECTOR_SORT_FLOAT_DEFINE(32, float)
+VECTOR_SORT_FLOAT_DEFINE(64, double)
+
+/*******************************************************************************
+* vector_sort: Sorterar angiven vektor i stigande ordning.
+*              - self: Pekare till vektorn.
+*******************************************************************************/
+int vector_sort(struct vector* self)
+{
+   const size_t width = self->ops->element_size;
+   if (self->type >= VECTOR_TYPE_NONE || (self->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (self->size < 2) return 0;
+   if (vector_unshare(self)) return 1;
+
+   switch (self->type)
+   {
+      case VECTOR_TYPE_INTEGER:
+      case VECTOR_TYPE_INT8:
+      case VECTOR_TYPE_INT16:
+      case VECTOR_TYPE_INT64:
+         return vector_sort_signed(self->data.raw, self->size, width);
+      case VECTOR_TYPE_DOUBLE:
+      case VECTOR_TYPE_FLOAT:
+         return vector_sort_floating(self->data.raw, self->size, width);
+      default:
+         return vector_sort_keys(self->data.raw, self->size, width);
+   }
+}
+
+/*******************************************************************************
+* vector_sort_descending: Sorterar angiven vektor i fallande ordning. NaN
+*                         placeras sist ven vid fallande ordning.
+*                         - self: Pekare till vektorn.
+*******************************************************************************/
+int vector_sort_descending(struct vector* self)
+{
+   if (vector_sort(self)) return 1;
+   size_t size = self->size;
+
+   if (self->type == VECTOR_TYPE_DOUBLE || self->type == VECTOR_TYPE_FLOAT)
+   {
+      size = vector_sort_trim_nan(self->data.raw, size, self->ops->element_size);
+   }
+
+   vector_sort_reverse(self->data.raw, size, self->ops->element_size);
+   return 0;
+}
+
+/*******************************************************************************
+* VECTOR_IS_SORTED_LOOP: Kontrollerar stigande ordning fr en given datatyp,
+*                        dr NaN godtas sist i flyttalsvektorer.
+*******************************************************************************/
+#define VECTOR_IS_SORTED_LOOP(member)                                           \
+{                                                                               \
+   for (size_t i = 1; i < self->size; ++i)                                      \
+   {                                                                            \
+      if (self->data.member[i] < self->data.member[i - 1]) return 0;            \
+      if (self->data.member[i - 1] != self->data.member[i - 1] &&               \
+          self->data.member[i] == self->data.member[i]) return 0;               \
+   }                                                                            \
+   return 1;                                                                    \
+}
+
+/*******************************************************************************
+* vector_is_sorted: Indikerar ifall angiven vektor r sorterad i stigande
+*                   ordning (NaN godtas enbart sist).
+*                   - self: Pekare till vektorn.
+*******************************************************************************/
+int vector_is_sorted(const struct vector* self)
+{
+   switch (self->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_IS_SORTED_LOOP(integer)
+      case VECTOR_TYPE_DOUBLE: VECTOR_IS_SORTED_LOOP(decimal)
+      case VECTOR_TYPE_UNSIGNED: VECTOR_IS_SORTED_LOOP(natural)
+      case VECTOR_TYPE_INT8: VECTOR_IS_SORTED_LOOP(int8)
+      case VECTOR_TYPE_INT16: VECTOR_IS_SORTED_LOOP(int16)
+      case VECTOR_TYPE_INT64: VECTOR_IS_SORTED_LOOP(int64)
+      case VECTOR_TYPE_UINT8: VECTOR_IS_SORTED_LOOP(uint8)
+      case VECTOR_TYPE_UINT16: VECTOR_IS_SORTED_LOOP(uint16)
+      case VECTOR_TYPE_UINT32: VECTOR_IS_SORTED_LOOP(uint32)
+      case VECTOR_TYPE_FLOAT: VECTOR_IS_SORTED_LOOP(single)
+      default: return 1;
+   }
+}
+
+/*******************************************************************************
+* VECTOR_BOUND_LOOP: Binrskning fr en given datatyp och jmfrelse.
+*                    - type   : Elementens datatyp.
+*                    - member : Motsvarande medlem i union vector_ptr.
+*                    - compare: Villkor fr att ska vidare t hger, uttryckt
+*                               via elementet x och skt vrde key.
+*******************************************************************************/
+#define VECTOR_BOUND_LOOP(type, member, compare)                                \
+{                                                                               \
+   const type key = *(const type*)value;                                        \
+   size_t first = 0, count = self->size;                                        \
+   while (count)                                                                \
+   {                                                                            \
+      const size_t step = count / 2;                                            \
+      const type x = self->data.member[first + step];                           \
+      if (compare)                                                              \
+      {                                                                         \
+         first += step + 1;                                                     \
+         count -= step + 1;                                                     \
+      }                                                                         \
+      else                                                                      \
+      {                                                                         \
+         count = step;                                                          \
+      }                                                                         \
+   }                                                                            \
+   return first;                                                                \
+}
+
+/*******************************************************************************
+* vector_lower_bound: Returnerar index fr frsta elementet som inte r
+*                     mindre n angivet vrde i en stigande sorterad vektor,
+*                     eller vektorns storlek om inget sdant element finns.
+*                     - self : Pekare till den sorterade vektorn.
+*                     - value: Pekare till skt vrde av vektorns datatyp.
+*******************************************************************************/
+size_t vector_lower_bound(const struct vector* self,
+                          const void* value)
+{
+   switch (self->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_BOUND_LOOP(int, integer, x < key)
+      case VECTOR_TYPE_DOUBLE: VECTOR_BOUND_LOOP(double, decimal, x < key || (x == x && key != key))
+      case VECTOR_TYPE_UNSIGNED: VECTOR_BOUND_LOOP(size_t, natural, x < key)
+      case VECTOR_TYPE_INT8: VECTOR_BOUND_LOOP(int8_t, int8, x < key)
+      case VECTOR_TYPE_INT16: VECTOR_BOUND_LOOP(int16_t, int16, x < key)
+      case VECTOR_TYPE_INT64: VECTOR_BOUND_LOOP(int64_t, int64, x < key)
+      case VECTOR_TYPE_UINT8: VECTOR_BOUND_LOOP(uint8_t, uint8, x < key)
+      case VECTOR_TYPE_UINT16: VECTOR_BOUND_LOOP(uint16_t, uint16, x < key)
+      case VECTOR_TYPE_UINT32: VECTOR_BOUND_LOOP(uint32_t, uint32, x < key)
+      case VECTOR_TYPE_FLOAT: VECTOR_BOUND_LOOP(float, single, x < key || (x == x && key != key))
+      default: return self->size;
+   }
+}
+
+/*******************************************************************************
+* vector_upper_bound: Returnerar index fr frsta elementet som r strre n
+*                     angivet vrde i en stigande sorterad vektor, eller
+*                     vektorns storlek om inget sdant element finns.
+*                     - self : Pekare till den sorterade vektorn.
+*                     - value: Pekare till skt vrde av vektorns datatyp.
+*******************************************************************************/
+size_t vector_upper_bound(const struct vector* self,
+                          const void* value)
+{
+   switch (self->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_BOUND_LOOP(int, integer, !(key < x))
+      case VECTOR_TYPE_DOUBLE: VECTOR_BOUND_LOOP(double, decimal, !(key < x) && (x == x || key != key))
+      case VECTOR_TYPE_UNSIGNED: VECTOR_BOUND_LOOP(size_t, natural, !(key < x))
+      case VECTOR_TYPE_INT8: VECTOR_BOUND_LOOP(int8_t, int8, !(key < x))
+      case VECTOR_TYPE_INT16: VECTOR_BOUND_LOOP(int16_t, int16, !(key < x))
+      case VECTOR_TYPE_INT64: VECTOR_BOUND_LOOP(int64_t, int64, !(key < x))
+      case VECTOR_TYPE_UINT8: VECTOR_BOUND_LOOP(uint8_t, uint8, !(key < x))
+      case VECTOR_TYPE_UINT16: VECTOR_BOUND_LOOP(uint16_t, uint16, !(key < x))
+      case VECTOR_TYPE_UINT32: VECTOR_BOUND_LOOP(uint32_t, uint32, !(key < x))
+      case VECTOR_TYPE_FLOAT: VECTOR_BOUND_LOOP(float, single, !(key < x) && (x == x || key != key))
+      default: return self->size;
+   }
+}
+
+/*******************************************************************************
+* vector_sort_keys: Sorterar osignerade nycklar av angiven bredd. Stora flt
+*                   delas upp i block som sorteras parallellt via
+*                   trdpoolen i vector_parallel, varefter blocken
+*                   sammanfogas parvis tills ett block terstr.
+*                   - data : Pekare till nycklarna.
+*                   - size : Antalet nycklar.
+*                   - width: Nycklarnas storlek i byte (1, 2, 4 eller 8).
+*******************************************************************************/
+static int vector_sort_keys(void* data,
+                            const size_t size,
+                            const size_t width)
+{
+   struct vector_sort_task tasks[VECTOR_SORT_MAX_THREADS];
+   size_t num_tasks = 1;
+
+   if (size <= VECTOR_SORT_INSERTION_LIMIT)
+   {
+      switch (width)
+      {
+         case sizeof(uint8_t): vector_insertion_sort_u8((uint8_t*)data, size); break;
+         case sizeof(uint16_t): vector_insertion_sort_u16((uint16_t*)data, size); break;
+         case sizeof(uint32_t): vector_insertion_sort_u32((uint32_t*)data, size); break;
+         default: vector_insertion_sort_u64((uint64_t*)data, size); break;
+      }
+      return 0;
+   }
+
+   if (size >= VECTOR_SORT_PARALLEL_THRESHOLD)
+   {
+      num_tasks = vector_parallel_threads();
+      if (num_tasks > VECTOR_SORT_MAX_THREADS) num_tasks = VECTOR_SORT_MAX_THREADS;
+   }
+
+   char* temp = (char*)malloc(size * width);
+   if (!temp) return 1;
+
+   for (size_t i = 0; i < num_tasks; ++i)
+   {
+      const size_t first = size * i / num_tasks;
+      tasks[i].data = (char*)data + first * width;
+      tasks[i].temp = temp + first * width;
+      tasks[i].size = size * (i + 1) / num_tasks - first;
+      tasks[i].middle = 0;
+      tasks[i].width = width;
+   }
+
+   vector_parallel_for(num_tasks, &vector_sort_task_run, tasks);
+
+   /* Sammanfogar intilliggande block parvis, vxelvis mellan flten: */
+   while (num_tasks > 1)
+   {
+      size_t num_merged = 0;
+
+      for (size_t i = 0; i < num_tasks; i += 2, ++num_merged)
+      {
+         struct vector_sort_task merged = tasks[i];
+         merged.middle = merged.size;
+         if (i + 1 < num_tasks) merged.size += tasks[i + 1].size;
+         tasks[num_merged] = merged;
+      }
+
+      num_tasks = num_merged;
+      vector_parallel_for(num_tasks, &vector_merge_task_run, tasks);
+
+      for (size_t i = 0; i < num_tasks; ++i)
+      {
+         void* swap = tasks[i].data;
+         tasks[i].data = tasks[i].temp;
+         tasks[i].temp = swap;
+      }
+   }
+
+   if (tasks[0].data != data) memcpy(data, tasks[0].data, size * width);
+   free(temp);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sort_task_run: Radixsorterar ett block (deluppgift i trdpoolen).
+*                       - index  : Blockets index.
+*                       - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_sort_task_run(const size_t index,
+                                 void* context)
+{
+   struct vector_sort_task* task = (struct vector_sort_task*)context + index;
+
+   switch (task->width)
+   {
+      case sizeof(uint8_t):
+         vector_radix_sort_u8((uint8_t*)task->data, (uint8_t*)task->temp, task->size);
+         break;
+      case sizeof(uint16_t):
+         vector_radix_sort_u16((uint16_t*)task->data, (uint16_t*)task->temp, task->size);
+         break;
+      case sizeof(uint32_t):
+         vector_radix_sort_u32((uint32_t*)task->data, (uint32_t*)task->temp, task->size);
+         break;
+      default:
+         vector_radix_sort_u64((uint64_t*)task->data, (uint64_t*)task->temp, task->size);
+         break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_merge_task_run: Sammanfogar blockets tv sorterade delar till
+*                        motsvarande plats i det andra fltet (deluppgift i
+*                        trdpoolen).
+*                        - index  : Blockets index.
+*                        - context: Pekare till arrayen med deluppgifter.
+*******************************************************************************/
+static void vector_merge_task_run(const size_t index,
+                                  void* context)
+{
+   struct vector_sort_task* task = (struct vector_sort_task*)context + index;
+   const size_t rest = task->size - task->middle;
+
+   switch (task->width)
+   {
+      case sizeof(uint8_t):
+      {
+         const uint8_t* data = (const uint8_t*)task->data;
+         vector_merge_u8(data, task->middle, data + task->middle, rest, (uint8_t*)task->temp);
+         break;
+      }
+      case sizeof(uint16_t):
+      {
+         const uint16_t* data = (const uint16_t*)task->data;
+         vector_merge_u16(data, task->middle, data + task->middle, rest, (uint16_t*)task->temp);
+         break;
+      }
+      case sizeof(uint32_t):
+      {
+         const uint32_t* data = (const uint32_t*)task->data;
+         vector_merge_u32(data, task->middle, data + task->middle, rest, (uint32_t*)task->temp);
+         break;
+      }
+      default:
+      {
+         const uint64_t* data = (const uint64_t*)task->data;
+         vector_merge_u64(data, task->middle, data + task->middle, rest, (uint64_t*)task->temp);
+         break;
+      }
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_sort_signed: Sorterar signerade heltal av angiven bredd genom att
+*                     teckenbiten inverteras fre och efter sorteringen.
+*******************************************************************************/
+static int vector_sort_signed(void* data,
+                              const size_t size,
+                              const size_t width)
+{
+   int status = 0;
+
+   switch (width)
+   {
+      case sizeof(uint8_t):
+         vector_flip_sign_u8((uint8_t*)data, size);
+         status = vector_sort_keys(data, size, width);
+         vector_flip_sign_u8((uint8_t*)data, size);
+         break;
+      case sizeof(uint16_t):
+         vector_flip_sign_u16((uint16_t*)data, size);
+         status = vector_sort_keys(data, size, width);
+         vector_flip_sign_u16((uint16_t*)data, size);
+         break;
+      case sizeof(uint32_t):
+         vector_flip_sign_u32((uint32_t*)data, size);
+         status = vector_sort_keys(data, size, width);
+         vector_flip_sign_u32((uint32_t*)data, size);
+         break;
+      default:
+         vector_flip_sign_u64((uint64_t*)data, size);
+         status = vector_sort_keys(data, size, width);
+         vector_flip_sign_u64((uint64_t*)data, size);
+         break;
+   }
+   return status;
+}
+
+/*******************************************************************************
+* vector_sort_floating: Sorterar flyttal av angiven bredd (4 eller 8 byte),
+*                       dr NaN frst flyttas sist i fltet och vriga tal
+*                       sorteras som nycklar.
+*******************************************************************************/
+static int vector_sort_floating(void* data,
+                                const size_t size,
+                                const size_t width)
+{
+   int status = 0;
+
+   if (width == sizeof(float))
+   {
+      const size_t count = vector_partition_nan_f32((float*)data, size);
+      vector_float_encode_u32(data, count);
+      status = vector_sort_keys(data, count, width);
+      vector_float_decode_u32(data, count);
+   }
+   else
+   {
+      const size_t count = vector_partition_nan_f64((double*)data, size);
+      vector_float_encode_u64(data, count);
+      status = vector_sort_keys(data, count, width);
+      vector_float_decode_u64(data, count);
+   }
+   return status;
+}
+
+/*******************************************************************************
+* vector_sort_trim_nan: Returnerar antalet element i ett sorterat flyttalsflt
+*                       av angiven bredd, exklusive NaN sist i fltet.
+*******************************************************************************/
+static size_t vector_sort_trim_nan(const void* data,
+                                   const size_t size,
+                                   const size_t width)
+{
+   size_t count = size;
+
+   if (width == sizeof(float))
+   {
+      const float* x = (const float*)data;
+      while (count && x[count - 1] != x[count - 1]) count--;
+   }
+   else
+   {
+      const double* x = (const double*)data;
+      while (count && x[count - 1] != x[count - 1]) count--;
+   }
+   return count;
+}
+
+/*******************************************************************************
+* vector_sort_reverse: Vnder ordningen p elementen i ett flt.
+*******************************************************************************/
+static void vector_sort_reverse(void* data,
+                                const size_t size,
+                                const size_t width)
+{
+   char* first = (char*)data;
+   char* last = first + (size ? size - 1 : 0) * width;
+   char temp[sizeof(uint64_t)];
+
+   while (first < last)
+   {
+      memcpy(temp, first, width);
+      memcpy(first, last, width);
+      memcpy(last, temp, width);
+      first += width;
+      last -= width;
+   }
+   return;
+}
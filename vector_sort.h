@@ -0,0 +1,27 @@
+/*******************************************************************************
+* vector_sort.h: Sortering och binrskning fr vektorer. Samtliga datatyper
+*                sorteras via LSD-radixsortering p osignerade nycklar:
+*                signerade heltal fr teckenbiten inverterad och flyttal fr
+*                sina bitar omvandlade s att nycklarnas ordning motsvarar
+*                talens ordning. NaN placeras alltid sist, oavsett riktning.
+*                Stora vektorer delas upp mellan flera trdar, vars sorterade
+*                delar drefter sammanfogas parvis.
+*
+*                Programmet mste lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_SORT_H_
+#define VECTOR_SORT_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/* Externa funktioner: */
+int vector_sort(struct vector* self);
+int vector_sort_descending(struct vector* self);
+int vector_is_sorted(const struct vector* self);
+size_t vector_lower_bound(const struct vector* self,
+                          const void* value);
+size_t vector_upper_bound(const struct vector* self,
+                          const void* value);
+
+#endif /* VECTOR_SORT_H_ */
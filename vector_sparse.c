@@ -0,0 +1,560 @@
+/*******************************************************************************
+* vector_sparse.c: Innehller funktioner fr glesa vektorer. Berkningarna
+*                  genereras fr samtliga datatyper via makron och vljs via
+*                  en tabell indexerad med datatypen. Heltalsberkningar sker
+*                  med modulr aritmetik, likt vector_kernels.
+*******************************************************************************/
+#include "vector_sparse.h"
+#include "vector_sort.h"
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_SPARSE_BLOCK_SIZE 8           /* Antalet element som testas t gngen vid omvandling. */
+#define VECTOR_SPARSE_DEFAULT_THRESHOLD 0.1  /* Frvald trskel fr element om 8 byte (brytpunkt fr skalrprodukt). */
+
+/*******************************************************************************
+* vector_sparse_table: Funktionspekare till berkningar fr en given datatyp.
+*******************************************************************************/
+struct vector_sparse_table
+{
+   size_t (*count)(const void* data, const size_t n);
+   void (*gather)(const void* data, const size_t n, size_t* indices, void* values);
+   void (*scatter)(void* dense, const size_t* indices, const void* values, const size_t n);
+   void (*dot)(const size_t* indices, const void* values, const size_t n,
+               const void* dense, void* result);
+   void (*axpy)(void* dense, const void* alpha, const size_t* indices,
+                const void* values, const size_t n);
+   size_t (*add)(size_t* indices, void* values,
+                 const size_t* first_indices, const void* first_values, const size_t first_size,
+                 const size_t* second_indices, const void* second_values, const size_t second_size);
+};
+
+/*******************************************************************************
+* VECTOR_SPARSE_DEFINE: Genererar samtliga berkningar fr en given datatyp.
+*                       Omvandling frn tt vektor testar ett block i taget,
+*                       s att block som enbart bestr av nollor hoppas ver,
+*                       medan vriga block komprimeras utan hopp genom att
+*                       varje element skrivs och utdatapositionen enbart
+*                       flyttas fram fr nollskilda element. Skalrprodukten
+*                       summeras i fyra oberoende delsummor.
+*                       - name: Namnsuffix fr datatypen.
+*                       - type: Elementens datatyp.
+*                       - wrap: Datatyp fr aritmetik (se vector_kernels.c).
+*******************************************************************************/
+#define VECTOR_SPARSE_DEFINE(name, type, wrap)                                  \
+static size_t vector_sparse_count_##name(const void* data,                      \
+                                         const size_t n)                        \
+{                                                                               \
+   const type* x = (const type*)data;                                           \
+   size_t count = 0;                                                            \
+   for (size_t i = 0; i < n; ++i) count += x[i] != 0;                           \
+   return count;                                                                \
+}                                                                               \
+                                                                                \
+static void vector_sparse_gather_##name(const void* data,                       \
+                                        const size_t n,                         \
+                                        size_t* indices,                        \
+                                        void* values)                           \
+{                                                                               \
+   const type* x = (const type*)data;                                           \
+   type* v = (type*)values;                                                     \
+   size_t k = 0;                                                                \
+   for (size_t i = 0; i < n; i += VECTOR_SPARSE_BLOCK_SIZE)                     \
+   {                                                                            \
+      const size_t end = i + VECTOR_SPARSE_BLOCK_SIZE < n ?                     \
+                         i + VECTOR_SPARSE_BLOCK_SIZE : n;                      \
+      int any = 0;                                                              \
+      for (size_t j = i; j < end; ++j) any |= x[j] != 0;                        \
+      if (!any) continue;                                                       \
+      for (size_t j = i; j < end; ++j)                                          \
+      {                                                                         \
+         indices[k] = j;                                                        \
+         v[k] = x[j];                                                           \
+         k += x[j] != 0;                                                        \
+      }                                                                         \
+   }                                                                            \
+}                                                                               \
+                                                                                \
+static void vector_sparse_scatter_##name(void* dense,                           \
+                                         const size_t* indices,                 \
+                                         const void* values,                    \
+                                         const size_t n)                        \
+{                                                                               \
+   type* y = (type*)dense;                                                      \
+   const type* v = (const type*)values;                                         \
+   for (size_t k = 0; k < n; ++k) y[indices[k]] = v[k];                         \
+}                                                                               \
+                                                                                \
+static void vector_sparse_dot_##name(const size_t* indices,                     \
+                                     const void* values,                        \
+                                     const size_t n,                            \
+                                     const void* dense,                         \
+                                     void* result)                              \
+{                                                                               \
+   const type* v = (const type*)values;                                         \
+   const type* y = (const type*)dense;                                          \
+   wrap acc[4] = { 0 };                                                         \
+   size_t k = 0;                                                                \
+   for (; k + 4 <= n; k += 4)                                                   \
+      for (size_t j = 0; j < 4; ++j)                                            \
+         acc[j] += (wrap)v[k + j] * (wrap)y[indices[k + j]];                    \
+   for (; k < n; ++k) acc[0] += (wrap)v[k] * (wrap)y[indices[k]];               \
+   *(type*)result = (type)((acc[0] + acc[1]) + (acc[2] + acc[3]));              \
+}                                                                               \
+                                                                                \
+static void vector_sparse_axpy_##name(void* dense,                              \
+                                      const void* alpha,                        \
+                                      const size_t* indices,                    \
+                                      const void* values,                       \
+                                      const size_t n)                           \
+{                                                                               \
+   type* y = (type*)dense;                                                      \
+   const type* v = (const type*)values;                                         \
+   const wrap a = (wrap)*(const type*)alpha;                                    \
+   for (size_t k = 0; k < n; ++k)                                               \
+      y[indices[k]] = (type)((wrap)y[indices[k]] + a * (wrap)v[k]);             \
+}                                                                               \
+                                                                                \
+static size_t vector_sparse_add_##name(size_t* indices,                         \
+                                       void* values,                            \
+                                       const size_t* first_indices,             \
+                                       const void* first_values,                \
+                                       const size_t first_size,                 \
+                                       const size_t* second_indices,            \
+                                       const void* second_values,               \
+                                       const size_t second_size)                \
+{                                                                               \
+   const type* a = (const type*)first_values;                                   \
+   const type* b = (const type*)second_values;                                  \
+   type* c = (type*)values;                                                     \
+   size_t i = 0, j = 0, k = 0;                                                  \
+   while (i < first_size && j < second_size)                                    \
+   {                                                                            \
+      if (first_indices[i] < second_indices[j])                                 \
+      {                                                                         \
+         indices[k] = first_indices[i];                                         \
+         c[k++] = a[i++];                                                       \
+      }                                                                         \
+      else if (second_indices[j] < first_indices[i])                            \
+      {                                                                         \
+         indices[k] = second_indices[j];                                        \
+         c[k++] = b[j++];                                                       \
+      }                                                                         \
+      else                                                                      \
+      {                                                                         \
+         const type sum = (type)((wrap)a[i] + (wrap)b[j]);                      \
+         indices[k] = first_indices[i];                                         \
+         c[k] = sum;                                                            \
+         k += sum != 0;                                                         \
+         ++i;                                                                   \
+         ++j;                                                                   \
+      }                                                                         \
+   }                                                                            \
+   for (; i < first_size; ++i, ++k)                                             \
+   {                                                                            \
+      indices[k] = first_indices[i];                                            \
+      c[k] = a[i];                                                              \
+   }                                                                            \
+   for (; j < second_size; ++j, ++k)                                            \
+   {                                                                            \
+      indices[k] = second_indices[j];                                           \
+      c[k] = b[j];                                                              \
+   }                                                                            \
+   return k;                                                                    \
+}
+
+VECTOR_SPARSE_DEFINE(int, int, unsigned)
+VECTOR_SPARSE_DEFINE(double, double, double)
+VECTOR_SPARSE_DEFINE(unsigned, size_t, size_t)
+VECTOR_SPARSE_DEFINE(int8, int8_t, unsigned)
+VECTOR_SPARSE_DEFINE(int16, int16_t, unsigned)
+VECTOR_SPARSE_DEFINE(int64, int64_t, uint64_t)
+VECTOR_SPARSE_DEFINE(uint8, uint8_t, unsigned)
+VECTOR_SPARSE_DEFINE(uint16, uint16_t, unsigned)
+VECTOR_SPARSE_DEFINE(uint32, uint32_t, uint32_t)
+VECTOR_SPARSE_DEFINE(float, float, float)
+
+/* Tabellpost fr en given datatyp. */
+#define VECTOR_SPARSE_TABLE(name)                                               \
+{                                                                               \
+   &vector_sparse_count_##name, &vector_sparse_gather_##name,                   \
+   &vector_sparse_scatter_##name, &vector_sparse_dot_##name,                    \
+   &vector_sparse_axpy_##name, &vector_sparse_add_##name                        \
+}
+
+/* Statiska variabler: */
+static const struct vector_sparse_table vector_sparse_tables[] =
+{
+   VECTOR_SPARSE_TABLE(int),
+   VECTOR_SPARSE_TABLE(double),
+   VECTOR_SPARSE_TABLE(unsigned),
+   VECTOR_SPARSE_TABLE(int8),
+   VECTOR_SPARSE_TABLE(int16),
+   VECTOR_SPARSE_TABLE(int64),
+   VECTOR_SPARSE_TABLE(uint8),
+   VECTOR_SPARSE_TABLE(uint16),
+   VECTOR_SPARSE_TABLE(uint32),
+   VECTOR_SPARSE_TABLE(float)
+};
+
+static double vector_sparse_min_density = 0.0; /* Trskel angiven via vector_sparse_set_threshold. */
+
+/* Statiska funktioner: */
+static const struct vector_sparse_table* vector_sparse_get_table(const enum vector_type type);
+static int vector_sparse_output(struct vector_sparse* dest,
+                                struct vector* indices,
+                                struct vector* values,
+                                const enum vector_type type,
+                                const size_t capacity);
+
+/*******************************************************************************
+* vector_sparse_new: Initierar en tom gles vektor av angiven datatyp och
+*                    storlek, vilket motsvarar en tt vektor med enbart nollor.
+*                    - self: Pekare till den glesa vektorn.
+*                    - type: Elementens datatyp.
+*                    - size: Vektorns storlek inklusive nollor.
+*******************************************************************************/
+void vector_sparse_new(struct vector_sparse* self,
+                       const enum vector_type type,
+                       const size_t size)
+{
+   vector_new(&self->indices, VECTOR_TYPE_UNSIGNED);
+   vector_new(&self->values, type);
+   self->size = size;
+   return;
+}
+
+/*******************************************************************************
+* vector_sparse_delete: Frigr minnet fr angiven gles vektor, vars storlek
+*                       stts till noll. Datatypen behlls.
+*                       - self: Pekare till den glesa vektorn.
+*******************************************************************************/
+void vector_sparse_delete(struct vector_sparse* self)
+{
+   vector_delete(&self->indices);
+   vector_delete(&self->values);
+   self->size = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_sparse_from_dense: Lagrar de nollskilda elementen i angiven tt
+*                           vektor i en gles vektor, som antar den tta
+*                           vektorns datatyp och storlek. Eventuellt
+*                           tidigare innehll erstts. Antalet nollskilda
+*                           element rknas frst, s att minnet allokeras
+*                           en gng.
+*                           - self  : Pekare till den glesa vektorn.
+*                           - source: Pekare till den tta vektorn.
+*******************************************************************************/
+int vector_sparse_from_dense(struct vector_sparse* self,
+                             const struct vector* source)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(source->type);
+   struct vector indices, values;
+   if (!table) return 1;
+
+   const size_t count = table->count(source->data.raw, source->size);
+   if (vector_sparse_output(self, &indices, &values, source->type, count + 1)) return 1;
+   table->gather(source->data.raw, source->size, indices.data.natural, values.data.raw);
+   vector_resize(&indices, count);
+   vector_resize(&values, count);
+
+   vector_move(&self->indices, &indices);
+   vector_move(&self->values, &values);
+   self->size = source->size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_to_dense: Lagrar angiven gles vektor som tt vektor, dr
+*                         samtliga element som inte lagras stts till noll.
+*                         Eventuellt tidigare innehll erstts, men
+*                         mlvektorns allokerare behlls.
+*                         - dest: Pekare till den tta vektorn.
+*                         - self: Pekare till den glesa vektorn.
+*******************************************************************************/
+int vector_sparse_to_dense(struct vector* dest,
+                           const struct vector_sparse* self)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(self->values.type);
+   struct vector copy;
+   if (!table || (dest->flags & VECTOR_FLAG_READONLY)) return 1;
+
+   vector_new(&copy, self->values.type);
+   copy.allocator = dest->allocator;
+   if (vector_resize(&copy, self->size))
+   {
+      vector_delete(&copy);
+      return 1;
+   }
+
+   if (self->size) memset(copy.data.raw, 0, self->size * copy.ops->element_size);
+   table->scatter(copy.data.raw, self->indices.data.natural, self->values.data.raw,
+                  self->values.size);
+   vector_move(dest, &copy);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_copy: Kopierar innehllet frn en gles vektor till en annan
+*                     via vector_copy, vilket gr att flten delas i stllet
+*                     fr att kopieras om kllans flt kan delas.
+*                     - self  : Pekare till den glesa vektor som kopierat
+*                               innehll skall lagras i.
+*                     - source: Pekare till den glesa vektor som skall kopieras.
+*******************************************************************************/
+int vector_sparse_copy(struct vector_sparse* self,
+                       const struct vector_sparse* source)
+{
+   if (self == source) return 0;
+   if (vector_copy(&self->indices, &source->indices) ||
+       vector_copy(&self->values, &source->values))
+   {
+      return 1;
+   }
+   self->size = source->size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_push: Lgger till ett element i slutet av angiven gles vektor,
+*                     vilket anvnds fr att bygga upp vektorn i indexordning.
+*                     Indexet mste vara strre n tidigare lagrade index och
+*                     mindre n vektorns storlek. Nollor lagras inte.
+*                     - self : Pekare till den glesa vektorn.
+*                     - index: Elementets index.
+*                     - value: Pekare till elementets vrde, av vektorns datatyp.
+*******************************************************************************/
+int vector_sparse_push(struct vector_sparse* self,
+                       const size_t index,
+                       const void* value)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(self->values.type);
+   const size_t count = self->indices.size;
+   if (!table || index >= self->size) return 1;
+   if (count && index <= self->indices.data.natural[count - 1]) return 1;
+   if (!table->count(value, 1)) return 0;
+
+   if (vector_push(&self->indices, &index)) return 1;
+   if (vector_push(&self->values, value))
+   {
+      vector_pop(&self->indices);
+      return 1;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_get: Lser elementet p angivet index via binrskning bland
+*                    lagrade index, dr element som inte lagras lses som noll.
+*                    - self  : Pekare till den glesa vektorn.
+*                    - index : Elementets index.
+*                    - result: Pekare till variabel av vektorns datatyp dr
+*                              elementet skall lagras.
+*******************************************************************************/
+int vector_sparse_get(const struct vector_sparse* self,
+                      const size_t index,
+                      void* result)
+{
+   const size_t element_size = self->values.ops->element_size;
+   if (!element_size || !result || index >= self->size) return 1;
+
+   const size_t position = vector_lower_bound(&self->indices, &index);
+   if (position < self->indices.size && self->indices.data.natural[position] == index)
+   {
+      memcpy(result, vector_get(&self->values, position), element_size);
+   }
+   else
+   {
+      memset(result, 0, element_size);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_density: Returnerar andelen nollskilda element (0 - 1).
+*                        - self: Pekare till den glesa vektorn.
+*******************************************************************************/
+double vector_sparse_density(const struct vector_sparse* self)
+{
+   return self->size ? (double)self->values.size / (double)self->size : 0.0;
+}
+
+/*******************************************************************************
+* vector_sparse_dot: Berknar skalrprodukten av en gles och en tt vektor,
+*                    som mste ha samma datatyp och storlek. Enbart de
+*                    element i den tta vektorn vars index lagras lses.
+*                    - self  : Pekare till den glesa vektorn.
+*                    - dense : Pekare till den tta vektorn.
+*                    - result: Pekare till variabel av vektorernas datatyp dr
+*                              skalrprodukten skall lagras.
+*******************************************************************************/
+int vector_sparse_dot(const struct vector_sparse* self,
+                      const struct vector* dense,
+                      void* result)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(self->values.type);
+   if (!table || !result || dense->type != self->values.type || dense->size != self->size) return 1;
+   table->dot(self->indices.data.natural, self->values.data.raw, self->values.size,
+              dense->data.raw, result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_axpy: Berknar dense = alpha * x + dense, dr x r gles.
+*                     Enbart de element i den tta vektorn vars index lagras
+*                     i x ndras. Vektorerna mste ha samma datatyp och storlek.
+*                     - dense: Pekare till den tta vektorn som resultatet
+*                              lagras i.
+*                     - alpha: Pekare till skalren, som mste vara av samma
+*                              datatyp som vektorerna.
+*                     - x    : Pekare till den glesa vektorn.
+*******************************************************************************/
+int vector_sparse_axpy(struct vector* dense,
+                       const void* alpha,
+                       const struct vector_sparse* x)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(x->values.type);
+   if (!table || !alpha || dense->type != x->values.type || dense->size != x->size) return 1;
+   if ((dense->flags & VECTOR_FLAG_READONLY) || vector_unshare(dense)) return 1;
+   table->axpy(dense->data.raw, alpha, x->indices.data.natural, x->values.data.raw,
+               x->values.size);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_add: Berknar summan av tv glesa vektorer, som mste ha samma
+*                    datatyp och storlek, genom att deras index sammanfogas i
+*                    ordning. Element som tar ut varandra lagras inte.
+*                    Resultatet fr lagras i ngon av kllorna.
+*                    - dest  : Pekare till den glesa vektor dr summan lagras.
+*                    - first : Pekare till den frsta glesa vektorn.
+*                    - second: Pekare till den andra glesa vektorn.
+*******************************************************************************/
+int vector_sparse_add(struct vector_sparse* dest,
+                      const struct vector_sparse* first,
+                      const struct vector_sparse* second)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(first->values.type);
+   struct vector indices, values;
+   if (!table || second->values.type != first->values.type || second->size != first->size) return 1;
+
+   const size_t capacity = first->values.size + second->values.size;
+   if (vector_sparse_output(dest, &indices, &values, first->values.type, capacity)) return 1;
+
+   const size_t count = table->add(indices.data.natural, values.data.raw,
+                                   first->indices.data.natural, first->values.data.raw,
+                                   first->values.size,
+                                   second->indices.data.natural, second->values.data.raw,
+                                   second->values.size);
+   vector_resize(&indices, count);
+   vector_resize(&values, count);
+
+   vector_move(&dest->indices, &indices);
+   vector_move(&dest->values, &values);
+   dest->size = first->size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_sparse_count: Returnerar antalet nollskilda element i angiven tt
+*                      vektor.
+*                      - source: Pekare till den tta vektorn.
+*******************************************************************************/
+size_t vector_sparse_count(const struct vector* source)
+{
+   const struct vector_sparse_table* table = vector_sparse_get_table(source->type);
+   return table ? table->count(source->data.raw, source->size) : 0;
+}
+
+/*******************************************************************************
+* vector_sparse_threshold: Returnerar den hgsta tthet dr gles lagring r
+*                          att fredra fr angiven datatyp. Frvald trskel
+*                          r VECTOR_SPARSE_DEFAULT_THRESHOLD fr element om
+*                          8 byte och minskar i proportion till elementens
+*                          storlek, eftersom tta berkningar lser
+*                          proportionellt frre byte per element medan
+*                          kostnaden per lagrat element i gles form r
+*                          densamma (ett index samt ett slumpmssigt ls).
+*                          - type: Elementens datatyp.
+*******************************************************************************/
+double vector_sparse_threshold(const enum vector_type type)
+{
+   if (vector_sparse_min_density > 0.0) return vector_sparse_min_density;
+   return VECTOR_SPARSE_DEFAULT_THRESHOLD * (double)vector_ops(type)->element_size / 8.0;
+}
+
+/*******************************************************************************
+* vector_sparse_set_threshold: Anger ttheten under vilken gles lagring r att
+*                              fredra fr samtliga datatyper, se
+*                              vector_sparse_prefer.
+*                              - density: Trskel mellan 0 och 1 (0 medfr
+*                                         frvald trskel per datatyp).
+*******************************************************************************/
+void vector_sparse_set_threshold(const double density)
+{
+   vector_sparse_min_density = density > 0.0 ? density : 0.0;
+   return;
+}
+
+/*******************************************************************************
+* vector_sparse_prefer: Indikerar ifall angiven tt vektor br lagras glest,
+*                       vilket r fallet om andelen nollskilda element
+*                       understiger trskeln fr vektorns datatyp (se
+*                       vector_sparse_threshold). Tomma vektorer lagras ttt.
+*                       - source: Pekare till den tta vektorn.
+*******************************************************************************/
+int vector_sparse_prefer(const struct vector* source)
+{
+   if (!source->size || !vector_sparse_get_table(source->type)) return 0;
+   return (double)vector_sparse_count(source) <=
+          vector_sparse_threshold(source->type) * (double)source->size;
+}
+
+/*******************************************************************************
+* vector_sparse_get_table: Returnerar berkningarna fr angiven datatyp, eller
+*                          nullpekare om datatypen saknar berkningar.
+*                          - type: Elementens datatyp.
+*******************************************************************************/
+static const struct vector_sparse_table* vector_sparse_get_table(const enum vector_type type)
+{
+   return type < VECTOR_TYPE_NONE ? &vector_sparse_tables[type] : 0;
+}
+
+/*******************************************************************************
+* vector_sparse_output: Initierar temporra index- och vrdevektorer fr ett
+*                       resultat, med mlvektorns allokerare och plats fr
+*                       angivet antal element. Resultatet frflyttas drefter
+*                       till mlvektorn, vilket gr att mlvektorn fr vara
+*                       en av kllorna.
+*                       - dest    : Pekare till den glesa mlvektorn.
+*                       - indices : Pekare till den temporra indexvektorn.
+*                       - values  : Pekare till den temporra vrdevektorn.
+*                       - type    : Vrdenas datatyp.
+*                       - capacity: Strsta antalet element i resultatet.
+*******************************************************************************/
+static int vector_sparse_output(struct vector_sparse* dest,
+                                struct vector* indices,
+                                struct vector* values,
+                                const enum vector_type type,
+                                const size_t capacity)
+{
+   if ((dest->indices.flags & VECTOR_FLAG_READONLY) || (dest->values.flags & VECTOR_FLAG_READONLY))
+   {
+      return 1;
+   }
+
+   vector_new(indices, VECTOR_TYPE_UNSIGNED);
+   vector_new(values, type);
+   indices->allocator = dest->indices.allocator;
+   values->allocator = dest->values.allocator;
+
+   if (vector_resize(indices, capacity) || vector_resize(values, capacity))
+   {
+      vector_delete(indices);
+      vector_delete(values);
+      return 1;
+   }
+   return 0;
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* vector_sparse.h: Gles representation av vektorer dr de flesta element r
+*                  noll. Enbart nollskilda element lagras, i form av en
+*                  sorterad indexvektor (VECTOR_TYPE_UNSIGNED) samt en
+*                  vrdevektor av valfri datatyp, dr vrde k hr till index
+*                  k. Minnestgng och berkningar blir drmed proportionella
+*                  mot antalet nollskilda element i stllet fr vektorns
+*                  storlek.
+*
+*                  Flyttal rknas som noll om de jmfrs lika med noll,
+*                  vilket innebr att -0.0 inte lagras, medan NaN lagras.
+*
+*                  Gles lagring lnar sig enbart under en viss tthet
+*                  (andelen nollskilda element), eftersom varje lagrat
+*                  element kostar ett index samt ett slumpmssigt minnesls
+*                  i den tta vektorn, medan tta berkningar lser minnet
+*                  sekventiellt med SIMD-instruktioner. Trskeln kan
+*                  hmtas via vector_sparse_threshold och ndras via
+*                  vector_sparse_set_threshold, och vector_sparse_prefer
+*                  indikerar ifall en given tt vektor br lagras glest.
+*******************************************************************************/
+#ifndef VECTOR_SPARSE_H_
+#define VECTOR_SPARSE_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_sparse: Gles vektor, bestende av index och vrden fr nollskilda
+*                element samt vektorns logiska storlek. Indexen r strikt
+*                vxande och mindre n storleken.
+*******************************************************************************/
+struct vector_sparse
+{
+   struct vector indices; /* Index fr nollskilda element (VECTOR_TYPE_UNSIGNED). */
+   struct vector values;  /* Nollskilda elements vrden. */
+   size_t size;           /* Vektorns storlek inklusive nollor. */
+};
+
+/* Externa funktioner: */
+void vector_sparse_new(struct vector_sparse* self,
+                       const enum vector_type type,
+                       const size_t size);
+void vector_sparse_delete(struct vector_sparse* self);
+int vector_sparse_from_dense(struct vector_sparse* self,
+                             const struct vector* source);
+int vector_sparse_to_dense(struct vector* dest,
+                           const struct vector_sparse* self);
+int vector_sparse_copy(struct vector_sparse* self,
+                       const struct vector_sparse* source);
+int vector_sparse_push(struct vector_sparse* self,
+                       const size_t index,
+                       const void* value);
+int vector_sparse_get(const struct vector_sparse* self,
+                      const size_t index,
+                      void* result);
+double vector_sparse_density(const struct vector_sparse* self);
+int vector_sparse_dot(const struct vector_sparse* self,
+                      const struct vector* dense,
+                      void* result);
+int vector_sparse_axpy(struct vector* dense,
+                       const void* alpha,
+                       const struct vector_sparse* x);
+int vector_sparse_add(struct vector_sparse* dest,
+                      const struct vector_sparse* first,
+                      const struct vector_sparse* second);
+size_t vector_sparse_count(const struct vector* source);
+double vector_sparse_threshold(const enum vector_type type);
+void vector_sparse_set_threshold(const double density);
+int vector_sparse_prefer(const struct vector* source);
+
+#endif /* VECTOR_SPARSE_H_ */
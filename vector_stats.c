@@ -0,0 +1,232 @@
+/*******************************************************************************
+* vector_stats.c: Innehller funktioner fr insamling och sammanstllning av
+*                 statistik fr vektorer.
+*******************************************************************************/
+#ifdef VECTOR_STATS
+#define _POSIX_C_SOURCE 200809L
+#endif
+#include "vector_stats.h"
+#include <string.h>
+
+#ifdef VECTOR_STATS
+#include <pthread.h>
+
+/* Statiska funktioner: */
+static void vector_stats_init(void);
+static void vector_stats_retire(void* arg);
+
+/* Statiska variabler: */
+static pthread_once_t vector_stats_once = PTHREAD_ONCE_INIT;      /* Initiering av nyckeln. */
+static pthread_key_t vector_stats_key;                            /* Nyckel fr trdavslut. */
+static pthread_mutex_t vector_stats_mutex = PTHREAD_MUTEX_INITIALIZER; /* Skyddar listan. */
+static struct vector_stats_thread* vector_stats_threads = 0;      /* Registrerade trdar. */
+static size_t vector_stats_retired[VECTOR_STATS_COUNTERS];        /* Avslutade trdars rknare. */
+static atomic_size_t vector_stats_live = 0;                       /* Levande antal byte. */
+static atomic_size_t vector_stats_peak = 0;                       /* Hgsta antal byte. */
+
+/* Rknare fr anropande trd (nullpekare innan trden registrerats). */
+_Thread_local struct vector_stats_thread* vector_stats_current = 0;
+#endif /* VECTOR_STATS */
+
+/*******************************************************************************
+* vector_stats_enabled: Indikerar ifall statistik har aktiverats vid
+*                       kompilering.
+*******************************************************************************/
+int vector_stats_enabled(void)
+{
+#ifdef VECTOR_STATS
+   return 1;
+#else
+   return 0;
+#endif
+}
+
+/*******************************************************************************
+* vector_stats_snapshot: Summerar rknarna fr samtliga trdar, inklusive
+*                        avslutade trdar. Rknare som kas under tiden av
+*                        andra trdar kan komma med eller inte.
+*                        - self: Pekare till strukten dr statistiken lagras.
+*******************************************************************************/
+void vector_stats_snapshot(struct vector_stats* self)
+{
+   memset(self, 0, sizeof(*self));
+#ifdef VECTOR_STATS
+   size_t counters[VECTOR_STATS_COUNTERS];
+
+   pthread_mutex_lock(&vector_stats_mutex);
+   memcpy(counters, vector_stats_retired, sizeof(counters));
+
+   for (const struct vector_stats_thread* i = vector_stats_threads; i; i = i->next)
+   {
+      for (size_t j = 0; j < VECTOR_STATS_COUNTERS; ++j)
+      {
+         counters[j] += atomic_load_explicit(&i->counters[j], memory_order_relaxed);
+      }
+   }
+   pthread_mutex_unlock(&vector_stats_mutex);
+
+   self->allocations = counters[VECTOR_STATS_ALLOCATIONS];
+   self->reallocations = counters[VECTOR_STATS_REALLOCATIONS];
+   self->deallocations = counters[VECTOR_STATS_DEALLOCATIONS];
+   self->bytes_allocated = counters[VECTOR_STATS_BYTES_ALLOCATED];
+   self->bytes_copied = counters[VECTOR_STATS_BYTES_COPIED];
+   self->live_bytes = atomic_load(&vector_stats_live);
+   self->peak_bytes = atomic_load(&vector_stats_peak);
+
+   for (size_t i = 0; i <= VECTOR_TYPE_NONE; ++i)
+   {
+      self->push[i] = counters[VECTOR_STATS_PUSH + i];
+      self->pop[i] = counters[VECTOR_STATS_POP + i];
+      self->get[i] = counters[VECTOR_STATS_GET + i];
+      self->set[i] = counters[VECTOR_STATS_SET + i];
+   }
+#endif /* VECTOR_STATS */
+   return;
+}
+
+/*******************************************************************************
+* vector_stats_reset: Nollstller samtliga rknare, frutom antalet levande
+*                     byte, som ju fortfarande r allokerade. Hgsta antalet
+*                     byte stts till antalet levande byte. Nollstllningen
+*                     r exakt enbart om inga andra trdar anvnder vektorer
+*                     under tiden.
+*******************************************************************************/
+void vector_stats_reset(void)
+{
+#ifdef VECTOR_STATS
+   pthread_mutex_lock(&vector_stats_mutex);
+   memset(vector_stats_retired, 0, sizeof(vector_stats_retired));
+
+   for (struct vector_stats_thread* i = vector_stats_threads; i; i = i->next)
+   {
+      for (size_t j = 0; j < VECTOR_STATS_COUNTERS; ++j)
+      {
+         atomic_store_explicit(&i->counters[j], 0, memory_order_relaxed);
+      }
+   }
+   pthread_mutex_unlock(&vector_stats_mutex);
+   atomic_store(&vector_stats_peak, atomic_load(&vector_stats_live));
+#endif /* VECTOR_STATS */
+   return;
+}
+
+/*******************************************************************************
+* vector_stats_dump: Skriver ut aktuell statistik i lsbar form.
+*                    - ostream: Pekare till angiven utstrm.
+*******************************************************************************/
+void vector_stats_dump(FILE* ostream)
+{
+   static const char* type_names[] =
+   {
+      "int", "double", "unsigned", "int8", "int16", "int64",
+      "uint8", "uint16", "uint32", "float", "none"
+   };
+   struct vector_stats stats;
+   vector_stats_snapshot(&stats);
+
+   if (!vector_stats_enabled())
+   {
+      fprintf(ostream, "Vector statistics are disabled (compile with -DVECTOR_STATS).\n");
+      return;
+   }
+
+   fprintf(ostream, "allocations     : %zu\n", stats.allocations);
+   fprintf(ostream, "reallocations   : %zu\n", stats.reallocations);
+   fprintf(ostream, "deallocations   : %zu\n", stats.deallocations);
+   fprintf(ostream, "bytes allocated : %zu\n", stats.bytes_allocated);
+   fprintf(ostream, "bytes copied    : %zu\n", stats.bytes_copied);
+   fprintf(ostream, "live bytes      : %zu\n", stats.live_bytes);
+   fprintf(ostream, "peak bytes      : %zu\n", stats.peak_bytes);
+   fprintf(ostream, "%-10s %14s %14s %14s %14s\n", "type", "push", "pop", "get", "set");
+
+   for (size_t i = 0; i <= VECTOR_TYPE_NONE; ++i)
+   {
+      fprintf(ostream, "%-10s %14zu %14zu %14zu %14zu\n", type_names[i],
+              stats.push[i], stats.pop[i], stats.get[i], stats.set[i]);
+   }
+   return;
+}
+
+#ifdef VECTOR_STATS
+
+/*******************************************************************************
+* vector_stats_register: Allokerar och registrerar rknare fr anropande
+*                        trd. Rknarna verfrs till gemensamma rknare nr
+*                        trden avslutas. Returnerar nullpekare ifall minnet
+*                        inte rcker, varvid trden inte rknas.
+*******************************************************************************/
+struct vector_stats_thread* vector_stats_register(void)
+{
+   struct vector_stats_thread* self =
+      (struct vector_stats_thread*)calloc(1, sizeof(struct vector_stats_thread));
+   if (!self) return 0;
+
+   pthread_once(&vector_stats_once, &vector_stats_init);
+   pthread_setspecific(vector_stats_key, self);
+
+   pthread_mutex_lock(&vector_stats_mutex);
+   self->next = vector_stats_threads;
+   vector_stats_threads = self;
+   pthread_mutex_unlock(&vector_stats_mutex);
+
+   vector_stats_current = self;
+   return self;
+}
+
+/*******************************************************************************
+* vector_stats_track: Uppdaterar levande samt hgsta antalet allokerade byte.
+*                     - allocated: Antalet byte som allokerats.
+*                     - freed    : Antalet byte som frigjorts.
+*******************************************************************************/
+void vector_stats_track(const size_t allocated,
+                        const size_t freed)
+{
+   const size_t live = atomic_fetch_add(&vector_stats_live, allocated - freed) + allocated - freed;
+   size_t peak = atomic_load_explicit(&vector_stats_peak, memory_order_relaxed);
+
+   while (live > peak && live < (size_t)1 << (sizeof(size_t) * 8 - 1) &&
+          !atomic_compare_exchange_weak(&vector_stats_peak, &peak, live));
+   return;
+}
+
+/*******************************************************************************
+* vector_stats_init: Skapar nyckeln vars destruktor anropas nr en
+*                    registrerad trd avslutas.
+*******************************************************************************/
+static void vector_stats_init(void)
+{
+   pthread_key_create(&vector_stats_key, &vector_stats_retire);
+   return;
+}
+
+/*******************************************************************************
+* vector_stats_retire: verfr rknarna fr en avslutad trd till de
+*                      gemensamma rknarna och frigr trdens rknare.
+*                      - arg: Pekare till trdens rknare.
+*******************************************************************************/
+static void vector_stats_retire(void* arg)
+{
+   struct vector_stats_thread* self = (struct vector_stats_thread*)arg;
+   pthread_mutex_lock(&vector_stats_mutex);
+
+   for (struct vector_stats_thread** i = &vector_stats_threads; *i; i = &(*i)->next)
+   {
+      if (*i == self)
+      {
+         *i = self->next;
+         break;
+      }
+   }
+
+   for (size_t j = 0; j < VECTOR_STATS_COUNTERS; ++j)
+   {
+      vector_stats_retired[j] += atomic_load_explicit(&self->counters[j], memory_order_relaxed);
+   }
+
+   pthread_mutex_unlock(&vector_stats_mutex);
+   vector_stats_current = 0;
+   free(self);
+   return;
+}
+
+#endif /* VECTOR_STATS */
@@ -0,0 +1,146 @@
+/*******************************************************************************
+* vector_stats.h: Valbar statistik ver vektorernas minnesanvndning och
+*                 anrop. Statistiken aktiveras vid kompilering via makrot
+*                 VECTOR_STATS (kompileringsflaggan -DVECTOR_STATS), som mste
+*                 anges fr samtliga kllfiler. Utan makrot expanderar
+*                 rknarmakrona till ingenting, vilket innebr att funktionerna
+*                 i vector.c inte pverkas, medan statistikfunktionerna
+*                 returnerar nollstlld statistik.
+*
+*                 Rknarna fr anrop och kopierade byte lagras per trd och
+*                 summeras frst nr statistiken hmtas. Rknare fr trdar
+*                 som avslutats bevaras. Levande samt hgsta antalet
+*                 allokerade byte delas mellan trdarna och uppdateras
+*                 atomrt, men enbart vid allokering och frigring.
+*
+*                 Anrop rknas fr de generella funktionerna vector_push,
+*                 vector_pop, vector_get samt vector_set, men inte fr de
+*                 typade inline-funktionerna (exempelvis vector_int_get).
+*
+*                 Med statistik aktiverad mste programmet lnkas med
+*                 flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_STATS_H_
+#define VECTOR_STATS_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_stats: Sammanstlld statistik fr samtliga trdar. Anrop rknas per
+*               datatyp, indexerat via enumerationen vector_type.
+*******************************************************************************/
+struct vector_stats
+{
+   size_t allocations;                    /* Antalet allokeringar. */
+   size_t reallocations;                  /* Antalet omallokeringar. */
+   size_t deallocations;                  /* Antalet frigringar. */
+   size_t bytes_allocated;                /* Totalt antal allokerade byte. */
+   size_t bytes_copied;                   /* Antalet byte kopierade mellan flt. */
+   size_t live_bytes;                     /* Antalet allokerade byte just nu. */
+   size_t peak_bytes;                     /* Hgsta antalet allokerade byte. */
+   size_t push[VECTOR_TYPE_NONE + 1];     /* Antalet anrop av vector_push. */
+   size_t pop[VECTOR_TYPE_NONE + 1];      /* Antalet anrop av vector_pop. */
+   size_t get[VECTOR_TYPE_NONE + 1];      /* Antalet anrop av vector_get. */
+   size_t set[VECTOR_TYPE_NONE + 1];      /* Antalet anrop av vector_set. */
+};
+
+/* Externa funktioner: */
+int vector_stats_enabled(void);
+void vector_stats_snapshot(struct vector_stats* self);
+void vector_stats_reset(void);
+void vector_stats_dump(FILE* ostream);
+
+#ifdef VECTOR_STATS
+
+/* Inkluderingsdirektiv: */
+#include <stdatomic.h>
+
+/*******************************************************************************
+* vector_stats_counter: Index fr rknare som lagras per trd.
+*******************************************************************************/
+enum vector_stats_counter
+{
+   VECTOR_STATS_ALLOCATIONS,                                     /* Allokeringar. */
+   VECTOR_STATS_REALLOCATIONS,                                   /* Omallokeringar. */
+   VECTOR_STATS_DEALLOCATIONS,                                   /* Frigringar. */
+   VECTOR_STATS_BYTES_ALLOCATED,                                 /* Allokerade byte. */
+   VECTOR_STATS_BYTES_COPIED,                                    /* Kopierade byte. */
+   VECTOR_STATS_PUSH,                                            /* vector_push per datatyp. */
+   VECTOR_STATS_POP = VECTOR_STATS_PUSH + VECTOR_TYPE_NONE + 1,  /* vector_pop per datatyp. */
+   VECTOR_STATS_GET = VECTOR_STATS_POP + VECTOR_TYPE_NONE + 1,   /* vector_get per datatyp. */
+   VECTOR_STATS_SET = VECTOR_STATS_GET + VECTOR_TYPE_NONE + 1,   /* vector_set per datatyp. */
+   VECTOR_STATS_COUNTERS = VECTOR_STATS_SET + VECTOR_TYPE_NONE + 1 /* Antalet rknare. */
+};
+
+/*******************************************************************************
+* vector_stats_thread: Rknare fr en trd. Enbart gande trd skriver till
+*                      rknarna, vilket gr att kningar kan ske utan atomra
+*                      ls-modifiera-skriv-instruktioner.
+*******************************************************************************/
+struct vector_stats_thread
+{
+   atomic_size_t counters[VECTOR_STATS_COUNTERS]; /* Trdens rknare. */
+   struct vector_stats_thread* next;              /* Nsta registrerade trd. */
+};
+
+/* Externa variabler: */
+extern _Thread_local struct vector_stats_thread* vector_stats_current;
+
+/* Externa funktioner: */
+struct vector_stats_thread* vector_stats_register(void);
+void vector_stats_track(const size_t allocated,
+                        const size_t freed);
+
+/*******************************************************************************
+* vector_stats_add: kar angiven rknare fr anropande trd. Trden
+*                   registreras vid frsta anropet.
+*                   - counter: Rknaren som skall kas.
+*                   - amount : Vrdet som rknaren skall kas med.
+*******************************************************************************/
+static inline void vector_stats_add(const enum vector_stats_counter counter,
+                                    const size_t amount)
+{
+   struct vector_stats_thread* self = vector_stats_current;
+   if (!self && !(self = vector_stats_register())) return;
+   atomic_store_explicit(&self->counters[counter],
+      atomic_load_explicit(&self->counters[counter], memory_order_relaxed) + amount,
+      memory_order_relaxed);
+   return;
+}
+
+/* Rknar ett anrop av angiven operation (PUSH, POP, GET eller SET). */
+#define VECTOR_STATS_CALL(op, type) \
+   vector_stats_add((enum vector_stats_counter)(VECTOR_STATS_##op + (type)), 1)
+
+/* Rknar angivet antal byte som kopierats mellan flt. */
+#define VECTOR_STATS_COPY(bytes) vector_stats_add(VECTOR_STATS_BYTES_COPIED, (bytes))
+
+/* Rknar en allokering av angivet antal byte. */
+#define VECTOR_STATS_ALLOCATE(bytes) \
+   (vector_stats_add(VECTOR_STATS_ALLOCATIONS, 1), \
+    vector_stats_add(VECTOR_STATS_BYTES_ALLOCATED, (bytes)), \
+    vector_stats_track((bytes), 0))
+
+/* Rknar en omallokering frn old_bytes till new_bytes byte. */
+#define VECTOR_STATS_REALLOCATE(old_bytes, new_bytes) \
+   (vector_stats_add(VECTOR_STATS_REALLOCATIONS, 1), \
+    vector_stats_add(VECTOR_STATS_BYTES_ALLOCATED, (new_bytes)), \
+    vector_stats_track((new_bytes), (old_bytes)))
+
+/* Rknar en frigring av angivet antal byte. */
+#define VECTOR_STATS_DEALLOCATE(bytes) \
+   (vector_stats_add(VECTOR_STATS_DEALLOCATIONS, 1), \
+    vector_stats_track(0, (bytes)))
+
+#else
+
+#define VECTOR_STATS_CALL(op, type) ((void)0)
+#define VECTOR_STATS_COPY(bytes) ((void)0)
+#define VECTOR_STATS_ALLOCATE(bytes) ((void)0)
+#define VECTOR_STATS_REALLOCATE(old_bytes, new_bytes) ((void)0)
+#define VECTOR_STATS_DEALLOCATE(bytes) ((void)0)
+
+#endif /* VECTOR_STATS */
+
+#endif /* VECTOR_STATS_H_ */
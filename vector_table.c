@@ -0,0 +1,551 @@
+/*******************************************************************************
+* vector_table.c: Innehller funktioner fr kolumnorienterade tabeller.
+*                 Filtrering sker block fr block, dr varje villkor
+*                 berknas som en mask med en byte per rad via en enkel loop
+*                 som kompilatorn verstter till SIMD-instruktioner, i
+*                 samma stil som vector_expr. Masken packas sedan ihop till
+*                 radindex utan villkorliga hopp.
+*******************************************************************************/
+#include "vector_table.h"
+#include "vector_kernels.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Makrodefinitioner: */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_TABLE_X86 1 /* SIMD-versioner genereras fr x86-processorer. */
+#endif
+
+#define VECTOR_TABLE_BLOCK_SIZE 1024 /* Antalet rader per block vid filtrering. */
+
+/* Antalet element per varv fr angiven registerbredd i byte. */
+#define VECTOR_TABLE_LANES(bytes, type) ((bytes) ? 2 * (bytes) / sizeof(type) : 1)
+
+/*******************************************************************************
+* VECTOR_TABLE_LOOP: Utfr angiven sats fr index i frn 0 till size, dr
+*                    huvudloopen behandlar lanes element per varv. Den inre
+*                    loopen har konstant lngd, vilket gr att kompilatorn
+*                    verstter den till SIMD-instruktioner.
+*******************************************************************************/
+#define VECTOR_TABLE_LOOP(lanes, size, ...)                                     \
+do                                                                              \
+{                                                                               \
+   size_t first = 0;                                                            \
+   for (; first + (lanes) <= (size); first += (lanes))                          \
+   {                                                                            \
+      for (size_t lane = 0; lane < (lanes); ++lane)                             \
+      {                                                                         \
+         const size_t i = first + lane;                                         \
+         __VA_ARGS__;                                                           \
+      }                                                                         \
+   }                                                                            \
+   for (size_t i = first; i < (size); ++i) { __VA_ARGS__; }                     \
+} while (0)
+
+/*******************************************************************************
+* vector_table_kernels: Jmfrelser fr samtliga datatyper (indexerade via
+*                       vector_type) fr en given instruktionsuppsttning.
+*                       Varje jmfrelse nollstller maskens byte fr rader
+*                       dr villkoret inte r uppfyllt.
+*******************************************************************************/
+struct vector_table_kernels
+{
+   void (*compare[VECTOR_TYPE_NONE])(uint8_t* restrict mask, const void* restrict data,
+                                     const size_t size, const enum vector_table_op op,
+                                     const void* value);
+};
+
+/*******************************************************************************
+* VECTOR_TABLE_COMPARE: Genererar jmfrelser fr en given datatyp och
+*                       instruktionsuppsttning. Switchsatsen ligger utanfr
+*                       looparna, s att varje jmfrelse blir en egen loop.
+*                       - isa  : Namnsuffix fr instruktionsuppsttningen.
+*                       - attr : Attribut som anger mlarkitektur.
+*                       - bytes: SIMD-registrens bredd i byte (0 = skalr).
+*                       - name : Namnsuffix fr datatypen.
+*                       - type : Elementens datatyp.
+*******************************************************************************/
+#define VECTOR_TABLE_COMPARE(isa, attr, bytes, name, type)                      \
+static attr void vector_table_compare_##name##_##isa(uint8_t* restrict mask,    \
+                                                     const void* restrict data, \
+                                                     const size_t size,         \
+                                                     const enum vector_table_op op, \
+                                                     const void* value)         \
+{                                                                               \
+   enum { lanes = VECTOR_TABLE_LANES(bytes, type) };                            \
+   const type* x = (const type*)data;                                           \
+   const type v = *(const type*)value;                                          \
+   switch (op)                                                                  \
+   {                                                                            \
+      case VECTOR_TABLE_LT:                                                     \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] < v));        \
+         break;                                                                 \
+      case VECTOR_TABLE_LE:                                                     \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] <= v));       \
+         break;                                                                 \
+      case VECTOR_TABLE_GT:                                                     \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] > v));        \
+         break;                                                                 \
+      case VECTOR_TABLE_GE:                                                     \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] >= v));       \
+         break;                                                                 \
+      case VECTOR_TABLE_EQ:                                                     \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] == v));       \
+         break;                                                                 \
+      default:                                                                  \
+         VECTOR_TABLE_LOOP(lanes, size, mask[i] &= (uint8_t)(x[i] != v));       \
+         break;                                                                 \
+   }                                                                            \
+}
+
+/* Genererar jmfrelser fr samtliga datatyper fr en instruktionsuppsttning. */
+#define VECTOR_TABLE_DEFINE_ALL(isa, attr, bytes)                               \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, int, int)                                \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, double, double)                          \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, unsigned, size_t)                        \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, int8, int8_t)                            \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, int16, int16_t)                          \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, int64, int64_t)                          \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, uint8, uint8_t)                          \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, uint16, uint16_t)                        \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, uint32, uint32_t)                        \
+VECTOR_TABLE_COMPARE(isa, attr, bytes, float, float)
+
+/* Initierar jmfrelser fr samtliga datatyper (indexerade via vector_type). */
+#define VECTOR_TABLE_TABLE(isa)                                                 \
+{                                                                               \
+   {                                                                            \
+      &vector_table_compare_int_##isa, &vector_table_compare_double_##isa,      \
+      &vector_table_compare_unsigned_##isa, &vector_table_compare_int8_##isa,   \
+      &vector_table_compare_int16_##isa, &vector_table_compare_int64_##isa,     \
+      &vector_table_compare_uint8_##isa, &vector_table_compare_uint16_##isa,    \
+      &vector_table_compare_uint32_##isa, &vector_table_compare_float_##isa     \
+   }                                                                            \
+}
+
+/* Jmfrelser fr respektive instruktionsuppsttning: */
+VECTOR_TABLE_DEFINE_ALL(scalar, , 0)
+static const struct vector_table_kernels vector_table_scalar = VECTOR_TABLE_TABLE(scalar);
+
+#ifdef VECTOR_TABLE_X86
+VECTOR_TABLE_DEFINE_ALL(sse2, __attribute__((target("sse2"))), 16)
+VECTOR_TABLE_DEFINE_ALL(avx2, __attribute__((target("avx2"))), 32)
+VECTOR_TABLE_DEFINE_ALL(avx512, __attribute__((target("avx512f,avx512dq"))), 64)
+static const struct vector_table_kernels vector_table_sse2 = VECTOR_TABLE_TABLE(sse2);
+static const struct vector_table_kernels vector_table_avx2 = VECTOR_TABLE_TABLE(avx2);
+static const struct vector_table_kernels vector_table_avx512 = VECTOR_TABLE_TABLE(avx512);
+#endif /* VECTOR_TABLE_X86 */
+
+/* Statiska funktioner: */
+static const struct vector_table_kernels* vector_table_get(void);
+static int vector_table_grow(struct vector* self,
+                             const size_t min_capacity);
+static size_t vector_table_compact(size_t* restrict dest,
+                                   const uint8_t* restrict mask,
+                                   const size_t first,
+                                   const size_t size);
+static void vector_table_gather_data(void* dest,
+                                     const void* source,
+                                     const size_t element_size,
+                                     const size_t* indices,
+                                     const size_t count);
+
+/*******************************************************************************
+* vector_table_new: Initierar en ny tom tabell utan kolumner.
+*                   - self: Pekare till tabellen.
+*******************************************************************************/
+void vector_table_new(struct vector_table* self)
+{
+   self->num_columns = 0;
+   self->num_rows = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_table_delete: Raderar samtliga kolumner och nollstller tabellen.
+*                      - self: Pekare till tabellen.
+*******************************************************************************/
+void vector_table_delete(struct vector_table* self)
+{
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      vector_delete(&self->columns[i].data);
+   }
+   self->num_columns = 0;
+   self->num_rows = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_table_add_column: Lgger till en kolumn av angiven datatyp. Om
+*                          tabellen redan innehller rader fylls den nya
+*                          kolumnen med nollor. Kolumnnamnen mste vara unika.
+*                          - self: Pekare till tabellen.
+*                          - name: Kolumnens namn.
+*                          - type: Kolumnens datatyp.
+*******************************************************************************/
+int vector_table_add_column(struct vector_table* self,
+                            const char* name,
+                            const enum vector_type type)
+{
+   if (self->num_columns >= VECTOR_TABLE_MAX_COLUMNS || type >= VECTOR_TYPE_NONE) return 1;
+   if (strlen(name) >= VECTOR_TABLE_NAME_SIZE) return 1;
+   if (vector_table_find(self, name) != VECTOR_TABLE_INVALID) return 1;
+
+   struct vector_table_column* column = &self->columns[self->num_columns];
+   vector_new(&column->data, type);
+
+   if (vector_resize(&column->data, self->num_rows))
+   {
+      vector_delete(&column->data);
+      return 1;
+   }
+   memset(column->data.data.raw, 0, self->num_rows * column->data.ops->element_size);
+   strcpy(column->name, name);
+   self->num_columns++;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_find: Returnerar index till kolumnen med angivet namn, eller
+*                    VECTOR_TABLE_INVALID om kolumnen inte finns.
+*                    - self: Pekare till tabellen.
+*                    - name: Kolumnens namn.
+*******************************************************************************/
+size_t vector_table_find(const struct vector_table* self,
+                         const char* name)
+{
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      if (!strcmp(self->columns[i].name, name)) return i;
+   }
+   return VECTOR_TABLE_INVALID;
+}
+
+/*******************************************************************************
+* vector_table_column: Returnerar en pekare till vektorn som lagrar kolumnen
+*                      med angivet namn, eller nullpekare om kolumnen inte
+*                      finns. Vektorn fr enbart lsas, eftersom samtliga
+*                      kolumner mste ha lika mnga element.
+*                      - self: Pekare till tabellen.
+*                      - name: Kolumnens namn.
+*******************************************************************************/
+const struct vector* vector_table_column(const struct vector_table* self,
+                                         const char* name)
+{
+   const size_t index = vector_table_find(self, name);
+   return index != VECTOR_TABLE_INVALID ? &self->columns[index].data : 0;
+}
+
+/*******************************************************************************
+* vector_table_reserve: Reserverar minne fr angivet antal rader i samtliga
+*                       kolumner, s att rader kan lggas till utan
+*                       omallokering.
+*                       - self    : Pekare till tabellen.
+*                       - num_rows: Antalet rader som skall rymmas.
+*******************************************************************************/
+int vector_table_reserve(struct vector_table* self,
+                         const size_t num_rows)
+{
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      if (vector_reserve(&self->columns[i].data, num_rows)) return 1;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_append: Lgger till ett antal rader i tabellen. Elementen
+*                      anges kolumn fr kolumn, dr columns[i] pekar p
+*                      num_rows element av kolumn i:s datatyp. Minne fr
+*                      samtliga kolumner reserveras innan ngot element
+*                      kopieras, vilket gr att tabellen r ofrndrad om
+*                      minnet inte rcker.
+*                      - self    : Pekare till tabellen.
+*                      - columns : Pekare till elementen fr respektive kolumn.
+*                      - num_rows: Antalet rader som skall lggas till.
+*******************************************************************************/
+int vector_table_append(struct vector_table* self,
+                        const void* const* columns,
+                        const size_t num_rows)
+{
+   const size_t new_size = self->num_rows + num_rows;
+   if (new_size < self->num_rows) return 1;
+
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      if (vector_table_grow(&self->columns[i].data, new_size)) return 1;
+   }
+
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      vector_push_range(&self->columns[i].data, columns[i], num_rows);
+   }
+   self->num_rows = new_size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_clear: Tar bort samtliga rader men behller kolumnerna samt
+*                     deras allokerade minne.
+*                     - self: Pekare till tabellen.
+*******************************************************************************/
+void vector_table_clear(struct vector_table* self)
+{
+   for (size_t i = 0; i < self->num_columns; ++i)
+   {
+      vector_resize(&self->columns[i].data, 0);
+   }
+   self->num_rows = 0;
+   return;
+}
+
+/*******************************************************************************
+* vector_table_select: Filtrerar tabellens rader och lagrar index till de rader
+*                      dr samtliga villkor r uppfyllda i stigande ordning i
+*                      selektionsvektorn, som fr datatypen
+*                      VECTOR_TYPE_UNSIGNED. Enbart kolumner som ingr i ngot
+*                      villkor lses. Utan villkor vljs samtliga rader.
+*                      - self          : Pekare till tabellen.
+*                      - predicates    : Pekare till villkoren.
+*                      - num_predicates: Antalet villkor.
+*                      - selection     : Pekare till selektionsvektorn.
+*******************************************************************************/
+int vector_table_select(const struct vector_table* self,
+                        const struct vector_table_predicate* predicates,
+                        const size_t num_predicates,
+                        struct vector* selection)
+{
+   const struct vector* columns[VECTOR_TABLE_MAX_PREDICATES];
+   const struct vector_table_kernels* kernels = vector_table_get();
+   uint8_t mask[VECTOR_TABLE_BLOCK_SIZE];
+   struct vector result;
+
+   if (num_predicates > VECTOR_TABLE_MAX_PREDICATES || (selection->flags & VECTOR_FLAG_READONLY)) return 1;
+
+   for (size_t j = 0; j < num_predicates; ++j)
+   {
+      if (!(columns[j] = vector_table_column(self, predicates[j].column))) return 1;
+      if (predicates[j].op > VECTOR_TABLE_NE) return 1;
+   }
+
+   vector_new(&result, VECTOR_TYPE_UNSIGNED);
+   result.allocator = selection->allocator;
+
+   for (size_t first = 0; first < self->num_rows; first += VECTOR_TABLE_BLOCK_SIZE)
+   {
+      const size_t count = self->num_rows - first < VECTOR_TABLE_BLOCK_SIZE ?
+                           self->num_rows - first : VECTOR_TABLE_BLOCK_SIZE;
+
+      if (vector_table_grow(&result, result.size + count))
+      {
+         vector_delete(&result);
+         return 1;
+      }
+      memset(mask, 1, count);
+
+      for (size_t j = 0; j < num_predicates; ++j)
+      {
+         const struct vector* column = columns[j];
+         const char* data = (const char*)column->data.raw + first * column->ops->element_size;
+         kernels->compare[column->type](mask, data, count, predicates[j].op, predicates[j].value);
+      }
+      result.size += vector_table_compact(result.data.natural + result.size, mask, first, count);
+   }
+
+   vector_move(selection, &result);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_gather: Kopierar elementen i angiven kolumn fr de rader som
+*                      anges i selektionsvektorn till mlvektorn, vars
+*                      tidigare innehll raderas. Mlvektorn fr kolumnens
+*                      datatyp och behller sin allokerare.
+*                      - dest     : Pekare till mlvektorn.
+*                      - self     : Pekare till tabellen.
+*                      - column   : Kolumnens namn.
+*                      - selection: Pekare till radindex av typen
+*                                   VECTOR_TYPE_UNSIGNED (nullpekare = samtliga
+*                                   rader).
+*******************************************************************************/
+int vector_table_gather(struct vector* dest,
+                        const struct vector_table* self,
+                        const char* column,
+                        const struct vector* selection)
+{
+   const struct vector* source = vector_table_column(self, column);
+   struct vector copy;
+   size_t max_index = 0;
+
+   if (!source || (dest->flags & VECTOR_FLAG_READONLY)) return 1;
+   if (!selection) return vector_copy(dest, source);
+   if (selection->type != VECTOR_TYPE_UNSIGNED) return 1;
+
+   for (size_t i = 0; i < selection->size; ++i)
+   {
+      max_index = selection->data.natural[i] > max_index ? selection->data.natural[i] : max_index;
+   }
+   if (selection->size && max_index >= self->num_rows) return 1;
+
+   vector_new(&copy, source->type);
+   copy.allocator = dest->allocator;
+
+   if (selection->size && vector_resize(&copy, selection->size))
+   {
+      vector_delete(&copy);
+      return 1;
+   }
+   vector_table_gather_data(copy.data.raw, source->data.raw, source->ops->element_size,
+                            selection->data.natural, selection->size);
+   vector_move(dest, &copy);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_project: Skapar en ny tabell bestende av angivna kolumner fr
+*                       de rader som anges i selektionsvektorn. Mltabellens
+*                       tidigare innehll raderas och vid fel lmnas den tom.
+*                       - dest       : Pekare till mltabellen.
+*                       - source     : Pekare till tabellen som lses.
+*                       - selection  : Pekare till radindex av typen
+*                                      VECTOR_TYPE_UNSIGNED (nullpekare =
+*                                      samtliga rader).
+*                       - columns    : Namnen p kolumnerna som skall kopieras.
+*                       - num_columns: Antalet kolumner.
+*******************************************************************************/
+int vector_table_project(struct vector_table* dest,
+                         const struct vector_table* source,
+                         const struct vector* selection,
+                         const char* const* columns,
+                         const size_t num_columns)
+{
+   if (dest == source) return 1;
+   vector_table_delete(dest);
+
+   for (size_t i = 0; i < num_columns; ++i)
+   {
+      const struct vector* column = vector_table_column(source, columns[i]);
+
+      if (!column || vector_table_add_column(dest, columns[i], column->type) ||
+          vector_table_gather(&dest->columns[i].data, source, columns[i], selection))
+      {
+         vector_table_delete(dest);
+         return 1;
+      }
+   }
+   dest->num_rows = selection ? selection->size : source->num_rows;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_table_get: Returnerar jmfrelserna fr den instruktionsuppsttning
+*                   som valts i vector_kernels.
+*******************************************************************************/
+static const struct vector_table_kernels* vector_table_get(void)
+{
+#ifdef VECTOR_TABLE_X86
+   const enum vector_isa isa = vector_kernels_isa();
+   if (isa == VECTOR_ISA_AVX512) return &vector_table_avx512;
+   if (isa == VECTOR_ISA_AVX2) return &vector_table_avx2;
+   if (isa == VECTOR_ISA_SSE2) return &vector_table_sse2;
+#endif /* VECTOR_TABLE_X86 */
+   return &vector_table_scalar;
+}
+
+/*******************************************************************************
+* vector_table_grow: Skerstller att vektorn rymmer minst angivet antal
+*                    element, dr kapaciteten minst frdubblas vid
+*                    omallokering s att upprepade sm tillgg inte
+*                    kopierar om hela kolumnen varje gng.
+*                    - self        : Pekare till vektorn.
+*                    - min_capacity: Minsta antalet element som skall rymmas.
+*******************************************************************************/
+static int vector_table_grow(struct vector* self,
+                             const size_t min_capacity)
+{
+   const size_t capacity = vector_capacity(self);
+   if (min_capacity <= capacity) return 0;
+   return vector_reserve(self, min_capacity > 2 * capacity ? min_capacity : 2 * capacity);
+}
+
+/*******************************************************************************
+* vector_table_compact: Lagrar index till de rader i ett block vars byte i
+*                       masken r ettstlld och returnerar antalet index.
+*                       Masken lses tta byte i taget, dr helt nollstllda
+*                       ord hoppas ver. vriga index skrivs alltid men rknas
+*                       enbart om raden r vald, vilket undviker felgissade
+*                       hopp vid slumpmssiga urval. Mlet mste rymma size
+*                       index.
+*                       - dest : Pekare till platsen fr frsta indexet.
+*                       - mask : Pekare till blockets mask (0 eller 1 per rad).
+*                       - first: Index till blockets frsta rad.
+*                       - size : Antalet rader i blocket.
+*******************************************************************************/
+static size_t vector_table_compact(size_t* restrict dest,
+                                   const uint8_t* restrict mask,
+                                   const size_t first,
+                                   const size_t size)
+{
+   size_t count = 0, i = 0;
+
+   for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+   {
+      uint64_t word;
+      memcpy(&word, mask + i, sizeof(word));
+      if (!word) continue;
+
+      for (size_t j = i; j < i + sizeof(uint64_t); ++j)
+      {
+         dest[count] = first + j;
+         count += mask[j];
+      }
+   }
+   for (; i < size; ++i)
+   {
+      dest[count] = first + i;
+      count += mask[i];
+   }
+   return count;
+}
+
+/*******************************************************************************
+* vector_table_gather_data: Kopierar elementen p angivna index till en
+*                           sammanhngande buffert. Elementen kopieras med
+*                           konstant storlek, som i vector_view.
+*                           - dest        : Pekare till bufferten.
+*                           - source      : Pekare till kolumnens flt.
+*                           - element_size: Elementens storlek i byte.
+*                           - indices     : Pekare till radindex.
+*                           - count       : Antalet element som skall kopieras.
+*******************************************************************************/
+static void vector_table_gather_data(void* dest,
+                                     const void* source,
+                                     const size_t element_size,
+                                     const size_t* indices,
+                                     const size_t count)
+{
+   const char* data = (const char*)source;
+   char* target = (char*)dest;
+
+   if (element_size == sizeof(uint8_t))
+   {
+      for (size_t i = 0; i < count; ++i) target[i] = data[indices[i]];
+   }
+   else if (element_size == sizeof(uint16_t))
+   {
+      for (size_t i = 0; i < count; ++i)
+         memcpy(target + i * sizeof(uint16_t), data + indices[i] * sizeof(uint16_t), sizeof(uint16_t));
+   }
+   else if (element_size == sizeof(uint32_t))
+   {
+      for (size_t i = 0; i < count; ++i)
+         memcpy(target + i * sizeof(uint32_t), data + indices[i] * sizeof(uint32_t), sizeof(uint32_t));
+   }
+   else if (element_size == sizeof(uint64_t))
+   {
+      for (size_t i = 0; i < count; ++i)
+         memcpy(target + i * sizeof(uint64_t), data + indices[i] * sizeof(uint64_t), sizeof(uint64_t));
+   }
+   return;
+}
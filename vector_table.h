@@ -0,0 +1,115 @@
+/*******************************************************************************
+* vector_table.h: Kolumnorienterad tabell bestende av namngivna kolumner,
+*                 dr varje kolumn lagras som en vanlig vektor av valfri
+*                 datatyp och rad i motsvarar element i i samtliga kolumner.
+*                 Rader lggs till i omgngar, kolumn fr kolumn, vilket
+*                 erstter manuellt synkroniserade parallella vektorer.
+*
+*                 Filtrering sker i tv steg. Frst vljs rader via
+*                 vector_table_select, dr varje villkor enbart lser sin
+*                 egen kolumn blockvis med SIMD-instruktioner och resultatet
+*                 blir en selektionsvektor (radindex av typen
+*                 VECTOR_TYPE_UNSIGNED). Drefter hmtas enbart de kolumner
+*                 som behvs fr de valda raderna via vector_table_gather
+*                 eller vector_table_project:
+*
+*                 const struct vector_table_predicate where[] =
+*                 {
+*                    { "flags", VECTOR_TABLE_EQ, &one },
+*                    { "value", VECTOR_TABLE_GT, &limit }
+*                 };
+*                 const char* columns[] = { "id", "value" };
+*                 vector_table_select(&table, where, 2, &selection);
+*                 vector_table_project(&result, &table, &selection, columns, 2);
+*
+*                 En tabell fr inte kopieras via tilldelning, eftersom
+*                 kolumnerna kan lagra element direkt i vektorstrukturen.
+*******************************************************************************/
+#ifndef VECTOR_TABLE_H_
+#define VECTOR_TABLE_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_TABLE_MAX_COLUMNS 32        /* Strsta antalet kolumner i en tabell. */
+#define VECTOR_TABLE_NAME_SIZE 32          /* Strsta kolumnnamnets lngd inklusive nolltecken. */
+#define VECTOR_TABLE_MAX_PREDICATES 16     /* Strsta antalet villkor vid filtrering. */
+#define VECTOR_TABLE_INVALID ((size_t)-1)  /* Returneras av vector_table_find vid fel. */
+
+/*******************************************************************************
+* vector_table_op: Jmfrelser som kan anvndas som villkor vid filtrering,
+*                  dr kolumnens element jmfrs med ett konstant vrde.
+*******************************************************************************/
+enum vector_table_op
+{
+   VECTOR_TABLE_LT, /* x < vrde */
+   VECTOR_TABLE_LE, /* x <= vrde */
+   VECTOR_TABLE_GT, /* x > vrde */
+   VECTOR_TABLE_GE, /* x >= vrde */
+   VECTOR_TABLE_EQ, /* x == vrde */
+   VECTOR_TABLE_NE  /* x != vrde */
+};
+
+/*******************************************************************************
+* vector_table_predicate: Villkor vid filtrering. En rad vljs enbart om
+*                         samtliga angivna villkor r uppfyllda.
+*******************************************************************************/
+struct vector_table_predicate
+{
+   const char* column;      /* Namnet p kolumnen som jmfrs. */
+   enum vector_table_op op; /* Jmfrelse. */
+   const void* value;       /* Pekare till vrdet, av kolumnens datatyp. */
+};
+
+/*******************************************************************************
+* vector_table_column: Namngiven kolumn i en tabell.
+*******************************************************************************/
+struct vector_table_column
+{
+   char name[VECTOR_TABLE_NAME_SIZE]; /* Kolumnens namn. */
+   struct vector data;                /* Kolumnens element, ett per rad. */
+};
+
+/*******************************************************************************
+* vector_table: Tabell bestende av upp till VECTOR_TABLE_MAX_COLUMNS
+*               kolumner med lika mnga element.
+*******************************************************************************/
+struct vector_table
+{
+   size_t num_columns; /* Antalet kolumner. */
+   size_t num_rows;    /* Antalet rader. */
+   struct vector_table_column columns[VECTOR_TABLE_MAX_COLUMNS]; /* Tabellens kolumner. */
+};
+
+/* Externa funktioner: */
+void vector_table_new(struct vector_table* self);
+void vector_table_delete(struct vector_table* self);
+int vector_table_add_column(struct vector_table* self,
+                            const char* name,
+                            const enum vector_type type);
+size_t vector_table_find(const struct vector_table* self,
+                         const char* name);
+const struct vector* vector_table_column(const struct vector_table* self,
+                                         const char* name);
+int vector_table_reserve(struct vector_table* self,
+                         const size_t num_rows);
+int vector_table_append(struct vector_table* self,
+                        const void* const* columns,
+                        const size_t num_rows);
+void vector_table_clear(struct vector_table* self);
+int vector_table_select(const struct vector_table* self,
+                        const struct vector_table_predicate* predicates,
+                        const size_t num_predicates,
+                        struct vector* selection);
+int vector_table_gather(struct vector* dest,
+                        const struct vector_table* self,
+                        const char* column,
+                        const struct vector* selection);
+int vector_table_project(struct vector_table* dest,
+                         const struct vector_table* source,
+                         const struct vector* selection,
+                         const char* const* columns,
+                         const size_t num_columns);
+
+#endif /* VECTOR_TABLE_H_ */
@@ -0,0 +1,720 @@
+/*******************************************************************************
+* vector_view.c: Innehller funktioner fr vyer ver vektorer. Berkningar
+*                och sortering sker via befintliga funktioner fr vektorer:
+*                sammanhngande vyer (stride 1) behandlas som en vektor som
+*                pekar direkt in i fltet, medan vriga vyer samlas ihop
+*                blockvis i en buffert p stacken, vilket gr att
+*                SIMD-versionerna i vector_kernels kan anvndas ven d.
+*******************************************************************************/
+#include "vector_view.h"
+#include "vector_kernels.h"
+#include "vector_parallel.h"
+#include "vector_sort.h"
+#include <stdint.h>
+#include <string.h>
+
+/* Makrodefinitioner: */
+#define VECTOR_VIEW_BLOCK_SIZE 512 /* Antalet element per block fr vyer med stride. */
+
+/* Statiska funktioner: */
+static inline size_t vector_view_element_size(const struct vector_view* self);
+static inline size_t vector_view_block_size(const struct vector_view* self);
+static void vector_view_gather(void* dest,
+                               const struct vector_view* self,
+                               const size_t first,
+                               const size_t count);
+static void vector_view_scatter(struct vector_view* self,
+                                const void* source,
+                                const size_t first,
+                                const size_t count);
+static void vector_view_load(const struct vector_view* self,
+                             const size_t first,
+                             const size_t count,
+                             void* buffer,
+                             struct vector* block);
+static void vector_view_combine(const enum vector_type type,
+                                const enum vector_parallel_reduction reduction,
+                                void* result,
+                                const void* partial);
+static int vector_view_reduce(const struct vector_view* self,
+                              const enum vector_parallel_reduction reduction,
+                              void* result);
+static int vector_view_apply(struct vector_view* self,
+                             const struct vector_view* other,
+                             const void* operand,
+                             int (*op)(struct vector* self,
+                                       const struct vector* other,
+                                       const void* operand));
+static int vector_view_add_block(struct vector* self,
+                                 const struct vector* other,
+                                 const void* operand);
+static int vector_view_mul_block(struct vector* self,
+                                 const struct vector* other,
+                                 const void* operand);
+static int vector_view_scale_block(struct vector* self,
+                                   const struct vector* other,
+                                   const void* operand);
+static int vector_view_axpy_block(struct vector* self,
+                                  const struct vector* other,
+                                  const void* operand);
+static int vector_view_sort_with(struct vector_view* self,
+                                 int (*sort)(struct vector* self));
+
+/*******************************************************************************
+* vector_view_new: Initierar en vy ver samtliga element i angiven vektor.
+*                  Vyn r skrivskyddad om vektorn r skrivskyddad eller om
+*                  vektorns flt kan delas med andra vektorer.
+*                  - self  : Pekare till vyn.
+*                  - source: Pekare till vektorn.
+*******************************************************************************/
+void vector_view_new(struct vector_view* self,
+                     const struct vector* source)
+{
+   self->data = source->data.raw;
+   self->size = source->size;
+   self->stride = 1;
+   self->type = source->type;
+   self->flags = source->flags & VECTOR_FLAG_READONLY;
+   if (source->flags & VECTOR_FLAG_SHARED) self->flags |= VECTOR_FLAG_READONLY;
+   return;
+}
+
+/*******************************************************************************
+* vector_view_slice: Initierar en vy ver ett delomrde av en annan vy, med
+*                    start p angivet index och angivet steg mellan
+*                    elementen. Steget 1 ger ett sammanhngande delomrde,
+*                    medan exempelvis steget 2 ger vartannat element.
+*                    - self  : Pekare till den nya vyn.
+*                    - source: Pekare till vyn som delomrdet tas ur.
+*                    - first : Index i kllan till vyns frsta element.
+*                    - size  : Antalet element i den nya vyn.
+*                    - step  : Steg mellan elementen i kllan (minst 1).
+*******************************************************************************/
+int vector_view_slice(struct vector_view* self,
+                      const struct vector_view* source,
+                      const size_t first,
+                      const size_t size,
+                      const size_t step)
+{
+   if (!step || step > SIZE_MAX / source->stride || first > source->size) return 1;
+   if (size && (first == source->size || (size - 1) > (source->size - 1 - first) / step)) return 1;
+
+   self->data = (char*)source->data + first * source->stride * vector_view_element_size(source);
+   self->size = size;
+   self->stride = source->stride * step;
+   self->type = source->type;
+   self->flags = source->flags;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_split: Initierar en vy ver en av num_parts lika stora delar av
+*                    en annan vy, exempelvis fr att dela upp en vektor mellan
+*                    trdar. Delarnas storlek skiljer sig som mest med ett
+*                    element och tillsammans omfattar de hela kllan.
+*                    - self     : Pekare till den nya vyn.
+*                    - source   : Pekare till vyn som skall delas upp.
+*                    - num_parts: Antalet delar.
+*                    - part     : Index till delen som vyn skall omfatta.
+*******************************************************************************/
+int vector_view_split(struct vector_view* self,
+                      const struct vector_view* source,
+                      const size_t num_parts,
+                      const size_t part)
+{
+   if (!num_parts || part >= num_parts) return 1;
+   const size_t base = source->size / num_parts;
+   const size_t remainder = source->size % num_parts;
+   const size_t first = part * base + (part < remainder ? part : remainder);
+   return vector_view_slice(self, source, first, base + (part < remainder ? 1 : 0), 1);
+}
+
+/*******************************************************************************
+* vector_view_get: Returnerar pekare till elementet p angivet index i vyn,
+*                  eller nullpekare om index r ogiltigt.
+*                  - self : Pekare till vyn.
+*                  - index: Index till elementet.
+*******************************************************************************/
+const void* vector_view_get(const struct vector_view* self,
+                            const size_t index)
+{
+   if (index >= self->size) return 0;
+   return (const char*)self->data + index * self->stride * vector_view_element_size(self);
+}
+
+/*******************************************************************************
+* vector_view_copy: Kopierar elementen i angiven vy till en vektor, som d
+*                   blir sammanhngande. Eventuellt tidigare innehll raderas
+*                   ur mlvektorn, som dock behller sin allokerare. Vyn fr
+*                   referera till mlvektorn.
+*                   - dest  : Pekare till mlvektorn.
+*                   - source: Pekare till vyn som skall kopieras.
+*******************************************************************************/
+int vector_view_copy(struct vector* dest,
+                     const struct vector_view* source)
+{
+   struct vector copy;
+   if (dest->flags & VECTOR_FLAG_READONLY) return 1;
+   vector_new(&copy, source->type);
+   copy.allocator = dest->allocator;
+
+   if (source->size && vector_resize(&copy, source->size))
+   {
+      vector_delete(&copy);
+      return 1;
+   }
+   vector_view_gather(copy.data.raw, source, 0, source->size);
+   vector_move(dest, &copy);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_print: Skriver ut samtliga element i vyn p var sin rad p
+*                    samma format som vector_print.
+*                    - self   : Pekare till vyn.
+*                    - ostream: Pekare till angiven utstrm (nullpekare
+*                               medfr stdout).
+*******************************************************************************/
+void vector_view_print(const struct vector_view* self,
+                       FILE* ostream)
+{
+   const struct vector_ops* ops = vector_ops(self->type);
+   if (!self->size || !ops->print) return;
+   if (!ostream) ostream = stdout;
+   fprintf(ostream, "--------------------------------------------------------------------------------\n");
+
+   if (self->stride == 1)
+   {
+      ops->print(ostream, self->data, self->size);
+   }
+   else
+   {
+      for (size_t i = 0; i < self->size; ++i)
+      {
+         ops->print(ostream, vector_view_get(self, i), 1);
+      }
+   }
+
+   fprintf(ostream, "--------------------------------------------------------------------------------\n\n");
+   return;
+}
+
+/*******************************************************************************
+* vector_view_sum: Berknar summan av samtliga element i vyn.
+*                  - self  : Pekare till vyn.
+*                  - result: Pekare till variabel av vyns datatyp dr summan
+*                            skall lagras.
+*******************************************************************************/
+int vector_view_sum(const struct vector_view* self,
+                    void* result)
+{
+   return vector_view_reduce(self, VECTOR_PARALLEL_SUM, result);
+}
+
+/*******************************************************************************
+* vector_view_min: Tar fram det minsta elementet i vyn.
+*                  - self  : Pekare till vyn (fr inte vara tom).
+*                  - result: Pekare till variabel av vyns datatyp dr minsta
+*                            elementet skall lagras.
+*******************************************************************************/
+int vector_view_min(const struct vector_view* self,
+                    void* result)
+{
+   return vector_view_reduce(self, VECTOR_PARALLEL_MIN, result);
+}
+
+/*******************************************************************************
+* vector_view_max: Tar fram det strsta elementet i vyn.
+*                  - self  : Pekare till vyn (fr inte vara tom).
+*                  - result: Pekare till variabel av vyns datatyp dr strsta
+*                            elementet skall lagras.
+*******************************************************************************/
+int vector_view_max(const struct vector_view* self,
+                    void* result)
+{
+   return vector_view_reduce(self, VECTOR_PARALLEL_MAX, result);
+}
+
+/*******************************************************************************
+* vector_view_mean: Berknar medelvrdet av elementen i vyn, dr blockens
+*                   medelvrden viktas med antalet element.
+*                   - self  : Pekare till vyn (fr inte vara tom).
+*                   - result: Pekare till variabel dr medelvrdet skall
+*                             lagras.
+*******************************************************************************/
+int vector_view_mean(const struct vector_view* self,
+                     double* result)
+{
+   uint64_t buffer[VECTOR_VIEW_BLOCK_SIZE];
+   const size_t block_size = vector_view_block_size(self);
+   struct vector block;
+   double sum = 0.0;
+
+   if (!self->size || !result) return 1;
+
+   for (size_t first = 0; first < self->size; first += block_size)
+   {
+      const size_t count = self->size - first < block_size ? self->size - first : block_size;
+      double mean;
+      vector_view_load(self, first, count, buffer, &block);
+      if (vector_mean(&block, &mean)) return 1;
+      sum += mean * (double)count;
+   }
+   *result = sum / (double)self->size;
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_dot: Berknar skalrprodukten av tv vyer, som mste ha samma
+*                  datatyp och storlek.
+*                  - self  : Pekare till frsta vyn.
+*                  - other : Pekare till andra vyn.
+*                  - result: Pekare till variabel av vyernas datatyp dr
+*                            skalrprodukten skall lagras.
+*******************************************************************************/
+int vector_view_dot(const struct vector_view* self,
+                    const struct vector_view* other,
+                    void* result)
+{
+   uint64_t buffer[VECTOR_VIEW_BLOCK_SIZE];
+   uint64_t other_buffer[VECTOR_VIEW_BLOCK_SIZE];
+   const size_t block_size = self->stride == 1 && other->stride == 1 ?
+      self->size : VECTOR_VIEW_BLOCK_SIZE;
+   struct vector block, other_block;
+   union vector_small partial;
+
+   if (self->type != other->type || self->size != other->size || !result) return 1;
+   if (self->type >= VECTOR_TYPE_NONE) return 1;
+   memset(result, 0, vector_view_element_size(self));
+
+   for (size_t first = 0; first < self->size; first += block_size)
+   {
+      const size_t count = self->size - first < block_size ? self->size - first : block_size;
+      vector_view_load(self, first, count, buffer, &block);
+      vector_view_load(other, first, count, other_buffer, &other_block);
+      if (vector_dot(&block, &other_block, &partial)) return 1;
+      vector_view_combine(self->type, VECTOR_PARALLEL_SUM, result, &partial);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_add: Adderar elementen i en vy till motsvarande element i en
+*                  annan vy. Vyerna mste ha samma datatyp och storlek.
+*                  - self : Pekare till vyn som resultatet lagras i.
+*                  - other: Pekare till vyn vars element skall adderas.
+*******************************************************************************/
+int vector_view_add(struct vector_view* self,
+                    const struct vector_view* other)
+{
+   return vector_view_apply(self, other, 0, &vector_view_add_block);
+}
+
+/*******************************************************************************
+* vector_view_mul: Multiplicerar elementen i en vy med motsvarande element i
+*                  en annan vy. Vyerna mste ha samma datatyp och storlek.
+*                  - self : Pekare till vyn som resultatet lagras i.
+*                  - other: Pekare till vyn vars element skall multipliceras.
+*******************************************************************************/
+int vector_view_mul(struct vector_view* self,
+                    const struct vector_view* other)
+{
+   return vector_view_apply(self, other, 0, &vector_view_mul_block);
+}
+
+/*******************************************************************************
+* vector_view_scale: Multiplicerar samtliga element i vyn med en faktor.
+*                    - self  : Pekare till vyn.
+*                    - factor: Pekare till faktorn, som mste vara av vyns
+*                              datatyp.
+*******************************************************************************/
+int vector_view_scale(struct vector_view* self,
+                      const void* factor)
+{
+   if (!factor) return 1;
+   return vector_view_apply(self, 0, factor, &vector_view_scale_block);
+}
+
+/*******************************************************************************
+* vector_view_axpy: Berknar self = alpha * x + self elementvis. Vyerna mste
+*                   ha samma datatyp och storlek.
+*                   - self : Pekare till vyn som resultatet lagras i.
+*                   - alpha: Pekare till skalren, som mste vara av vyns
+*                            datatyp.
+*                   - x    : Pekare till vyn som multipliceras med skalren.
+*******************************************************************************/
+int vector_view_axpy(struct vector_view* self,
+                     const void* alpha,
+                     const struct vector_view* x)
+{
+   if (!alpha) return 1;
+   return vector_view_apply(self, x, alpha, &vector_view_axpy_block);
+}
+
+/*******************************************************************************
+* vector_view_sort: Sorterar elementen i vyn i stigande ordning via
+*                   vector_sort. Element utanfr vyn pverkas inte. Vyer med
+*                   stride kopieras till en temporr vektor fr sortering.
+*                   - self: Pekare till vyn.
+*******************************************************************************/
+int vector_view_sort(struct vector_view* self)
+{
+   return vector_view_sort_with(self, &vector_sort);
+}
+
+/*******************************************************************************
+* vector_view_sort_descending: Sorterar elementen i vyn i fallande ordning
+*                              via vector_sort_descending.
+*                              - self: Pekare till vyn.
+*******************************************************************************/
+int vector_view_sort_descending(struct vector_view* self)
+{
+   return vector_view_sort_with(self, &vector_sort_descending);
+}
+
+/*******************************************************************************
+* vector_view_is_sorted: Indikerar ifall elementen i vyn r sorterade i
+*                        stigande ordning, se vector_is_sorted. Vyer med
+*                        stride kontrolleras blockvis, dr varje block
+*                        brjar med fregende blocks sista element.
+*                        - self: Pekare till vyn.
+*******************************************************************************/
+int vector_view_is_sorted(const struct vector_view* self)
+{
+   uint64_t buffer[VECTOR_VIEW_BLOCK_SIZE];
+   const size_t block_size = vector_view_block_size(self);
+   struct vector block;
+
+   if (self->size < 2) return 1;
+
+   for (size_t first = 0;; first += block_size - 1)
+   {
+      const size_t count = self->size - first < block_size ? self->size - first : block_size;
+      vector_view_load(self, first, count, buffer, &block);
+      if (!vector_is_sorted(&block)) return 0;
+      if (first + count == self->size) return 1;
+   }
+}
+
+/*******************************************************************************
+* vector_view_element_size: Returnerar storleken p vyns element i byte.
+*******************************************************************************/
+static inline size_t vector_view_element_size(const struct vector_view* self)
+{
+   return vector_ops(self->type)->element_size;
+}
+
+/*******************************************************************************
+* vector_view_block_size: Returnerar antalet element som behandlas per block.
+*                         Sammanhngande vyer behandlas i ett enda block.
+*******************************************************************************/
+static inline size_t vector_view_block_size(const struct vector_view* self)
+{
+   return self->stride == 1 ? self->size : VECTOR_VIEW_BLOCK_SIZE;
+}
+
+/*******************************************************************************
+* vector_view_gather: Kopierar angivet antal element ur vyn till en
+*                     sammanhngande buffert. Elementen kopieras med konstant
+*                     storlek, vilket kompilatorn verstter till enkla
+*                     lsningar och skrivningar.
+*                     - dest : Pekare till bufferten.
+*                     - self : Pekare till vyn.
+*                     - first: Index i vyn till frsta elementet.
+*                     - count: Antalet element som skall kopieras.
+*******************************************************************************/
+static void vector_view_gather(void* dest,
+                               const struct vector_view* self,
+                               const size_t first,
+                               const size_t count)
+{
+   const size_t element_size = vector_view_element_size(self);
+   const size_t step = self->stride * element_size;
+   const char* source = (const char*)self->data + first * step;
+   char* target = (char*)dest;
+
+   if (element_size == sizeof(uint8_t))
+   {
+      for (size_t i = 0; i < count; ++i) target[i] = source[i * step];
+   }
+   else if (element_size == sizeof(uint16_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * sizeof(uint16_t), source + i * step, sizeof(uint16_t));
+   }
+   else if (element_size == sizeof(uint32_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * sizeof(uint32_t), source + i * step, sizeof(uint32_t));
+   }
+   else if (element_size == sizeof(uint64_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * sizeof(uint64_t), source + i * step, sizeof(uint64_t));
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_view_scatter: Kopierar angivet antal element frn en sammanhngande
+*                      buffert tillbaka till vyn, motsvarande
+*                      vector_view_gather.
+*                      - self  : Pekare till vyn.
+*                      - source: Pekare till bufferten.
+*                      - first : Index i vyn till frsta elementet.
+*                      - count : Antalet element som skall kopieras.
+*******************************************************************************/
+static void vector_view_scatter(struct vector_view* self,
+                                const void* source,
+                                const size_t first,
+                                const size_t count)
+{
+   const size_t element_size = vector_view_element_size(self);
+   const size_t step = self->stride * element_size;
+   char* target = (char*)self->data + first * step;
+   const char* data = (const char*)source;
+
+   if (element_size == sizeof(uint8_t))
+   {
+      for (size_t i = 0; i < count; ++i) target[i * step] = data[i];
+   }
+   else if (element_size == sizeof(uint16_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * step, data + i * sizeof(uint16_t), sizeof(uint16_t));
+   }
+   else if (element_size == sizeof(uint32_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * step, data + i * sizeof(uint32_t), sizeof(uint32_t));
+   }
+   else if (element_size == sizeof(uint64_t))
+   {
+      for (size_t i = 0; i < count; ++i) memcpy(target + i * step, data + i * sizeof(uint64_t), sizeof(uint64_t));
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_view_load: Initierar en vektor som refererar till ett block av vyn.
+*                   Sammanhngande vyer refereras direkt, medan vyer med
+*                   stride frst samlas ihop i angiven buffert. Vektorn ger
+*                   inte fltet och fr drmed inte raderas.
+*                   - self  : Pekare till vyn.
+*                   - first : Index i vyn till blockets frsta element.
+*                   - count : Antalet element i blocket.
+*                   - buffer: Buffert fr VECTOR_VIEW_BLOCK_SIZE element.
+*                   - block : Pekare till vektorn som skall initieras.
+*******************************************************************************/
+static void vector_view_load(const struct vector_view* self,
+                             const size_t first,
+                             const size_t count,
+                             void* buffer,
+                             struct vector* block)
+{
+   vector_new(block, self->type);
+
+   if (self->stride == 1)
+   {
+      block->data.raw = (char*)self->data + first * vector_view_element_size(self);
+   }
+   else
+   {
+      vector_view_gather(buffer, self, first, count);
+      block->data.raw = buffer;
+   }
+   block->size = count;
+   block->capacity = count;
+   return;
+}
+
+/* Kombinerar delresultat fr en given datatyp, med aritmetik i datatypen wrap. */
+#define VECTOR_VIEW_COMBINE(type, wrap)                                         \
+{                                                                               \
+   type* acc = (type*)result;                                                   \
+   const type value = *(const type*)partial;                                    \
+   if (reduction == VECTOR_PARALLEL_SUM) *acc = (type)((wrap)*acc + (wrap)value); \
+   else if (reduction == VECTOR_PARALLEL_MIN) *acc = value < *acc ? value : *acc; \
+   else *acc = value > *acc ? value : *acc;                                     \
+}
+
+/*******************************************************************************
+* vector_view_combine: Kombinerar ett blocks delresultat med resultatet fr
+*                      tidigare block. Heltal summeras med modulr aritmetik.
+*                      - type     : Elementens datatyp.
+*                      - reduction: Reduktionen som utfrs.
+*                      - result   : Pekare till resultatet fr tidigare block.
+*                      - partial  : Pekare till blockets delresultat.
+*******************************************************************************/
+static void vector_view_combine(const enum vector_type type,
+                                const enum vector_parallel_reduction reduction,
+                                void* result,
+                                const void* partial)
+{
+   switch (type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_VIEW_COMBINE(int, unsigned) break;
+      case VECTOR_TYPE_DOUBLE: VECTOR_VIEW_COMBINE(double, double) break;
+      case VECTOR_TYPE_UNSIGNED: VECTOR_VIEW_COMBINE(size_t, size_t) break;
+      case VECTOR_TYPE_INT8: VECTOR_VIEW_COMBINE(int8_t, unsigned) break;
+      case VECTOR_TYPE_INT16: VECTOR_VIEW_COMBINE(int16_t, unsigned) break;
+      case VECTOR_TYPE_INT64: VECTOR_VIEW_COMBINE(int64_t, uint64_t) break;
+      case VECTOR_TYPE_UINT8: VECTOR_VIEW_COMBINE(uint8_t, unsigned) break;
+      case VECTOR_TYPE_UINT16: VECTOR_VIEW_COMBINE(uint16_t, unsigned) break;
+      case VECTOR_TYPE_UINT32: VECTOR_VIEW_COMBINE(uint32_t, uint32_t) break;
+      case VECTOR_TYPE_FLOAT: VECTOR_VIEW_COMBINE(float, float) break;
+      default: break;
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_view_reduce: Reducerar vyn blockvis via vector_sum, vector_min eller
+*                     vector_max och kombinerar blockens delresultat.
+*                     - self     : Pekare till vyn.
+*                     - reduction: Reduktionen som skall utfras.
+*                     - result   : Pekare till variabel av vyns datatyp dr
+*                                  resultatet skall lagras.
+*******************************************************************************/
+static int vector_view_reduce(const struct vector_view* self,
+                              const enum vector_parallel_reduction reduction,
+                              void* result)
+{
+   uint64_t buffer[VECTOR_VIEW_BLOCK_SIZE];
+   const size_t block_size = vector_view_block_size(self);
+   struct vector block;
+   union vector_small partial;
+
+   if (self->type >= VECTOR_TYPE_NONE || !result) return 1;
+   if (!self->size)
+   {
+      if (reduction != VECTOR_PARALLEL_SUM) return 1;
+      memset(result, 0, vector_view_element_size(self));
+      return 0;
+   }
+
+   for (size_t first = 0; first < self->size; first += block_size)
+   {
+      const size_t count = self->size - first < block_size ? self->size - first : block_size;
+      int status;
+      vector_view_load(self, first, count, buffer, &block);
+
+      if (reduction == VECTOR_PARALLEL_SUM) status = vector_sum(&block, &partial);
+      else if (reduction == VECTOR_PARALLEL_MIN) status = vector_min(&block, &partial);
+      else status = vector_max(&block, &partial);
+      if (status) return 1;
+
+      if (first) vector_view_combine(self->type, reduction, result, &partial);
+      else memcpy(result, &partial, vector_view_element_size(self));
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_apply: Utfr en elementvis operation blockvis, dr vyns block
+*                    skrivs tillbaka efter operationen. Vyer med stride
+*                    samlas ihop till buffertar p stacken.
+*                    - self   : Pekare till vyn som resultatet lagras i.
+*                    - other  : Pekare till vyn med andra operanden (eller
+*                               nullpekare fr operationer utan vy).
+*                    - operand: Pekare till skalr operand (eller nullpekare).
+*                    - op     : Operationen som utfrs fr varje block.
+*******************************************************************************/
+static int vector_view_apply(struct vector_view* self,
+                             const struct vector_view* other,
+                             const void* operand,
+                             int (*op)(struct vector* self,
+                                       const struct vector* other,
+                                       const void* operand))
+{
+   uint64_t buffer[VECTOR_VIEW_BLOCK_SIZE];
+   uint64_t other_buffer[VECTOR_VIEW_BLOCK_SIZE];
+   const size_t block_size = self->stride == 1 && (!other || other->stride == 1) ?
+      self->size : VECTOR_VIEW_BLOCK_SIZE;
+   struct vector block, other_block;
+
+   if (self->flags & VECTOR_FLAG_READONLY) return 1;
+   if (self->type >= VECTOR_TYPE_NONE) return 1;
+   if (other && (other->type != self->type || other->size != self->size)) return 1;
+
+   for (size_t first = 0; first < self->size; first += block_size)
+   {
+      const size_t count = self->size - first < block_size ? self->size - first : block_size;
+      vector_view_load(self, first, count, buffer, &block);
+      if (other) vector_view_load(other, first, count, other_buffer, &other_block);
+      if (op(&block, other ? &other_block : 0, operand)) return 1;
+      if (self->stride != 1) vector_view_scatter(self, buffer, first, count);
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_view_add_block: Adderar ett block via vector_add.
+*******************************************************************************/
+static int vector_view_add_block(struct vector* self,
+                                 const struct vector* other,
+                                 const void* operand)
+{
+   (void)operand;
+   return vector_add(self, other);
+}
+
+/*******************************************************************************
+* vector_view_mul_block: Multiplicerar ett block via vector_mul.
+*******************************************************************************/
+static int vector_view_mul_block(struct vector* self,
+                                 const struct vector* other,
+                                 const void* operand)
+{
+   (void)operand;
+   return vector_mul(self, other);
+}
+
+/*******************************************************************************
+* vector_view_scale_block: Skalar ett block via vector_scale.
+*******************************************************************************/
+static int vector_view_scale_block(struct vector* self,
+                                   const struct vector* other,
+                                   const void* operand)
+{
+   (void)other;
+   return vector_scale(self, operand);
+}
+
+/*******************************************************************************
+* vector_view_axpy_block: Berknar alpha * x + self fr ett block via
+*                         vector_axpy.
+*******************************************************************************/
+static int vector_view_axpy_block(struct vector* self,
+                                  const struct vector* other,
+                                  const void* operand)
+{
+   return vector_axpy(self, operand, other);
+}
+
+/*******************************************************************************
+* vector_view_sort_with: Sorterar vyn via angiven sorteringsfunktion.
+*                        Sammanhngande vyer sorteras p plats, medan vyer
+*                        med stride kopieras till en temporr vektor som
+*                        sorteras och drefter kopieras tillbaka.
+*                        - self: Pekare till vyn.
+*                        - sort: Sorteringsfunktion fr vektorer.
+*******************************************************************************/
+static int vector_view_sort_with(struct vector_view* self,
+                                 int (*sort)(struct vector* self))
+{
+   struct vector block;
+   if (self->flags & VECTOR_FLAG_READONLY) return 1;
+   if (self->type >= VECTOR_TYPE_NONE) return 1;
+
+   if (self->stride == 1)
+   {
+      vector_view_load(self, 0, self->size, 0, &block);
+      return sort(&block);
+   }
+
+   vector_new(&block, self->type);
+   if (vector_view_copy(&block, self) || sort(&block))
+   {
+      vector_delete(&block);
+      return 1;
+   }
+   vector_view_scatter(self, block.data.raw, 0, self->size);
+   vector_delete(&block);
+   return 0;
+}
@@ -0,0 +1,77 @@
+/*******************************************************************************
+* vector_view.h: Vyer ver vektorer, det vill sga lnade delomrden som
+*                refererar direkt till en vektors flt utan att minne
+*                allokeras eller element kopieras. En vy kan omfatta hela
+*                vektorn, ett delomrde eller vart N:te element (stride).
+*                Vyer kan delas upp vidare, exempelvis i ett delomrde per
+*                trd, och lsas, skrivas ut, anvndas i berkningar frn
+*                vector_kernels samt sorteras direkt.
+*
+*                En vy r giltig s lnge vektorn den skapats frn varken
+*                raderas eller omallokeras. Vyer ver skrivskyddade vektorer
+*                samt vektorer vars flt kan delas (se vector_set_shared) r
+*                skrivskyddade, eftersom ndringar via vyn annars skulle
+*                synas i andra vektorer.
+*******************************************************************************/
+#ifndef VECTOR_VIEW_H_
+#define VECTOR_VIEW_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+
+/*******************************************************************************
+* vector_view: Vy ver element i en vektors flt, dr element i ligger p
+*              adressen data + i * stride * elementstorleken.
+*******************************************************************************/
+struct vector_view
+{
+   void* data;            /* Pekare till vyns frsta element. */
+   size_t size;           /* Antalet element i vyn. */
+   size_t stride;         /* Avstnd mellan element i antalet element (minst 1). */
+   enum vector_type type; /* Elementens datatyp. */
+   unsigned flags;        /* Vyns egenskaper (se vector_flag). */
+};
+
+/* Externa funktioner: */
+void vector_view_new(struct vector_view* self,
+                     const struct vector* source);
+int vector_view_slice(struct vector_view* self,
+                      const struct vector_view* source,
+                      const size_t first,
+                      const size_t size,
+                      const size_t step);
+int vector_view_split(struct vector_view* self,
+                      const struct vector_view* source,
+                      const size_t num_parts,
+                      const size_t part);
+const void* vector_view_get(const struct vector_view* self,
+                            const size_t index);
+int vector_view_copy(struct vector* dest,
+                     const struct vector_view* source);
+void vector_view_print(const struct vector_view* self,
+                       FILE* ostream);
+int vector_view_sum(const struct vector_view* self,
+                    void* result);
+int vector_view_min(const struct vector_view* self,
+                    void* result);
+int vector_view_max(const struct vector_view* self,
+                    void* result);
+int vector_view_mean(const struct vector_view* self,
+                     double* result);
+int vector_view_dot(const struct vector_view* self,
+                    const struct vector_view* other,
+                    void* result);
+int vector_view_add(struct vector_view* self,
+                    const struct vector_view* other);
+int vector_view_mul(struct vector_view* self,
+                    const struct vector_view* other);
+int vector_view_scale(struct vector_view* self,
+                      const void* factor);
+int vector_view_axpy(struct vector_view* self,
+                     const void* alpha,
+                     const struct vector_view* x);
+int vector_view_sort(struct vector_view* self);
+int vector_view_sort_descending(struct vector_view* self);
+int vector_view_is_sorted(const struct vector_view* self);
+
+#endif /* VECTOR_VIEW_H_ */
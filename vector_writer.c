@@ -0,0 +1,583 @@
+/*******************************************************************************
+* vector_writer.c: Innehller funktioner fr asynkron textutskrift av vektorer.
+*                  Skrivaren bestr av en k av vektorer, en formateringstrd
+*                  samt en skrivtrd. Formateringstrden fyller buffertarna i
+*                  tur och ordning och lmnar ver fulla buffertar till
+*                  skrivtrden, som skriver dem till filbeskrivaren och
+*                  terlmnar dem tomma.
+*******************************************************************************/
+#define _POSIX_C_SOURCE 200809L
+#include "vector_writer.h"
+#include <errno.h>
+#include <pthread.h>
+#include <string.h>
+#include <unistd.h>
+
+/*******************************************************************************
+* vector_writer_buffer: Utskriftsbuffert. En buffert tillhr formateringstrden
+*                       tills den markerats som full, drefter skrivtrden
+*                       tills den skrivits och tmts.
+*******************************************************************************/
+struct vector_writer_buffer
+{
+   char* data;    /* Buffertens innehll. */
+   size_t length; /* Antalet lagrade tecken. */
+   int full;      /* Indikerar ifall bufferten vntar p att skrivas. */
+};
+
+/*******************************************************************************
+* vector_writer: Asynkron skrivare. Kn r en ringbuffert av vektorer, dr
+*                platserna head till head + count - 1 vntar p utskrift.
+*                Samtliga flt utom buffertarnas innehll skyddas av mutex.
+*******************************************************************************/
+struct vector_writer
+{
+   struct vector* entries;     /* Kns platser. */
+   size_t depth;               /* Kns kapacitet. */
+   size_t head;                /* Index fr nsta vektor att formatera. */
+   size_t count;               /* Antalet kade vektorer. */
+   struct vector_writer_buffer buffers[VECTOR_WRITER_BUFFERS]; /* Roterande buffertar. */
+   size_t current;             /* Buffert som formateras. */
+   size_t next;                /* Nsta buffert att skriva. */
+   struct vector_write_options options; /* Instllningar fr utskriften. */
+   int fd;                     /* Filbeskrivare som utskriften skrivs till. */
+   int status;                 /* Stts till 1 vid fel vid skrivning. */
+   int closing;                /* Indikerar att formateringstrden skall avslutas. */
+   int done;                   /* Indikerar att skrivtrden skall avslutas. */
+   pthread_mutex_t mutex;      /* Skyddar skrivarens tillstnd. */
+   pthread_cond_t queued;      /* Signaleras nr en vektor har kats. */
+   pthread_cond_t filled;      /* Signaleras nr en buffert r full. */
+   pthread_cond_t progress;    /* Signaleras nr en kplats eller buffert frigrs. */
+   pthread_t formatter;        /* Formateringstrd. */
+   pthread_t output;           /* Skrivtrd. */
+};
+
+/* Statiska funktioner: */
+static int vector_writer_start(struct vector_writer* self);
+static void* vector_writer_format_run(void* arg);
+static void* vector_writer_output_run(void* arg);
+static void vector_writer_format_vector(struct vector_writer* self,
+                                        const struct vector* source);
+static size_t vector_writer_format(char* dest,
+                                   const struct vector* source,
+                                   const size_t begin,
+                                   const size_t end,
+                                   const char separator);
+static struct vector_writer_buffer* vector_writer_buffer(struct vector_writer* self);
+static void vector_writer_append(struct vector_writer* self,
+                                 const char* text);
+static void vector_writer_submit(struct vector_writer* self);
+static int vector_writer_write_all(const int fd,
+                                   const char* data,
+                                   size_t length);
+static void vector_writer_free(struct vector_writer* self);
+
+/*******************************************************************************
+* vector_writer_new: Returnerar en ny skrivare fr angiven filbeskrivare och
+*                    startar dess trdar, eller nullpekare vid fel.
+*                    Filbeskrivaren stngs inte av skrivaren. Eventuellt
+*                    sidhuvud och sidfot skrivs fre respektive efter varje
+*                    vektor och mste finnas kvar tills skrivaren stngs.
+*                    - fd     : Filbeskrivare som utskriften skrivs till.
+*                    - depth  : Kns kapacitet i antalet vektorer (noll
+*                               medfr VECTOR_WRITER_DEFAULT_DEPTH).
+*                    - options: Instllningar fr utskriften (nullpekare
+*                               medfr ett element per rad).
+*******************************************************************************/
+struct vector_writer* vector_writer_new(const int fd,
+                                        const size_t depth,
+                                        const struct vector_write_options* options)
+{
+   if (fd < 0) return 0;
+   struct vector_writer* self = (struct vector_writer*)calloc(1, sizeof(struct vector_writer));
+   if (!self) return 0;
+
+   self->depth = depth ? depth : VECTOR_WRITER_DEFAULT_DEPTH;
+   self->fd = fd;
+   self->options.separator = options ? options->separator : VECTOR_SEPARATOR_NEWLINE;
+   self->options.header = options ? options->header : 0;
+   self->options.footer = options ? options->footer : 0;
+   pthread_mutex_init(&self->mutex, 0);
+   pthread_cond_init(&self->queued, 0);
+   pthread_cond_init(&self->filled, 0);
+   pthread_cond_init(&self->progress, 0);
+   self->entries = (struct vector*)malloc(sizeof(struct vector) * self->depth);
+
+   if (!self->entries)
+   {
+      self->depth = 0;
+      vector_writer_free(self);
+      return 0;
+   }
+
+   for (size_t i = 0; i < self->depth; ++i)
+   {
+      vector_new(&self->entries[i], VECTOR_TYPE_NONE);
+   }
+
+   for (size_t i = 0; i < VECTOR_WRITER_BUFFERS; ++i)
+   {
+      self->buffers[i].data = (char*)malloc(VECTOR_WRITER_BUFFER_SIZE);
+      if (!self->buffers[i].data)
+      {
+         vector_writer_free(self);
+         return 0;
+      }
+   }
+
+   if (vector_writer_start(self))
+   {
+      vector_writer_free(self);
+      return 0;
+   }
+   return self;
+}
+
+/*******************************************************************************
+* vector_writer_write: Lgger en kopia av angiven vektor i kn. Elementen
+*                      kopieras i anropande trd, frutom om vektorns flt
+*                      delas (se vector_set_shared), d fltet i stllet
+*                      delas med kn i konstant tid. Vntar om kn r full.
+*                      Returnerar 1 vid fel, exempelvis om ett tidigare
+*                      frsk att skriva har misslyckats.
+*                      - self  : Pekare till skrivaren.
+*                      - source: Pekare till vektorn som skall skrivas ut.
+*******************************************************************************/
+int vector_writer_write(struct vector_writer* self,
+                        const struct vector* source)
+{
+   struct vector copy;
+   vector_new(&copy, source->type);
+
+   if (vector_set_allocator(&copy, source->flags & VECTOR_FLAG_SHARED ? source->allocator : 0) ||
+       vector_copy(&copy, source))
+   {
+      vector_delete(&copy);
+      return 1;
+   }
+
+   const int status = vector_writer_write_move(self, &copy);
+   vector_delete(&copy);
+   return status;
+}
+
+/*******************************************************************************
+* vector_writer_write_move: Frflyttar innehllet i angiven vektor till kn
+*                           via vector_move, vilket sker i konstant tid.
+*                           Vektorn r drefter tom och innehllet frigrs
+*                           av skrivaren nr det har skrivits ut, i
+*                           formateringstrden om den inbyggda allokeraren
+*                           anvnds och annars i anropande trd (se
+*                           vector_writer_format_run). Den plats som tas i
+*                           ansprk frigrs hr frn en tidigare utskriven
+*                           vektor. Vntar s lnge kn r full.
+*                           Vid fel lmnas vektorn orrd.
+*                           - self  : Pekare till skrivaren.
+*                           - source: Pekare till vektorn som skall skrivas ut.
+*******************************************************************************/
+int vector_writer_write_move(struct vector_writer* self,
+                             struct vector* source)
+{
+   if (source->type >= VECTOR_TYPE_NONE) return 1;
+   pthread_mutex_lock(&self->mutex);
+
+   while (self->count == self->depth && !self->status)
+   {
+      pthread_cond_wait(&self->progress, &self->mutex);
+   }
+
+   const int status = self->status;
+   if (!status)
+   {
+      vector_move(&self->entries[(self->head + self->count) % self->depth], source);
+      if (!self->count++) pthread_cond_signal(&self->queued);
+   }
+   pthread_mutex_unlock(&self->mutex);
+   return status;
+}
+
+/*******************************************************************************
+* vector_writer_write_snapshot: Lgger en gonblicksbild av angiven vektor i
+*                               kn genom att vektorns flt delas med kn
+*                               (copy-on-write), vilket sker i konstant tid.
+*                               Fram till att utskriften r klar fr vektorn
+*                               enbart ndras via funktioner som hanterar
+*                               delade flt (exempelvis vector_set,
+*                               vector_push och vector_resize), som d ger
+*                               vektorn en egen kopia. Typade funktioner som
+*                               vector_int_set samt skrivning via fltpekaren
+*                               skriver direkt i det delade fltet och krver
+*                               att vector_unshare anropas frst. Egenskapen
+*                               att fltet delas kvarstr tills vektorn
+*                               raderas. Skrivskyddade vektorer kopieras i
+*                               stllet.
+*                               - self  : Pekare till skrivaren.
+*                               - source: Pekare till vektorn som skall
+*                                         skrivas ut.
+*******************************************************************************/
+int vector_writer_write_snapshot(struct vector_writer* self,
+                                 struct vector* source)
+{
+   if (!(source->flags & VECTOR_FLAG_READONLY) && vector_set_shared(source, 1)) return 1;
+   return vector_writer_write(self, source);
+}
+
+/*******************************************************************************
+* vector_writer_flush: Vntar tills samtliga kade vektorer har formaterats
+*                      och skrivits till filbeskrivaren, varefter utskrivna
+*                      vektorer med egen allokerare frigrs. Returnerar 1 om
+*                      ngon skrivning har misslyckats sedan skrivaren
+*                      skapades, annars 0.
+*                      - self: Pekare till skrivaren.
+*******************************************************************************/
+int vector_writer_flush(struct vector_writer* self)
+{
+   pthread_mutex_lock(&self->mutex);
+   for (;;)
+   {
+      int idle = !self->count && !self->buffers[self->current].length;
+      for (size_t i = 0; i < VECTOR_WRITER_BUFFERS; ++i)
+      {
+         if (self->buffers[i].full) idle = 0;
+      }
+      if (idle) break;
+      pthread_cond_wait(&self->progress, &self->mutex);
+   }
+
+   /* Utskrivna vektorer med egen allokerare frigrs i anropande trd: */
+   for (size_t i = self->count; i < self->depth; ++i)
+   {
+      vector_delete(&self->entries[(self->head + i) % self->depth]);
+   }
+   const int status = self->status;
+   pthread_mutex_unlock(&self->mutex);
+   return status;
+}
+
+/*******************************************************************************
+* vector_writer_close: Skriver ut samtliga kade vektorer, avslutar
+*                      skrivarens trdar och frigr skrivaren, varefter
+*                      pekaren stts till null. Returnerar 1 om ngon
+*                      skrivning har misslyckats, annars 0.
+*                      - self: Adressen till pekaren som pekar p skrivaren.
+*******************************************************************************/
+int vector_writer_close(struct vector_writer** self)
+{
+   struct vector_writer* writer = *self;
+   if (!writer) return 0;
+
+   pthread_mutex_lock(&writer->mutex);
+   writer->closing = 1;
+   pthread_cond_signal(&writer->queued);
+   pthread_mutex_unlock(&writer->mutex);
+   pthread_join(writer->formatter, 0);
+
+   pthread_mutex_lock(&writer->mutex);
+   writer->done = 1;
+   pthread_cond_signal(&writer->filled);
+   pthread_mutex_unlock(&writer->mutex);
+   pthread_join(writer->output, 0);
+
+   const int status = writer->status;
+   vector_writer_free(writer);
+   *self = 0;
+   return status;
+}
+
+/*******************************************************************************
+* vector_writer_start: Startar skrivarens trdar. Om formateringstrden inte
+*                      kan skapas avslutas skrivtrden igen.
+*                      - self: Pekare till skrivaren.
+*******************************************************************************/
+static int vector_writer_start(struct vector_writer* self)
+{
+   if (pthread_create(&self->output, 0, &vector_writer_output_run, self)) return 1;
+   if (!pthread_create(&self->formatter, 0, &vector_writer_format_run, self)) return 0;
+
+   pthread_mutex_lock(&self->mutex);
+   self->done = 1;
+   pthread_cond_signal(&self->filled);
+   pthread_mutex_unlock(&self->mutex);
+   pthread_join(self->output, 0);
+   return 1;
+}
+
+/*******************************************************************************
+* vector_writer_format_run: Formateringstrdens huvudloop. Kade vektorer
+*                           formateras utan att skrivaren r lst, eftersom
+*                           platsen inte ndras av andra trdar frrn den
+*                           lmnats tillbaka. Enbart vektorer med den
+*                           inbyggda allokeraren frigrs hr, d vriga
+*                           allokerare (exempelvis arenor och pooler) inte
+*                           r trdskra. Sdana vektorer ligger kvar p sin
+*                           plats och frigrs i anropande trd nr platsen
+*                           teranvnds, vid vector_writer_flush eller vid
+*                           vector_writer_close. Nr kn blir tom lmnas ven
+*                           en delvis fylld buffert ver, s att utskriften
+*                           inte drjer tills nsta vektor kas.
+*                           - arg: Pekare till skrivaren.
+*******************************************************************************/
+static void* vector_writer_format_run(void* arg)
+{
+   struct vector_writer* self = (struct vector_writer*)arg;
+   pthread_mutex_lock(&self->mutex);
+
+   for (;;)
+   {
+      while (!self->count && !self->closing)
+      {
+         pthread_cond_wait(&self->queued, &self->mutex);
+      }
+      if (!self->count) break;
+
+      struct vector* entry = &self->entries[self->head];
+      pthread_mutex_unlock(&self->mutex);
+      vector_writer_format_vector(self, entry);
+      if (entry->allocator == vector_allocator_heap()) vector_delete(entry);
+      pthread_mutex_lock(&self->mutex);
+
+      self->head = (self->head + 1) % self->depth;
+      self->count--;
+      if (!self->count && self->buffers[self->current].length)
+      {
+         self->buffers[self->current].full = 1;
+         self->current = (self->current + 1) % VECTOR_WRITER_BUFFERS;
+         pthread_cond_signal(&self->filled);
+      }
+      pthread_cond_broadcast(&self->progress);
+   }
+
+   pthread_mutex_unlock(&self->mutex);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_writer_output_run: Skrivtrdens huvudloop. Fulla buffertar skrivs i
+*                           den ordning de fylldes. Vid fel sparas felet och
+*                           bufferten tms nd, s att formateringen inte
+*                           stannar upp.
+*                           - arg: Pekare till skrivaren.
+*******************************************************************************/
+static void* vector_writer_output_run(void* arg)
+{
+   struct vector_writer* self = (struct vector_writer*)arg;
+   pthread_mutex_lock(&self->mutex);
+
+   for (;;)
+   {
+      struct vector_writer_buffer* buffer = &self->buffers[self->next];
+      while (!buffer->full && !self->done)
+      {
+         pthread_cond_wait(&self->filled, &self->mutex);
+      }
+      if (!buffer->full) break;
+
+      pthread_mutex_unlock(&self->mutex);
+      const int status = vector_writer_write_all(self->fd, buffer->data, buffer->length);
+      pthread_mutex_lock(&self->mutex);
+
+      if (status) self->status = 1;
+      buffer->length = 0;
+      buffer->full = 0;
+      self->next = (self->next + 1) % VECTOR_WRITER_BUFFERS;
+      pthread_cond_broadcast(&self->progress);
+   }
+
+   pthread_mutex_unlock(&self->mutex);
+   return 0;
+}
+
+/*******************************************************************************
+* vector_writer_format_vector: Formaterar samtliga element i angiven vektor
+*                              till skrivarens buffertar, p samma stt som
+*                              vector_write. Elementen formateras i s stora
+*                              omgngar som ryms i aktuell buffert.
+*                              - self  : Pekare till skrivaren.
+*                              - source: Pekare till vektorn.
+*******************************************************************************/
+static void vector_writer_format_vector(struct vector_writer* self,
+                                        const struct vector* source)
+{
+   const char separator = self->options.separator == VECTOR_SEPARATOR_COMMA ? ',' :
+                          self->options.separator == VECTOR_SEPARATOR_SPACE ? ' ' : '\n';
+   struct vector_writer_buffer* buffer = 0;
+   size_t index = 0;
+
+   if (self->options.header) vector_writer_append(self, self->options.header);
+
+   while (index < source->size)
+   {
+      buffer = vector_writer_buffer(self);
+      const size_t room = (VECTOR_WRITER_BUFFER_SIZE - buffer->length) / (VECTOR_FORMAT_MAX + 1);
+
+      if (!room)
+      {
+         vector_writer_submit(self);
+         continue;
+      }
+
+      const size_t end = index + room < source->size ? index + room : source->size;
+      buffer->length += vector_writer_format(buffer->data + buffer->length,
+                                             source, index, end, separator);
+      index = end;
+   }
+
+   if (buffer && separator != '\n') buffer->length--;
+   if (self->options.footer) vector_writer_append(self, self->options.footer);
+   return;
+}
+
+/*******************************************************************************
+* VECTOR_WRITER_FORMAT_LOOP: Formaterar elementen i ett intervall, dr varje
+*                            element fljs av angiven separator.
+*                            - member: Medlem i union vector_ptr.
+*                            - format: Funktion som formaterar ett element.
+*******************************************************************************/
+#define VECTOR_WRITER_FORMAT_LOOP(member, format)                              \
+   for (size_t i = begin; i < end; ++i)                                        \
+   {                                                                           \
+      length += format(dest + length, source->data.member[i]);                 \
+      dest[length++] = separator;                                              \
+   }                                                                           \
+   break;
+
+/*******************************************************************************
+* vector_writer_format: Formaterar elementen i angivet intervall till angiven
+*                       adress och returnerar antalet skrivna tecken. Plats
+*                       mste finnas fr VECTOR_FORMAT_MAX + 1 tecken per
+*                       element.
+*                       - dest     : Adressen dit texten skrivs.
+*                       - source   : Pekare till vektorn.
+*                       - begin    : Index fr frsta elementet.
+*                       - end      : Index efter sista elementet.
+*                       - separator: Tecken som skrivs efter varje element.
+*******************************************************************************/
+static size_t vector_writer_format(char* dest,
+                                   const struct vector* source,
+                                   const size_t begin,
+                                   const size_t end,
+                                   const char separator)
+{
+   size_t length = 0;
+   switch (source->type)
+   {
+      case VECTOR_TYPE_INTEGER: VECTOR_WRITER_FORMAT_LOOP(integer, vector_format_int)
+      case VECTOR_TYPE_DOUBLE: VECTOR_WRITER_FORMAT_LOOP(decimal, vector_format_double)
+      case VECTOR_TYPE_UNSIGNED: VECTOR_WRITER_FORMAT_LOOP(natural, vector_format_unsigned)
+      case VECTOR_TYPE_INT8: VECTOR_WRITER_FORMAT_LOOP(int8, vector_format_int)
+      case VECTOR_TYPE_INT16: VECTOR_WRITER_FORMAT_LOOP(int16, vector_format_int)
+      case VECTOR_TYPE_INT64: VECTOR_WRITER_FORMAT_LOOP(int64, vector_format_int64)
+      case VECTOR_TYPE_UINT8: VECTOR_WRITER_FORMAT_LOOP(uint8, vector_format_unsigned)
+      case VECTOR_TYPE_UINT16: VECTOR_WRITER_FORMAT_LOOP(uint16, vector_format_unsigned)
+      case VECTOR_TYPE_UINT32: VECTOR_WRITER_FORMAT_LOOP(uint32, vector_format_unsigned)
+      case VECTOR_TYPE_FLOAT: VECTOR_WRITER_FORMAT_LOOP(single, vector_format_float)
+      default: break;
+   }
+   return length;
+}
+
+/*******************************************************************************
+* vector_writer_buffer: Returnerar bufferten som formateras, dr
+*                       formateringstrden vntar om bufferten fortfarande
+*                       skrivs av skrivtrden.
+*                       - self: Pekare till skrivaren.
+*******************************************************************************/
+static struct vector_writer_buffer* vector_writer_buffer(struct vector_writer* self)
+{
+   pthread_mutex_lock(&self->mutex);
+   struct vector_writer_buffer* buffer = &self->buffers[self->current];
+   while (buffer->full)
+   {
+      pthread_cond_wait(&self->progress, &self->mutex);
+   }
+   pthread_mutex_unlock(&self->mutex);
+   return buffer;
+}
+
+/*******************************************************************************
+* vector_writer_append: Lgger till angiven text i buffertarna, uppdelad p
+*                       flera buffertar om texten inte ryms i aktuell.
+*                       - self: Pekare till skrivaren.
+*                       - text: Texten som skall lggas till.
+*******************************************************************************/
+static void vector_writer_append(struct vector_writer* self,
+                                 const char* text)
+{
+   size_t remaining = strlen(text);
+   while (remaining)
+   {
+      struct vector_writer_buffer* buffer = vector_writer_buffer(self);
+      size_t length = VECTOR_WRITER_BUFFER_SIZE - buffer->length;
+      if (length > remaining) length = remaining;
+
+      memcpy(buffer->data + buffer->length, text, length);
+      buffer->length += length;
+      text += length;
+      remaining -= length;
+      if (buffer->length == VECTOR_WRITER_BUFFER_SIZE) vector_writer_submit(self);
+   }
+   return;
+}
+
+/*******************************************************************************
+* vector_writer_submit: Lmnar ver bufferten som formateras till skrivtrden
+*                       och gr vidare till nsta buffert.
+*                       - self: Pekare till skrivaren.
+*******************************************************************************/
+static void vector_writer_submit(struct vector_writer* self)
+{
+   pthread_mutex_lock(&self->mutex);
+   self->buffers[self->current].full = 1;
+   self->current = (self->current + 1) % VECTOR_WRITER_BUFFERS;
+   pthread_cond_signal(&self->filled);
+   pthread_mutex_unlock(&self->mutex);
+   return;
+}
+
+/*******************************************************************************
+* vector_writer_write_all: Skriver angivet antal tecken till filbeskrivaren,
+*                          dr avbrutna och ofullstndiga anrop upprepas.
+*                          - fd    : Filbeskrivaren.
+*                          - data  : Tecknen som skall skrivas.
+*                          - length: Antalet tecken.
+*******************************************************************************/
+static int vector_writer_write_all(const int fd,
+                                   const char* data,
+                                   size_t length)
+{
+   while (length)
+   {
+      const ssize_t written = write(fd, data, length);
+      if (written < 0)
+      {
+         if (errno == EINTR) continue;
+         return 1;
+      }
+      data += written;
+      length -= (size_t)written;
+   }
+   return 0;
+}
+
+/*******************************************************************************
+* vector_writer_free: Frigr skrivarens k, buffertar, ls och struktur.
+*                     - self: Pekare till skrivaren.
+*******************************************************************************/
+static void vector_writer_free(struct vector_writer* self)
+{
+   pthread_mutex_destroy(&self->mutex);
+   pthread_cond_destroy(&self->queued);
+   pthread_cond_destroy(&self->filled);
+   pthread_cond_destroy(&self->progress);
+   for (size_t i = 0; i < self->depth; ++i)
+   {
+      vector_delete(&self->entries[i]);
+   }
+   for (size_t i = 0; i < VECTOR_WRITER_BUFFERS; ++i)
+   {
+      free(self->buffers[i].data);
+   }
+   free(self->entries);
+   free(self);
+   return;
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+* vector_writer.h: Asynkron textutskrift av vektorer till en filbeskrivare.
+*                  Anroparen lgger vektorer i en k, varefter en
+*                  bakgrundstrd formaterar elementen (likt vector_write)
+*                  till roterande buffertar, som skrivs till filbeskrivaren
+*                  av en separat trd. Formatering och skrivning sker
+*                  drmed parallellt, utan att anroparen vntar p ngotdera.
+*
+*                  Vektorer kan lggas i kn p tre stt, dr de tv senare
+*                  sker i konstant tid oavsett vektorns storlek:
+*
+*                  - vector_writer_write: Elementen kopieras (via
+*                    vector_copy, vilket sker i konstant tid om fltet
+*                    redan delas, se vector_set_shared).
+*                  - vector_writer_write_move: Innehllet frflyttas via
+*                    vector_move, varefter anroparens vektor r tom.
+*                  - vector_writer_write_snapshot: Fltet delas med kn
+*                    (copy-on-write). Anroparens vektor fr en egen kopia
+*                    om den ndras via vector_set, vector_push med flera
+*                    innan utskriften r klar. Typade funktioner
+*                    (vector_int_set med flera) och skrivning via
+*                    fltpekaren kontrollerar inte delning, varfr
+*                    vector_unshare mste anropas fre sdana ndringar.
+*
+*                  Vektorer med den inbyggda allokeraren frigrs i
+*                  bakgrunden nr de har skrivits ut. vriga allokerare r
+*                  inte trdskra, varfr sdana vektorer i stllet frigrs
+*                  i anropande trd, nr kplatsen teranvnds eller vid
+*                  vector_writer_flush och vector_writer_close.
+*
+*                  Kn rymmer ett begrnsat antal vektorer. Nr kn r full
+*                  vntar anroparen tills en plats frigjorts (mottryck), s
+*                  att minnestgngen begrnsas om utskriften inte hinner
+*                  med. Via vector_writer_flush vntar anroparen tills samtliga
+*                  kade vektorer har skrivits. Fel vid skrivning sparas och
+*                  returneras av vector_writer_flush och vector_writer_close.
+*
+*                  Programmet mste lnkas med flaggan -pthread.
+*******************************************************************************/
+#ifndef VECTOR_WRITER_H_
+#define VECTOR_WRITER_H_
+
+/* Inkluderingsdirektiv: */
+#include "vector.h"
+#include "vector_format.h"
+
+/* Makrodefinitioner: */
+#define VECTOR_WRITER_BUFFER_SIZE 65536 /* Storlek p varje utskriftsbuffert i byte. */
+#define VECTOR_WRITER_BUFFERS 2         /* Antalet roterande buffertar. */
+#define VECTOR_WRITER_DEFAULT_DEPTH 8   /* Kns frvalda kapacitet (antalet vektorer). */
+
+/*******************************************************************************
+* vector_writer: Asynkron skrivare, definieras i vector_writer.c.
+*******************************************************************************/
+struct vector_writer;
+
+/* Externa funktioner: */
+struct vector_writer* vector_writer_new(const int fd,
+                                        const size_t depth,
+                                        const struct vector_write_options* options);
+int vector_writer_write(struct vector_writer* self,
+                        const struct vector* source);
+int vector_writer_write_move(struct vector_writer* self,
+                             struct vector* source);
+int vector_writer_write_snapshot(struct vector_writer* self,
+                                 struct vector* source);
+int vector_writer_flush(struct vector_writer* self);
+int vector_writer_close(struct vector_writer** self);
+
+#endif /* VECTOR_WRITER_H_ */